@@ -0,0 +1,147 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/EntityModel.h"
+#include "Renderer/IndexRangeMap.h"
+#include "Renderer/IndexRangeMapBuilder.h"
+#include "Renderer/PrimType.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/constants.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+
+namespace TrenchBroom
+{
+namespace Assets
+{
+static constexpr size_t NumRings = 256;
+static constexpr size_t NumSegments = 512;
+static constexpr size_t NumRays = 100'000;
+static constexpr float Radius = 64.0f;
+
+/**
+ * Creates a model with a single frame containing a UV sphere made of
+ * 2 * NumRings * NumSegments triangles.
+ */
+static std::unique_ptr<EntityModel> makeHighPolyModel()
+{
+  auto model =
+    std::make_unique<EntityModel>("sphere", PitchType::Normal, Orientation::Oriented);
+  model->addFrame();
+  auto& surface = model->addSurface("sphere");
+
+  const auto vertexAt = [](const size_t ring, const size_t segment) {
+    const auto theta = vm::Cf::pi() * float(ring) / float(NumRings);
+    const auto phi = vm::Cf::two_pi() * float(segment) / float(NumSegments);
+    const auto position = vm::vec3f{
+      Radius * std::sin(theta) * std::cos(phi),
+      Radius * std::sin(theta) * std::sin(phi),
+      Radius * std::cos(theta)};
+    const auto texCoords =
+      vm::vec2f{float(segment) / float(NumSegments), float(ring) / float(NumRings)};
+    return EntityModelVertex{position, texCoords};
+  };
+
+  auto triangles = std::vector<EntityModelVertex>{};
+  triangles.reserve(NumRings * NumSegments * 6);
+  for (size_t ring = 0; ring < NumRings; ++ring)
+  {
+    for (size_t segment = 0; segment < NumSegments; ++segment)
+    {
+      triangles.push_back(vertexAt(ring, segment));
+      triangles.push_back(vertexAt(ring + 1, segment));
+      triangles.push_back(vertexAt(ring + 1, segment + 1));
+
+      triangles.push_back(vertexAt(ring, segment));
+      triangles.push_back(vertexAt(ring + 1, segment + 1));
+      triangles.push_back(vertexAt(ring, segment + 1));
+    }
+  }
+
+  auto size = Renderer::IndexRangeMap::Size{};
+  size.inc(Renderer::PrimType::Triangles, triangles.size());
+
+  auto builder = Renderer::IndexRangeMapBuilder<EntityModelVertex::Type>{
+    triangles.size(), size};
+  builder.addTriangles(triangles);
+
+  auto& frame = model->loadFrame(0, "frame", vm::bbox3f{Radius});
+  surface.addIndexedMesh(
+    frame, std::move(builder.vertices()), std::move(builder.indices()));
+
+  return model;
+}
+
+/**
+ * Creates rays that start outside of the sphere and point roughly towards its center, so
+ * that most of them hit.
+ */
+static std::vector<vm::ray3f> makeRays()
+{
+  auto rays = std::vector<vm::ray3f>{};
+  rays.reserve(NumRays);
+  for (size_t i = 0; i < NumRays; ++i)
+  {
+    const auto a = float(i) * 0.37f;
+    const auto b = float(i) * 0.11f;
+    const auto origin = vm::vec3f{
+      4.0f * Radius * std::cos(a), 4.0f * Radius * std::sin(a), Radius * std::sin(b)};
+    const auto target = vm::vec3f{
+      Radius * std::sin(float(i)), Radius * std::cos(float(i)), 0.0f};
+    rays.emplace_back(origin, vm::normalize(target - origin));
+  }
+  return rays;
+}
+
+TEST_CASE("EntityModelBenchmark.pickHighPolyModel")
+{
+  auto model = std::unique_ptr<EntityModel>{};
+  timeLambda(
+    [&]() { model = makeHighPolyModel(); },
+    "build model with " + std::to_string(NumRings * NumSegments * 2) + " triangles");
+
+  const auto* frame = model->frame(0);
+  const auto rays = makeRays();
+
+  auto hits = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& ray : rays)
+      {
+        if (!vm::is_nan(frame->intersect(ray)))
+        {
+          ++hits;
+        }
+      }
+    },
+    "intersect " + std::to_string(rays.size()) + " rays");
+
+  CHECK(hits > 0u);
+}
+} // namespace Assets
+} // namespace TrenchBroom
@@ -0,0 +1,173 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/EntityModel.h"
+#include "Assets/EntityModelMeshOptimizer.h"
+#include "Renderer/IndexRangeMap.h"
+#include "Renderer/IndexRangeMapBuilder.h"
+#include "Renderer/PrimType.h"
+
+#include <vecmath/constants.h>
+#include <vecmath/vec.h>
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+
+namespace TrenchBroom
+{
+namespace Assets
+{
+namespace
+{
+struct SampleModel
+{
+  std::string name;
+  std::vector<EntityModelVertex> vertices;
+  EntityModelIndices indices;
+};
+
+EntityModelVertex sphereVertex(
+  const size_t ring,
+  const size_t numRings,
+  const size_t segment,
+  const size_t numSegments)
+{
+  const auto theta = vm::Cf::pi() * float(ring) / float(numRings);
+  const auto phi = vm::Cf::two_pi() * float(segment % numSegments) / float(numSegments);
+  const auto position = vm::vec3f{
+    64.0f * std::sin(theta) * std::cos(phi),
+    64.0f * std::sin(theta) * std::sin(phi),
+    64.0f * std::cos(theta)};
+  const auto texCoords =
+    vm::vec2f{float(segment) / float(numSegments), float(ring) / float(numRings)};
+  return EntityModelVertex{position, texCoords};
+}
+
+/**
+ * A sphere made of one polygon per face, like the OBJ and ASE parsers emit.
+ */
+SampleModel makePolygonSphere(const size_t numRings, const size_t numSegments)
+{
+  auto size = Renderer::IndexRangeMap::Size{};
+  size.inc(Renderer::PrimType::Polygon, numRings * numSegments);
+
+  auto builder = Renderer::IndexRangeMapBuilder<EntityModelVertex::Type>{
+    numRings * numSegments * 4, size};
+  for (size_t ring = 0; ring < numRings; ++ring)
+  {
+    for (size_t segment = 0; segment < numSegments; ++segment)
+    {
+      builder.addPolygon({
+        sphereVertex(ring, numRings, segment, numSegments),
+        sphereVertex(ring + 1, numRings, segment, numSegments),
+        sphereVertex(ring + 1, numRings, segment + 1, numSegments),
+        sphereVertex(ring, numRings, segment + 1, numSegments),
+      });
+    }
+  }
+
+  return {
+    "polygon sphere " + std::to_string(numRings) + "x" + std::to_string(numSegments),
+    std::move(builder.vertices()),
+    std::move(builder.indices())};
+}
+
+/**
+ * A sphere made of a triangle soup, like the MD2 and MD3 parsers emit.
+ */
+SampleModel makeTriangleSphere(const size_t numRings, const size_t numSegments)
+{
+  auto triangles = std::vector<EntityModelVertex>{};
+  for (size_t ring = 0; ring < numRings; ++ring)
+  {
+    for (size_t segment = 0; segment < numSegments; ++segment)
+    {
+      triangles.push_back(sphereVertex(ring, numRings, segment, numSegments));
+      triangles.push_back(sphereVertex(ring + 1, numRings, segment, numSegments));
+      triangles.push_back(sphereVertex(ring + 1, numRings, segment + 1, numSegments));
+
+      triangles.push_back(sphereVertex(ring, numRings, segment, numSegments));
+      triangles.push_back(sphereVertex(ring + 1, numRings, segment + 1, numSegments));
+      triangles.push_back(sphereVertex(ring, numRings, segment + 1, numSegments));
+    }
+  }
+
+  auto size = Renderer::IndexRangeMap::Size{};
+  size.inc(Renderer::PrimType::Triangles, triangles.size());
+
+  auto builder =
+    Renderer::IndexRangeMapBuilder<EntityModelVertex::Type>{triangles.size(), size};
+  builder.addTriangles(triangles);
+
+  return {
+    "triangle sphere " + std::to_string(numRings) + "x" + std::to_string(numSegments),
+    std::move(builder.vertices()),
+    std::move(builder.indices())};
+}
+} // namespace
+
+TEST_CASE("EntityModelMeshOptimizerBenchmark.optimizeSampleModels")
+{
+  auto models = std::vector<SampleModel>{};
+  models.push_back(makePolygonSphere(16, 32));
+  models.push_back(makePolygonSphere(128, 256));
+  models.push_back(makeTriangleSphere(16, 32));
+  models.push_back(makeTriangleSphere(128, 256));
+
+  for (const auto& model : models)
+  {
+    const auto original = triangulateMesh(model.vertices, model.indices);
+    auto optimized = EntityModelTriangleMesh{};
+    timeLambda(
+      [&]() { optimized = optimizeMesh(original); }, "optimize " + model.name);
+
+    const auto indexSize =
+      optimized.vertices.size() <= size_t(std::numeric_limits<std::uint16_t>::max()) + 1u
+        ? sizeof(std::uint16_t)
+        : sizeof(std::uint32_t);
+
+    // the original vertices are rendered without an index buffer
+    const auto originalBytes = model.vertices.size() * sizeof(EntityModelVertex);
+    const auto optimizedBytes = optimized.vertices.size() * sizeof(EntityModelVertex)
+                                + optimized.indices.size() * indexSize;
+
+    printf(
+      "%s: %zu -> %zu vertices, %zu -> %zu bytes (%.1f%% saved), ACMR %.3f -> %.3f\n",
+      model.name.c_str(),
+      model.vertices.size(),
+      optimized.vertices.size(),
+      originalBytes,
+      optimizedBytes,
+      100.0 * (1.0 - double(optimizedBytes) / double(originalBytes)),
+      double(computeACMR(original.indices)),
+      double(computeACMR(optimized.indices)));
+
+    CHECK(optimized.indices.size() <= original.indices.size());
+    CHECK(optimized.vertices.size() < model.vertices.size());
+    CHECK(computeACMR(optimized.indices) < computeACMR(original.indices));
+  }
+}
+} // namespace Assets
+} // namespace TrenchBroom
@@ -0,0 +1,212 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vecmath/bbox.h>
+#include <vecmath/intersection.h>
+#include <vecmath/plane.h>
+#include <vecmath/ray.h>
+#include <vecmath/scalar.h>
+#include <vecmath/vec.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+
+namespace TrenchBroom
+{
+namespace
+{
+constexpr size_t NumBatchItems = 1'000;
+constexpr size_t NumBatchRepetitions = 10'000;
+
+vm::vec3d randomVector(std::mt19937& rng, const double min, const double max)
+{
+  auto coord = std::uniform_real_distribution<double>{min, max};
+  return vm::vec3d{coord(rng), coord(rng), coord(rng)};
+}
+
+std::vector<vm::ray3d> makeRays(std::mt19937& rng)
+{
+  auto result = std::vector<vm::ray3d>{};
+  for (size_t i = 0; i < NumBatchItems; ++i)
+  {
+    result.emplace_back(
+      randomVector(rng, -1024.0, 1024.0), vm::normalize(randomVector(rng, -1.0, 1.0)));
+  }
+  return result;
+}
+
+std::vector<vm::bbox3d> makeBoxes(std::mt19937& rng)
+{
+  auto result = std::vector<vm::bbox3d>{};
+  for (size_t i = 0; i < NumBatchItems; ++i)
+  {
+    const auto min = randomVector(rng, -1024.0, 1024.0);
+    result.emplace_back(min, min + randomVector(rng, 8.0, 256.0));
+  }
+  return result;
+}
+
+std::vector<vm::plane3d> makePlanes(std::mt19937& rng)
+{
+  auto result = std::vector<vm::plane3d>{};
+  for (size_t i = 0; i < NumBatchItems; ++i)
+  {
+    result.emplace_back(
+      randomVector(rng, -1024.0, 1024.0), vm::normalize(randomVector(rng, -1.0, 1.0)));
+  }
+  return result;
+}
+
+size_t countHits(const std::vector<double>& distances)
+{
+  auto result = size_t(0);
+  for (const auto distance : distances)
+  {
+    result += vm::is_nan(distance) ? 0u : 1u;
+  }
+  return result;
+}
+
+std::string describe(const std::string& what)
+{
+  return what + " " + std::to_string(NumBatchRepetitions) + " times";
+}
+} // namespace
+
+TEST_CASE("IntersectionBenchmark.intersectRayBboxes")
+{
+  auto rng = std::mt19937{42};
+  const auto ray = makeRays(rng).front();
+  const auto boxes = makeBoxes(rng);
+
+  auto batch = vm::bbox_batch<double, 3>{};
+  for (const auto& box : boxes)
+  {
+    batch.push_back(box);
+  }
+
+  auto scalarDistances = std::vector<double>(boxes.size());
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumBatchRepetitions; ++i)
+      {
+        for (size_t j = 0; j < boxes.size(); ++j)
+        {
+          scalarDistances[j] = vm::intersect_ray_bbox(ray, boxes[j]);
+        }
+      }
+    },
+    describe("intersect one ray with " + std::to_string(boxes.size()) + " boxes"));
+
+  auto batchDistances = std::vector<double>(boxes.size());
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumBatchRepetitions; ++i)
+      {
+        vm::intersect_ray_bboxes(ray, batch, batchDistances.data());
+      }
+    },
+    describe(
+      "intersect one ray with " + std::to_string(boxes.size()) + " boxes in a batch"));
+
+  CHECK(countHits(batchDistances) == countHits(scalarDistances));
+}
+
+TEST_CASE("IntersectionBenchmark.intersectRaysBbox")
+{
+  auto rng = std::mt19937{42};
+  const auto rays = makeRays(rng);
+  const auto box = vm::bbox3d{-256.0, 256.0};
+
+  auto batch = vm::ray_batch<double, 3>{};
+  for (const auto& ray : rays)
+  {
+    batch.push_back(ray);
+  }
+
+  auto scalarDistances = std::vector<double>(rays.size());
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumBatchRepetitions; ++i)
+      {
+        for (size_t j = 0; j < rays.size(); ++j)
+        {
+          scalarDistances[j] = vm::intersect_ray_bbox(rays[j], box);
+        }
+      }
+    },
+    describe("intersect " + std::to_string(rays.size()) + " rays with one box"));
+
+  auto batchDistances = std::vector<double>(rays.size());
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumBatchRepetitions; ++i)
+      {
+        vm::intersect_rays_bbox(batch, box, batchDistances.data());
+      }
+    },
+    describe(
+      "intersect " + std::to_string(rays.size()) + " rays with one box in a batch"));
+
+  CHECK(countHits(batchDistances) == countHits(scalarDistances));
+}
+
+TEST_CASE("IntersectionBenchmark.intersectRayPlanes")
+{
+  auto rng = std::mt19937{42};
+  const auto ray = makeRays(rng).front();
+  const auto planes = makePlanes(rng);
+
+  auto batch = vm::plane_batch<double, 3>{};
+  for (const auto& plane : planes)
+  {
+    batch.push_back(plane);
+  }
+
+  auto scalarDistances = std::vector<double>(planes.size());
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumBatchRepetitions; ++i)
+      {
+        for (size_t j = 0; j < planes.size(); ++j)
+        {
+          scalarDistances[j] = vm::intersect_ray_plane(ray, planes[j]);
+        }
+      }
+    },
+    describe("intersect one ray with " + std::to_string(planes.size()) + " planes"));
+
+  auto batchDistances = std::vector<double>(planes.size());
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumBatchRepetitions; ++i)
+      {
+        vm::intersect_ray_planes(ray, batch, batchDistances.data());
+      }
+    },
+    describe(
+      "intersect one ray with " + std::to_string(planes.size()) + " planes in a batch"));
+
+  CHECK(countHits(batchDistances) == countHits(scalarDistances));
+}
+} // namespace TrenchBroom
@@ -0,0 +1,214 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Model/ApplyToNodeContents.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushError.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceHandle.h"
+#include "Model/BrushNode.h"
+#include "Model/ChangeBrushFaceAttributesRequest.h"
+#include "Model/MapFormat.h"
+#include "Model/NodeContents.h"
+
+#include <kdl/overload.h>
+#include <kdl/result.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/constants.h>
+#include <vecmath/vec.h>
+
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+
+namespace TrenchBroom
+{
+namespace Model
+{
+static constexpr size_t NumBrushes = 20'000;
+static constexpr size_t NumPrismSides = 12;
+static constexpr size_t GridWidth = 100;
+static constexpr FloatType GridSpacing = 80.0;
+
+namespace
+{
+/**
+ * Creates a grid of prisms. Their side vertices do not lie on integer coordinates, so
+ * snapping them to the integer grid changes every brush.
+ */
+std::vector<std::unique_ptr<BrushNode>> makeBrushNodes(const vm::bbox3& worldBounds)
+{
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  auto result = std::vector<std::unique_ptr<BrushNode>>{};
+  result.reserve(NumBrushes);
+
+  for (size_t i = 0; i < NumBrushes; ++i)
+  {
+    const auto center = vm::vec3{
+      GridSpacing * FloatType(i % GridWidth),
+      GridSpacing * FloatType(i / GridWidth),
+      0.0};
+
+    auto points = std::vector<vm::vec3>{};
+    for (size_t j = 0; j < NumPrismSides; ++j)
+    {
+      const auto angle = vm::C::two_pi() * FloatType(j) / FloatType(NumPrismSides);
+      const auto offset = vm::vec3{32.0 * std::cos(angle), 32.0 * std::sin(angle), 0.0};
+      points.push_back(center + offset + vm::vec3{0, 0, -32});
+      points.push_back(center + offset + vm::vec3{0, 0, +32});
+    }
+
+    result.push_back(
+      std::make_unique<BrushNode>(builder.createBrush(points, "texture").value()));
+  }
+
+  return result;
+}
+
+template <typename L>
+auto snapVertices(
+  const std::vector<BrushNode*>& brushNodes,
+  const vm::bbox3& worldBounds,
+  std::atomic<size_t>& succeededBrushCount,
+  L wrap)
+{
+  return applyToNodeContents(
+    brushNodes,
+    wrap(kdl::overload(
+      [](Layer&) { return true; },
+      [](Group&) { return true; },
+      [](Entity&) { return true; },
+      [&](Brush& brush) {
+        if (brush.canSnapVertices(worldBounds, 1.0))
+        {
+          brush.snapVertices(worldBounds, 1.0, false)
+            .transform([&]() { succeededBrushCount += 1; })
+            .or_else([](const BrushError) {
+              // brushes that fail to snap are missing from succeededBrushCount
+            });
+        }
+        return true;
+      },
+      [](BezierPatch&) { return true; })));
+}
+
+/**
+ * Baseline for setting face attributes: copies every brush and applies the lambda to all
+ * faces of the copy, as was necessary before the face texturing could be swapped alone.
+ */
+template <typename L>
+std::vector<std::pair<Node*, NodeContents>> copyBrushesAndApplyToFaces(
+  const std::vector<std::unique_ptr<BrushNode>>& brushNodes, const L& lambda)
+{
+  auto newNodes = std::vector<std::pair<Node*, NodeContents>>{};
+  newNodes.reserve(brushNodes.size());
+
+  for (const auto& brushNode : brushNodes)
+  {
+    auto brush = brushNode->brush();
+    for (auto& face : brush.faces())
+    {
+      lambda(face);
+    }
+    newNodes.emplace_back(brushNode.get(), NodeContents{std::move(brush)});
+  }
+
+  return newNodes;
+}
+} // namespace
+
+TEST_CASE("ApplyToNodeContentsBenchmark.snapVertices")
+{
+  const auto worldBounds = vm::bbox3{32768.0};
+  const auto brushNodes = makeBrushNodes(worldBounds);
+  const auto brushNodePtrs = kdl::vec_transform(
+    brushNodes, [](const auto& brushNode) { return brushNode.get(); });
+
+  auto serialCount = std::atomic<size_t>{0};
+  timeLambda(
+    [&]() {
+      const auto newNodes = snapVertices(
+        brushNodePtrs, worldBounds, serialCount, [](auto lambda) { return lambda; });
+      CHECK(newNodes);
+    },
+    "snap vertices of " + std::to_string(NumBrushes) + " brushes");
+
+  auto parallelCount = std::atomic<size_t>{0};
+  timeLambda(
+    [&]() {
+      const auto newNodes =
+        snapVertices(brushNodePtrs, worldBounds, parallelCount, [](auto lambda) {
+          return threadSafe(std::move(lambda));
+        });
+      CHECK(newNodes);
+    },
+    "snap vertices of " + std::to_string(NumBrushes) + " brushes in parallel");
+
+  CHECK(serialCount == NumBrushes);
+  CHECK(parallelCount == NumBrushes);
+}
+
+TEST_CASE("ApplyToNodeContentsBenchmark.setFaceAttributes")
+{
+  const auto worldBounds = vm::bbox3{32768.0};
+  const auto brushNodes = makeBrushNodes(worldBounds);
+
+  auto faces = std::vector<BrushFaceHandle>{};
+  for (const auto& brushNode : brushNodes)
+  {
+    faces = kdl::vec_concat(std::move(faces), toHandles(brushNode.get()));
+  }
+
+  auto request = ChangeBrushFaceAttributesRequest{};
+  request.setTextureName("other_texture");
+  request.addRotation(15.0f);
+  request.mulScale(vm::vec2f{2.0f, 2.0f});
+
+  const auto evaluate = [&](BrushFace& face) {
+    request.evaluate(face);
+    return true;
+  };
+
+  timeLambda(
+    [&]() {
+      const auto newNodes = copyBrushesAndApplyToFaces(brushNodes, evaluate);
+      CHECK(newNodes.size() == NumBrushes);
+    },
+    "set attributes of " + std::to_string(faces.size()) + " faces by copying brushes");
+
+  timeLambda(
+    [&]() { CHECK(applyToBrushFaces(faces, evaluate)); },
+    "set attributes of " + std::to_string(faces.size()) + " faces");
+
+  timeLambda(
+    [&]() { CHECK(applyToBrushFaces(faces, threadSafe(evaluate))); },
+    "set attributes of " + std::to_string(faces.size()) + " faces in parallel");
+}
+} // namespace Model
+} // namespace TrenchBroom
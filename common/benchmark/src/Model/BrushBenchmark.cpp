@@ -0,0 +1,518 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IO/DiskIO.h"
+#include "IO/IOUtils.h"
+#include "IO/NodeReader.h"
+#include "IO/Path.h"
+#include "IO/TestParserStatus.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushError.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushGeometry.h"
+#include "Model/BrushNode.h"
+#include "Model/Group.h"
+#include "Model/GroupNode.h"
+#include "Model/MapFormat.h"
+#include "Model/Node.h"
+#include "Model/Polyhedron.h"
+#include "Model/UpdateLinkedGroupsError.h"
+
+#include <kdl/parallel.h>
+#include <kdl/result.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/constants.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+
+namespace TrenchBroom
+{
+namespace Model
+{
+static constexpr size_t NumBrushes = 100'000;
+static constexpr size_t NumPrismSides = 8;
+static constexpr size_t GridWidth = 100;
+static constexpr FloatType GridSpacing = 80.0;
+static constexpr size_t NumSubtractionTiles = 3;
+static constexpr FloatType SubtrahendSize = 16.0;
+static constexpr FloatType SubtrahendSpacing = 48.0;
+static constexpr size_t NumPrefabBrushes = 64;
+static constexpr size_t NumLinkedGroups = 500;
+static constexpr size_t NumLargePrefabBrushes = 2'000;
+static constexpr size_t NumLargePrefabInstances = 50;
+static constexpr size_t NumDraggedBrushes = 1'000;
+static constexpr size_t NumDraggedPrismSides = 32;
+static constexpr size_t NumDragSteps = 20;
+
+/**
+ * Returns the vertices of a prism with a regular polygon as its base.
+ */
+static std::vector<vm::vec3> makePrismPoints(
+  const vm::vec3& center, const size_t numSides)
+{
+  auto result = std::vector<vm::vec3>{};
+  for (size_t i = 0; i < numSides; ++i)
+  {
+    const auto angle = vm::C::two_pi() * FloatType(i) / FloatType(numSides);
+    const auto offset = vm::vec3{32.0 * std::cos(angle), 32.0 * std::sin(angle), 0.0};
+    result.push_back(center + offset + vm::vec3{0, 0, -32});
+    result.push_back(center + offset + vm::vec3{0, 0, +32});
+  }
+  return result;
+}
+
+/**
+ * Creates a grid of brushes, alternating between cuboids and prisms.
+ */
+static std::vector<Brush> makeBrushes(const BrushBuilder& builder, const size_t count)
+{
+  auto result = std::vector<Brush>{};
+  result.reserve(count);
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    const auto center = vm::vec3{
+      GridSpacing * FloatType(i % GridWidth),
+      GridSpacing * FloatType((i / GridWidth) % GridWidth),
+      GridSpacing * FloatType(i / (GridWidth * GridWidth))};
+
+    if (i % 2 == 0)
+    {
+      const auto bounds =
+        vm::bbox3{center - vm::vec3{32, 32, 32}, center + vm::vec3{32, 32, 32}};
+      result.push_back(builder.createCuboid(bounds, "texture").value());
+    }
+    else
+    {
+      result.push_back(
+        builder.createBrush(makePrismPoints(center, NumPrismSides), "texture").value());
+    }
+  }
+
+  return result;
+}
+
+TEST_CASE("BrushBenchmark.createCopyDestroy")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  auto brushes = std::vector<Brush>{};
+  timeLambda(
+    [&]() { brushes = makeBrushes(builder, NumBrushes); },
+    "create " + std::to_string(NumBrushes) + " brushes");
+  REQUIRE(brushes.size() == NumBrushes);
+
+  auto copies = std::vector<Brush>{};
+  timeLambda(
+    [&]() { copies = brushes; }, "copy " + std::to_string(NumBrushes) + " brushes");
+  REQUIRE(copies.size() == NumBrushes);
+
+  auto faces = std::vector<std::vector<BrushFace>>{};
+  faces.reserve(brushes.size());
+  for (const auto& brush : brushes)
+  {
+    faces.push_back(brush.faces());
+  }
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < faces.size(); ++i)
+      {
+        brushes[i] = Brush::create(worldBounds, std::move(faces[i])).value();
+      }
+    },
+    "recreate " + std::to_string(NumBrushes) + " brushes from their faces");
+
+  timeLambda(
+    [&]() { copies.clear(); }, "destroy " + std::to_string(NumBrushes) + " copies");
+  timeLambda(
+    [&]() { brushes.clear(); }, "destroy " + std::to_string(NumBrushes) + " brushes");
+
+  // the second round reuses the elements released by the first one
+  timeLambda(
+    [&]() { brushes = makeBrushes(builder, NumBrushes); },
+    "create " + std::to_string(NumBrushes) + " brushes again");
+  timeLambda(
+    [&]() { brushes.clear(); }, "destroy " + std::to_string(NumBrushes) + " brushes");
+}
+
+TEST_CASE("BrushBenchmark.loadMap")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  auto str = std::stringstream{};
+  str.precision(std::numeric_limits<FloatType>::max_digits10);
+  for (const auto& brush : makeBrushes(builder, NumBrushes))
+  {
+    str << "{\n";
+    for (const auto& face : brush.faces())
+    {
+      for (const auto& point : face.points())
+      {
+        str << "( " << point.x() << " " << point.y() << " " << point.z() << " ) ";
+      }
+      str << "texture 0 0 0 1 1\n";
+    }
+    str << "}\n";
+  }
+  const auto data = str.str();
+
+  auto status = IO::TestParserStatus{};
+  auto nodes = std::vector<Node*>{};
+  timeLambda(
+    [&]() {
+      nodes =
+        IO::NodeReader::read(data, MapFormat::Standard, worldBounds, {}, {}, status);
+    },
+    "load " + std::to_string(NumBrushes) + " brushes");
+  CHECK(nodes.size() == NumBrushes);
+
+  kdl::vec_clear_and_delete(nodes);
+}
+
+TEST_CASE("BrushBenchmark.subtract")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  const auto path = IO::Disk::getCurrentWorkingDir()
+                    + IO::Path{"fixture/test/Model/Brush/subtrahend.map"};
+  auto stream = IO::openPathAsInputStream(path);
+  auto str = std::stringstream{};
+  str << stream.rdbuf();
+
+  auto status = IO::TestParserStatus{};
+  auto nodes =
+    IO::NodeReader::read(str.str(), MapFormat::Standard, worldBounds, {}, {}, status);
+  REQUIRE(!nodes.empty());
+
+  auto tile = std::vector<Brush>{};
+  auto tileBounds = static_cast<BrushNode*>(nodes.front())->brush().bounds();
+  for (const auto* node : nodes)
+  {
+    const auto& brush = static_cast<const BrushNode*>(node)->brush();
+    tile.push_back(brush);
+    tileBounds = vm::merge(tileBounds, brush.bounds());
+  }
+  kdl::vec_clear_and_delete(nodes);
+
+  // Scale the fixture up by placing copies of it next to each other, and carve a grid of
+  // small cubes out of the copies.
+  auto minuends = std::vector<Brush>{};
+  auto subtrahends = std::vector<Brush>{};
+  const auto tileSize = tileBounds.size();
+  for (size_t x = 0; x < NumSubtractionTiles; ++x)
+  {
+    for (size_t y = 0; y < NumSubtractionTiles; ++y)
+    {
+      const auto offset =
+        vm::vec3{FloatType(x) * tileSize.x(), FloatType(y) * tileSize.y(), 0.0};
+      for (const auto& brush : tile)
+      {
+        auto minuend = brush;
+        REQUIRE(minuend.transform(worldBounds, vm::translation_matrix(offset), false)
+                  .is_success());
+        minuends.push_back(std::move(minuend));
+      }
+    }
+  }
+
+  const auto bounds = vm::bbox3{
+    tileBounds.min,
+    tileBounds.min
+      + vm::vec3{
+        FloatType(NumSubtractionTiles) * tileSize.x(),
+        FloatType(NumSubtractionTiles) * tileSize.y(),
+        tileSize.z()}};
+  for (auto min = bounds.min; min.x() < bounds.max.x(); min[0] += SubtrahendSpacing)
+  {
+    for (min[1] = bounds.min.y(); min.y() < bounds.max.y(); min[1] += SubtrahendSpacing)
+    {
+      for (min[2] = bounds.min.z(); min.z() < bounds.max.z(); min[2] += SubtrahendSpacing)
+      {
+        const auto cube = vm::bbox3{min, min + vm::vec3::fill(SubtrahendSize)};
+        subtrahends.push_back(builder.createCuboid(cube, "texture").value());
+      }
+    }
+  }
+
+  const auto subtrahendPtrs =
+    kdl::vec_transform(subtrahends, [](const auto& brush) { return &brush; });
+  const auto subtract = [&](const Brush& minuend) {
+    return minuend.subtract(MapFormat::Standard, worldBounds, "texture", subtrahendPtrs);
+  };
+
+  const auto description = std::to_string(subtrahends.size()) + " brushes from "
+                           + std::to_string(minuends.size()) + " brushes";
+
+  auto serialResults = std::vector<std::vector<kdl::result<Brush, BrushError>>>{};
+  timeLambda(
+    [&]() { serialResults = kdl::vec_transform(minuends, subtract); },
+    "subtract " + description);
+
+  auto parallelResults = std::vector<std::vector<kdl::result<Brush, BrushError>>>{};
+  timeLambda(
+    [&]() { parallelResults = kdl::vec_parallel_transform(minuends, subtract); },
+    "subtract " + description + " in parallel");
+
+  REQUIRE(parallelResults.size() == serialResults.size());
+  for (size_t i = 0; i < serialResults.size(); ++i)
+  {
+    CHECK(parallelResults[i].size() == serialResults[i].size());
+  }
+}
+TEST_CASE("BrushBenchmark.duplicateLinkedGroups")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  auto sourceGroupNode = GroupNode{Group{"prefab"}};
+  for (auto& brush : makeBrushes(builder, NumPrefabBrushes))
+  {
+    sourceGroupNode.addChild(new BrushNode{std::move(brush)});
+  }
+
+  const auto description = std::to_string(NumLinkedGroups) + " groups with "
+                           + std::to_string(NumPrefabBrushes) + " brushes";
+
+  auto duplicates = std::vector<Node*>{};
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumLinkedGroups; ++i)
+      {
+        duplicates.push_back(sourceGroupNode.cloneRecursively(worldBounds));
+      }
+    },
+    "duplicate " + description);
+
+  // the duplicates share the geometry of the prefab brushes
+  auto sharedCount = size_t(0);
+  for (const auto* duplicate : duplicates)
+  {
+    for (size_t i = 0; i < NumPrefabBrushes; ++i)
+    {
+      const auto* brushNode = static_cast<const BrushNode*>(duplicate->children()[i]);
+      const auto* sourceBrushNode =
+        static_cast<const BrushNode*>(sourceGroupNode.children()[i]);
+      sharedCount +=
+        brushNode->brush().sharesGeometryWith(sourceBrushNode->brush()) ? 1u : 0u;
+    }
+  }
+  CHECK(sharedCount == NumLinkedGroups * NumPrefabBrushes);
+
+  // the linked groups are translated, which copies the geometry
+  auto targetGroupNodes = std::vector<GroupNode*>{};
+  for (size_t i = 0; i < duplicates.size(); ++i)
+  {
+    auto* groupNode = static_cast<GroupNode*>(duplicates[i]);
+    auto group = groupNode->group();
+    group.setTransformation(
+      vm::translation_matrix(vm::vec3{0.0, 0.0, 8.0 * FloatType(i + 1)}));
+    groupNode->setGroup(std::move(group));
+    targetGroupNodes.push_back(groupNode);
+  }
+
+  auto updateResult =
+    std::optional<kdl::result<UpdateLinkedGroupsResult, UpdateLinkedGroupsError>>{};
+  timeLambda(
+    [&]() {
+      updateResult = updateLinkedGroups(sourceGroupNode, targetGroupNodes, worldBounds);
+    },
+    "update " + description);
+  CHECK(updateResult->is_success());
+
+  kdl::vec_clear_and_delete(duplicates);
+}
+
+TEST_CASE("BrushBenchmark.updateLinkedGroupsIncrementally")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  auto sourceGroupNode = GroupNode{Group{"prefab"}};
+  for (auto& brush : makeBrushes(builder, NumLargePrefabBrushes))
+  {
+    sourceGroupNode.addChild(new BrushNode{std::move(brush)});
+  }
+
+  auto instances = std::vector<std::unique_ptr<GroupNode>>{};
+  auto targetGroupNodes = std::vector<GroupNode*>{};
+  for (size_t i = 0; i < NumLargePrefabInstances; ++i)
+  {
+    auto groupNode = std::unique_ptr<GroupNode>{
+      static_cast<GroupNode*>(sourceGroupNode.cloneRecursively(worldBounds))};
+    auto group = groupNode->group();
+    group.setTransformation(
+      vm::translation_matrix(vm::vec3{0.0, 0.0, 8.0 * FloatType(i + 1)}));
+    groupNode->setGroup(std::move(group));
+    targetGroupNodes.push_back(groupNode.get());
+    instances.push_back(std::move(groupNode));
+  }
+
+  // bring the instances in sync with their transformations
+  REQUIRE(updateLinkedGroups(sourceGroupNode, targetGroupNodes, worldBounds)
+            .transform([](UpdateLinkedGroupsResult&& childrenToReplace) {
+              for (auto& [groupNode, newChildren] : childrenToReplace)
+              {
+                groupNode->replaceChildren(std::move(newChildren));
+              }
+            })
+            .is_success());
+
+  // edit one brush of the prefab
+  auto* brushNode = static_cast<BrushNode*>(sourceGroupNode.children().front());
+  auto brush = brushNode->brush();
+  REQUIRE(brush
+            .transform(
+              worldBounds, vm::translation_matrix(vm::vec3{0.0, 0.0, 16.0}), true)
+            .is_success());
+  brushNode->setBrush(std::move(brush));
+
+  const auto description = "one brush in " + std::to_string(NumLargePrefabInstances)
+                           + " groups with " + std::to_string(NumLargePrefabBrushes)
+                           + " brushes";
+
+  auto updateResult =
+    std::optional<kdl::result<UpdateLinkedGroupsResult, UpdateLinkedGroupsError>>{};
+  timeLambda(
+    [&]() {
+      updateResult = updateLinkedGroups(sourceGroupNode, targetGroupNodes, worldBounds);
+    },
+    "update " + description);
+  CHECK(updateResult->is_success());
+
+  auto incrementalUpdateResult = std::optional<
+    kdl::result<IncrementalUpdateLinkedGroupsResult, UpdateLinkedGroupsError>>{};
+  timeLambda(
+    [&]() {
+      incrementalUpdateResult = updateLinkedGroupsIncrementally(
+        sourceGroupNode, {brushNode}, targetGroupNodes, worldBounds);
+    },
+    "incrementally update " + description);
+  incrementalUpdateResult
+    ->transform([](const IncrementalUpdateLinkedGroupsResult& r) {
+      CHECK(r.childrenToReplace.empty());
+      CHECK(r.contentsToSwap.size() == NumLargePrefabInstances);
+    })
+    .or_else([](const auto&) { FAIL(); });
+}
+
+TEST_CASE("BrushBenchmark.moveVertices")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  auto brushes = std::vector<Brush>{};
+  auto vertexPositions = std::vector<vm::vec3>{};
+  for (size_t i = 0; i < NumDraggedBrushes; ++i)
+  {
+    const auto center = vm::vec3{
+      GridSpacing * FloatType(i % GridWidth),
+      GridSpacing * FloatType(i / GridWidth),
+      0.0};
+    brushes.push_back(
+      builder.createBrush(makePrismPoints(center, NumDraggedPrismSides), "texture")
+        .value());
+    vertexPositions.push_back(center + vm::vec3{32.0, 0.0, 32.0});
+  }
+
+  // drag one vertex of every brush upwards like the vertex tool does, checking every step
+  // before applying it
+  const auto delta = vm::vec3{0.0, 0.0, 1.0};
+  auto movedCount = size_t(0);
+  timeLambda(
+    [&]() {
+      for (size_t step = 0; step < NumDragSteps; ++step)
+      {
+        for (size_t i = 0; i < brushes.size(); ++i)
+        {
+          auto& brush = brushes[i];
+          auto& vertexPosition = vertexPositions[i];
+          if (
+            brush.canMoveVertices(worldBounds, {vertexPosition}, delta)
+            && brush.moveVertices(worldBounds, {vertexPosition}, delta, false)
+                 .is_success())
+          {
+            vertexPosition = vertexPosition + delta;
+            ++movedCount;
+          }
+        }
+      }
+    },
+    "drag a vertex of " + std::to_string(NumDraggedBrushes) + " brushes with "
+      + std::to_string(2 * NumDraggedPrismSides) + " vertices over "
+      + std::to_string(NumDragSteps) + " steps");
+
+  CHECK(movedCount == NumDraggedBrushes * NumDragSteps);
+}
+
+TEST_CASE("BrushBenchmark.buildConvexHulls")
+{
+  // the points of the prisms in BrushBenchmark.moveVertices at every drag step
+  auto pointSets = std::vector<std::vector<vm::vec3>>{};
+  pointSets.reserve(NumDraggedBrushes * NumDragSteps);
+  for (size_t i = 0; i < NumDraggedBrushes; ++i)
+  {
+    const auto center = vm::vec3{
+      GridSpacing * FloatType(i % GridWidth),
+      GridSpacing * FloatType(i / GridWidth),
+      0.0};
+    for (size_t step = 0; step < NumDragSteps; ++step)
+    {
+      auto points = makePrismPoints(center, NumDraggedPrismSides);
+      // the second point is the dragged vertex
+      points[1] = points[1] + vm::vec3{0.0, 0.0, FloatType(step + 1)};
+      pointSets.push_back(std::move(points));
+    }
+  }
+
+  auto vertexCount = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& points : pointSets)
+      {
+        const auto geometry = BrushGeometry{points};
+        vertexCount += geometry.vertexCount();
+      }
+    },
+    "build " + std::to_string(pointSets.size()) + " convex hulls of "
+      + std::to_string(2 * NumDraggedPrismSides) + " points");
+
+  CHECK(vertexCount == pointSets.size() * 2 * NumDraggedPrismSides);
+}
+} // namespace Model
+} // namespace TrenchBroom
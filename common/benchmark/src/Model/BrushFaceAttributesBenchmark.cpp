@@ -0,0 +1,169 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Color.h"
+#include "Model/BrushFaceAttributes.h"
+
+#include <kdl/interned_string.h>
+
+#include <vecmath/mat.h>
+#include <vecmath/vec.h>
+
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+
+namespace TrenchBroom
+{
+namespace Model
+{
+static constexpr size_t NumFaces = 1'200'000;
+static constexpr size_t NumTextureNames = 300;
+
+namespace
+{
+/**
+ * The layout of the brush face attributes before the texture names were interned and
+ * the rarely used attributes were moved out of line.
+ */
+struct InlineBrushFaceAttributes
+{
+  std::string textureName;
+  vm::vec2f offset;
+  vm::vec2f scale;
+  float rotation;
+  std::optional<int> surfaceContents;
+  std::optional<int> surfaceFlags;
+  std::optional<float> surfaceValue;
+  std::optional<Color> color;
+  bool bpMode;
+  vm::mat4x4f bpMatrix;
+
+  explicit InlineBrushFaceAttributes(std::string i_textureName)
+    : textureName{std::move(i_textureName)}
+    , offset{vm::vec2f::zero()}
+    , scale{vm::vec2f{1.0f, 1.0f}}
+    , rotation{0.0f}
+    , bpMode{false}
+    , bpMatrix{vm::mat4x4f::identity()}
+  {
+  }
+};
+
+std::vector<std::string> makeTextureNames()
+{
+  auto result = std::vector<std::string>{};
+  for (size_t i = 0; i < NumTextureNames; ++i)
+  {
+    result.push_back("textures/base_wall/metal_panel_" + std::to_string(i));
+  }
+  return result;
+}
+
+size_t heapSize(const std::string& str)
+{
+  const auto* data = str.data();
+  const auto* begin = reinterpret_cast<const char*>(&str);
+  const auto* end = begin + sizeof(std::string);
+  // short strings are stored inside the string object
+  return data >= begin && data < end ? 0 : str.capacity() + 1;
+}
+
+void printMemory(const std::string& message, const size_t bytes)
+{
+  printf(
+    "Memory used by '%s': %.1fMB\n",
+    message.c_str(),
+    static_cast<double>(bytes) / (1024.0 * 1024.0));
+}
+} // namespace
+
+TEST_CASE("BrushFaceAttributesBenchmark.memory")
+{
+  const auto textureNames = makeTextureNames();
+
+  auto inlineAttributes = std::vector<InlineBrushFaceAttributes>{};
+  inlineAttributes.reserve(NumFaces);
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumFaces; ++i)
+      {
+        inlineAttributes.emplace_back(textureNames[i % NumTextureNames]);
+      }
+    },
+    "create " + std::to_string(NumFaces) + " inline face attributes");
+
+  auto attributes = std::vector<BrushFaceAttributes>{};
+  attributes.reserve(NumFaces);
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumFaces; ++i)
+      {
+        attributes.emplace_back(textureNames[i % NumTextureNames]);
+      }
+    },
+    "create " + std::to_string(NumFaces) + " face attributes");
+
+  auto inlineBytes = NumFaces * sizeof(InlineBrushFaceAttributes);
+  for (const auto& faceAttributes : inlineAttributes)
+  {
+    inlineBytes += heapSize(faceAttributes.textureName);
+  }
+
+  // the string table is shared by all faces, count its strings once
+  auto bytes = NumFaces * sizeof(BrushFaceAttributes);
+  for (const auto& textureName : textureNames)
+  {
+    bytes += sizeof(std::string) + heapSize(textureName);
+  }
+
+  printMemory(std::to_string(NumFaces) + " inline face attributes", inlineBytes);
+  printMemory(std::to_string(NumFaces) + " face attributes", bytes);
+  CHECK(sizeof(BrushFaceAttributes) < sizeof(InlineBrushFaceAttributes));
+
+  const auto& textureName = textureNames.front();
+  auto inlineCount = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& faceAttributes : inlineAttributes)
+      {
+        inlineCount += faceAttributes.textureName == textureName ? 1u : 0u;
+      }
+    },
+    "compare " + std::to_string(NumFaces) + " texture names");
+
+  const auto internedTextureName = kdl::interned_string{textureName};
+  auto count = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& faceAttributes : attributes)
+      {
+        count += faceAttributes.internedTextureName() == internedTextureName ? 1u : 0u;
+      }
+    },
+    "compare " + std::to_string(NumFaces) + " interned texture names");
+
+  CHECK(count == inlineCount);
+}
+} // namespace Model
+} // namespace TrenchBroom
@@ -0,0 +1,170 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/EntityDefinition.h"
+#include "Assets/EntityModel.h"
+#include "Assets/ModelDefinition.h"
+#include "Color.h"
+#include "Model/EditorContext.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/PickResult.h"
+#include "Model/WorldNode.h"
+#include "Renderer/IndexRangeMap.h"
+#include "Renderer/IndexRangeMapBuilder.h"
+#include "Renderer/PrimType.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/constants.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+
+namespace TrenchBroom
+{
+namespace Model
+{
+static constexpr size_t NumModels = 20;
+static constexpr size_t NumInstances = 5'000;
+static constexpr size_t NumRays = 10'000;
+static constexpr size_t GridWidth = 100;
+static constexpr FloatType GridSpacing = 192.0;
+
+/**
+ * Creates a model with a single frame containing a UV sphere with the given radius and
+ * resolution.
+ */
+static std::unique_ptr<Assets::EntityModel> makeSphereModel(
+  const std::string& name, const float radius, const size_t numRings)
+{
+  const auto numSegments = 2 * numRings;
+
+  auto model = std::make_unique<Assets::EntityModel>(
+    name, Assets::PitchType::Normal, Assets::Orientation::Oriented);
+  model->addFrame();
+  auto& surface = model->addSurface(name);
+
+  const auto vertexAt = [&](const size_t ring, const size_t segment) {
+    const auto theta = vm::Cf::pi() * float(ring) / float(numRings);
+    const auto phi = vm::Cf::two_pi() * float(segment) / float(numSegments);
+    const auto position = vm::vec3f{
+      radius * std::sin(theta) * std::cos(phi),
+      radius * std::sin(theta) * std::sin(phi),
+      radius * std::cos(theta)};
+    return Assets::EntityModelVertex{position, vm::vec2f::zero()};
+  };
+
+  auto triangles = std::vector<Assets::EntityModelVertex>{};
+  triangles.reserve(numRings * numSegments * 6);
+  for (size_t ring = 0; ring < numRings; ++ring)
+  {
+    for (size_t segment = 0; segment < numSegments; ++segment)
+    {
+      triangles.push_back(vertexAt(ring, segment));
+      triangles.push_back(vertexAt(ring + 1, segment));
+      triangles.push_back(vertexAt(ring + 1, segment + 1));
+
+      triangles.push_back(vertexAt(ring, segment));
+      triangles.push_back(vertexAt(ring + 1, segment + 1));
+      triangles.push_back(vertexAt(ring, segment + 1));
+    }
+  }
+
+  auto size = Renderer::IndexRangeMap::Size{};
+  size.inc(Renderer::PrimType::Triangles, triangles.size());
+
+  auto builder = Renderer::IndexRangeMapBuilder<Assets::EntityModelVertex::Type>{
+    triangles.size(), size};
+  builder.addTriangles(triangles);
+
+  auto& frame = model->loadFrame(0, "frame", vm::bbox3f{radius});
+  surface.addIndexedMesh(
+    frame, std::move(builder.vertices()), std::move(builder.indices()));
+
+  return model;
+}
+
+TEST_CASE("EntityPickingBenchmark.pickInstancedModels")
+{
+  auto models = std::vector<std::unique_ptr<Assets::EntityModel>>{};
+  for (size_t i = 0; i < NumModels; ++i)
+  {
+    models.push_back(makeSphereModel(
+      "model" + std::to_string(i), 32.0f + 2.0f * float(i), 16 + 4 * i));
+  }
+
+  // use small definition bounds so that most picks have to test the model
+  auto definition = Assets::PointEntityDefinition{
+    "some_name", Color{}, vm::bbox3{4.0}, "", {}, Assets::ModelDefinition{}};
+
+  auto world = WorldNode{{}, {}, MapFormat::Standard};
+  for (size_t i = 0; i < NumInstances; ++i)
+  {
+    const auto x = FloatType(i % GridWidth) * GridSpacing;
+    const auto y = FloatType(i / GridWidth) * GridSpacing;
+    auto* entityNode = new EntityNode{Entity{
+      {},
+      {{"classname", "some_name"},
+       {"origin", std::to_string(x) + " " + std::to_string(y) + " 0"},
+       {"angle", std::to_string((i * 37) % 360)}}}};
+    entityNode->setDefinition(&definition);
+    entityNode->setModelFrame(models[i % NumModels]->frame(0));
+    world.defaultLayer()->addChild(entityNode);
+  }
+
+  // shoot rays at the grid from above, slightly tilted
+  auto rays = std::vector<vm::ray3>{};
+  rays.reserve(NumRays);
+  for (size_t i = 0; i < NumRays; ++i)
+  {
+    const auto x = FloatType((i * 7919) % (GridWidth * 64)) * GridSpacing / 64.0;
+    const auto y = FloatType((i * 104729) % (NumInstances / GridWidth * 64))
+                   * GridSpacing / 64.0;
+    rays.emplace_back(
+      vm::vec3{x, y, 1024.0}, vm::normalize(vm::vec3{0.1, 0.05, -1.0}));
+  }
+
+  const auto editorContext = EditorContext{};
+  auto hits = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& ray : rays)
+      {
+        auto pickResult = PickResult::byDistance();
+        world.pick(editorContext, ray, pickResult);
+        hits += pickResult.size();
+      }
+    },
+    "pick " + std::to_string(rays.size()) + " rays against "
+      + std::to_string(NumInstances) + " instances of " + std::to_string(NumModels)
+      + " models");
+
+  CHECK(hits > 0u);
+}
+} // namespace Model
+} // namespace TrenchBroom
@@ -0,0 +1,149 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FloatType.h"
+#include "Model/BezierPatch.h"
+#include "Model/EditorContext.h"
+#include "Model/PatchNode.h"
+#include "Model/PickResult.h"
+
+#include <vecmath/intersection.h>
+#include <vecmath/ray.h>
+#include <vecmath/scalar.h>
+#include <vecmath/vec.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+
+namespace TrenchBroom
+{
+namespace Model
+{
+static constexpr size_t NumControlPoints = 33;
+static constexpr size_t NumPicksX = 64;
+static constexpr size_t NumPicksY = 64;
+static constexpr FloatType PatchSize = 1024.0;
+
+TEST_CASE("PatchPickingBenchmark.pick")
+{
+  // a large, wavy patch with 16x16 surfaces, similar to terrain in Doom 3 maps
+  auto controlPoints = std::vector<BezierPatch::Point>{};
+  for (size_t row = 0; row < NumControlPoints; ++row)
+  {
+    for (size_t col = 0; col < NumControlPoints; ++col)
+    {
+      const auto x = PatchSize * FloatType(col) / FloatType(NumControlPoints - 1);
+      const auto y = PatchSize * FloatType(row) / FloatType(NumControlPoints - 1);
+      const auto z = 64.0 * std::sin(x / 64.0) * std::cos(y / 96.0);
+      controlPoints.push_back(BezierPatch::Point{x, y, z, 0.0, 0.0});
+    }
+  }
+
+  auto patchNode = PatchNode{
+    BezierPatch{NumControlPoints, NumControlPoints, std::move(controlPoints), "texture"}};
+  const auto& grid = patchNode.grid();
+
+  // rays looking down at the patch at an angle
+  auto pickRays = std::vector<vm::ray3>{};
+  for (size_t x = 0; x < NumPicksX; ++x)
+  {
+    for (size_t y = 0; y < NumPicksY; ++y)
+    {
+      const auto target = vm::vec3{
+        PatchSize * (FloatType(x) + 0.5) / FloatType(NumPicksX),
+        PatchSize * (FloatType(y) + 0.5) / FloatType(NumPicksY),
+        0.0};
+      const auto origin = vm::vec3{-256.0, -256.0, 512.0};
+      pickRays.emplace_back(origin, vm::normalize(target - origin));
+    }
+  }
+
+  const auto triangleCount = 2u * grid.quadRowCount() * grid.quadColumnCount();
+  const auto name = std::to_string(pickRays.size()) + " rays against a patch with "
+                    + std::to_string(triangleCount) + " triangles";
+
+  auto bruteForceDistances = std::vector<FloatType>{};
+  timeLambda(
+    [&]() {
+      for (const auto& pickRay : pickRays)
+      {
+        auto closest = vm::nan<FloatType>();
+        for (size_t row = 0u; row < grid.quadRowCount(); ++row)
+        {
+          for (size_t col = 0u; col < grid.quadColumnCount(); ++col)
+          {
+            const auto& v0 = grid.point(row, col).position;
+            const auto& v1 = grid.point(row, col + 1u).position;
+            const auto& v2 = grid.point(row + 1u, col + 1u).position;
+            const auto& v3 = grid.point(row + 1u, col).position;
+            for (const auto distance :
+                 {vm::intersect_ray_triangle(pickRay, v0, v1, v2),
+                  vm::intersect_ray_triangle(pickRay, v2, v3, v0)})
+            {
+              if (!vm::is_nan(distance) && !(distance >= closest))
+              {
+                closest = distance;
+              }
+            }
+          }
+        }
+        bruteForceDistances.push_back(closest);
+      }
+    },
+    "pick " + name + " by testing all triangles");
+
+  const auto editorContext = EditorContext{};
+  timeLambda(
+    [&]() {
+      auto pickResult = PickResult{};
+      patchNode.pick(editorContext, pickRays.front(), pickResult);
+    },
+    "build the picking BVH for a patch with " + std::to_string(triangleCount)
+      + " triangles");
+
+  auto distances = std::vector<FloatType>{};
+  timeLambda(
+    [&]() {
+      for (const auto& pickRay : pickRays)
+      {
+        auto pickResult = PickResult{};
+        patchNode.pick(editorContext, pickRay, pickResult);
+        distances.push_back(
+          pickResult.empty() ? vm::nan<FloatType>()
+                             : pickResult.all().front().distance());
+      }
+    },
+    "pick " + name);
+
+  REQUIRE(distances.size() == bruteForceDistances.size());
+  for (size_t i = 0; i < distances.size(); ++i)
+  {
+    CHECK(vm::is_nan(distances[i]) == vm::is_nan(bruteForceDistances[i]));
+    if (!vm::is_nan(distances[i]))
+    {
+      CHECK(distances[i] == Approx(bruteForceDistances[i]));
+    }
+  }
+}
+} // namespace Model
+} // namespace TrenchBroom
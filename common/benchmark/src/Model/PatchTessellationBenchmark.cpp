@@ -0,0 +1,328 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FloatType.h"
+#include "Model/BezierPatch.h"
+#include "Model/PatchNode.h"
+
+#include <kdl/parallel.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bezier_surface.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/scalar.h>
+#include <vecmath/vec.h>
+
+#include <array>
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+
+namespace TrenchBroom
+{
+namespace Model
+{
+static constexpr size_t NumPatches = 2'000;
+static constexpr size_t NumControlPoints = 9;
+static constexpr size_t SubdivisionsPerSurface = 3;
+static constexpr size_t GridWidth = 50;
+static constexpr FloatType PatchSize = 256.0;
+
+namespace
+{
+/**
+ * Creates a grid of wavy patches with 4*4 surfaces each.
+ */
+std::vector<BezierPatch> makePatches()
+{
+  auto result = std::vector<BezierPatch>{};
+  result.reserve(NumPatches);
+
+  for (size_t i = 0; i < NumPatches; ++i)
+  {
+    const auto originX = PatchSize * FloatType(i % GridWidth);
+    const auto originY = PatchSize * FloatType(i / GridWidth);
+
+    auto controlPoints = std::vector<BezierPatch::Point>{};
+    for (size_t row = 0; row < NumControlPoints; ++row)
+    {
+      for (size_t col = 0; col < NumControlPoints; ++col)
+      {
+        const auto s = FloatType(col) / FloatType(NumControlPoints - 1);
+        const auto t = FloatType(row) / FloatType(NumControlPoints - 1);
+        const auto x = originX + PatchSize * s;
+        const auto y = originY + PatchSize * t;
+        const auto z = 32.0 * std::sin(x / 48.0) * std::cos(y / 80.0);
+        controlPoints.push_back(BezierPatch::Point{x, y, z, s, t});
+      }
+    }
+
+    result.emplace_back(
+      NumControlPoints, NumControlPoints, std::move(controlPoints), "texture");
+  }
+
+  return result;
+}
+
+/**
+ * Baseline for evaluating a patch: evaluates every grid point of every surface
+ * individually, as was done before the Bernstein polynomials were tabulated.
+ */
+std::vector<BezierPatch::Point> evaluatePointByPoint(const BezierPatch& patch)
+{
+  const auto quadsPerSurfaceSide = size_t(1) << SubdivisionsPerSurface;
+  const auto gridRowCount = patch.surfaceRowCount() * quadsPerSurfaceSide + 1u;
+  const auto gridColumnCount = patch.surfaceColumnCount() * quadsPerSurfaceSide + 1u;
+
+  auto result = std::vector<BezierPatch::Point>{};
+  result.reserve(gridRowCount * gridColumnCount);
+
+  for (size_t gridRow = 0; gridRow < gridRowCount; ++gridRow)
+  {
+    const auto surfaceRow = (gridRow > 0u ? gridRow - 1u : 0u) / quadsPerSurfaceSide;
+    const auto v = FloatType(gridRow - surfaceRow * quadsPerSurfaceSide)
+                   / FloatType(quadsPerSurfaceSide);
+    for (size_t gridCol = 0; gridCol < gridColumnCount; ++gridCol)
+    {
+      const auto surfaceCol = (gridCol > 0u ? gridCol - 1u : 0u) / quadsPerSurfaceSide;
+      const auto u = FloatType(gridCol - surfaceCol * quadsPerSurfaceSide)
+                     / FloatType(quadsPerSurfaceSide);
+
+      auto surfaceControlPoints = std::array<std::array<BezierPatch::Point, 3>, 3>{};
+      for (size_t row = 0; row < 3; ++row)
+      {
+        for (size_t col = 0; col < 3; ++col)
+        {
+          surfaceControlPoints[row][col] =
+            patch.controlPoint(2u * surfaceRow + row, 2u * surfaceCol + col);
+        }
+      }
+      result.push_back(vm::evaluate_quadratic_bezier_surface(surfaceControlPoints, u, v));
+    }
+  }
+
+  return result;
+}
+} // namespace
+
+TEST_CASE("PatchTessellationBenchmark.evaluate")
+{
+  const auto patches = makePatches();
+  const auto name = std::to_string(NumPatches) + " patches with "
+                    + std::to_string(patches.front().surfaceRowCount()
+                                     * patches.front().surfaceColumnCount())
+                    + " surfaces";
+
+  auto expectedGrids = std::vector<std::vector<BezierPatch::Point>>{};
+  timeLambda(
+    [&]() {
+      for (const auto& patch : patches)
+      {
+        expectedGrids.push_back(evaluatePointByPoint(patch));
+      }
+    },
+    "evaluate " + name + " point by point");
+
+  auto grids = std::vector<std::vector<BezierPatch::Point>>{};
+  timeLambda(
+    [&]() {
+      for (const auto& patch : patches)
+      {
+        grids.push_back(patch.evaluate(SubdivisionsPerSurface));
+      }
+    },
+    "evaluate " + name);
+
+  CHECK(grids == expectedGrids);
+}
+
+TEST_CASE("PatchTessellationBenchmark.createPatchNodes")
+{
+  const auto patches = makePatches();
+  const auto name = std::to_string(NumPatches) + " patch nodes";
+
+  timeLambda(
+    [&]() {
+      auto patchNodes = std::vector<std::unique_ptr<PatchNode>>{};
+      for (const auto& patch : patches)
+      {
+        patchNodes.push_back(std::make_unique<PatchNode>(patch));
+      }
+      CHECK(patchNodes.size() == NumPatches);
+    },
+    "create " + name);
+
+  timeLambda(
+    [&]() {
+      // the map reader creates nodes like this
+      const auto patchNodes =
+        kdl::vec_parallel_transform(patches, [](BezierPatch&& patch) {
+          return std::make_unique<PatchNode>(std::move(patch));
+        });
+      CHECK(patchNodes.size() == NumPatches);
+    },
+    "create " + name + " in parallel");
+}
+
+TEST_CASE("PatchTessellationBenchmark.transformPatchNodes")
+{
+  const auto patchNodes = kdl::vec_transform(makePatches(), [](BezierPatch&& patch) {
+    return std::make_unique<PatchNode>(std::move(patch));
+  });
+  const auto patchNodePtrs = kdl::vec_transform(
+    patchNodes, [](const auto& patchNode) { return patchNode.get(); });
+
+  const auto transformation =
+    vm::translation_matrix(vm::vec3{16.0, 32.0, 8.0})
+    * vm::rotation_matrix(vm::vec3::pos_z(), vm::to_radians(15.0));
+  const auto name = std::to_string(NumPatches) + " patch nodes";
+
+  timeLambda(
+    [&]() {
+      // creates new patches, so their grids are evaluated again
+      auto newPatches =
+        kdl::vec_parallel_transform(patchNodePtrs, [&](const PatchNode* patchNode) {
+          const auto& patch = patchNode->patch();
+          auto newPatch = BezierPatch{
+            patch.pointRowCount(),
+            patch.pointColumnCount(),
+            patch.controlPoints(),
+            patch.textureName()};
+          newPatch.transform(transformation);
+          return newPatch;
+        });
+
+      for (size_t i = 0; i < patchNodePtrs.size(); ++i)
+      {
+        patchNodePtrs[i]->setPatch(std::move(newPatches[i]));
+      }
+    },
+    "transform " + name + " and evaluate them again");
+
+  auto previousPatches = std::vector<BezierPatch>{};
+  timeLambda(
+    [&]() {
+      // this is what MapDocument::transformObjects does
+      auto newPatches =
+        kdl::vec_parallel_transform(patchNodePtrs, [&](const PatchNode* patchNode) {
+          auto newPatch = patchNode->patch();
+          newPatch.transform(transformation);
+          return newPatch;
+        });
+
+      for (size_t i = 0; i < patchNodePtrs.size(); ++i)
+      {
+        previousPatches.push_back(patchNodePtrs[i]->setPatch(std::move(newPatches[i])));
+      }
+    },
+    "transform " + name + " and their grids");
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < patchNodePtrs.size(); ++i)
+      {
+        patchNodePtrs[i]->setPatch(std::move(previousPatches[i]));
+      }
+    },
+    "undo transforming " + name + " and their grids");
+
+  for (const auto* patchNode : patchNodePtrs)
+  {
+    const auto& patch = patchNode->patch();
+    const auto expectedGrid = makePatchGrid(
+      BezierPatch{
+        patch.pointRowCount(),
+        patch.pointColumnCount(),
+        patch.controlPoints(),
+        patch.textureName()},
+      SubdivisionsPerSurface);
+
+    const auto& points = patchNode->grid().points;
+    REQUIRE(points.size() == expectedGrid.points.size());
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      CHECK(vm::is_equal(points[i].position, expectedGrid.points[i].position, 0.001));
+    }
+  }
+}
+
+TEST_CASE("PatchTessellationBenchmark.scalePatchNodes")
+{
+  const auto patchNodes = kdl::vec_transform(makePatches(), [](BezierPatch&& patch) {
+    return std::make_unique<PatchNode>(std::move(patch));
+  });
+  const auto patchNodePtrs = kdl::vec_transform(
+    patchNodes, [](const auto& patchNode) { return patchNode.get(); });
+
+  const auto transformation = vm::scaling_matrix(vm::vec3{2.0, 2.0, 1.0});
+  const auto name = std::to_string(NumPatches) + " patch nodes";
+
+  const auto scalePatches = [&]() {
+    return kdl::vec_parallel_transform(patchNodePtrs, [&](const PatchNode* patchNode) {
+      auto newPatch = patchNode->patch();
+      newPatch.transform(transformation);
+      return newPatch;
+    });
+  };
+
+  auto newPatches = scalePatches();
+  auto previousPatches = std::vector<BezierPatch>{};
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < patchNodePtrs.size(); ++i)
+      {
+        previousPatches.push_back(patchNodePtrs[i]->setPatch(std::move(newPatches[i])));
+      }
+    },
+    "scale " + name + " and tessellate them one by one");
+
+  for (size_t i = 0; i < patchNodePtrs.size(); ++i)
+  {
+    patchNodePtrs[i]->setPatch(std::move(previousPatches[i]));
+  }
+
+  newPatches = scalePatches();
+  timeLambda(
+    [&]() {
+      // this is what MapDocumentCommandFacade::performSwapNodeContents does
+      auto grids = std::vector<std::optional<PatchGrid>>(patchNodePtrs.size());
+      kdl::parallel_for(patchNodePtrs.size(), [&](const size_t i) {
+        grids[i] = patchNodePtrs[i]->makeGrid(newPatches[i]);
+      });
+
+      for (size_t i = 0; i < patchNodePtrs.size(); ++i)
+      {
+        patchNodePtrs[i]->setPatch(std::move(newPatches[i]), std::move(*grids[i]));
+      }
+    },
+    "scale " + name + " and tessellate them in parallel");
+
+  for (const auto* patchNode : patchNodePtrs)
+  {
+    CHECK(patchNode->grid() == makePatchGrid(patchNode->patch(), SubdivisionsPerSurface));
+  }
+}
+} // namespace Model
+} // namespace TrenchBroom
@@ -0,0 +1,211 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/EditorContext.h"
+#include "Model/Entity.h"
+#include "Model/EntityProperties.h"
+#include "Model/Hit.h"
+#include "Model/HitAdapter.h"
+#include "Model/HitFilter.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/PickResult.h"
+#include "Model/WorldNode.h"
+
+#ifdef TB_USE_AABB_NODE_TREE
+#include "aabb_tree.h"
+#else
+#include "octree.h"
+#endif
+
+#include <kdl/result.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+
+namespace TrenchBroom
+{
+namespace Model
+{
+static constexpr size_t NumPickingBrushesX = 100;
+static constexpr size_t NumPickingBrushesY = 100;
+static constexpr size_t NumPickingBrushesZ = 20;
+static constexpr size_t NumPickingRays = 1'000;
+static constexpr FloatType BrushSize = 32.0;
+static constexpr FloatType BrushSpacing = 48.0;
+static constexpr size_t HoverScreenWidth = 64;
+static constexpr size_t HoverScreenHeight = 36;
+
+static std::unique_ptr<WorldNode> makeBrushGrid()
+{
+  const auto worldBounds = vm::bbox3{32768.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  // a dense grid of brushes, similar to a detailed map
+  auto brushNodes = std::vector<Node*>{};
+  brushNodes.reserve(NumPickingBrushesX * NumPickingBrushesY * NumPickingBrushesZ);
+  for (size_t x = 0; x < NumPickingBrushesX; ++x)
+  {
+    for (size_t y = 0; y < NumPickingBrushesY; ++y)
+    {
+      for (size_t z = 0; z < NumPickingBrushesZ; ++z)
+      {
+        const auto min =
+          vm::vec3{FloatType(x), FloatType(y), FloatType(z)} * BrushSpacing;
+        const auto bounds = vm::bbox3{min, min + vm::vec3::fill(BrushSize)};
+        brushNodes.push_back(
+          new BrushNode{builder.createCuboid(bounds, "texture").value()});
+      }
+    }
+  }
+
+  auto world = std::make_unique<WorldNode>(
+    EntityPropertyConfig{}, Entity{}, MapFormat::Standard);
+  world->defaultLayer()->addChildren(std::move(brushNodes));
+  return world;
+}
+
+TEST_CASE("WorldPickingBenchmark.pickClosest")
+{
+  const auto world = makeBrushGrid();
+
+  // shoot rays into the grid from its side, slightly tilted, so that most rays hit
+  // several brushes
+  auto rays = std::vector<vm::ray3>{};
+  rays.reserve(NumPickingRays);
+  for (size_t i = 0; i < NumPickingRays; ++i)
+  {
+    const auto y =
+      FloatType((i * 7919) % (NumPickingBrushesY * 64)) * BrushSpacing / 64.0;
+    const auto z =
+      FloatType((i * 104729) % (NumPickingBrushesZ * 64)) * BrushSpacing / 64.0;
+    rays.emplace_back(
+      vm::vec3{-1024.0, y, z}, vm::normalize(vm::vec3{1.0, 0.05, 0.01}));
+  }
+
+  const auto editorContext = EditorContext{};
+  const auto hitFilter = HitFilters::type(BrushNode::BrushHitType);
+
+  auto allHits = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& ray : rays)
+      {
+        auto pickResult = PickResult::byDistance();
+        for (auto* node : world->nodeTree().find_intersectors(ray))
+        {
+          node->pick(editorContext, ray, pickResult);
+        }
+        allHits += pickResult.first(hitFilter).isMatch() ? 1 : 0;
+      }
+    },
+    "pick " + std::to_string(rays.size()) + " rays against every intersector");
+
+  auto orderedHits = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& ray : rays)
+      {
+        auto pickResult = PickResult::byDistance();
+        world->pick(editorContext, ray, pickResult);
+        orderedHits += pickResult.first(hitFilter).isMatch() ? 1 : 0;
+      }
+    },
+    "pick " + std::to_string(rays.size()) + " rays");
+
+  auto firstHits = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& ray : rays)
+      {
+        auto pickResult = PickResult::closest(hitFilter);
+        world->pick(editorContext, ray, pickResult);
+        firstHits += pickResult.first(hitFilter).isMatch() ? 1 : 0;
+      }
+    },
+    "pick closest hit of " + std::to_string(rays.size()) + " rays");
+
+  CHECK(allHits > 0u);
+  CHECK(orderedHits == allHits);
+  CHECK(firstHits == allHits);
+}
+
+TEST_CASE("WorldPickingBenchmark.hover")
+{
+  const auto world = makeBrushGrid();
+
+  // move the mouse over the whole screen of a camera that looks at the grid from its side
+  const auto cameraPosition = vm::vec3{
+    -512.0,
+    FloatType(NumPickingBrushesY) * BrushSpacing / 2.0,
+    FloatType(NumPickingBrushesZ) * BrushSpacing / 2.0};
+  auto rays = std::vector<vm::ray3>{};
+  rays.reserve(HoverScreenWidth * HoverScreenHeight);
+  for (size_t x = 0; x < HoverScreenWidth; ++x)
+  {
+    for (size_t y = 0; y < HoverScreenHeight; ++y)
+    {
+      const auto right = FloatType(x) / FloatType(HoverScreenWidth) - 0.5;
+      const auto up = (FloatType(y) / FloatType(HoverScreenHeight) - 0.5) * 9.0 / 16.0;
+      rays.emplace_back(cameraPosition, vm::normalize(vm::vec3{1.0, right, up}));
+    }
+  }
+
+  const auto editorContext = EditorContext{};
+  const auto hitFilter = HitFilters::type(BrushNode::BrushHitType);
+
+  auto allHitNodes = std::vector<Node*>{};
+  timeLambda(
+    [&]() {
+      for (const auto& ray : rays)
+      {
+        // this is how MapView3D picks when the mouse moves
+        auto pickResult = PickResult::byDistance();
+        world->pick(editorContext, ray, pickResult);
+        allHitNodes.push_back(hitToNode(pickResult.first(hitFilter)));
+      }
+    },
+    "hover over " + std::to_string(rays.size()) + " points keeping all hits");
+
+  auto closestHitNodes = std::vector<Node*>{};
+  timeLambda(
+    [&]() {
+      for (const auto& ray : rays)
+      {
+        auto pickResult = PickResult::closest(hitFilter);
+        world->pick(editorContext, ray, pickResult);
+        closestHitNodes.push_back(hitToNode(pickResult.first(hitFilter)));
+      }
+    },
+    "hover over " + std::to_string(rays.size()) + " points keeping the closest hit");
+
+  CHECK(closestHitNodes == allHitNodes);
+}
+} // namespace Model
+} // namespace TrenchBroom
@@ -0,0 +1,157 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+#include "Renderer/PerspectiveCamera.h"
+#include "Renderer/VisibleNodeCache.h"
+
+#include <kdl/result.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/intersection.h>
+#include <vecmath/plane.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+static constexpr size_t NumBrushesX = 100;
+static constexpr size_t NumBrushesY = 100;
+static constexpr size_t NumBrushesZ = 20;
+static constexpr size_t NumFrames = 100;
+static constexpr FloatType BrushSize = 32.0;
+static constexpr FloatType BrushSpacing = 48.0;
+
+TEST_CASE("VisibleNodeCacheBenchmark.visibleNodes")
+{
+  const auto worldBounds = vm::bbox3{32768.0};
+  const auto builder = Model::BrushBuilder{Model::MapFormat::Standard, worldBounds};
+
+  // a dense grid of brushes, similar to a detailed map
+  auto brushNodes = std::vector<Model::Node*>{};
+  brushNodes.reserve(NumBrushesX * NumBrushesY * NumBrushesZ);
+  for (size_t x = 0; x < NumBrushesX; ++x)
+  {
+    for (size_t y = 0; y < NumBrushesY; ++y)
+    {
+      for (size_t z = 0; z < NumBrushesZ; ++z)
+      {
+        const auto min =
+          vm::vec3{FloatType(x), FloatType(y), FloatType(z)} * BrushSpacing;
+        const auto bounds = vm::bbox3{min, min + vm::vec3::fill(BrushSize)};
+        brushNodes.push_back(
+          new Model::BrushNode{builder.createCuboid(bounds, "texture").value()});
+      }
+    }
+  }
+
+  auto world = Model::WorldNode{{}, {}, Model::MapFormat::Standard};
+  world.defaultLayer()->addChildren(brushNodes);
+
+  struct CameraPose
+  {
+    vm::vec3f position;
+    vm::vec3f direction;
+    vm::vec3f up;
+  };
+
+  // inside the grid looking along it, at its corner looking across it, and above it
+  // looking down
+  const auto cameraPoses = std::vector<CameraPose>{
+    {{2400, 2400, 480}, {1, 0, 0}, {0, 0, 1}},
+    {{-256, -256, 480}, vm::normalize(vm::vec3f{1, 1, 0}), {0, 0, 1}},
+    {{2400, 2400, 2048}, {0, 0, -1}, {1, 0, 0}},
+  };
+
+  auto camera = PerspectiveCamera{
+    90.0f,
+    1.0f,
+    8192.0f,
+    Camera::Viewport{0, 0, 1920, 1080},
+    vm::vec3f{0, 0, 0},
+    vm::vec3f{1, 0, 0},
+    vm::vec3f{0, 0, 1}};
+
+  for (size_t i = 0; i < cameraPoses.size(); ++i)
+  {
+    const auto& pose = cameraPoses[i];
+    camera.moveTo(pose.position);
+    camera.setDirection(pose.direction, pose.up);
+
+    const auto frustumPlanes = visibilityPlanes(camera);
+    const auto name = "camera " + std::to_string(i) + ": ";
+
+    auto numBruteForceNodes = size_t(0);
+    timeLambda(
+      [&]() {
+        for (size_t frame = 0; frame < NumFrames; ++frame)
+        {
+          numBruteForceNodes = size_t(std::count_if(
+            brushNodes.begin(), brushNodes.end(), [&](const auto* node) {
+              return std::none_of(
+                frustumPlanes.begin(), frustumPlanes.end(), [&](const auto& plane) {
+                  return vm::plane_bbox_status(plane, node->physicalBounds())
+                         == vm::plane_status::above;
+                });
+            }));
+        }
+      },
+      name + "test " + std::to_string(brushNodes.size()) + " nodes in "
+        + std::to_string(NumFrames) + " frames");
+
+    auto numQueriedNodes = size_t(0);
+    timeLambda(
+      [&]() {
+        for (size_t frame = 0; frame < NumFrames; ++frame)
+        {
+          numQueriedNodes = world.findNodesInFrustum(frustumPlanes).size();
+        }
+      },
+      name + "query node tree in " + std::to_string(NumFrames) + " frames");
+
+    auto cache = VisibleNodeCache{};
+    auto numCachedNodes = size_t(0);
+    timeLambda(
+      [&]() {
+        for (size_t frame = 0; frame < NumFrames; ++frame)
+        {
+          numCachedNodes = cache.visibleNodes(camera, world).size();
+        }
+      },
+      name + "get cached nodes in " + std::to_string(NumFrames) + " frames");
+
+    CHECK(numBruteForceNodes > 0u);
+    CHECK(numQueriedNodes == numBruteForceNodes);
+    CHECK(numCachedNodes == numBruteForceNodes);
+  }
+}
+} // namespace Renderer
+} // namespace TrenchBroom
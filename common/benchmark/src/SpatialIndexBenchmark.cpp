@@ -0,0 +1,172 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "aabb_tree.h"
+#include "octree.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+
+namespace TrenchBroom
+{
+namespace
+{
+constexpr size_t NumIndexedBoxes = 200'000;
+constexpr size_t NumIndexQueries = 10'000;
+
+struct Workload
+{
+  std::vector<vm::bbox3d> bounds;
+  std::vector<vm::bbox3d> movedBounds;
+  std::vector<vm::ray3d> rays;
+  std::vector<vm::vec3d> points;
+};
+
+/**
+ * Creates boxes of typical brush sizes scattered over a map of typical size, and rays and
+ * points to query them with.
+ */
+Workload makeWorkload()
+{
+  auto rng = std::mt19937{42};
+  auto coord = std::uniform_real_distribution<double>{-8192.0, 8192.0};
+  auto extent = std::uniform_real_distribution<double>{8.0, 256.0};
+  auto offset = std::uniform_real_distribution<double>{-16.0, 16.0};
+
+  auto workload = Workload{};
+  for (size_t i = 0; i < NumIndexedBoxes; ++i)
+  {
+    const auto min = vm::vec3d{coord(rng), coord(rng), coord(rng) / 8.0};
+    const auto bounds =
+      vm::bbox3d{min, min + vm::vec3d{extent(rng), extent(rng), extent(rng)}};
+    workload.bounds.push_back(bounds);
+    workload.movedBounds.push_back(
+      bounds.translate(vm::vec3d{offset(rng), offset(rng), offset(rng)}));
+  }
+
+  for (size_t i = 0; i < NumIndexQueries; ++i)
+  {
+    const auto origin = vm::vec3d{coord(rng), coord(rng), coord(rng) / 8.0};
+    const auto target = vm::vec3d{coord(rng), coord(rng), coord(rng) / 8.0};
+    workload.rays.emplace_back(origin, vm::normalize(target - origin));
+    workload.points.push_back(origin);
+  }
+
+  return workload;
+}
+
+template <typename Tree>
+void benchmarkTree(Tree tree, const Workload& workload, const std::string& name)
+{
+  auto items = std::vector<std::pair<vm::bbox3d, size_t>>{};
+  for (size_t i = 0; i < workload.bounds.size(); ++i)
+  {
+    items.emplace_back(workload.bounds[i], i);
+  }
+
+  timeLambda(
+    [&]() { tree.build(items); },
+    name + ": build from " + std::to_string(workload.bounds.size()) + " boxes");
+
+  auto numBuiltIntersectors = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& ray : workload.rays)
+      {
+        numBuiltIntersectors += tree.find_intersectors(ray).size();
+      }
+    },
+    name + ": find intersectors of " + std::to_string(workload.rays.size())
+      + " rays after build");
+
+  tree.clear();
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < workload.bounds.size(); ++i)
+      {
+        tree.insert(workload.bounds[i], i);
+      }
+    },
+    name + ": insert " + std::to_string(workload.bounds.size()) + " boxes");
+
+  auto numIntersectors = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& ray : workload.rays)
+      {
+        numIntersectors += tree.find_intersectors(ray).size();
+      }
+    },
+    name + ": find intersectors of " + std::to_string(workload.rays.size()) + " rays");
+
+  auto numContainers = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& point : workload.points)
+      {
+        numContainers += tree.find_containers(point).size();
+      }
+    },
+    name + ": find containers of " + std::to_string(workload.points.size()) + " points");
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < workload.movedBounds.size(); ++i)
+      {
+        tree.update(workload.movedBounds[i], i);
+      }
+    },
+    name + ": update " + std::to_string(workload.bounds.size()) + " boxes");
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < workload.bounds.size(); ++i)
+      {
+        tree.remove(i);
+      }
+    },
+    name + ": remove " + std::to_string(workload.bounds.size()) + " boxes");
+
+  CHECK(numIntersectors > 0u);
+  CHECK(numBuiltIntersectors == numIntersectors);
+  CHECK(tree.empty());
+}
+} // namespace
+
+TEST_CASE("SpatialIndexBenchmark.octree")
+{
+  const auto workload = makeWorkload();
+  benchmarkTree(octree<double, size_t>{256.0}, workload, "octree");
+}
+
+TEST_CASE("SpatialIndexBenchmark.aabb_tree")
+{
+  const auto workload = makeWorkload();
+  benchmarkTree(aabb_tree<double, size_t>{}, workload, "aabb_tree");
+}
+} // namespace TrenchBroom
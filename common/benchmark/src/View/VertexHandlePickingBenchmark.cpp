@@ -0,0 +1,221 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FloatType.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/MapFormat.h"
+#include "Model/PickResult.h"
+#include "PreferenceManager.h"
+#include "Preferences.h"
+#include "Renderer/PerspectiveCamera.h"
+#include "View/Grid.h"
+#include "View/Lasso.h"
+#include "View/VertexHandleManager.h"
+
+#include <kdl/result.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/scalar.h>
+#include <vecmath/vec.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+
+namespace TrenchBroom
+{
+namespace View
+{
+static constexpr size_t NumBrushesX = 20;
+static constexpr size_t NumBrushesY = 20;
+static constexpr size_t NumBrushSides = 16;
+static constexpr size_t NumPicksX = 32;
+static constexpr size_t NumPicksY = 24;
+static constexpr size_t NumLassos = 100;
+static constexpr FloatType BrushRadius = 48.0;
+static constexpr FloatType BrushSpacing = 128.0;
+
+TEST_CASE("VertexHandlePickingBenchmark.pickAndLasso")
+{
+  const auto worldBounds = vm::bbox3{32768.0};
+  const auto builder = Model::BrushBuilder{Model::MapFormat::Standard, worldBounds};
+
+  // a grid of cylinders, similar to a large selection of complex brushes in the vertex
+  // tool
+  auto brushNodes = std::vector<std::unique_ptr<Model::BrushNode>>{};
+  for (size_t x = 0; x < NumBrushesX; ++x)
+  {
+    for (size_t y = 0; y < NumBrushesY; ++y)
+    {
+      const auto center = vm::vec3{FloatType(x), FloatType(y), 0.0} * BrushSpacing;
+      auto points = std::vector<vm::vec3>{};
+      for (size_t i = 0; i < NumBrushSides; ++i)
+      {
+        const auto angle = vm::C::two_pi() * FloatType(i) / FloatType(NumBrushSides);
+        const auto offset =
+          vm::vec3{std::cos(angle) * BrushRadius, std::sin(angle) * BrushRadius, 0.0};
+        points.push_back(center + offset);
+        points.push_back(center + offset + vm::vec3{0, 0, 2.0 * BrushRadius});
+      }
+      brushNodes.push_back(std::make_unique<Model::BrushNode>(
+        builder.createBrush(points, "texture").value()));
+    }
+  }
+
+  auto vertexHandles = VertexHandleManager{};
+  auto edgeHandles = EdgeHandleManager{};
+  auto faceHandles = FaceHandleManager{};
+  for (const auto& brushNode : brushNodes)
+  {
+    vertexHandles.addHandles(brushNode.get());
+    edgeHandles.addHandles(brushNode.get());
+    faceHandles.addHandles(brushNode.get());
+  }
+
+  const auto camera = Renderer::PerspectiveCamera{
+    90.0f,
+    1.0f,
+    8192.0f,
+    Renderer::Camera::Viewport{0, 0, 1920, 1080},
+    vm::vec3f{-256, -256, 512},
+    vm::normalize(vm::vec3f{1, 1, -0.5f}),
+    vm::vec3f{0, 0, 1}};
+  const auto grid = Grid{4};
+  const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+
+  auto pickRays = std::vector<vm::ray3>{};
+  for (size_t x = 0; x < NumPicksX; ++x)
+  {
+    for (size_t y = 0; y < NumPicksY; ++y)
+    {
+      pickRays.emplace_back(camera.pickRay(
+        float(camera.viewport().width) * (float(x) + 0.5f) / float(NumPicksX),
+        float(camera.viewport().height) * (float(y) + 0.5f) / float(NumPicksY)));
+    }
+  }
+
+  auto numBruteForceHits = size_t(0);
+  timeLambda(
+    [&]() {
+      const auto allHandles = vertexHandles.allHandles();
+      for (const auto& pickRay : pickRays)
+      {
+        for (const auto& handle : allHandles)
+        {
+          if (!vm::is_nan(camera.pickPointHandle(pickRay, handle, handleRadius)))
+          {
+            ++numBruteForceHits;
+          }
+        }
+      }
+    },
+    "pick " + std::to_string(vertexHandles.totalHandleCount())
+      + " vertex handles by testing all handles");
+
+  auto numHits = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& pickRay : pickRays)
+      {
+        auto pickResult = Model::PickResult{};
+        vertexHandles.pick(pickRay, camera, pickResult);
+        numHits += pickResult.size();
+      }
+    },
+    "pick " + std::to_string(vertexHandles.totalHandleCount()) + " vertex handles");
+  CHECK(numHits == numBruteForceHits);
+
+  timeLambda(
+    [&]() {
+      for (const auto& pickRay : pickRays)
+      {
+        auto pickResult = Model::PickResult{};
+        edgeHandles.pickGridHandle(pickRay, camera, grid, pickResult);
+        edgeHandles.pickCenterHandle(pickRay, camera, pickResult);
+      }
+    },
+    "pick " + std::to_string(edgeHandles.totalHandleCount()) + " edge handles");
+
+  timeLambda(
+    [&]() {
+      for (const auto& pickRay : pickRays)
+      {
+        auto pickResult = Model::PickResult{};
+        faceHandles.pickGridHandle(pickRay, camera, grid, pickResult);
+        faceHandles.pickCenterHandle(pickRay, camera, pickResult);
+      }
+    },
+    "pick " + std::to_string(faceHandles.totalHandleCount()) + " face handles");
+
+  // small lassos spread over the screen
+  auto lassos = std::vector<std::unique_ptr<Lasso>>{};
+  for (size_t i = 0; i < NumLassos; ++i)
+  {
+    const auto x = float(camera.viewport().width) * float(i % 10 + 1) / 11.0f;
+    const auto y = float(camera.viewport().height) * float(i / 10 + 1) / 11.0f;
+    const auto start = vm::vec3{
+      vm::point_at_distance(camera.pickRay(x - 32.0f, y - 32.0f), 64.0f)};
+    const auto end = vm::vec3{
+      vm::point_at_distance(camera.pickRay(x + 32.0f, y + 32.0f), 64.0f)};
+    lassos.push_back(std::make_unique<Lasso>(camera, 64.0, start));
+    lassos.back()->update(end);
+  }
+
+  auto numBruteForceSelected = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& lasso : lassos)
+      {
+        const auto allHandles = vertexHandles.allHandles();
+        auto selected = std::vector<vm::vec3>{};
+        lasso->selected(
+          std::begin(allHandles), std::end(allHandles), std::back_inserter(selected));
+        numBruteForceSelected += selected.size();
+      }
+    },
+    "lasso " + std::to_string(vertexHandles.totalHandleCount())
+      + " vertex handles by testing all handles");
+
+  auto numSelected = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& lasso : lassos)
+      {
+        auto candidates = std::vector<vm::vec3>{};
+        vertexHandles.forEachHandle(
+          [&](const vm::bbox3& bounds) { return lasso->mightSelect(bounds); },
+          [&](const vm::vec3& handle) { candidates.push_back(handle); });
+
+        auto selected = std::vector<vm::vec3>{};
+        lasso->selected(
+          std::begin(candidates), std::end(candidates), std::back_inserter(selected));
+        numSelected += selected.size();
+      }
+    },
+    "lasso " + std::to_string(vertexHandles.totalHandleCount()) + " vertex handles");
+  CHECK(numSelected == numBruteForceSelected);
+}
+} // namespace View
+} // namespace TrenchBroom
@@ -19,12 +19,18 @@
 
 #include "EntityModel.h"
 
+#include "Assets/EntityModelMeshOptimizer.h"
+#include "Assets/Texture.h"
 #include "Assets/TextureCollection.h"
+#include "Exceptions.h"
+#include "Macros.h"
+#include "Renderer/IndexArray.h"
 #include "Renderer/IndexRangeMap.h"
 #include "Renderer/PrimType.h"
+#include "Renderer/TexturedIndexArrayMap.h"
+#include "Renderer/TexturedIndexArrayRenderer.h"
 #include "Renderer/TexturedIndexRangeMap.h"
 #include "Renderer/TexturedIndexRangeRenderer.h"
-#include "octree.h"
 
 #include <vecmath/bbox.h>
 #include <vecmath/forward.h>
@@ -34,7 +40,10 @@
 //#include <tinybvh/tiny_bvh.h>
 #include "../../lib/tinybvh/include/tiny_bvh.h" // RB FIXME
 
+#include <algorithm>
+#include <limits>
 #include <string>
+#include <variant>
 
 namespace TrenchBroom
 {
@@ -78,7 +87,6 @@ EntityModelLoadedFrame::EntityModelLoadedFrame(
   , m_bounds{bounds}
   , m_pitchType{pitchType}
   , m_orientation{orientation}
-  , m_spacialTree{std::make_unique<SpacialTree>(16.0f)}
 {
 }
 
@@ -109,158 +117,85 @@ Orientation EntityModelLoadedFrame::orientation() const
   return m_orientation;
 }
 
-float EntityModelLoadedFrame::intersect(const vm::ray3f& ray) const
+namespace
+{
+tinybvh::Ray toBVHRay(const vm::ray3f& ray)
 {
-  auto closestDistance = vm::nan<float>();
+  return tinybvh::Ray{
+    tinybvh::bvhvec3{ray.origin[0], ray.origin[1], ray.origin[2]},
+    tinybvh::bvhvec3{ray.direction[0], ray.direction[1], ray.direction[2]}};
+}
 
-#if 1
-  if (m_bvhTris.size() > 2)
-  {
-    tinybvh::bvhvec3 O(ray.origin[0], ray.origin[1], ray.origin[2]);
-    tinybvh::bvhvec3 D(ray.direction[0], ray.direction[1], ray.direction[2]);
-    tinybvh::Ray ray2(O, D);
+tinybvh::bvhvec4 toBVHVertex(const EntityModelVertex& vertex)
+{
+  const auto& p = Renderer::getVertexComponent<0>(vertex);
+  return tinybvh::bvhvec4{p[0], p[1], p[2], 0.0f};
+}
 
-    int steps = m_bvh.Intersect(ray2);
-    if (steps > 0)
-    {
-      closestDistance = ray2.hit.t;
-    }
-    // printf( "std: nearest intersection: %f (found in %i traversal steps).\n",
-    // ray.hit.t, steps );
+size_t usedMemory(const tinybvh::BVH& bvh)
+{
+  return size_t(bvh.allocatedNodes) * sizeof(tinybvh::BVH::BVHNode)
+         + size_t(bvh.idxCount) * sizeof(uint32_t)
+         + size_t(bvh.triCount) * sizeof(tinybvh::BVH::Fragment);
+}
 
-    // m_logger.info()
-    //<< "std: nearest intersection: '" << ray2.hit.t << "(found in " << steps <<
-    //"traversal steps)";
-  }
-#else
-  {
-    const auto candidates = m_spacialTree->find_intersectors(ray);
-    for (const TriNum triNum : candidates)
-    {
-      const vm::vec3f& p1 = m_tris[triNum * 3 + 0];
-      const vm::vec3f& p2 = m_tris[triNum * 3 + 1];
-      const vm::vec3f& p3 = m_tris[triNum * 3 + 2];
-      closestDistance =
-        vm::safe_min(closestDistance, vm::intersect_ray_triangle(ray, p1, p2, p3));
-    }
-  }
-#endif
+[[maybe_unused]] size_t usedMemory(const tinybvh::BVH_SoA& bvh)
+{
+  return size_t(bvh.allocatedNodes) * sizeof(tinybvh::BVH_SoA::BVHNode)
+         + usedMemory(bvh.bvh);
+}
 
-  return closestDistance;
+size_t usedMemory(const Texture& texture)
+{
+  const auto bytesPerPixel =
+    texture.format() == GL_RGBA || texture.format() == GL_BGRA ? 4u : 3u;
+  return texture.width() * texture.height() * bytesPerPixel;
 }
+} // namespace
 
-void EntityModelLoadedFrame::addToSpacialTree(
-  const std::vector<EntityModelVertex>& vertices,
-  const Renderer::PrimType primType,
-  const size_t index,
-  const size_t count)
-{
-#if 0
-  switch (primType)
-  {
-  case Renderer::PrimType::Points:
-  case Renderer::PrimType::Lines:
-  case Renderer::PrimType::LineStrip:
-  case Renderer::PrimType::LineLoop:
-    break;
-  case Renderer::PrimType::Triangles: {
-    assert(count % 3 == 0);
-    m_tris.reserve(m_tris.size() + count);
-    for (size_t i = 0; i < count; i += 3)
+float EntityModelLoadedFrame::intersect(const vm::ray3f& ray) const
+{
+  if (m_bvh)
+  {
+    auto bvhRay = toBVHRay(ray);
+    m_bvh->Intersect(bvhRay);
+    if (bvhRay.hit.t < BVH_FAR)
     {
-      auto bounds = vm::bbox3f::builder{};
-      const auto& p1 = Renderer::getVertexComponent<0>(vertices[index + i + 0]);
-      const auto& p2 = Renderer::getVertexComponent<0>(vertices[index + i + 1]);
-      const auto& p3 = Renderer::getVertexComponent<0>(vertices[index + i + 2]);
-      bounds.add(p1);
-      bounds.add(p2);
-      bounds.add(p3);
-
-      const size_t triIndex = m_tris.size() / 3u;
-      m_tris.push_back(p1);
-      m_tris.push_back(p2);
-      m_tris.push_back(p3);
-      m_spacialTree->insert(bounds.bounds(), triIndex);
+      return bvhRay.hit.t;
     }
-    break;
   }
-  case Renderer::PrimType::Polygon:
-  case Renderer::PrimType::TriangleFan: {
-    assert(count > 2);
-    m_tris.reserve(m_tris.size() + (count - 2) * 3);
 
-    const auto& p1 = Renderer::getVertexComponent<0>(vertices[index]);
-    for (size_t i = 1; i < count - 1; ++i)
-    {
-      auto bounds = vm::bbox3f::builder{};
-      const auto& p2 = Renderer::getVertexComponent<0>(vertices[index + i]);
-      const auto& p3 = Renderer::getVertexComponent<0>(vertices[index + i + 1]);
-      bounds.add(p1);
-      bounds.add(p2);
-      bounds.add(p3);
-
-      const size_t triIndex = m_tris.size() / 3u;
-      m_tris.push_back(p1);
-      m_tris.push_back(p2);
-      m_tris.push_back(p3);
-      m_spacialTree->insert(bounds.bounds(), triIndex);
-    }
-    break;
-  }
-  case Renderer::PrimType::Quads:
-  case Renderer::PrimType::QuadStrip:
-  case Renderer::PrimType::TriangleStrip: {
-    assert(count > 2);
-    m_tris.reserve(m_tris.size() + (count - 2) * 3);
-    for (size_t i = 0; i < count - 2; ++i)
-    {
-      auto bounds = vm::bbox3f::builder{};
-      const auto& p1 = Renderer::getVertexComponent<0>(vertices[index + i + 0]);
-      const auto& p2 = Renderer::getVertexComponent<0>(vertices[index + i + 1]);
-      const auto& p3 = Renderer::getVertexComponent<0>(vertices[index + i + 2]);
-      bounds.add(p1);
-      bounds.add(p2);
-      bounds.add(p3);
-
-      const size_t triIndex = m_tris.size() / 3u;
-      if (i % 2 == 0)
-      {
-        m_tris.push_back(p1);
-        m_tris.push_back(p2);
-        m_tris.push_back(p3);
-      }
-      else
-      {
-        m_tris.push_back(p1);
-        m_tris.push_back(p3);
-        m_tris.push_back(p2);
-      }
-      m_spacialTree->insert(bounds.bounds(), triIndex);
-    }
-    break;
-  }
-    switchDefault();
-  }
-#endif
+  return vm::nan<float>();
 }
 
-void EntityModelLoadedFrame::buildBVH()
+size_t EntityModelLoadedFrame::usedMemory() const
+{
+  const auto trisMemory = m_bvhTris.capacity() * sizeof(tinybvh::bvhvec4);
+  return m_bvh ? trisMemory + Assets::usedMemory(*m_bvh) : trisMemory;
+}
+
+void EntityModelLoadedFrame::addToBVH(
+  const std::vector<EntityModelVertex>& vertices,
+  const std::vector<std::uint32_t>& indices)
 {
-  int nTris = m_bvhTris.size() / 3;
-  if (nTris > 0)
+  m_bvhTris.reserve(m_bvhTris.size() + indices.size());
+  for (const auto index : indices)
   {
-    m_bvh.Build(&m_bvhTris[0], nTris);
+    m_bvhTris.push_back(toBVHVertex(vertices[index]));
   }
 }
 
-void EntityModelLoadedFrame::buildBVH(const std::vector<tinybvh::bvhvec4>& bvhTris)
+void EntityModelLoadedFrame::buildBVH()
 {
-  m_bvhTris = bvhTris;
+  // the BVH references the triangle array, so it must be rebuilt whenever the array
+  // changes
+  m_bvh.reset();
 
-  int nTris = m_bvhTris.size() / 3;
-  if (nTris > 0)
+  const auto triCount = static_cast<uint32_t>(m_bvhTris.size() / 3);
+  if (triCount > 0)
   {
-    m_bvh.Build(&m_bvhTris[0], nTris);
+    m_bvh = std::make_unique<BVH>();
+    m_bvh->Build(m_bvhTris.data(), triCount);
   }
 }
 
@@ -301,66 +236,131 @@ public:
   Orientation orientation() const override { return Orientation::Oriented; }
 
   float intersect(const vm::ray3f& /* ray */) const override { return vm::nan<float>(); }
+
+  size_t usedMemory() const override { return 0; }
 };
 
 // EntityModel::Mesh
 
 /**
- * The mesh associated with a frame and a surface.
+ * The mesh associated with a frame and a surface. The mesh is optimized when it is
+ * created, see optimizeMesh. Its triangles are stored as indices into its vertices, using
+ * 16 bit indices if the number of vertices allows it.
  */
 class EntityModelMesh
 {
+private:
+  using Indices16 = std::vector<GLushort>;
+  using Indices32 = std::vector<GLuint>;
+
 protected:
   std::vector<EntityModelVertex> m_vertices;
+  std::variant<Indices16, Indices32> m_indices;
+  Renderer::TexturedIndexArrayMap m_indexArrayMap;
 
   /**
-   * Creates a new frame mesh that uses the given vertices.
+   * Creates a new frame mesh by optimizing the given triangle mesh and adds its triangles
+   * to the given frame's hit testing data.
    *
-   * @param vertices the vertices
+   * @param frame the frame to which this mesh belongs
+   * @param mesh the triangle mesh
    */
-  explicit EntityModelMesh(std::vector<EntityModelVertex> vertices)
-    : m_vertices{std::move(vertices)}
+  EntityModelMesh(EntityModelLoadedFrame& frame, EntityModelTriangleMesh mesh)
   {
+    mesh = optimizeMesh(std::move(mesh));
+
+    frame.addToBVH(mesh.vertices, mesh.indices);
+    frame.buildBVH();
+
+    // the index array map decides where the triangles of each texture go
+    auto size = Renderer::TexturedIndexArrayMap::Size{};
+    for (const auto& group : mesh.groups)
+    {
+      size.inc(group.texture, Renderer::PrimType::Triangles, group.count);
+    }
+
+    m_indexArrayMap = Renderer::TexturedIndexArrayMap{size};
+    auto indices = Indices32(mesh.indices.size());
+    for (const auto& group : mesh.groups)
+    {
+      const auto offset =
+        m_indexArrayMap.add(group.texture, Renderer::PrimType::Triangles, group.count);
+      const auto first = std::begin(mesh.indices) + std::ptrdiff_t(group.offset);
+      std::copy(
+        first,
+        first + std::ptrdiff_t(group.count),
+        std::begin(indices) + std::ptrdiff_t(offset));
+    }
+
+    m_vertices = std::move(mesh.vertices);
+    if (m_vertices.size() <= size_t(std::numeric_limits<GLushort>::max()) + 1u)
+    {
+      m_indices = Indices16(std::begin(indices), std::end(indices));
+    }
+    else
+    {
+      m_indices = std::move(indices);
+    }
   }
 
 public:
   virtual ~EntityModelMesh() = default;
 
 public:
+  /**
+   * Returns an estimate of the number of bytes used by the vertices and indices of this
+   * mesh.
+   */
+  size_t usedMemory() const
+  {
+    return m_vertices.capacity() * sizeof(EntityModelVertex)
+           + std::visit(
+             [](const auto& indices) {
+               return indices.capacity() * sizeof(typename std::decay_t<
+                                                  decltype(indices)>::value_type);
+             },
+             m_indices);
+  }
+
   /**
    * Returns a renderer that renders this mesh with the given texture.
    *
    * @param skin the texture to use when rendering the mesh
    * @return the renderer
    */
-  std::unique_ptr<Renderer::TexturedIndexRangeRenderer> buildRenderer(const Texture* skin)
+  std::unique_ptr<Renderer::TexturedRenderer> buildRenderer(const Texture* skin)
+  {
+    auto vertexArray = Renderer::VertexArray::ref(m_vertices);
+    auto indexArray = std::visit(
+      [](const auto& indices) { return Renderer::IndexArray::ref(indices); }, m_indices);
+    return std::make_unique<Renderer::TexturedIndexArrayRenderer>(
+      std::move(vertexArray), std::move(indexArray), doGetIndexArrayMap(skin));
+  }
+
+protected:
+  size_t indexCount() const
   {
-    const auto vertexArray = Renderer::VertexArray::ref(m_vertices);
-    return doBuildRenderer(skin, vertexArray);
+    return std::visit([](const auto& indices) { return indices.size(); }, m_indices);
   }
 
 private:
   /**
-   * Creates and returns the actual mesh renderer
+   * Returns the index array map that associates the triangles of this mesh with their
+   * textures.
    *
    * @param skin the skin to use when rendering the mesh
-   * @param vertices the vertices associated with this mesh
-   * @return the renderer
    */
-  virtual std::unique_ptr<Renderer::TexturedIndexRangeRenderer> doBuildRenderer(
-    const Texture* skin, const Renderer::VertexArray& vertices) = 0;
+  virtual Renderer::TexturedIndexArrayMap doGetIndexArrayMap(
+    const Texture* skin) const = 0;
 };
 
 // EntityModel::IndexedMesh
 
 /**
- * A model frame mesh for indexed rendering. Stores vertices and vertex indices.
+ * A model frame mesh that is rendered with the skin of the frame.
  */
 class EntityModelIndexedMesh : public EntityModelMesh
 {
-private:
-  EntityModelIndices m_indices;
-
 public:
   /**
    * Creates a new frame mesh with the given vertices and indices.
@@ -372,37 +372,32 @@ public:
   EntityModelIndexedMesh(
     EntityModelLoadedFrame& frame,
     std::vector<EntityModelVertex> vertices,
-    EntityModelIndices indices)
-    : EntityModelMesh{std::move(vertices)}
-    , m_indices{std::move(indices)}
+    const EntityModelIndices& indices)
+    : EntityModelMesh{frame, triangulateMesh(std::move(vertices), indices)}
   {
-    m_indices.forEachPrimitive(
-      [&](const Renderer::PrimType primType, const size_t index, const size_t count) {
-        frame.addToSpacialTree(m_vertices, primType, index, count);
-      });
   }
 
 private:
-  std::unique_ptr<Renderer::TexturedIndexRangeRenderer> doBuildRenderer(
-    const Texture* skin, const Renderer::VertexArray& vertices) override
+  Renderer::TexturedIndexArrayMap doGetIndexArrayMap(const Texture* skin) const override
   {
-    const Renderer::TexturedIndexRangeMap texturedIndices(skin, m_indices);
-    return std::make_unique<Renderer::TexturedIndexRangeRenderer>(
-      vertices, texturedIndices);
+    const auto count = indexCount();
+
+    auto size = Renderer::TexturedIndexArrayMap::Size{};
+    size.inc(skin, Renderer::PrimType::Triangles, count);
+
+    auto result = Renderer::TexturedIndexArrayMap{size};
+    result.add(skin, Renderer::PrimType::Triangles, count);
+    return result;
   }
 };
 
 // EntityModel::TexturedMesh
 
 /**
- * A model frame mesh for per texture indexed rendering. Stores vertices and per texture
- * indices.
+ * A model frame mesh for per texture indexed rendering.
  */
 class EntityModelTexturedMesh : public EntityModelMesh
 {
-private:
-  EntityModelTexturedIndices m_indices;
-
 public:
   /**
    * Creates a new frame mesh with the given vertices and per texture indices.
@@ -414,34 +409,16 @@ public:
   EntityModelTexturedMesh(
     EntityModelLoadedFrame& frame,
     std::vector<EntityModelVertex> vertices,
-    EntityModelTexturedIndices indices,
-    const std::vector<tinybvh::bvhvec4>* bvhTris)
-    : EntityModelMesh{std::move(vertices)}
-    , m_indices{std::move(indices)}
-  {
-#if 0
-	// this is super slow even with medium sized models from 2013
-    m_indices.forEachPrimitive([&](
-                                 const Texture* /* texture */,
-                                 const Renderer::PrimType primType,
-                                 const size_t index,
-                                 const size_t count) {
-      frame.addToSpacialTree(m_vertices, primType, index, count);
-    });
-#endif
-
-    // RB: build BVH from collected triangles
-    if (bvhTris && bvhTris->size() > 2)
-    {
-      frame.buildBVH(*bvhTris);
-    }
+    const EntityModelTexturedIndices& indices)
+    : EntityModelMesh{frame, triangulateMesh(std::move(vertices), indices)}
+  {
   }
 
 private:
-  std::unique_ptr<Renderer::TexturedIndexRangeRenderer> doBuildRenderer(
-    const Texture* /* skin */, const Renderer::VertexArray& vertices) override
+  Renderer::TexturedIndexArrayMap doGetIndexArrayMap(
+    const Texture* /* skin */) const override
   {
-    return std::make_unique<Renderer::TexturedIndexRangeRenderer>(vertices, m_indices);
+    return m_indexArrayMap;
   }
 };
 
@@ -477,19 +454,18 @@ void EntityModelSurface::addIndexedMesh(
   EntityModelIndices indices)
 {
   assert(frame.index() < frameCount());
-  m_meshes[frame.index()] = std::make_unique<EntityModelIndexedMesh>(
-    frame, std::move(vertices), std::move(indices));
+  m_meshes[frame.index()] =
+    std::make_unique<EntityModelIndexedMesh>(frame, std::move(vertices), indices);
 }
 
 void EntityModelSurface::addTexturedMesh(
   EntityModelLoadedFrame& frame,
   std::vector<EntityModelVertex> vertices,
-  EntityModelTexturedIndices indices,
-  const std::vector<tinybvh::bvhvec4>* bvhTris)
+  EntityModelTexturedIndices indices)
 {
   assert(frame.index() < frameCount());
-  m_meshes[frame.index()] = std::make_unique<EntityModelTexturedMesh>(
-    frame, std::move(vertices), std::move(indices), bvhTris);
+  m_meshes[frame.index()] =
+    std::make_unique<EntityModelTexturedMesh>(frame, std::move(vertices), indices);
 }
 
 void EntityModelSurface::setSkins(std::vector<Texture> skins)
@@ -507,6 +483,23 @@ size_t EntityModelSurface::skinCount() const
   return m_skins->textureCount();
 }
 
+size_t EntityModelSurface::usedMemory() const
+{
+  auto result = size_t(0);
+  for (const auto& mesh : m_meshes)
+  {
+    if (mesh)
+    {
+      result += mesh->usedMemory();
+    }
+  }
+  for (const auto& skin : m_skins->textures())
+  {
+    result += Assets::usedMemory(skin);
+  }
+  return result;
+}
+
 const Texture* EntityModelSurface::skin(const std::string& name) const
 {
   return m_skins->textureByName(name);
@@ -517,7 +510,7 @@ const Texture* EntityModelSurface::skin(const size_t index) const
   return m_skins->textureByIndex(index);
 }
 
-std::unique_ptr<Renderer::TexturedIndexRangeRenderer> EntityModelSurface::buildRenderer(
+std::unique_ptr<Renderer::TexturedRenderer> EntityModelSurface::buildRenderer(
   const size_t skinIndex, const size_t frameIndex)
 {
   assert(frameIndex < frameCount());
@@ -548,7 +541,7 @@ EntityModel::EntityModel(
 std::unique_ptr<Renderer::TexturedRenderer> EntityModel::buildRenderer(
   const size_t skinIndex, const size_t frameIndex) const
 {
-  std::vector<std::unique_ptr<Renderer::TexturedIndexRangeRenderer>> renderers;
+  std::vector<std::unique_ptr<Renderer::TexturedRenderer>> renderers;
   if (frameIndex >= frameCount())
   {
     return nullptr;
@@ -572,7 +565,7 @@ std::unique_ptr<Renderer::TexturedRenderer> EntityModel::buildRenderer(
   }
   else
   {
-    return std::make_unique<Renderer::MultiTexturedIndexRangeRenderer>(
+    return std::make_unique<Renderer::MultiTexturedRenderer>(
       std::move(renderers));
   }
 }
@@ -656,6 +649,20 @@ size_t EntityModel::surfaceCount() const
   return m_surfaces.size();
 }
 
+size_t EntityModel::usedMemory() const
+{
+  auto result = size_t(0);
+  for (const auto& frame : m_frames)
+  {
+    result += frame->usedMemory();
+  }
+  for (const auto& surface : m_surfaces)
+  {
+    result += surface->usedMemory();
+  }
+  return result;
+}
+
 std::vector<const EntityModelFrame*> EntityModel::frames() const
 {
   return kdl::vec_transform(m_frames, [](const auto& frame) {
@@ -24,6 +24,7 @@
 #include <vecmath/bbox.h>
 #include <vecmath/forward.h>
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -32,13 +33,9 @@
 
 namespace TrenchBroom
 {
-template <typename T, typename U>
-class octree;
-
 namespace Renderer
 {
 enum class PrimType;
-class TexturedIndexRangeRenderer;
 class TexturedRenderer;
 } // namespace Renderer
 
@@ -151,6 +148,12 @@ public:
    * intersect this frame
    */
   virtual float intersect(const vm::ray3f& ray) const = 0;
+
+  /**
+   * Returns an estimate of the number of bytes used by the hit testing data of this
+   * frame, that is, its triangles and BVH.
+   */
+  virtual size_t usedMemory() const = 0;
 };
 
 /**
@@ -164,14 +167,14 @@ private:
   PitchType m_pitchType;
   Orientation m_orientation;
 
-  // For hit testing
-  std::vector<vm::vec3f> m_tris;
-  using TriNum = size_t;
-  using SpacialTree = octree<float, TriNum>;
-  std::unique_ptr<SpacialTree> m_spacialTree;
-
-  tinybvh::BVH m_bvh;
+  // For hit testing, use the SIMD traversal layout where tinybvh supports it
+#if defined(BVH_USEAVX) || defined(BVH_USENEON)
+  using BVH = tinybvh::BVH_SoA;
+#else
+  using BVH = tinybvh::BVH;
+#endif
   std::vector<tinybvh::bvhvec4> m_bvhTris;
+  std::unique_ptr<BVH> m_bvh;
 
 public:
   /**
@@ -198,25 +201,23 @@ public:
   PitchType pitchType() const override;
   Orientation orientation() const override;
   float intersect(const vm::ray3f& ray) const override;
+  size_t usedMemory() const override;
 
   /**
-   * Adds the given primitives to the spacial tree for this frame.
+   * Adds the given triangles to the hit testing triangles of this frame. The BVH is not
+   * updated until buildBVH is called.
    *
-   * @param vertices the vertices
-   * @param primType the primitive type
-   * @param index the index of the first primitive's first vertex in the given vertex
-   * array
-   * @param count the number of vertices that make up the primitive(s)
+   * @param vertices the mesh vertices
+   * @param indices the vertex indices, every three of which make up a triangle
    */
-  void addToSpacialTree(
+  void addToBVH(
     const std::vector<EntityModelVertex>& vertices,
-    Renderer::PrimType primType,
-    size_t index,
-    size_t count);
+    const std::vector<std::uint32_t>& indices);
 
-  // RB
+  /**
+   * Rebuilds the BVH from the hit testing triangles of this frame.
+   */
   void buildBVH();
-  void buildBVH(const std::vector<tinybvh::bvhvec4>& bvhTris);
 };
 
 class EntityModelMesh;
@@ -295,8 +296,7 @@ public:
   void addTexturedMesh(
     EntityModelLoadedFrame& frame,
     std::vector<EntityModelVertex> vertices,
-    EntityModelTexturedIndices indices,
-    const std::vector<tinybvh::bvhvec4>* bvhTris = nullptr);
+    EntityModelTexturedIndices indices);
 
   /**
    * Sets the given textures as skins to this surface.
@@ -320,6 +320,12 @@ public:
    */
   size_t skinCount() const;
 
+  /**
+   * Returns an estimate of the number of bytes used by the meshes and skins of this
+   * surface.
+   */
+  size_t usedMemory() const;
+
   /**
    * Returns the skin with the given name.
    *
@@ -336,7 +342,7 @@ public:
    */
   const Texture* skin(size_t index) const;
 
-  std::unique_ptr<Renderer::TexturedIndexRangeRenderer> buildRenderer(
+  std::unique_ptr<Renderer::TexturedRenderer> buildRenderer(
     size_t skinIndex, size_t frameIndex);
 };
 
@@ -448,6 +454,13 @@ public:
    */
   size_t surfaceCount() const;
 
+  /**
+   * Returns an estimate of the number of bytes used by this model, including the vertices
+   * and indices of its meshes, the hit testing data of its loaded frames and the texture
+   * data of its skins.
+   */
+  size_t usedMemory() const;
+
   /**
    * Returns all frames of this model.
    *
@@ -28,7 +28,9 @@
 #include "Model/EntityNode.h"
 #include "Renderer/TexturedIndexRangeRenderer.h"
 
+#include <algorithm>
 #include <chrono>
+#include <unordered_set>
 
 namespace TrenchBroom
 {
@@ -41,6 +43,10 @@ EntityModelManager::EntityModelManager(
   , m_minFilter(minFilter)
   , m_magFilter(magFilter)
   , m_resetTextureMode(false)
+  , m_memoryBudget(DefaultMemoryBudget)
+  , m_memoryUsage(0)
+  , m_generation(0)
+  , m_evictionCount(0)
 {
 }
 
@@ -59,6 +65,8 @@ void EntityModelManager::clear()
   m_unpreparedModels.clear();
   m_unpreparedRenderers.clear();
 
+  m_memoryUsage = 0;
+
   // Remove logging because it might fail when the document is already destroyed.
 }
 
@@ -134,11 +142,48 @@ const EntityModelFrame* EntityModelManager::frame(
     if (!model->frame(spec.frameIndex)->loaded())
     {
       loadFrame(spec, *model);
+      updateMemoryUsage(m_models.at(spec.path));
     }
     return model->frame(spec.frameIndex);
   }
 }
 
+void EntityModelManager::setMemoryBudget(const size_t memoryBudget)
+{
+  m_memoryBudget = memoryBudget;
+}
+
+size_t EntityModelManager::memoryBudget() const
+{
+  return m_memoryBudget;
+}
+
+void EntityModelManager::setFramesInUse(FramesInUse framesInUse)
+{
+  m_framesInUse = std::move(framesInUse);
+}
+
+size_t EntityModelManager::memoryUsage() const
+{
+  return m_memoryUsage;
+}
+
+size_t EntityModelManager::memoryUsage(const IO::Path& path) const
+{
+  const auto it = m_models.find(path);
+  return it != std::end(m_models) ? it->second.usedMemory : 0u;
+}
+
+size_t EntityModelManager::modelCount() const
+{
+  return m_models.size();
+}
+
+size_t EntityModelManager::evictionCount() const
+{
+  return m_evictionCount;
+}
+
 EntityModel* EntityModelManager::model(const IO::Path& path) const
 {
   if (path.isEmpty())
@@ -149,7 +194,8 @@ EntityModel* EntityModelManager::model(const IO::Path& path) const
   auto it = m_models.find(path);
   if (it != std::end(m_models))
   {
-    return it->second.get();
+    it->second.lastUsed = m_generation;
+    return it->second.model.get();
   }
 
   if (m_modelMismatches.count(path) > 0)
@@ -159,11 +205,14 @@ EntityModel* EntityModelManager::model(const IO::Path& path) const
 
   try
   {
-    const auto [pos, success] = m_models.emplace(path, loadModel(path));
+    const auto [pos, success] =
+      m_models.emplace(path, CachedModel{loadModel(path), 0u, m_generation});
     assert(success);
     unused(success);
 
-    auto* model = pos->second.get();
+    updateMemoryUsage(pos->second);
+
+    auto* model = pos->second.model.get();
     m_unpreparedModels.push_back(model);
 
     m_logger.debug() << "Loaded entity model " << path;
@@ -226,15 +275,16 @@ void EntityModelManager::prepare(Renderer::VboManager& vboManager)
   resetTextureMode();
   prepareModels();
   prepareRenderers(vboManager);
+  evictModels();
 }
 
 void EntityModelManager::resetTextureMode()
 {
   if (m_resetTextureMode)
   {
-    for (const auto& [path, model] : m_models)
+    for (const auto& [path, cachedModel] : m_models)
     {
-      model->setTextureMode(m_minFilter, m_magFilter);
+      cachedModel.model->setTextureMode(m_minFilter, m_magFilter);
     }
     m_resetTextureMode = false;
   }
@@ -257,5 +307,89 @@ void EntityModelManager::prepareRenderers(Renderer::VboManager& vboManager)
   }
   m_unpreparedRenderers.clear();
 }
+
+void EntityModelManager::updateMemoryUsage(CachedModel& cachedModel) const
+{
+  m_memoryUsage -= cachedModel.usedMemory;
+  cachedModel.usedMemory = cachedModel.model->usedMemory();
+  m_memoryUsage += cachedModel.usedMemory;
+}
+
+void EntityModelManager::evictModels()
+{
+  // models that were used since the last call to prepare are never evicted because
+  // callers may still hold pointers to their renderers
+  const auto generation = m_generation++;
+  if (m_memoryUsage <= m_memoryBudget)
+  {
+    return;
+  }
+
+  auto framesInUse = std::unordered_set<const EntityModelFrame*>{};
+  if (m_framesInUse)
+  {
+    for (const auto* frame : m_framesInUse())
+    {
+      framesInUse.insert(frame);
+    }
+  }
+
+  const auto isInUse = [&](const EntityModel& model) {
+    for (const auto* frame : model.frames())
+    {
+      if (framesInUse.count(frame) > 0)
+      {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  auto candidates = std::vector<ModelCache::iterator>{};
+  for (auto it = std::begin(m_models); it != std::end(m_models); ++it)
+  {
+    if (it->second.lastUsed < generation && !isInUse(*it->second.model))
+    {
+      candidates.push_back(it);
+    }
+  }
+
+  std::sort(
+    std::begin(candidates), std::end(candidates), [](const auto& lhs, const auto& rhs) {
+      return lhs->second.lastUsed < rhs->second.lastUsed;
+    });
+
+  for (auto it : candidates)
+  {
+    if (m_memoryUsage <= m_memoryBudget)
+    {
+      break;
+    }
+    evictModel(it);
+  }
+}
+
+void EntityModelManager::evictModel(ModelCache::iterator it)
+{
+  const auto& path = it->first;
+  for (auto rIt = std::begin(m_renderers); rIt != std::end(m_renderers);)
+  {
+    if (rIt->first.path == path)
+    {
+      rIt = m_renderers.erase(rIt);
+    }
+    else
+    {
+      ++rIt;
+    }
+  }
+
+  m_logger.debug() << "Evicted entity model " << path << " ("
+                   << it->second.usedMemory << " bytes)";
+
+  m_memoryUsage -= it->second.usedMemory;
+  ++m_evictionCount;
+  m_models.erase(it);
+}
 } // namespace Assets
 } // namespace TrenchBroom
@@ -23,6 +23,7 @@
 
 #include <kdl/vector_set.h>
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <vector>
@@ -56,8 +57,24 @@ enum class Orientation;
 
 class EntityModelManager
 {
+public:
+  /**
+   * Returns the model frames that are currently referenced by entities in the map. Models
+   * with at least one referenced frame are never evicted.
+   */
+  using FramesInUse = std::function<std::vector<const EntityModelFrame*>()>;
+
+  static constexpr size_t DefaultMemoryBudget = 512u * 1024u * 1024u;
+
 private:
-  using ModelCache = std::map<IO::Path, std::unique_ptr<EntityModel>>;
+  struct CachedModel
+  {
+    std::unique_ptr<EntityModel> model;
+    size_t usedMemory;
+    size_t lastUsed;
+  };
+
+  using ModelCache = std::map<IO::Path, CachedModel>;
   using ModelMismatches = kdl::vector_set<IO::Path>;
   using ModelList = std::vector<EntityModel*>;
 
@@ -81,6 +98,12 @@ private:
   mutable ModelList m_unpreparedModels;
   mutable RendererList m_unpreparedRenderers;
 
+  size_t m_memoryBudget;
+  FramesInUse m_framesInUse;
+  mutable size_t m_memoryUsage;
+  mutable size_t m_generation;
+  mutable size_t m_evictionCount;
+
 public:
   EntityModelManager(int magFilter, int minFilter, Logger& logger);
   ~EntityModelManager();
@@ -93,6 +116,33 @@ public:
 
   const EntityModelFrame* frame(const ModelSpecification& spec) const;
 
+  /**
+   * Sets the number of bytes that the cached models may use before unreferenced models
+   * are evicted. Eviction happens in prepare, least recently used models first. Evicted
+   * models are reloaded when they are requested again.
+   */
+  void setMemoryBudget(size_t memoryBudget);
+  size_t memoryBudget() const;
+
+  /**
+   * Sets the function that determines which models are referenced by the map.
+   */
+  void setFramesInUse(FramesInUse framesInUse);
+
+  /**
+   * Returns an estimate of the number of bytes used by all cached models.
+   */
+  size_t memoryUsage() const;
+
+  /**
+   * Returns an estimate of the number of bytes used by the model with the given path, or
+   * 0 if that model is not cached.
+   */
+  size_t memoryUsage(const IO::Path& path) const;
+
+  size_t modelCount() const;
+  size_t evictionCount() const;
+
 private:
   EntityModel* model(const IO::Path& path) const;
   EntityModel* safeGetModel(const IO::Path& path) const;
@@ -106,6 +156,9 @@ private:
   void resetTextureMode();
   void prepareModels();
   void prepareRenderers(Renderer::VboManager& vboManager);
+  void updateMemoryUsage(CachedModel& cachedModel) const;
+  void evictModels();
+  void evictModel(ModelCache::iterator it);
 };
 } // namespace Assets
 } // namespace TrenchBroom
@@ -0,0 +1,451 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntityModelMeshOptimizer.h"
+
+#include "Macros.h"
+#include "Renderer/IndexRangeMap.h"
+#include "Renderer/PrimType.h"
+#include "Renderer/TexturedIndexRangeMap.h"
+
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <unordered_map>
+
+namespace TrenchBroom
+{
+namespace Assets
+{
+namespace
+{
+/**
+ * Appends the triangles of the given primitive to the given index list. Polygons and
+ * fans are triangulated around their first vertex, strips alternate the winding of every
+ * other triangle.
+ */
+void triangulate(
+  const Renderer::PrimType primType,
+  const size_t index,
+  const size_t count,
+  std::vector<std::uint32_t>& indices)
+{
+  const auto i = [&](const size_t offset) { return std::uint32_t(index + offset); };
+
+  switch (primType)
+  {
+  case Renderer::PrimType::Points:
+  case Renderer::PrimType::Lines:
+  case Renderer::PrimType::LineStrip:
+  case Renderer::PrimType::LineLoop:
+    break;
+  case Renderer::PrimType::Triangles: {
+    assert(count % 3 == 0);
+    for (size_t j = 0; j < count; ++j)
+    {
+      indices.push_back(i(j));
+    }
+    break;
+  }
+  case Renderer::PrimType::Polygon:
+  case Renderer::PrimType::TriangleFan: {
+    for (size_t j = 1; j + 1 < count; ++j)
+    {
+      indices.push_back(i(0));
+      indices.push_back(i(j));
+      indices.push_back(i(j + 1));
+    }
+    break;
+  }
+  case Renderer::PrimType::Quads: {
+    assert(count % 4 == 0);
+    for (size_t j = 0; j + 3 < count; j += 4)
+    {
+      indices.push_back(i(j));
+      indices.push_back(i(j + 1));
+      indices.push_back(i(j + 2));
+      indices.push_back(i(j));
+      indices.push_back(i(j + 2));
+      indices.push_back(i(j + 3));
+    }
+    break;
+  }
+  case Renderer::PrimType::QuadStrip:
+  case Renderer::PrimType::TriangleStrip: {
+    for (size_t j = 0; j + 2 < count; ++j)
+    {
+      indices.push_back(i(j));
+      if (j % 2 == 0)
+      {
+        indices.push_back(i(j + 1));
+        indices.push_back(i(j + 2));
+      }
+      else
+      {
+        indices.push_back(i(j + 2));
+        indices.push_back(i(j + 1));
+      }
+    }
+    break;
+  }
+    switchDefault();
+  }
+}
+
+using VertexKey = std::array<std::uint32_t, 5>;
+
+struct VertexKeyHash
+{
+  size_t operator()(const VertexKey& key) const
+  {
+    auto result = size_t(0);
+    for (const auto k : key)
+    {
+      result ^=
+        std::hash<std::uint32_t>{}(k) + 0x9e3779b9 + (result << 6) + (result >> 2);
+    }
+    return result;
+  }
+};
+
+VertexKey makeVertexKey(const EntityModelVertex& vertex)
+{
+  const auto& position = Renderer::getVertexComponent<0>(vertex);
+  const auto& texCoords = Renderer::getVertexComponent<1>(vertex);
+  const auto values = std::array<float, 5>{
+    position[0], position[1], position[2], texCoords[0], texCoords[1]};
+
+  auto result = VertexKey{};
+  std::memcpy(result.data(), values.data(), sizeof(values));
+  return result;
+}
+
+/**
+ * Replaces the indices of the given mesh so that they refer to the first of several
+ * identical vertices, and removes triangles that have become degenerate.
+ */
+void weldVertices(EntityModelTriangleMesh& mesh)
+{
+  auto firstVertex = std::unordered_map<VertexKey, std::uint32_t, VertexKeyHash>{};
+  firstVertex.reserve(mesh.vertices.size());
+
+  auto remap = std::vector<std::uint32_t>{};
+  remap.reserve(mesh.vertices.size());
+  for (size_t i = 0; i < mesh.vertices.size(); ++i)
+  {
+    const auto [it, inserted] =
+      firstVertex.emplace(makeVertexKey(mesh.vertices[i]), std::uint32_t(i));
+    unused(inserted);
+    remap.push_back(it->second);
+  }
+
+  auto indices = std::vector<std::uint32_t>{};
+  indices.reserve(mesh.indices.size());
+  for (auto& group : mesh.groups)
+  {
+    const auto offset = indices.size();
+    for (size_t i = group.offset; i < group.offset + group.count; i += 3)
+    {
+      const auto i0 = remap[mesh.indices[i + 0]];
+      const auto i1 = remap[mesh.indices[i + 1]];
+      const auto i2 = remap[mesh.indices[i + 2]];
+      if (i0 != i1 && i1 != i2 && i2 != i0)
+      {
+        indices.push_back(i0);
+        indices.push_back(i1);
+        indices.push_back(i2);
+      }
+    }
+    group.offset = offset;
+    group.count = indices.size() - offset;
+  }
+  mesh.indices = std::move(indices);
+}
+
+constexpr size_t ForsythCacheSize = 32;
+
+float vertexScore(const int cachePosition, const size_t activeTriangles)
+{
+  if (activeTriangles == 0)
+  {
+    return -1.0f;
+  }
+
+  auto score = 0.0f;
+  if (cachePosition >= 0)
+  {
+    if (cachePosition < 3)
+    {
+      // the vertices of the last triangle get a fixed score to avoid favoring them too
+      // much, otherwise the algorithm produces strips
+      score = 0.75f;
+    }
+    else
+    {
+      const auto scaler = 1.0f / float(ForsythCacheSize - 3);
+      score = std::pow(1.0f - float(cachePosition - 3) * scaler, 1.5f);
+    }
+  }
+
+  // vertices with few remaining triangles are favored to get rid of lone triangles
+  return score + 2.0f / std::sqrt(float(activeTriangles));
+}
+
+/**
+ * Reorders the triangles in the given index range using Tom Forsyth's algorithm.
+ */
+void optimizeVertexCache(
+  std::uint32_t* indices, const size_t indexCount, const size_t vertexCount)
+{
+  const auto triangleCount = indexCount / 3;
+  if (triangleCount < 2)
+  {
+    return;
+  }
+
+  // adjacency from vertices to triangles
+  auto activeTriangles = std::vector<size_t>(vertexCount, 0);
+  for (size_t i = 0; i < indexCount; ++i)
+  {
+    ++activeTriangles[indices[i]];
+  }
+
+  auto adjacencyOffsets = std::vector<size_t>(vertexCount + 1, 0);
+  for (size_t i = 0; i < vertexCount; ++i)
+  {
+    adjacencyOffsets[i + 1] = adjacencyOffsets[i] + activeTriangles[i];
+  }
+
+  auto adjacency = std::vector<size_t>(indexCount);
+  auto adjacencyFill =
+    std::vector<size_t>(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+  for (size_t t = 0; t < triangleCount; ++t)
+  {
+    for (size_t k = 0; k < 3; ++k)
+    {
+      adjacency[adjacencyFill[indices[3 * t + k]]++] = t;
+    }
+  }
+
+  auto cachePosition = std::vector<int>(vertexCount, -1);
+  auto vertexScores = std::vector<float>(vertexCount);
+  for (size_t i = 0; i < vertexCount; ++i)
+  {
+    vertexScores[i] = vertexScore(-1, activeTriangles[i]);
+  }
+
+  auto emitted = std::vector<bool>(triangleCount, false);
+
+  auto result = std::vector<std::uint32_t>{};
+  result.reserve(indexCount);
+
+  auto cache = std::vector<std::uint32_t>{};
+  auto newCache = std::vector<std::uint32_t>{};
+  cache.reserve(ForsythCacheSize + 3);
+  newCache.reserve(ForsythCacheSize + 3);
+
+  auto nextUnemitted = size_t(0);
+  auto bestTriangle = std::numeric_limits<size_t>::max();
+
+  for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+  {
+    if (bestTriangle == std::numeric_limits<size_t>::max())
+    {
+      // no candidate among the cached vertices, fall back to the next unemitted triangle
+      while (emitted[nextUnemitted])
+      {
+        ++nextUnemitted;
+      }
+      bestTriangle = nextUnemitted;
+    }
+
+    emitted[bestTriangle] = true;
+
+    // emit the triangle and move its vertices to the front of the cache
+    newCache.clear();
+    for (size_t k = 0; k < 3; ++k)
+    {
+      const auto v = indices[3 * bestTriangle + k];
+      result.push_back(v);
+      newCache.push_back(v);
+
+      // remove the triangle from the vertex' adjacency list
+      const auto begin = adjacency.begin() + std::ptrdiff_t(adjacencyOffsets[v]);
+      const auto end = begin + std::ptrdiff_t(activeTriangles[v]);
+      const auto it = std::find(begin, end, bestTriangle);
+      assert(it != end);
+      std::iter_swap(it, end - 1);
+      --activeTriangles[v];
+    }
+    for (const auto v : cache)
+    {
+      if (std::find(newCache.begin(), newCache.end(), v) == newCache.end())
+      {
+        newCache.push_back(v);
+      }
+    }
+
+    // update the scores of the cached vertices and of the vertices that were evicted
+    for (size_t i = 0; i < newCache.size(); ++i)
+    {
+      const auto v = newCache[i];
+      cachePosition[v] = i < ForsythCacheSize ? int(i) : -1;
+      vertexScores[v] = vertexScore(cachePosition[v], activeTriangles[v]);
+    }
+    newCache.resize(std::min(newCache.size(), ForsythCacheSize));
+    std::swap(cache, newCache);
+
+    // find the best triangle adjacent to the cached vertices
+    bestTriangle = std::numeric_limits<size_t>::max();
+    auto bestScore = -1.0f;
+    for (const auto v : cache)
+    {
+      for (size_t j = 0; j < activeTriangles[v]; ++j)
+      {
+        const auto t = adjacency[adjacencyOffsets[v] + j];
+        const auto score = vertexScores[indices[3 * t + 0]]
+                           + vertexScores[indices[3 * t + 1]]
+                           + vertexScores[indices[3 * t + 2]];
+        if (score > bestScore)
+        {
+          bestScore = score;
+          bestTriangle = t;
+        }
+      }
+    }
+  }
+
+  std::copy(result.begin(), result.end(), indices);
+}
+
+/**
+ * Reorders the vertices of the given mesh in the order in which they are first referenced
+ * and drops unreferenced vertices.
+ */
+void optimizeVertexFetch(EntityModelTriangleMesh& mesh)
+{
+  constexpr auto Unmapped = std::numeric_limits<std::uint32_t>::max();
+
+  auto remap = std::vector<std::uint32_t>(mesh.vertices.size(), Unmapped);
+  auto vertices = std::vector<EntityModelVertex>{};
+  vertices.reserve(mesh.vertices.size());
+
+  for (auto& index : mesh.indices)
+  {
+    if (remap[index] == Unmapped)
+    {
+      remap[index] = std::uint32_t(vertices.size());
+      vertices.push_back(mesh.vertices[index]);
+    }
+    index = remap[index];
+  }
+
+  vertices.shrink_to_fit();
+  mesh.vertices = std::move(vertices);
+}
+} // namespace
+
+EntityModelTriangleMesh triangulateMesh(
+  std::vector<EntityModelVertex> vertices, const EntityModelIndices& indices)
+{
+  auto result = EntityModelTriangleMesh{std::move(vertices), {}, {}};
+  indices.forEachPrimitive(
+    [&](const Renderer::PrimType primType, const size_t index, const size_t count) {
+      triangulate(primType, index, count, result.indices);
+    });
+  result.groups.push_back({nullptr, 0, result.indices.size()});
+  return result;
+}
+
+EntityModelTriangleMesh triangulateMesh(
+  std::vector<EntityModelVertex> vertices, const EntityModelTexturedIndices& indices)
+{
+  auto indicesPerTexture =
+    std::unordered_map<const Texture*, std::vector<std::uint32_t>>{};
+  auto textures = std::vector<const Texture*>{};
+  indices.forEachPrimitive([&](
+                             const Texture* texture,
+                             const Renderer::PrimType primType,
+                             const size_t index,
+                             const size_t count) {
+    auto [it, inserted] = indicesPerTexture.try_emplace(texture);
+    if (inserted)
+    {
+      textures.push_back(texture);
+    }
+    triangulate(primType, index, count, it->second);
+  });
+
+  auto result = EntityModelTriangleMesh{std::move(vertices), {}, {}};
+  for (const auto* texture : textures)
+  {
+    const auto& textureIndices = indicesPerTexture[texture];
+    result.groups.push_back({texture, result.indices.size(), textureIndices.size()});
+    result.indices.insert(
+      result.indices.end(), textureIndices.begin(), textureIndices.end());
+  }
+  return result;
+}
+
+EntityModelTriangleMesh optimizeMesh(EntityModelTriangleMesh mesh)
+{
+  weldVertices(mesh);
+  for (const auto& group : mesh.groups)
+  {
+    optimizeVertexCache(
+      mesh.indices.data() + group.offset, group.count, mesh.vertices.size());
+  }
+  optimizeVertexFetch(mesh);
+  mesh.indices.shrink_to_fit();
+  return mesh;
+}
+
+float computeACMR(const std::vector<std::uint32_t>& indices, const size_t cacheSize)
+{
+  const auto triangleCount = indices.size() / 3;
+  if (triangleCount == 0)
+  {
+    return 0.0f;
+  }
+
+  auto cache = std::deque<std::uint32_t>{};
+  auto misses = size_t(0);
+  for (const auto index : indices)
+  {
+    if (std::find(cache.begin(), cache.end(), index) == cache.end())
+    {
+      ++misses;
+      cache.push_back(index);
+      if (cache.size() > cacheSize)
+      {
+        cache.pop_front();
+      }
+    }
+  }
+
+  return float(misses) / float(triangleCount);
+}
+} // namespace Assets
+} // namespace TrenchBroom
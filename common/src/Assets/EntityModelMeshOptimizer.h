@@ -0,0 +1,84 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Assets/EntityModel_Forward.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Assets
+{
+class Texture;
+
+/**
+ * A mesh consisting of triangle lists that share a vertex array. Each group of triangles
+ * is associated with a texture.
+ */
+struct EntityModelTriangleMesh
+{
+  struct Group
+  {
+    const Texture* texture;
+    size_t offset;
+    size_t count;
+  };
+
+  std::vector<EntityModelVertex> vertices;
+  std::vector<std::uint32_t> indices;
+  std::vector<Group> groups;
+};
+
+/**
+ * Converts the primitives of the given mesh into triangle lists without changing the
+ * vertices. All triangles end up in a single group with a null texture.
+ */
+EntityModelTriangleMesh triangulateMesh(
+  std::vector<EntityModelVertex> vertices, const EntityModelIndices& indices);
+
+/**
+ * Converts the primitives of the given mesh into triangle lists without changing the
+ * vertices. The triangles are grouped by their textures.
+ */
+EntityModelTriangleMesh triangulateMesh(
+  std::vector<EntityModelVertex> vertices, const EntityModelTexturedIndices& indices);
+
+/**
+ * Optimizes the given triangle mesh for rendering:
+ *
+ * - identical vertices are welded and degenerate triangles are removed,
+ * - the triangles of each group are reordered for post-transform vertex cache locality
+ *   (Tom Forsyth, "Linear-Speed Vertex Cache Optimisation"),
+ * - the vertices are reordered by their first use so that vertex fetches are mostly
+ *   sequential.
+ */
+EntityModelTriangleMesh optimizeMesh(EntityModelTriangleMesh mesh);
+
+/**
+ * Returns the average cache miss ratio, that is, the number of vertex shader invocations
+ * per triangle when rendering the given triangle list with a FIFO post-transform vertex
+ * cache of the given size. The result ranges from 0.5 for a very regular mesh to 3 for a
+ * mesh that does not share any vertices.
+ */
+float computeACMR(const std::vector<std::uint32_t>& indices, size_t cacheSize = 16);
+} // namespace Assets
+} // namespace TrenchBroom
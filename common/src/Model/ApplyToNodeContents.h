@@ -0,0 +1,257 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Model/BezierPatch.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceHandle.h"
+#include "Model/BrushFaceTexturing.h"
+#include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/Group.h"
+#include "Model/GroupNode.h"
+#include "Model/Layer.h"
+#include "Model/LayerNode.h"
+#include "Model/NodeContents.h"
+#include "Model/PatchNode.h"
+#include "Model/WorldNode.h"
+
+#include <kdl/overload.h>
+#include <kdl/parallel.h>
+#include <kdl/vector_utils.h>
+
+#include <atomic>
+#include <optional>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+/**
+ * Wraps a lambda that may be called concurrently for the contents of different nodes.
+ *
+ * Passing a wrapped lambda to applyToNodeContents or applyToBrushFaces applies it to the
+ * node contents or faces in parallel. The lambda must therefore not modify any state
+ * that is shared between calls unless that state is synchronized, and it must not log.
+ */
+template <typename L>
+struct ThreadSafe
+{
+  L lambda;
+};
+
+template <typename L>
+ThreadSafe<L> threadSafe(L lambda)
+{
+  return ThreadSafe<L>{std::move(lambda)};
+}
+
+namespace detail
+{
+using NodeContentType = std::variant<Layer, Group, Entity, Brush, BezierPatch>;
+
+inline NodeContentType copyNodeContents(const Node* node)
+{
+  return node->accept(kdl::overload(
+    [](const WorldNode* worldNode) -> NodeContentType { return worldNode->entity(); },
+    [](const LayerNode* layerNode) -> NodeContentType { return layerNode->layer(); },
+    [](const GroupNode* groupNode) -> NodeContentType { return groupNode->group(); },
+    [](const EntityNode* entityNode) -> NodeContentType { return entityNode->entity(); },
+    [](const BrushNode* brushNode) -> NodeContentType { return brushNode->brush(); },
+    [](const PatchNode* patchNode) -> NodeContentType { return patchNode->patch(); }));
+}
+
+template <typename L>
+std::optional<BrushFaceTexturing> applyToFaceCopy(
+  const BrushFaceHandle& faceHandle, L& lambda)
+{
+  const auto& face = faceHandle.face();
+
+  // face copies do not reference the geometry, but the lambda may need it
+  auto faceCopy = face;
+  faceCopy.setGeometry(face.geometry());
+
+  if (!lambda(faceCopy))
+  {
+    return std::nullopt;
+  }
+
+  return BrushFaceTexturing{
+    faceHandle, faceCopy.attributes(), faceCopy.texCoordSystem().clone()};
+}
+} // namespace detail
+
+/**
+ * Applies the given lambda to a copy of the contents of each of the given nodes and
+ * returns a vector of pairs of the original node and the modified contents.
+ *
+ * The lambda L needs three overloads:
+ * - bool operator()(Model::Entity&);
+ * - bool operator()(Model::Brush&);
+ * - bool operator()(Model::BezierPatch&);
+ *
+ * The given node contents should be modified in place and the lambda should return true
+ * if it was applied successfully and false otherwise.
+ *
+ * Returns a vector of pairs which map each node to its modified contents if the lambda
+ * succeeded for every given node, or an empty optional otherwise.
+ */
+template <typename N, typename L>
+std::optional<std::vector<std::pair<Node*, NodeContents>>> applyToNodeContents(
+  const std::vector<N*>& nodes, L lambda)
+{
+  auto newNodes = std::vector<std::pair<Node*, NodeContents>>{};
+  newNodes.reserve(nodes.size());
+
+  for (auto* node : nodes)
+  {
+    auto nodeContents = detail::copyNodeContents(node);
+    if (!std::visit(lambda, nodeContents))
+    {
+      return std::nullopt;
+    }
+    newNodes.emplace_back(node, NodeContents{std::move(nodeContents)});
+  }
+
+  return newNodes;
+}
+
+/**
+ * Like applyToNodeContents above, but copies the node contents and applies the given
+ * lambda to them in parallel.
+ *
+ * Once the lambda has failed for any node, it is not applied to nodes that have not been
+ * processed yet.
+ */
+template <typename N, typename L>
+std::optional<std::vector<std::pair<Node*, NodeContents>>> applyToNodeContents(
+  const std::vector<N*>& nodes, ThreadSafe<L> threadSafeLambda)
+{
+  const auto& lambda = threadSafeLambda.lambda;
+  auto failed = std::atomic<bool>{false};
+
+  auto newNodes = kdl::vec_parallel_transform(
+    nodes, [&](N* node) -> std::optional<std::pair<Node*, NodeContents>> {
+      if (failed)
+      {
+        return std::nullopt;
+      }
+
+      auto nodeContents = detail::copyNodeContents(node);
+      if (!std::visit(lambda, nodeContents))
+      {
+        failed = true;
+        return std::nullopt;
+      }
+      return std::make_pair(node, NodeContents{std::move(nodeContents)});
+    });
+
+  if (failed)
+  {
+    return std::nullopt;
+  }
+
+  return kdl::vec_transform(std::move(newNodes), [](auto&& newNode) {
+    return std::move(*newNode);
+  });
+}
+
+/**
+ * Applies the given lambda to a copy of each of the given faces.
+ *
+ * Only the faces are copied and not their brushes. The copies share the geometry of the
+ * original faces, so the lambda can query the face geometry, but it must only change the
+ * attributes and the texture coordinate system of the face.
+ *
+ * The lambda L needs to accept brush faces:
+ * - bool operator()(Model::BrushFace&);
+ *
+ * The given faces should be modified in place and the lambda should return true if it was
+ * applied successfully and false otherwise.
+ *
+ * Returns the modified texturing of every given face if the lambda succeeded for every
+ * given face, or an empty optional otherwise.
+ */
+template <typename L>
+std::optional<std::vector<BrushFaceTexturing>> applyToBrushFaces(
+  const std::vector<BrushFaceHandle>& faces, L lambda)
+{
+  auto newTexturing = std::vector<BrushFaceTexturing>{};
+  newTexturing.reserve(faces.size());
+
+  for (const auto& faceHandle : faces)
+  {
+    auto texturing = detail::applyToFaceCopy(faceHandle, lambda);
+    if (!texturing)
+    {
+      return std::nullopt;
+    }
+    newTexturing.push_back(std::move(*texturing));
+  }
+
+  return newTexturing;
+}
+
+/**
+ * Like applyToBrushFaces above, but applies the given lambda to the face copies in
+ * parallel.
+ *
+ * Once the lambda has failed for any face, it is not applied to faces that have not been
+ * processed yet.
+ */
+template <typename L>
+std::optional<std::vector<BrushFaceTexturing>> applyToBrushFaces(
+  const std::vector<BrushFaceHandle>& faces, ThreadSafe<L> threadSafeLambda)
+{
+  const auto& lambda = threadSafeLambda.lambda;
+  auto failed = std::atomic<bool>{false};
+
+  auto newTexturing = kdl::vec_parallel_transform(
+    faces, [&](const BrushFaceHandle& faceHandle) -> std::optional<BrushFaceTexturing> {
+      if (failed)
+      {
+        return std::nullopt;
+      }
+
+      auto texturing = detail::applyToFaceCopy(faceHandle, lambda);
+      if (!texturing)
+      {
+        failed = true;
+      }
+      return texturing;
+    });
+
+  if (failed)
+  {
+    return std::nullopt;
+  }
+
+  return kdl::vec_transform(
+    std::move(newTexturing), [](std::optional<BrushFaceTexturing>&& texturing) {
+      return std::move(*texturing);
+    });
+}
+} // namespace Model
+} // namespace TrenchBroom
@@ -24,16 +24,30 @@
 
 #include <vecmath/bbox_io.h>
 #include <vecmath/bezier_surface.h>
+#include <vecmath/mat.h>
 #include <vecmath/vec_io.h>
 
 #include <kdl/reflection_impl.h>
 
+#include <array>
 #include <cassert>
+#include <optional>
 
 namespace TrenchBroom
 {
 namespace Model
 {
+struct BezierPatch::Revision
+{
+  /**
+   * If the control points of this revision were computed by transforming the control
+   * points of another revision, then this refers to that revision and the transformation
+   * that was applied to it.
+   */
+  std::weak_ptr<const Revision> source;
+  vm::mat4x4 sourceTransformation;
+};
+
 static vm::bbox3 computeBounds(const std::vector<BezierPatch::Point>& points)
 {
   vm::bbox3::builder builder;
@@ -54,6 +68,7 @@ BezierPatch::BezierPatch(
   , m_controlPoints{std::move(controlPoints)}
   , m_bounds(computeBounds(m_controlPoints))
   , m_textureName{std::move(textureName)}
+  , m_revision{std::make_shared<const Revision>()}
 {
   ensure(
     m_pointRowCount > 2 && m_pointColumnCount > 2,
@@ -123,6 +138,7 @@ void BezierPatch::setControlPoint(const size_t row, const size_t col, Point cont
   assert(col < m_pointColumnCount);
   m_controlPoints[row * m_pointColumnCount + col] = std::move(controlPoint);
   m_bounds = computeBounds(m_controlPoints);
+  m_revision = std::make_shared<const Revision>();
 }
 
 const vm::bbox3& BezierPatch::bounds() const
@@ -166,6 +182,34 @@ void BezierPatch::transform(const vm::mat4x4& transformation)
     builder.add(controlPoint.xyz());
   }
   m_bounds = builder.bounds();
+
+  // Bezier surfaces are invariant under affine transformations, so the grid of the
+  // transformed patch is the transformed grid of this patch
+  m_revision = std::make_shared<const Revision>(Revision{m_revision, transformation});
+}
+
+std::optional<vm::mat4x4> BezierPatch::gridTransformation(
+  const BezierPatch& original) const
+{
+  if (m_revision && original.m_revision)
+  {
+    if (m_revision->source.lock() == original.m_revision)
+    {
+      return m_revision->sourceTransformation;
+    }
+
+    // the given patch was transformed from this patch, e.g. if a transformation is undone
+    if (original.m_revision->source.lock() == m_revision)
+    {
+      if (const auto [invertible, inverse] =
+            vm::invert(original.m_revision->sourceTransformation);
+          invertible)
+      {
+        return inverse;
+      }
+    }
+  }
+  return std::nullopt;
 }
 
 using SurfaceControlPoints = std::array<std::array<BezierPatch::Point, 3u>, 3u>;
@@ -241,18 +285,80 @@ void evaluateSurface(
   }
 }
 
-std::vector<BezierPatch::Point> BezierPatch::evaluate(
-  const size_t subdivisionsPerSurface) const
+using BernsteinWeights = std::array<FloatType, 3u>;
+
+/**
+ * Returns the values of the three quadratic Bernstein polynomials at 0, 1/n, 2/n, ..., 1
+ * for n = 2^subdivisionsPerSurface.
+ *
+ * The tables are computed once for every supported number of subdivisions.
+ */
+static const std::vector<BernsteinWeights>& bernsteinTable(
+  const size_t subdivisionsPerSurface)
+{
+  constexpr auto MaxSubdivisionsPerSurface = size_t(10);
+
+  // the polynomials are evaluated like in vm::evaluate_quadratic_bezier_surface so that
+  // the grid points are exactly the same
+  using BernsteinTables =
+    std::array<std::vector<BernsteinWeights>, MaxSubdivisionsPerSurface + 1u>;
+  static const auto tables = [] {
+    auto result = BernsteinTables{};
+    for (size_t subdivisions = 0u; subdivisions < result.size(); ++subdivisions)
+    {
+      const auto quadsPerSurfaceSide = size_t(1) << subdivisions;
+      for (size_t i = 0u; i <= quadsPerSurfaceSide; ++i)
+      {
+        const auto x =
+          static_cast<FloatType>(i) / static_cast<FloatType>(quadsPerSurfaceSide);
+        result[subdivisions].push_back(BernsteinWeights{
+          static_cast<FloatType>(1) - static_cast<FloatType>(2) * x + (x * x),
+          static_cast<FloatType>(2) * (x - (x * x)),
+          x * x});
+      }
+    }
+    return result;
+  }();
+
+  ensure(
+    subdivisionsPerSurface <= MaxSubdivisionsPerSurface,
+    "Too many subdivisions per Bezier surface");
+  return tables[subdivisionsPerSurface];
+}
+
+static BezierPatch::Point interpolate(
+  const BernsteinWeights& weights, const std::array<BezierPatch::Point, 3u>& points)
+{
+  // this adds the terms in the same order as vm::evaluate_quadratic_bezier_surface, but
+  // computing each component separately avoids the temporary vectors
+  auto result = BezierPatch::Point{};
+  for (size_t i = 0u; i < BezierPatch::Point::size; ++i)
+  {
+    result[i] = ((static_cast<FloatType>(0) + weights[0] * points[0][i])
+                 + weights[1] * points[1][i])
+                + weights[2] * points[2][i];
+  }
+  return result;
+}
+
+static std::vector<BezierPatch::Point> evaluateGrid(
+  const std::vector<BezierPatch::Point>& controlPoints,
+  const size_t pointRowCount,
+  const size_t pointColumnCount,
+  const size_t subdivisionsPerSurface)
 {
   // collect the control points for each surface in this patch
   const auto allSurfaceControlPoints =
-    collectAllSurfaceControlPoints(m_controlPoints, m_pointRowCount, m_pointColumnCount);
+    collectAllSurfaceControlPoints(controlPoints, pointRowCount, pointColumnCount);
 
-  const auto quadsPerSurfaceSide = (1u << subdivisionsPerSurface);
+  const auto& weights = bernsteinTable(subdivisionsPerSurface);
+  const auto quadsPerSurfaceSide = (size_t(1) << subdivisionsPerSurface);
 
   // determine dimensions of the resulting point grid
-  const size_t gridPointRowCount = surfaceRowCount() * quadsPerSurfaceSide + 1u;
-  const size_t gridPointColumnCount = surfaceColumnCount() * quadsPerSurfaceSide + 1u;
+  const size_t surfaceRowCount = (pointRowCount - 1u) / 2u;
+  const size_t surfaceColumnCount = (pointColumnCount - 1u) / 2u;
+  const size_t gridPointRowCount = surfaceRowCount * quadsPerSurfaceSide + 1u;
+  const size_t gridPointColumnCount = surfaceColumnCount * quadsPerSurfaceSide + 1u;
 
   auto grid = std::vector<BezierPatch::Point>{};
   grid.reserve(gridPointRowCount * gridPointColumnCount);
@@ -305,31 +411,58 @@ std::vector<BezierPatch::Point> BezierPatch::evaluate(
   value of v
   */
 
+  /*
+  A point on a surface is computed by interpolating each of the three rows of control
+  points along u, and then interpolating the three results along v. The first step only
+  depends on the grid column and the surface row, so we compute it once per grid column
+  whenever we move on to the next row of surfaces and reuse it for all grid rows that
+  sample the same surfaces.
+  */
+  auto columnPoints = std::vector<std::array<BezierPatch::Point, 3u>>{};
+  columnPoints.resize(gridPointColumnCount);
+  auto columnPointsSurfaceRow = std::optional<size_t>{};
+
   for (size_t gridRow = 0u; gridRow < gridPointRowCount; ++gridRow)
   {
     const size_t surfaceRow =
       (gridRow > 0u ? gridRow - 1u : gridRow) / quadsPerSurfaceSide;
-    const FloatType v = static_cast<FloatType>(gridRow - surfaceRow * quadsPerSurfaceSide)
-                        / static_cast<FloatType>(quadsPerSurfaceSide);
+    const auto& vWeights = weights[gridRow - surfaceRow * quadsPerSurfaceSide];
+
+    if (columnPointsSurfaceRow != surfaceRow)
+    {
+      for (size_t gridCol = 0u; gridCol < gridPointColumnCount; ++gridCol)
+      {
+        const size_t surfaceCol =
+          (gridCol > 0u ? gridCol - 1u : gridCol) / quadsPerSurfaceSide;
+        const auto& uWeights = weights[gridCol - surfaceCol * quadsPerSurfaceSide];
+
+        const auto& surfaceControlPoints =
+          allSurfaceControlPoints[surfaceRow * surfaceColumnCount + surfaceCol];
+        columnPoints[gridCol] = {
+          interpolate(uWeights, surfaceControlPoints[0]),
+          interpolate(uWeights, surfaceControlPoints[1]),
+          interpolate(uWeights, surfaceControlPoints[2]),
+        };
+      }
+      columnPointsSurfaceRow = surfaceRow;
+    }
 
     for (size_t gridCol = 0u; gridCol < gridPointColumnCount; ++gridCol)
     {
-      const size_t surfaceCol =
-        (gridCol > 0u ? gridCol - 1u : gridCol) / quadsPerSurfaceSide;
-      const FloatType u =
-        static_cast<FloatType>(gridCol - surfaceCol * quadsPerSurfaceSide)
-        / static_cast<FloatType>(quadsPerSurfaceSide);
-
-      const auto& surfaceControlPoints =
-        allSurfaceControlPoints[surfaceRow * surfaceColumnCount() + surfaceCol];
-      auto point = vm::evaluate_quadratic_bezier_surface(surfaceControlPoints, u, v);
-      grid.push_back(std::move(point));
+      grid.push_back(interpolate(vWeights, columnPoints[gridCol]));
     }
   }
 
   return grid;
 }
 
+std::vector<BezierPatch::Point> BezierPatch::evaluate(
+  const size_t subdivisionsPerSurface) const
+{
+  return evaluateGrid(
+    m_controlPoints, m_pointRowCount, m_pointColumnCount, subdivisionsPerSurface);
+}
+
 kdl_reflect_impl(BezierPatch);
 
 } // namespace Model
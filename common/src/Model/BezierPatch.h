@@ -28,6 +28,8 @@
 
 #include <kdl/reflection_decl.h>
 
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -46,6 +48,8 @@ public:
   using Point = vm::vec<FloatType, 5>;
 
 private:
+  struct Revision;
+
   size_t m_pointRowCount;
   size_t m_pointColumnCount;
   std::vector<Point> m_controlPoints;
@@ -54,6 +58,14 @@ private:
   std::string m_textureName;
   Assets::AssetReference<Assets::Texture> m_textureReference;
 
+  /**
+   * Identifies the current control points. Copies of a patch share the revision until
+   * either of them changes. A transformed patch remembers the revision it was transformed
+   * from, so that data derived from the control points can be transformed instead of
+   * being computed again.
+   */
+  std::shared_ptr<const Revision> m_revision;
+
 public:
   BezierPatch(
     size_t pointRowCount,
@@ -91,6 +103,18 @@ public:
 
   void transform(const vm::mat4x4& transformation);
 
+  /**
+   * If this patch is a copy of the given patch that was transformed once and not changed
+   * otherwise, returns the transformation. If the given patch is such a copy of this
+   * patch, returns the inverse transformation. This allows to transform data derived from
+   * the grid of the given patch instead of computing it again.
+   */
+  std::optional<vm::mat4x4> gridTransformation(const BezierPatch& original) const;
+
+  /**
+   * Returns a grid of points on this patch, row by row. Every surface of the patch is
+   * subdivided into 2^subdivisionsPerSurface quads in each direction.
+   */
   std::vector<Point> evaluate(size_t subdivisionsPerSurface) const;
 
   kdl_reflect_decl(
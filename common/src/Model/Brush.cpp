@@ -29,11 +29,13 @@
 #include "Polyhedron.h"
 #include "Polyhedron_Matcher.h"
 
+#include <kdl/interned_string.h>
 #include <kdl/result.h>
 #include <kdl/result_for_each.h>
 #include <kdl/string_utils.h>
 #include <kdl/vector_utils.h>
 
+#include <vecmath/bbox.h>
 #include <vecmath/intersection.h>
 #include <vecmath/mat.h>
 #include <vecmath/mat_ext.h>
@@ -43,6 +45,8 @@
 #include <vecmath/vec.h>
 #include <vecmath/vec_ext.h>
 
+#include <algorithm>
+#include <array>
 #include <iterator>
 #include <set>
 #include <string>
@@ -53,6 +57,64 @@ namespace TrenchBroom
 {
 namespace Model
 {
+namespace
+{
+/**
+ * Checks whether the given transformation is a translation, optionally combined with a
+ * rotation by a multiple of 90 degrees about the coordinate axes. Such a transformation
+ * maps a brush onto a congruent brush with the same topology.
+ */
+bool isAxisAlignedRigidTransformation(const vm::mat4x4& transformation)
+{
+  const auto epsilon = vm::C::almost_zero();
+
+  // the last row must be (0, 0, 0, 1)
+  for (size_t c = 0u; c < 3u; ++c)
+  {
+    if (!vm::is_zero(transformation[c][3], epsilon))
+    {
+      return false;
+    }
+  }
+  if (!vm::is_equal(transformation[3][3], 1.0, epsilon))
+  {
+    return false;
+  }
+
+  // every column and every row of the linear part must contain exactly one entry that is
+  // 1 or -1, and all other entries must be 0
+  auto rows = std::array<bool, 3>{false, false, false};
+  for (size_t c = 0u; c < 3u; ++c)
+  {
+    auto unitCount = 0u;
+    for (size_t r = 0u; r < 3u; ++r)
+    {
+      const auto value = transformation[c][r];
+      if (vm::is_equal(vm::abs(value), 1.0, epsilon))
+      {
+        if (rows[r])
+        {
+          return false;
+        }
+        rows[r] = true;
+        ++unitCount;
+      }
+      else if (!vm::is_zero(value, epsilon))
+      {
+        return false;
+      }
+    }
+    if (unitCount != 1u)
+    {
+      return false;
+    }
+  }
+
+  // exclude mirroring, which would invert the face boundaries
+  return vm::compute_determinant(transformation) > 0.0;
+}
+} // namespace
+
 class Brush::CopyCallback : public BrushGeometry::CopyCallback
 {
 public:
@@ -67,21 +129,12 @@ Brush::Brush() {}
 
 Brush::Brush(const Brush& other)
   : m_faces(other.m_faces)
-  , m_geometry(
-      other.m_geometry
-        ? std::make_unique<BrushGeometry>(*other.m_geometry, CopyCallback())
-        : nullptr)
+  , m_geometry(other.m_geometry)
 {
-  if (m_geometry)
+  // the faces are in the same order, so they can share the face geometries, too
+  for (size_t i = 0u; i < m_faces.size(); ++i)
   {
-    for (BrushFaceGeometry* faceGeometry : m_geometry->faces())
-    {
-      if (const auto faceIndex = faceGeometry->payload())
-      {
-        BrushFace& face = m_faces[*faceIndex];
-        face.setGeometry(faceGeometry);
-      }
-    }
+    m_faces[i].setGeometry(other.m_faces[i].geometry());
   }
 }
 
@@ -126,21 +179,43 @@ kdl::result<void, BrushError> Brush::updateGeometryFromFaces(const vm::bbox3& wo
   // First, add all faces to the brush geometry
   BrushFace::sortFaces(m_faces);
 
-  auto geometry = std::make_unique<BrushGeometry>(worldBounds);
+  auto geometry = std::unique_ptr<BrushGeometry>{};
 
-  for (size_t i = 0u; i < m_faces.size(); ++i)
+  // Most brushes are well formed, so we try to build their geometry directly from the
+  // face planes. This fails for degenerate brushes, which are then handled by clipping.
+  const auto planes = kdl::vec_transform(
+    m_faces, [](const BrushFace& face) { return face.boundary(); });
+  if (auto fromPlanes = BrushGeometry::fromPlanes(planes, worldBounds))
   {
-    BrushFace& face = m_faces[i];
-    const auto result = geometry->clip(face.boundary());
-    if (result.success())
+    geometry = std::make_unique<BrushGeometry>(std::move(*fromPlanes));
+
+    // the faces of the geometry are in the same order as the planes
+    auto i = size_t(0);
+    for (BrushFaceGeometry* faceGeometry : geometry->faces())
     {
-      BrushFaceGeometry* faceGeometry = result.face();
-      face.setGeometry(faceGeometry);
+      m_faces[i].setGeometry(faceGeometry);
       faceGeometry->setPayload(i);
+      ++i;
     }
-    else if (result.empty())
+  }
+  else
+  {
+    geometry = std::make_unique<BrushGeometry>(worldBounds);
+
+    for (size_t i = 0u; i < m_faces.size(); ++i)
     {
-      return BrushError::EmptyBrush;
+      BrushFace& face = m_faces[i];
+      const auto result = geometry->clip(face.boundary());
+      if (result.success())
+      {
+        BrushFaceGeometry* faceGeometry = result.face();
+        face.setGeometry(faceGeometry);
+        faceGeometry->setPayload(i);
+      }
+      else if (result.empty())
+      {
+        return BrushError::EmptyBrush;
+      }
     }
   }
 
@@ -176,16 +251,48 @@ kdl::result<void, BrushError> Brush::updateGeometryFromFaces(const vm::bbox3& wo
   return kdl::void_success;
 }
 
+void Brush::makeGeometryUnique()
+{
+  ensure(m_geometry != nullptr, "geometry is null");
+
+  if (m_geometry.use_count() > 1)
+  {
+    m_geometry = std::make_shared<BrushGeometry>(*m_geometry, CopyCallback());
+    for (BrushFaceGeometry* faceGeometry : m_geometry->faces())
+    {
+      if (const auto faceIndex = faceGeometry->payload())
+      {
+        BrushFace& face = m_faces[*faceIndex];
+        face.setGeometry(faceGeometry);
+      }
+    }
+
+    assert(checkFaceLinks());
+  }
+}
+
 const vm::bbox3& Brush::bounds() const
 {
   ensure(m_geometry != nullptr, "geometry is null");
   return m_geometry->bounds();
 }
 
+bool Brush::sharesGeometryWith(const Brush& other) const
+{
+  return m_geometry != nullptr && m_geometry == other.m_geometry;
+}
+
 std::optional<size_t> Brush::findFace(const std::string& textureName) const
 {
+  // if the name was never interned, then no face can use it
+  const auto internedTextureName = kdl::interned_string::find(textureName);
+  if (!internedTextureName)
+  {
+    return std::nullopt;
+  }
+
   return kdl::vec_index_of(m_faces, [&](const BrushFace& face) {
-    return face.attributes().textureName() == textureName;
+    return face.attributes().internedTextureName() == *internedTextureName;
   });
 }
 
@@ -1149,19 +1256,57 @@ std::vector<kdl::result<Brush, BrushError>> Brush::subtract(
   const std::string& defaultTextureName,
   const std::vector<const Brush*>& subtrahends) const
 {
-  auto result = std::vector<BrushGeometry>{*m_geometry};
-
+  // Only subtrahends whose bounds intersect ours can cut away anything. Subtract the ones
+  // with the largest overlap first because they are likely to remove large parts of this
+  // brush, leaving smaller fragments that the remaining subtrahends can skip.
+  const auto& minuendBounds = bounds();
+  auto overlappingSubtrahends = std::vector<std::pair<FloatType, const Brush*>>{};
   for (const auto* subtrahend : subtrahends)
   {
+    if (minuendBounds.intersects(subtrahend->bounds()))
+    {
+      const auto overlap = vm::intersect(minuendBounds, subtrahend->bounds()).size();
+      overlappingSubtrahends.emplace_back(
+        overlap.x() * overlap.y() * overlap.z(), subtrahend);
+    }
+  }
+  std::stable_sort(
+    std::begin(overlappingSubtrahends),
+    std::end(overlappingSubtrahends),
+    [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+
+  auto result = std::vector<BrushGeometry>{};
+  result.push_back(*m_geometry);
+
+  for (const auto& overlappingSubtrahend : overlappingSubtrahends)
+  {
+    const auto* subtrahend = overlappingSubtrahend.second;
+    const auto& subtrahendBounds = subtrahend->bounds();
+
     auto nextResults = std::vector<BrushGeometry>{};
+    nextResults.reserve(result.size());
 
-    for (const BrushGeometry& fragment : result)
+    for (auto& fragment : result)
     {
-      auto subFragments = fragment.subtract(*subtrahend->m_geometry);
-      nextResults = kdl::vec_concat(std::move(nextResults), std::move(subFragments));
+      if (!fragment.bounds().intersects(subtrahendBounds))
+      {
+        nextResults.push_back(std::move(fragment));
+      }
+      else
+      {
+        auto subFragments = fragment.subtract(*subtrahend->m_geometry);
+        nextResults.insert(
+          std::end(nextResults),
+          std::make_move_iterator(std::begin(subFragments)),
+          std::make_move_iterator(std::end(subFragments)));
+      }
     }
 
     result = std::move(nextResults);
+    if (result.empty())
+    {
+      break;
+    }
   }
 
   return kdl::vec_transform(result, [&](const auto& geometry) {
@@ -1197,9 +1342,58 @@ kdl::result<void, BrushError> Brush::transform(
     }
   }
 
+  if (
+    isAxisAlignedRigidTransformation(transformation)
+    && transformGeometry(worldBounds, transformation))
+  {
+    return kdl::void_success;
+  }
+
   return updateGeometryFromFaces(worldBounds);
 }
 
+bool Brush::transformGeometry(
+  const vm::bbox3& worldBounds, const vm::mat4x4& transformation)
+{
+  makeGeometryUnique();
+
+  m_geometry->transform(transformation);
+  m_geometry->correctVertexPositions();
+  if (!worldBounds.encloses(m_geometry->bounds()))
+  {
+    return false;
+  }
+
+  // The face points are rounded when the faces are transformed, so we must check that
+  // the vertices still lie on the face boundaries.
+  for (auto& face : m_faces)
+  {
+    BrushFaceGeometry* faceGeometry = face.geometry();
+    faceGeometry->setPlane(face.boundary());
+
+    for (const BrushHalfEdge* halfEdge : faceGeometry->boundary())
+    {
+      const auto& position = halfEdge->origin()->position();
+      if (
+        vm::abs(face.boundary().point_distance(position))
+        > vm::C::point_status_epsilon())
+      {
+        return false;
+      }
+    }
+  }
+
+  // keep the faces in the same order as if the geometry had been rebuilt
+  BrushFace::sortFaces(m_faces);
+  for (size_t i = 0u; i < m_faces.size(); ++i)
+  {
+    m_faces[i].geometry()->setPayload(i);
+  }
+
+  assert(checkFaceLinks());
+  return true;
+}
+
 bool Brush::contains(const vm::bbox3& bounds) const
 {
   if (!this->bounds().contains(bounds))
@@ -58,7 +58,12 @@ public:
 
 private:
   std::vector<BrushFace> m_faces;
-  std::unique_ptr<BrushGeometry> m_geometry;
+
+  /**
+   * The geometry is shared between copies of this brush. It must only be modified in
+   * place after calling makeGeometryUnique.
+   */
+  std::shared_ptr<BrushGeometry> m_geometry;
 
 public:
   Brush();
@@ -79,9 +84,30 @@ private:
 
   kdl::result<void, BrushError> updateGeometryFromFaces(const vm::bbox3& worldBounds);
 
+  /**
+   * Copies the geometry of this brush if it is shared with other brushes.
+   */
+  void makeGeometryUnique();
+
+  /**
+   * Applies the given transformation to the geometry of this brush without rebuilding it.
+   * Must be called after the faces have been transformed, and only for transformations
+   * that cannot change the topology of this brush.
+   *
+   * @return true if the transformed geometry matches the transformed faces, and false if
+   * the geometry must be rebuilt
+   */
+  bool transformGeometry(const vm::bbox3& worldBounds, const vm::mat4x4& transformation);
+
 public:
   const vm::bbox3& bounds() const;
 
+  /**
+   * Indicates whether this brush shares its geometry with the given brush. Copies of a
+   * brush share its geometry until either of them is modified.
+   */
+  bool sharesGeometryWith(const Brush& other) const;
+
 public: // face management:
   std::optional<size_t> findFace(const std::string& textureName) const;
   std::optional<size_t> findFace(const vm::vec3& normal) const;
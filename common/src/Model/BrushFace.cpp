@@ -43,6 +43,7 @@
 #include <vecmath/plane.h>
 #include <vecmath/plane_io.h>
 #include <vecmath/polygon.h>
+#include <vecmath/ray.h>
 #include <vecmath/scalar.h>
 #include <vecmath/util.h>
 #include <vecmath/vec.h>
@@ -443,6 +444,16 @@ bool BrushFace::setAttributes(const BrushFace& other)
   return result;
 }
 
+void BrushFace::swapTexturing(
+  BrushFaceAttributes& attributes, std::unique_ptr<TexCoordSystem>& texCoordSystem)
+{
+  ensure(texCoordSystem != nullptr, "texCoordSystem is null");
+
+  using std::swap;
+  swap(m_attributes, attributes);
+  swap(m_texCoordSystem, texCoordSystem);
+}
+
 int BrushFace::resolvedSurfaceContents() const
 {
   if (m_attributes.surfaceContents())
@@ -846,23 +857,30 @@ vm::vec2f BrushFace::textureCoords(const vm::vec3& point) const
 }
 
 FloatType BrushFace::intersectWithRay(const vm::ray3& ray) const
+{
+  return intersectWithRay(ray, vm::intersect_ray_plane(ray, m_boundary));
+}
+
+FloatType BrushFace::intersectWithRay(
+  const vm::ray3& ray, const FloatType boundaryDistance) const
 {
   ensure(m_geometry != nullptr, "geometry is null");
 
   const FloatType cos = dot(m_boundary.normal, ray.direction);
-  if (cos >= FloatType(0.0))
+  if (cos >= FloatType(0.0) || vm::is_nan(boundaryDistance))
   {
     return vm::nan<FloatType>();
   }
-  else
-  {
-    return vm::intersect_ray_polygon(
-      ray,
-      m_boundary,
-      m_geometry->boundary().begin(),
-      m_geometry->boundary().end(),
-      BrushGeometry::GetVertexPosition());
-  }
+
+  const auto point = vm::point_at_distance(ray, boundaryDistance);
+  return vm::polygon_contains_point(
+           point,
+           m_boundary.normal,
+           m_geometry->boundary().begin(),
+           m_geometry->boundary().end(),
+           BrushGeometry::GetVertexPosition())
+           ? boundaryDistance
+           : vm::nan<FloatType>();
 }
 
 kdl::result<void, BrushError> BrushFace::setPoints(
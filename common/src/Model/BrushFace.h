@@ -203,6 +203,13 @@ public:
   void setAttributes(const BrushFaceAttributes& attributes);
   bool setAttributes(const BrushFace& other);
 
+  /**
+   * Swaps the attributes and the texture coordinate system of this face with the given
+   * ones. The texture of this face is not changed.
+   */
+  void swapTexturing(
+    BrushFaceAttributes& attributes, std::unique_ptr<TexCoordSystem>& texCoordSystem);
+
   int resolvedSurfaceContents() const;
   int resolvedSurfaceFlags() const;
   float resolvedSurfaceValue() const;
@@ -269,6 +276,12 @@ public:
 
   FloatType intersectWithRay(const vm::ray3& ray) const;
 
+  /**
+   * Intersects the given ray with this face, given the distance at which the ray hits the
+   * boundary plane of this face, e.g. as computed by vm::intersect_ray_planes.
+   */
+  FloatType intersectWithRay(const vm::ray3& ray, FloatType boundaryDistance) const;
+
 private:
   kdl::result<void, BrushError> setPoints(
     const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2);
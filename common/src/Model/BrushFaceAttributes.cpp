@@ -26,6 +26,7 @@
 
 #include <kdl/reflection_impl.h>
 
+#include <memory>
 #include <string>
 
 namespace TrenchBroom
@@ -39,8 +40,6 @@ BrushFaceAttributes::BrushFaceAttributes(std::string_view textureName)
   , m_offset(vm::vec2f::zero())
   , m_scale(vm::vec2f(1.0f, 1.0f))
   , m_rotation(0.0f)
-  , m_bpMode(false)
-  , m_bpMatrix(vm::mat4x4f::identity())
 {
 }
 
@@ -52,9 +51,7 @@ BrushFaceAttributes::BrushFaceAttributes(const BrushFaceAttributes& other)
   , m_surfaceContents(other.m_surfaceContents)
   , m_surfaceFlags(other.m_surfaceFlags)
   , m_surfaceValue(other.m_surfaceValue)
-  , m_color(other.m_color)
-  , m_bpMode(other.m_bpMode)
-  , m_bpMatrix(other.m_bpMatrix)
+  , m_extendedAttributes(other.m_extendedAttributes)
 {
 }
 
@@ -67,9 +64,7 @@ BrushFaceAttributes::BrushFaceAttributes(
   , m_surfaceContents(other.m_surfaceContents)
   , m_surfaceFlags(other.m_surfaceFlags)
   , m_surfaceValue(other.m_surfaceValue)
-  , m_color(other.m_color)
-  , m_bpMode(other.m_bpMode)
-  , m_bpMatrix(other.m_bpMatrix)
+  , m_extendedAttributes(other.m_extendedAttributes)
 {
 }
 
@@ -92,12 +87,15 @@ void swap(BrushFaceAttributes& lhs, BrushFaceAttributes& rhs)
   swap(lhs.m_surfaceContents, rhs.m_surfaceContents);
   swap(lhs.m_surfaceFlags, rhs.m_surfaceFlags);
   swap(lhs.m_surfaceValue, rhs.m_surfaceValue);
-  swap(lhs.m_color, rhs.m_color);
-  swap(lhs.m_bpMode, rhs.m_bpMode);
-  swap(lhs.m_bpMatrix, rhs.m_bpMatrix);
+  swap(lhs.m_extendedAttributes, rhs.m_extendedAttributes);
 }
 
 const std::string& BrushFaceAttributes::textureName() const
+{
+  return m_textureName.str();
+}
+
+const kdl::interned_string& BrushFaceAttributes::internedTextureName() const
 {
   return m_textureName;
 }
@@ -165,12 +163,12 @@ const std::optional<float>& BrushFaceAttributes::surfaceValue() const
 
 bool BrushFaceAttributes::hasColor() const
 {
-  return m_color.has_value();
+  return color().has_value();
 }
 
 const std::optional<Color>& BrushFaceAttributes::color() const
 {
-  return m_color;
+  return extendedAttributes().color;
 }
 
 bool BrushFaceAttributes::valid() const
@@ -181,13 +179,14 @@ bool BrushFaceAttributes::valid() const
 
 bool BrushFaceAttributes::setTextureName(const std::string& textureName)
 {
-  if (textureName == m_textureName)
+  auto internedTextureName = kdl::interned_string{textureName};
+  if (internedTextureName == m_textureName)
   {
     return false;
   }
   else
   {
-    m_textureName = textureName;
+    m_textureName = std::move(internedTextureName);
     return true;
   }
 }
@@ -324,34 +323,58 @@ bool BrushFaceAttributes::setSurfaceValue(const std::optional<float>& surfaceVal
 
 bool BrushFaceAttributes::setColor(const std::optional<Color>& color)
 {
-  if (color == m_color)
+  if (color == this->color())
   {
     return false;
   }
   else
   {
-    m_color = color;
+    mutableExtendedAttributes().color = color;
     return true;
   }
 }
 
+bool BrushFaceAttributes::hasBrushPrimitMode() const
+{
+  return extendedAttributes().bpMode;
+}
+
 bool BrushFaceAttributes::setBrushPrimitMatrix(const vm::mat4x4f& matrix)
 {
-  if (matrix == m_bpMatrix)
+  if (matrix == bpMatrix())
   {
     return false;
   }
   else
   {
-    m_bpMode = true;
-    m_bpMatrix = matrix;
+    auto& extendedAttributes = mutableExtendedAttributes();
+    extendedAttributes.bpMode = true;
+    extendedAttributes.bpMatrix = matrix;
     return true;
   }
 }
 
 const vm::mat4x4f& BrushFaceAttributes::bpMatrix() const
 {
-  return m_bpMatrix;
+  return extendedAttributes().bpMatrix;
+}
+
+const BrushFaceAttributes::ExtendedAttributes& BrushFaceAttributes::extendedAttributes()
+  const
+{
+  static const auto defaultAttributes = ExtendedAttributes{};
+  return m_extendedAttributes ? *m_extendedAttributes : defaultAttributes;
+}
+
+BrushFaceAttributes::ExtendedAttributes& BrushFaceAttributes::mutableExtendedAttributes()
+{
+  // the extended attributes may be shared with other copies, so we must copy them
+  if (!m_extendedAttributes || m_extendedAttributes.use_count() > 1)
+  {
+    m_extendedAttributes =
+      std::make_shared<ExtendedAttributes>(this->extendedAttributes());
+  }
+  return *m_extendedAttributes;
 }
 
 } // namespace Model
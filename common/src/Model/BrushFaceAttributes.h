@@ -24,8 +24,10 @@
 #include <vecmath/forward.h>
 #include <vecmath/mat.h>
 
+#include <kdl/interned_string.h>
 #include <kdl/reflection_decl.h>
 
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -46,7 +48,22 @@ public:
   static const std::string NoTextureName;
 
 private:
-  std::string m_textureName;
+  /**
+   * Attributes that only few map formats use. They are stored out of line and shared
+   * between copies so that they do not take up space in every face.
+   */
+  struct ExtendedAttributes
+  {
+    std::optional<Color> color;
+
+    // RB: Quake 3 / Doom 3 brush primitives that require the ComputeAxisBase rule for
+    // projection
+    bool bpMode = false;
+    // usually 2x3 affine transform in 2D space
+    vm::mat4x4f bpMatrix = vm::mat4x4f::identity();
+  };
+
+  kdl::interned_string m_textureName;
 
   vm::vec2f m_offset;
   vm::vec2f m_scale;
@@ -56,12 +73,7 @@ private:
   std::optional<int> m_surfaceFlags;
   std::optional<float> m_surfaceValue;
 
-  std::optional<Color> m_color;
-
-  // RB: Quake 3 / Doom 3 brush primitives that require the ComputeAxisBase rule for
-  // projection
-  bool m_bpMode;
-  vm::mat4x4f m_bpMatrix; // usually 2x3 affine transform in 2D space
+  std::shared_ptr<ExtendedAttributes> m_extendedAttributes;
 
 public:
   explicit BrushFaceAttributes(std::string_view textureName);
@@ -79,11 +91,16 @@ public:
     m_surfaceContents,
     m_surfaceFlags,
     m_surfaceValue,
-    m_color);
+    color());
 
   friend void swap(BrushFaceAttributes& lhs, BrushFaceAttributes& rhs);
 
   const std::string& textureName() const;
+  /**
+   * Returns the texture name as an interned string. Comparing interned strings only
+   * compares their addresses.
+   */
+  const kdl::interned_string& internedTextureName() const;
 
   const vm::vec2f& offset() const;
   float xOffset() const;
@@ -119,9 +136,13 @@ public:
   bool setSurfaceValue(const std::optional<float>& surfaceValue);
   bool setColor(const std::optional<Color>& color);
 
-  bool hasBrushPrimitMode() const { return m_bpMode; }
+  bool hasBrushPrimitMode() const;
   bool setBrushPrimitMatrix(const vm::mat4x4f& matrix);
   const vm::mat4x4f& bpMatrix() const;
+
+private:
+  const ExtendedAttributes& extendedAttributes() const;
+  ExtendedAttributes& mutableExtendedAttributes();
 };
 
 } // namespace Model
@@ -0,0 +1,46 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Model/BrushFaceAttributes.h"
+#include "Model/BrushFaceHandle.h"
+#include "Model/TexCoordSystem.h"
+
+#include <memory>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+/**
+ * The state that determines how a brush face is textured, namely its attributes and its
+ * texture coordinate system.
+ *
+ * Changing only this state leaves the brush geometry intact, so it can be swapped into
+ * the face without copying the brush.
+ */
+struct BrushFaceTexturing
+{
+  BrushFaceHandle faceHandle;
+  BrushFaceAttributes attributes;
+  std::unique_ptr<TexCoordSystem> texCoordSystem;
+};
+} // namespace Model
+} // namespace TrenchBroom
@@ -158,6 +158,17 @@ void BrushNode::setFaceTexture(const size_t faceIndex, Assets::Texture* texture)
   invalidateVertexCache();
 }
 
+void BrushNode::swapFaceTexturing(
+  const size_t faceIndex,
+  BrushFaceAttributes& attributes,
+  std::unique_ptr<TexCoordSystem>& texCoordSystem)
+{
+  m_brush.face(faceIndex).swapTexturing(attributes, texCoordSystem);
+
+  invalidateIssues();
+  invalidateVertexCache();
+}
+
 static bool containsPatch(const Brush& brush, const PatchGrid& grid)
 {
   if (!brush.bounds().contains(grid.bounds))
@@ -389,10 +400,22 @@ std::optional<std::tuple<FloatType, size_t>> BrushNode::findFaceHit(
 {
   if (!vm::is_nan(vm::intersect_ray_bbox(ray, logicalBounds())))
   {
+    // intersect the ray with the boundary planes of all faces at once, then only test the
+    // faces whose boundary planes are hit
+    thread_local auto boundaries = vm::plane_batch<FloatType, 3>{};
+    thread_local auto distances = std::vector<FloatType>{};
+
+    boundaries.clear();
+    for (const auto& face : m_brush.faces())
+    {
+      boundaries.push_back(face.boundary());
+    }
+    distances.resize(boundaries.size());
+    vm::intersect_ray_planes(ray, boundaries, distances.data());
+
     for (size_t i = 0u; i < m_brush.faceCount(); ++i)
     {
-      const auto& face = m_brush.face(i);
-      const auto distance = face.intersectWithRay(ray);
+      const auto distance = m_brush.face(i).intersectWithRay(ray, distances[i]);
       if (!vm::is_nan(distance))
       {
         return std::make_tuple(distance, i);
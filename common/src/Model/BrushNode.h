@@ -52,10 +52,12 @@ class BrushRendererBrushCache;
 namespace Model
 {
 class BrushFace;
+class BrushFaceAttributes;
 class GroupNode;
 class LayerNode;
 
 class ModelFactory;
+class TexCoordSystem;
 
 class BrushNode : public Node, public Object
 {
@@ -93,6 +95,15 @@ public:
 
   void setFaceTexture(size_t faceIndex, Assets::Texture* texture);
 
+  /**
+   * Swaps the attributes and the texture coordinate system of the face with the given
+   * index with the given ones. The brush geometry is not affected.
+   */
+  void swapFaceTexturing(
+    size_t faceIndex,
+    BrushFaceAttributes& attributes,
+    std::unique_ptr<TexCoordSystem>& texCoordSystem);
+
   bool contains(const Node* node) const;
   bool intersects(const Node* node) const;
 
@@ -19,7 +19,6 @@
 
 #include "CompareHits.h"
 
-#include "Ensure.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushFaceHandle.h"
 #include "Model/BrushNode.h"
@@ -33,44 +32,23 @@ namespace TrenchBroom
 {
 namespace Model
 {
-CompareHits::~CompareHits() {}
-
-int CompareHits::compare(const Hit& lhs, const Hit& rhs) const
-{
-  return doCompare(lhs, rhs);
-}
-
-CombineCompareHits::CombineCompareHits(
-  std::unique_ptr<CompareHits> first, std::unique_ptr<CompareHits> second)
-  : m_first(std::move(first))
-  , m_second(std::move(second))
-{
-  ensure(m_first != nullptr, "first is null");
-  ensure(m_second != nullptr, "second is null");
-}
-
-int CombineCompareHits::doCompare(const Hit& lhs, const Hit& rhs) const
-{
-  const int firstResult = m_first->compare(lhs, rhs);
-  if (firstResult == 0)
-    return m_second->compare(lhs, rhs);
-  return firstResult;
-}
-
-int CompareHitsByType::doCompare(const Hit& lhs, const Hit& rhs) const
+int CompareHitsByDistance::compare(const Hit& lhs, const Hit& rhs) const
 {
-  if (lhs.type() == BrushNode::BrushHitType)
+  if (lhs.distance() < rhs.distance())
     return -1;
-  if (rhs.type() == BrushNode::BrushHitType)
+  if (lhs.distance() > rhs.distance())
     return 1;
   return 0;
 }
 
-int CompareHitsByDistance::doCompare(const Hit& lhs, const Hit& rhs) const
+int CompareHitsByDistanceAndType::compare(const Hit& lhs, const Hit& rhs) const
 {
-  if (lhs.distance() < rhs.distance())
+  const int distanceResult = m_compareByDistance.compare(lhs, rhs);
+  if (distanceResult != 0)
+    return distanceResult;
+  if (lhs.type() == BrushNode::BrushHitType)
     return -1;
-  if (lhs.distance() > rhs.distance())
+  if (rhs.type() == BrushNode::BrushHitType)
     return 1;
   return 0;
 }
@@ -80,7 +58,7 @@ CompareHitsBySize::CompareHitsBySize(const vm::axis::type axis)
 {
 }
 
-int CompareHitsBySize::doCompare(const Hit& lhs, const Hit& rhs) const
+int CompareHitsBySize::compare(const Hit& lhs, const Hit& rhs) const
 {
   const FloatType lhsSize = getSize(lhs);
   const FloatType rhsSize = getSize(rhs);
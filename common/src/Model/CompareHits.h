@@ -23,7 +23,7 @@
 
 #include <vecmath/util.h>
 
-#include <memory>
+#include <variant>
 
 namespace TrenchBroom
 {
@@ -31,54 +31,47 @@ namespace Model
 {
 class Hit;
 
-class CompareHits
+/**
+ * Orders hits by their distance.
+ */
+class CompareHitsByDistance
 {
 public:
-  virtual ~CompareHits();
   int compare(const Hit& lhs, const Hit& rhs) const;
-
-private:
-  virtual int doCompare(const Hit& lhs, const Hit& rhs) const = 0;
 };
 
-class CombineCompareHits : public CompareHits
+/**
+ * Orders hits by their distance, and brush hits before other hits at the same distance.
+ */
+class CompareHitsByDistanceAndType
 {
 private:
-  std::unique_ptr<CompareHits> m_first;
-  std::unique_ptr<CompareHits> m_second;
+  CompareHitsByDistance m_compareByDistance;
 
 public:
-  CombineCompareHits(
-    std::unique_ptr<CompareHits> first, std::unique_ptr<CompareHits> second);
-
-private:
-  int doCompare(const Hit& lhs, const Hit& rhs) const override;
-};
-
-class CompareHitsByType : public CompareHits
-{
-private:
-  int doCompare(const Hit& lhs, const Hit& rhs) const override;
-};
-
-class CompareHitsByDistance : public CompareHits
-{
-private:
-  int doCompare(const Hit& lhs, const Hit& rhs) const override;
+  int compare(const Hit& lhs, const Hit& rhs) const;
 };
 
-class CompareHitsBySize : public CompareHits
+/**
+ * Orders hits by the area of the hit objects when projected onto the plane orthogonal to
+ * the given axis, and hits of the same size by distance.
+ */
+class CompareHitsBySize
 {
 private:
-  const vm::axis::type m_axis;
+  vm::axis::type m_axis;
   CompareHitsByDistance m_compareByDistance;
 
 public:
-  CompareHitsBySize(vm::axis::type axis);
+  explicit CompareHitsBySize(vm::axis::type axis);
+
+  int compare(const Hit& lhs, const Hit& rhs) const;
 
 private:
-  int doCompare(const Hit& lhs, const Hit& rhs) const override;
   FloatType getSize(const Hit& hit) const;
 };
+
+using CompareHits =
+  std::variant<CompareHitsByDistance, CompareHitsByDistanceAndType, CompareHitsBySize>;
 } // namespace Model
 } // namespace TrenchBroom
@@ -74,7 +74,11 @@ Entity::Entity()
   : m_pointEntity{true}
   , m_model{nullptr}
   , m_cachedProperties{
-      EntityPropertyValues::NoClassname, vm::vec3{}, vm::mat4x4{}, vm::mat4x4{}}
+      EntityPropertyValues::NoClassname,
+      vm::vec3{},
+      vm::mat4x4{},
+      vm::mat4x4{},
+      vm::mat4x4{}}
 {
 }
 
@@ -210,6 +214,11 @@ const vm::mat4x4& Entity::modelTransformation() const
   return m_cachedProperties.modelTransformation;
 }
 
+const std::optional<vm::mat4x4>& Entity::inverseModelTransformation() const
+{
+  return m_cachedProperties.inverseModelTransformation;
+}
+
 void Entity::unsetEntityDefinitionAndModel()
 {
   if (m_definition.get() == nullptr && m_model == nullptr)
@@ -221,6 +230,7 @@ void Entity::unsetEntityDefinitionAndModel()
   m_model = nullptr;
   m_cachedProperties.rotation = entityRotation(*this);
   m_cachedProperties.modelTransformation = vm::mat4x4::identity();
+  m_cachedProperties.inverseModelTransformation = vm::mat4x4::identity();
 }
 
 void Entity::addOrUpdateProperty(
@@ -457,6 +467,10 @@ void Entity::updateCachedProperties(const EntityPropertyConfig& propertyConfig)
   {
     m_cachedProperties.modelTransformation = vm::mat4x4::identity();
   }
+
+  const auto [invertible, inverse] = vm::invert(m_cachedProperties.modelTransformation);
+  m_cachedProperties.inverseModelTransformation =
+    invertible ? std::optional{inverse} : std::nullopt;
 }
 
 bool operator==(const Entity& lhs, const Entity& rhs)
@@ -111,6 +111,7 @@ private:
     vm::vec3 origin;
     vm::mat4x4 rotation;
     vm::mat4x4 modelTransformation;
+    std::optional<vm::mat4x4> inverseModelTransformation;
   };
 
   CachedProperties m_cachedProperties;
@@ -161,6 +162,13 @@ public:
   Assets::ModelSpecification modelSpecification() const;
   const vm::mat4x4& modelTransformation() const;
 
+  /**
+   * Returns the inverse of the model transformation, or std::nullopt if the model
+   * transformation is not invertible. The inverse is cached and only recomputed when the
+   * model transformation changes.
+   */
+  const std::optional<vm::mat4x4>& inverseModelTransformation() const;
+
   void unsetEntityDefinitionAndModel();
 
   void addOrUpdateProperty(
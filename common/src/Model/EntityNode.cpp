@@ -184,26 +184,27 @@ void EntityNode::doPick(
       }
     }
 
-    // only if the bbox hit test failed do we hit test the model
-    if (m_entity.model() != nullptr)
+    // only if the bbox hit test failed do we hit test the model, but only if the ray
+    // hits the model's world space bounds, too
+    const auto& inverse = m_entity.inverseModelTransformation();
+    if (
+      m_entity.model() != nullptr && inverse.has_value()
+      && (modelBounds().contains(ray.origin)
+          || !vm::is_nan(vm::intersect_ray_bbox(ray, modelBounds()))))
     {
-      // we transform the ray into the model's space
-      const auto transform = m_entity.modelTransformation();
-      const auto [invertible, inverse] = vm::invert(transform);
-      if (invertible)
+      // we transform the ray into the model's space; the model frame's BVH is shared by
+      // all entities using the same model
+      const auto transformedRay = vm::ray3f(ray.transform(*inverse));
+      const auto distance = m_entity.model()->intersect(transformedRay);
+      if (!vm::is_nan(distance))
       {
-        const auto transformedRay = vm::ray3f(ray.transform(inverse));
-        const auto distance = m_entity.model()->intersect(transformedRay);
-        if (!vm::is_nan(distance))
-        {
-          // transform back to world space
-          const auto transformedHitPoint =
-            vm::vec3(point_at_distance(transformedRay, distance));
-          const auto hitPoint = transform * transformedHitPoint;
-          pickResult.addHit(
-            Hit(EntityHitType, static_cast<FloatType>(distance), hitPoint, this));
-          return;
-        }
+        // transform back to world space
+        const auto transformedHitPoint =
+          vm::vec3(point_at_distance(transformedRay, distance));
+        const auto hitPoint = m_entity.modelTransformation() * transformedHitPoint;
+        pickResult.addHit(
+          Hit(EntityHitType, static_cast<FloatType>(distance), hitPoint, this));
+        return;
       }
     }
   }
@@ -44,9 +44,14 @@
 
 #include <vecmath/ray.h>
 
+#include <cassert>
 #include <functional>
+#include <optional>
 #include <string>
+#include <typeinfo>
 #include <unordered_map>
+#include <unordered_set>
+#include <variant>
 #include <vector>
 
 namespace TrenchBroom
@@ -58,11 +63,12 @@ namespace Model
  * `node`.
  * (`node` itself is skipped.)
  */
-static std::vector<const Node*> collectNodesToCloneAndTransform(const Node& node)
+template <typename N>
+static std::vector<N*> collectNodesToCloneAndTransform(N& node)
 {
-  auto result = std::vector<const Node*>{};
+  auto result = std::vector<N*>{};
 
-  std::function<void(const Node*)> collectNodes = [&](const Node* n) {
+  std::function<void(N*)> collectNodes = [&](N* n) {
     result.push_back(n);
     for (auto* child : n->children())
     {
@@ -345,11 +351,189 @@ kdl::result<UpdateLinkedGroupsResult, UpdateLinkedGroupsError> updateLinkedGroup
   });
 }
 
+/**
+ * Checks whether the given nodes have the same types of descendants in the same order.
+ */
+static bool haveSameStructure(const Node& lhs, const Node& rhs)
+{
+  if (lhs.childCount() != rhs.childCount())
+  {
+    return false;
+  }
+
+  for (size_t i = 0; i < lhs.childCount(); ++i)
+  {
+    const auto* lhsChild = lhs.children()[i];
+    const auto* rhsChild = rhs.children()[i];
+    if (
+      typeid(*lhsChild) != typeid(*rhsChild)
+      || !haveSameStructure(*lhsChild, *rhsChild))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Returns the indices of the given source nodes that are contained in the given changed
+ * nodes. The source nodes must have been returned by collectNodesToCloneAndTransform.
+ *
+ * Returns an empty optional if the changes cannot be propagated by swapping node
+ * contents, i.e. if a group or an entity has changed.
+ */
+static std::optional<std::vector<size_t>> findChangedNodes(
+  const std::vector<const Node*>& sourceNodes,
+  const std::vector<const Node*>& changedNodes)
+{
+  const auto changedNodeSet =
+    std::unordered_set<const Node*>{changedNodes.begin(), changedNodes.end()};
+
+  auto result = std::vector<size_t>{};
+  for (size_t i = 0; i < sourceNodes.size(); ++i)
+  {
+    const auto* sourceNode = sourceNodes[i];
+    if (changedNodeSet.count(sourceNode) > 0u)
+    {
+      if (
+        !dynamic_cast<const BrushNode*>(sourceNode)
+        && !dynamic_cast<const PatchNode*>(sourceNode))
+      {
+        return std::nullopt;
+      }
+      result.push_back(i);
+    }
+  }
+
+  return result;
+}
+
+kdl::result<IncrementalUpdateLinkedGroupsResult, UpdateLinkedGroupsError>
+updateLinkedGroupsIncrementally(
+  const GroupNode& sourceGroupNode,
+  const std::vector<const Node*>& changedNodes,
+  const std::vector<Model::GroupNode*>& targetGroupNodes,
+  const vm::bbox3& worldBounds)
+{
+  const auto& sourceGroup = sourceGroupNode.group();
+  const auto [success, invertedSourceTransformation] =
+    vm::invert(sourceGroup.transformation());
+  if (!success)
+  {
+    return UpdateLinkedGroupsError::TransformIsNotInvertible;
+  }
+
+  const auto _invertedSourceTransformation = invertedSourceTransformation;
+  const auto targetGroupNodesToUpdate =
+    kdl::vec_erase(targetGroupNodes, &sourceGroupNode);
+
+  const auto sourceNodes = collectNodesToCloneAndTransform<const Node>(sourceGroupNode);
+  const auto changedNodeIndices = findChangedNodes(sourceNodes, changedNodes);
+  if (!changedNodeIndices)
+  {
+    return updateLinkedGroups(sourceGroupNode, targetGroupNodesToUpdate, worldBounds)
+      .transform([](UpdateLinkedGroupsResult&& childrenToReplace) {
+        return IncrementalUpdateLinkedGroupsResult{std::move(childrenToReplace), {}};
+      });
+  }
+
+  struct NodeToUpdate
+  {
+    Node* targetNode;
+    const Node* sourceNode;
+    vm::mat4x4 transformation;
+  };
+
+  auto nodesToUpdate = std::vector<NodeToUpdate>{};
+  auto groupNodesToReplace = std::vector<GroupNode*>{};
+  for (auto* targetGroupNode : targetGroupNodesToUpdate)
+  {
+    if (!haveSameStructure(sourceGroupNode, *targetGroupNode))
+    {
+      groupNodesToReplace.push_back(targetGroupNode);
+      continue;
+    }
+
+    const auto transformation =
+      targetGroupNode->group().transformation() * _invertedSourceTransformation;
+    const auto targetNodes = collectNodesToCloneAndTransform<Node>(*targetGroupNode);
+    for (const auto i : *changedNodeIndices)
+    {
+      nodesToUpdate.push_back({targetNodes[i], sourceNodes[i], transformation});
+    }
+  }
+
+  using TransformResult = kdl::result<std::pair<Node*, NodeContents>, BrushError>;
+
+  const auto transformResults =
+    kdl::vec_parallel_transform(nodesToUpdate, [&](const NodeToUpdate& nodeToUpdate) {
+      auto* targetNode = nodeToUpdate.targetNode;
+      const auto& transformation = nodeToUpdate.transformation;
+
+      return nodeToUpdate.sourceNode->accept(kdl::overload(
+        [](const WorldNode*) -> TransformResult {
+          ensure(false, "Only brushes and patches have changed");
+        },
+        [](const LayerNode*) -> TransformResult {
+          ensure(false, "Only brushes and patches have changed");
+        },
+        [](const GroupNode*) -> TransformResult {
+          ensure(false, "Only brushes and patches have changed");
+        },
+        [](const EntityNode*) -> TransformResult {
+          ensure(false, "Only brushes and patches have changed");
+        },
+        [&](const BrushNode* brushNode) -> TransformResult {
+          auto brush = brushNode->brush();
+          return brush.transform(worldBounds, transformation, true)
+            .and_then([&]() -> TransformResult {
+              return std::make_pair(targetNode, NodeContents{std::move(brush)});
+            });
+        },
+        [&](const PatchNode* patchNode) -> TransformResult {
+          auto patch = patchNode->patch();
+          patch.transform(transformation);
+          return std::make_pair(targetNode, NodeContents{std::move(patch)});
+        }));
+    });
+
+  bool transformFailed = false;
+  auto contentsToSwap = kdl::collect_values(
+    transformResults, kdl::overload([&](const auto&) { transformFailed = true; }));
+
+  if (transformFailed)
+  {
+    return UpdateLinkedGroupsError::TransformFailed;
+  }
+
+  for (const auto& [targetNode, contents] : contentsToSwap)
+  {
+    const auto& bounds = std::visit(
+      kdl::overload(
+        [](const Brush& brush) -> const vm::bbox3& { return brush.bounds(); },
+        [](const BezierPatch& patch) -> const vm::bbox3& { return patch.bounds(); },
+        [&](const auto&) -> const vm::bbox3& { return targetNode->logicalBounds(); }),
+      contents.get());
+    if (!worldBounds.contains(bounds))
+    {
+      return UpdateLinkedGroupsError::UpdateExceedsWorldBounds;
+    }
+  }
+
+  return updateLinkedGroups(sourceGroupNode, groupNodesToReplace, worldBounds)
+    .transform([&](UpdateLinkedGroupsResult&& childrenToReplace) {
+      return IncrementalUpdateLinkedGroupsResult{
+        std::move(childrenToReplace), std::move(contentsToSwap)};
+    });
+}
+
 GroupNode::GroupNode(Group group)
   : m_group{std::move(group)}
   , m_editState{EditState::Closed}
   , m_boundsValid{false}
   , m_hasPendingChanges{false}
+  , m_pendingChangedNodes{std::vector<const Node*>{}}
 {
 }
 
@@ -414,9 +598,36 @@ bool GroupNode::hasPendingChanges() const
   return m_hasPendingChanges;
 }
 
+const std::optional<std::vector<const Node*>>& GroupNode::pendingChangedNodes() const
+{
+  return m_pendingChangedNodes;
+}
+
 void GroupNode::setHasPendingChanges(const bool hasPendingChanges)
 {
   m_hasPendingChanges = hasPendingChanges;
+  if (hasPendingChanges)
+  {
+    m_pendingChangedNodes = std::nullopt;
+  }
+  else
+  {
+    m_pendingChangedNodes = std::vector<const Node*>{};
+  }
+}
+
+void GroupNode::addPendingChangedNodes(const std::vector<const Node*>& changedNodes)
+{
+  if (!m_hasPendingChanges)
+  {
+    m_hasPendingChanges = true;
+    m_pendingChangedNodes = changedNodes;
+  }
+  else if (m_pendingChangedNodes)
+  {
+    m_pendingChangedNodes =
+      kdl::vec_concat(std::move(*m_pendingChangedNodes), changedNodes);
+  }
 }
 
 void GroupNode::setEditState(const EditState editState)
@@ -24,6 +24,7 @@
 #include "Model/Group.h"
 #include "Model/IdType.h"
 #include "Model/Node.h"
+#include "Model/NodeContents.h"
 #include "Model/Object.h"
 
 #include <kdl/result_forward.h>
@@ -76,6 +77,42 @@ kdl::result<UpdateLinkedGroupsResult, UpdateLinkedGroupsError> updateLinkedGroup
   const std::vector<Model::GroupNode*>& targetGroupNodes,
   const vm::bbox3& worldBounds);
 
+struct IncrementalUpdateLinkedGroupsResult
+{
+  UpdateLinkedGroupsResult childrenToReplace;
+  std::vector<std::pair<Node*, NodeContents>> contentsToSwap;
+};
+
+/**
+ * Updates the given target group nodes from the given source group node like
+ * `updateLinkedGroups`, but only transforms the given changed descendants of the source
+ * group node.
+ *
+ * The changed nodes are the descendants of the source group node whose contents have
+ * changed since its link set was last updated. They are only used to identify these
+ * descendants, so the vector may also contain nodes that are no longer part of the
+ * source group. All other descendants are assumed to be in sync with their corresponding
+ * nodes in the target groups and are not transformed.
+ *
+ * If only brushes and patches have changed, then a vector of pairs is returned in
+ * `contentsToSwap`, where each pair consists of a node in a target group and the
+ * transformed contents of the corresponding changed node. Swapping these contents into
+ * the target nodes preserves the identity of all nodes in the target groups.
+ *
+ * A target group whose structure differs from the source group's structure, i.e. which
+ * does not have the same types of nodes in the same order, is updated by replacing its
+ * children as `updateLinkedGroups` does. The same applies to all target groups if any
+ * group or entity has changed. These children are returned in `childrenToReplace`.
+ *
+ * This operation fails under the same conditions as `updateLinkedGroups`.
+ */
+kdl::result<IncrementalUpdateLinkedGroupsResult, UpdateLinkedGroupsError>
+updateLinkedGroupsIncrementally(
+  const GroupNode& sourceGroupNode,
+  const std::vector<const Node*>& changedNodes,
+  const std::vector<Model::GroupNode*>& targetGroupNodes,
+  const vm::bbox3& worldBounds);
+
 /**
  * A group of nodes that can be edited as one.
  *
@@ -108,6 +145,13 @@ private:
 
   bool m_hasPendingChanges;
 
+  /**
+   * The descendants whose contents have changed since the pending changes were last
+   * reset, or an empty optional if other changes are pending, e.g. because nodes were
+   * added or removed.
+   */
+  std::optional<std::vector<const Node*>> m_pendingChangedNodes;
+
 public:
   explicit GroupNode(Group group);
 
@@ -125,7 +169,9 @@ public:
   void resetPersistentId();
 
   bool hasPendingChanges() const;
+  const std::optional<std::vector<const Node*>>& pendingChangedNodes() const;
   void setHasPendingChanges(bool hasPendingChanges);
+  void addPendingChangedNodes(const std::vector<const Node*>& changedNodes);
 
 private:
   void setEditState(EditState editState);
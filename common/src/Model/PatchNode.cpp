@@ -33,15 +33,21 @@
 
 #include <kdl/overload.h>
 #include <kdl/reflection_impl.h>
-#include <kdl/zip_iterator.h>
 
 #include <vecmath/bbox_io.h>
 #include <vecmath/intersection.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
 #include <vecmath/vec_io.h>
 
+#include <tiny_bvh.h>
+
 #include <cassert>
+#include <optional>
 #include <ostream>
 #include <string>
+#include <tuple>
+#include <utility>
 
 namespace TrenchBroom
 {
@@ -89,7 +95,7 @@ kdl_reflect_impl(PatchGrid);
  * sides of the grid coincide, we treat them as one grid point and average their normals.
  */
 std::vector<vm::vec3> computeGridNormals(
-  const std::vector<BezierPatch::Point> patchGrid,
+  const std::vector<BezierPatch::Point>& patchGrid,
   const size_t pointRowCount,
   const size_t pointColumnCount)
 {
@@ -189,29 +195,40 @@ std::vector<vm::vec3> computeGridNormals(
   normals[index(b, l)] = normalForQuadrant(b, l, RowOffset::Above, ColOffset::Right);
   normals[index(b, r)] = normalForQuadrant(b, r, RowOffset::Above, ColOffset::Left);
 
+  /* The sum of the normals of two or four incident quadrants simplifies to a single cross
+   * product, e.g. A + B + C + D = (above - below) x (left - right) for an inner point.
+   * This saves most of the cross products on a large grid.
+   */
+
   // top and bottom row normals, excluding corners
   for (size_t col = 1u; col < r; ++col)
   {
+    // C + D and A + B
     normals[index(t, col)] =
-      (normalForQuadrant(t, col, RowOffset::Below, ColOffset::Left)
-       + normalForQuadrant(t, col, RowOffset::Below, ColOffset::Right))
+      vm::cross(
+        gridPoint(t, col - 1u) - gridPoint(t, col + 1u),
+        gridPoint(t + 1u, col) - gridPoint(t, col))
       / static_cast<FloatType>(2);
     normals[index(b, col)] =
-      (normalForQuadrant(b, col, RowOffset::Above, ColOffset::Left)
-       + normalForQuadrant(b, col, RowOffset::Above, ColOffset::Right))
+      vm::cross(
+        gridPoint(b - 1u, col) - gridPoint(b, col),
+        gridPoint(b, col - 1u) - gridPoint(b, col + 1u))
       / static_cast<FloatType>(2);
   }
 
   // left and right column normals, excluding corners
   for (size_t row = 1u; row < b; ++row)
   {
+    // B + D and A + C
     normals[index(row, l)] =
-      (normalForQuadrant(row, l, RowOffset::Above, ColOffset::Right)
-       + normalForQuadrant(row, l, RowOffset::Below, ColOffset::Right))
+      vm::cross(
+        gridPoint(row, l + 1u) - gridPoint(row, l),
+        gridPoint(row - 1u, l) - gridPoint(row + 1u, l))
       / static_cast<FloatType>(2);
     normals[index(row, r)] =
-      (normalForQuadrant(row, r, RowOffset::Above, ColOffset::Left)
-       + normalForQuadrant(row, r, RowOffset::Below, ColOffset::Left))
+      vm::cross(
+        gridPoint(row - 1u, r) - gridPoint(row + 1u, r),
+        gridPoint(row, r - 1u) - gridPoint(row, r))
       / static_cast<FloatType>(2);
   }
 
@@ -220,11 +237,11 @@ std::vector<vm::vec3> computeGridNormals(
   {
     for (size_t col = 1u; col < r; ++col)
     {
+      // A + B + C + D
       normals[index(row, col)] =
-        (normalForQuadrant(row, col, RowOffset::Above, ColOffset::Left)
-         + normalForQuadrant(row, col, RowOffset::Above, ColOffset::Right)
-         + normalForQuadrant(row, col, RowOffset::Below, ColOffset::Left)
-         + normalForQuadrant(row, col, RowOffset::Below, ColOffset::Right))
+        vm::cross(
+          gridPoint(row - 1u, col) - gridPoint(row + 1u, col),
+          gridPoint(row, col - 1u) - gridPoint(row, col + 1u))
         / static_cast<FloatType>(4);
     }
   }
@@ -280,12 +297,14 @@ PatchGrid makePatchGrid(const BezierPatch& patch, const size_t subdivisionsPerSu
   assert(patchGrid.size() == normals.size());
 
   auto points = std::vector<PatchGrid::Point>{};
+  points.reserve(patchGrid.size());
   auto boundsBuilder = vm::bbox3::builder{};
-  for (const auto [point, normal] : kdl::make_zip_range(patchGrid, normals))
+  for (size_t i = 0u; i < patchGrid.size(); ++i)
   {
-    const auto position = vm::slice<3>(point, 0);
-    const auto texCoords = vm::slice<2>(point, 3);
-    points.push_back(PatchGrid::Point{position, texCoords, normal});
+    const auto& point = patchGrid[i];
+    const auto position = vm::vec3{point[0], point[1], point[2]};
+    points.push_back(
+      PatchGrid::Point{position, vm::vec2{point[3], point[4]}, normals[i]});
     boundsBuilder.add(position);
   }
 
@@ -293,6 +312,157 @@ PatchGrid makePatchGrid(const BezierPatch& patch, const size_t subdivisionsPerSu
     gridPointRowCount, gridPointColumnCount, std::move(points), boundsBuilder.bounds()};
 }
 
+namespace
+{
+/**
+ * Returns the vertices of the triangle with the given index. Every quad of the grid is
+ * split into two triangles, and the triangles are numbered row by row.
+ */
+std::tuple<vm::vec3, vm::vec3, vm::vec3> gridTriangle(
+  const PatchGrid& grid, const size_t triangleIndex)
+{
+  const auto quadIndex = triangleIndex / 2u;
+  const auto row = quadIndex / grid.quadColumnCount();
+  const auto col = quadIndex % grid.quadColumnCount();
+
+  const auto& v0 = grid.point(row, col).position;
+  const auto& v1 = grid.point(row, col + 1u).position;
+  const auto& v2 = grid.point(row + 1u, col + 1u).position;
+  const auto& v3 = grid.point(row + 1u, col).position;
+
+  return triangleIndex % 2u == 0u ? std::tuple{v0, v1, v2} : std::tuple{v2, v3, v0};
+}
+
+tinybvh::bvhdbl3 toBVHVertex(const vm::vec3& v)
+{
+  return tinybvh::bvhdbl3{v.x(), v.y(), v.z()};
+}
+
+/**
+ * Transforms the given grid if the given transformation only rotates and translates. Then
+ * the normals computed by computeGridNormals are just rotated. Returns an empty optional
+ * for any other transformation because then the normals must be computed again.
+ */
+std::optional<PatchGrid> transformPatchGrid(
+  const PatchGrid& grid, const vm::mat4x4& transformation)
+{
+  // the transformation matrices created by TrenchBroom are much more accurate than this
+  constexpr auto epsilon = static_cast<FloatType>(1e-9);
+
+  const auto linearTransformation = vm::strip_translation(transformation);
+  if (
+    !vm::is_equal(
+      vm::transpose(linearTransformation) * linearTransformation,
+      vm::mat4x4::identity(),
+      epsilon)
+    || vm::compute_determinant(linearTransformation) < static_cast<FloatType>(0))
+  {
+    return std::nullopt;
+  }
+
+  auto result = grid;
+  auto boundsBuilder = vm::bbox3::builder{};
+  for (auto& point : result.points)
+  {
+    point.position = transformation * point.position;
+    point.normal = linearTransformation * point.normal;
+    boundsBuilder.add(point.position);
+  }
+  result.bounds = boundsBuilder.bounds();
+
+  return result;
+}
+} // namespace
+
+struct PatchNode::PickingBVH
+{
+  std::vector<tinybvh::bvhdbl3> triangles;
+  tinybvh::BVH_Double bvh;
+
+  explicit PickingBVH(const PatchGrid& grid)
+  {
+    const auto triangleCount = 2u * grid.quadRowCount() * grid.quadColumnCount();
+    triangles.reserve(3u * triangleCount);
+    for (size_t i = 0; i < triangleCount; ++i)
+    {
+      const auto [p0, p1, p2] = gridTriangle(grid, i);
+      triangles.push_back(toBVHVertex(p0));
+      triangles.push_back(toBVHVertex(p1));
+      triangles.push_back(toBVHVertex(p2));
+    }
+
+    // the BVH references the triangle array, so it must not change after this
+    bvh.Build(triangles.data(), static_cast<uint32_t>(triangleCount));
+  }
+
+  /**
+   * Returns the distance to the nearest triangle hit by the given ray, or NaN if the ray
+   * doesn't hit the grid.
+   *
+   * The BVH is only used to cull nodes. The triangles in the leaves are tested with the
+   * same function as before the BVH existed because tinybvh's test isn't watertight and
+   * misses rays that pass exactly through a shared edge of two triangles.
+   */
+  FloatType intersect(const vm::ray3& pickRay, const PatchGrid& grid) const
+  {
+    auto bvhRay =
+      tinybvh::RayEx{toBVHVertex(pickRay.origin), toBVHVertex(pickRay.direction)};
+    auto closest = vm::nan<FloatType>();
+
+    const tinybvh::BVH_Double::BVHNode* stack[64];
+    auto stackSize = size_t(0);
+    const auto* node = &bvh.bvhNode[0];
+    while (true)
+    {
+      if (node->isLeaf())
+      {
+        for (uint64_t i = 0; i < node->triCount; ++i)
+        {
+          const auto [p0, p1, p2] =
+            gridTriangle(grid, size_t(bvh.triIdx[node->leftFirst + i]));
+          const auto distance = vm::intersect_ray_triangle(pickRay, p0, p1, p2);
+          if (!vm::is_nan(distance) && !(distance >= closest))
+          {
+            closest = distance;
+            bvhRay.t = distance;
+          }
+        }
+      }
+      else
+      {
+        // visit the nearer child first so that the far child is likely culled
+        const auto* child1 = &bvh.bvhNode[node->leftFirst];
+        const auto* child2 = &bvh.bvhNode[node->leftFirst + 1];
+        auto dist1 = child1->Intersect(bvhRay);
+        auto dist2 = child2->Intersect(bvhRay);
+        if (dist1 > dist2)
+        {
+          std::swap(dist1, dist2);
+          std::swap(child1, child2);
+        }
+
+        if (dist1 != BVH_DBL_FAR)
+        {
+          if (dist2 != BVH_DBL_FAR)
+          {
+            stack[stackSize++] = child2;
+          }
+          node = child1;
+          continue;
+        }
+      }
+
+      if (stackSize == 0)
+      {
+        break;
+      }
+      node = stack[--stackSize];
+    }
+
+    return closest;
+  }
+};
+
 const HitType::Type PatchNode::PatchHitType = HitType::freeType();
 
 PatchNode::PatchNode(BezierPatch patch)
@@ -301,6 +471,8 @@ PatchNode::PatchNode(BezierPatch patch)
 {
 }
 
+PatchNode::~PatchNode() = default;
+
 const EntityNodeBase* PatchNode::entity() const
 {
   return visitParent(
@@ -333,15 +505,35 @@ const BezierPatch& PatchNode::patch() const
 }
 
 BezierPatch PatchNode::setPatch(BezierPatch patch)
+{
+  auto grid = makeGrid(patch);
+  return setPatch(std::move(patch), std::move(grid));
+}
+
+BezierPatch PatchNode::setPatch(BezierPatch patch, PatchGrid grid)
 {
   const auto nodeChange = NotifyNodeChange{*this};
   const auto boundsChange = NotifyPhysicalBoundsChange{*this};
 
   auto previousPatch = std::exchange(m_patch, std::move(patch));
-  m_grid = makePatchGrid(m_patch, DefaultSubdivisionsPerSurface);
+  m_grid = std::move(grid);
+  m_pickingBVH.reset();
   return previousPatch;
 }
 
+PatchGrid PatchNode::makeGrid(const BezierPatch& patch) const
+{
+  // if the patch was only moved, transform the grid instead of tessellating it again
+  if (const auto transformation = patch.gridTransformation(m_patch))
+  {
+    if (auto grid = transformPatchGrid(m_grid, *transformation))
+    {
+      return std::move(*grid);
+    }
+  }
+  return makePatchGrid(patch, DefaultSubdivisionsPerSurface);
+}
+
 void PatchNode::setTexture(Assets::Texture* texture)
 {
   m_patch.setTexture(texture);
@@ -422,31 +614,17 @@ void PatchNode::doPick(
   {
     return;
   }
-  const auto pickTriangle = [&](const auto& p0, const auto& p1, const auto& p2) {
-    if (const auto distance = vm::intersect_ray_triangle(pickRay, p0, p1, p2);
-        !vm::is_nan(distance))
-    {
-      const auto hitPoint = vm::point_at_distance(pickRay, distance);
-      pickResult.addHit(Hit(PatchHitType, distance, hitPoint, this));
-      return true;
-    }
-    return false;
-  };
 
-  for (size_t row = 0u; row < m_grid.pointRowCount - 1u; ++row)
+  if (!m_pickingBVH)
   {
-    for (size_t col = 0u; col < m_grid.pointColumnCount - 1u; ++col)
-    {
-      const auto v0 = m_grid.point(row, col).position;
-      const auto v1 = m_grid.point(row, col + 1u).position;
-      const auto v2 = m_grid.point(row + 1u, col + 1u).position;
-      const auto v3 = m_grid.point(row + 1u, col).position;
+    m_pickingBVH = std::make_unique<PickingBVH>(m_grid);
+  }
 
-      if (pickTriangle(v0, v1, v2) || pickTriangle(v2, v3, v0))
-      {
-        return;
-      }
-    }
+  const auto distance = m_pickingBVH->intersect(pickRay, m_grid);
+  if (!vm::is_nan(distance))
+  {
+    const auto hitPoint = vm::point_at_distance(pickRay, distance);
+    pickResult.addHit(Hit(PatchHitType, distance, hitPoint, this));
   }
 }
 
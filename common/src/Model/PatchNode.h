@@ -29,6 +29,7 @@
 
 #include <kdl/reflection_decl.h>
 
+#include <memory>
 #include <optional>
 
 namespace TrenchBroom
@@ -68,7 +69,7 @@ struct PatchGrid
 
 // public for testing
 std::vector<vm::vec3> computeGridNormals(
-  const std::vector<BezierPatch::Point> patchGrid,
+  const std::vector<BezierPatch::Point>& patchGrid,
   const size_t pointRowCount,
   const size_t pointColumnCount);
 
@@ -81,11 +82,20 @@ public:
   static const HitType::Type PatchHitType;
 
 private:
+  struct PickingBVH;
+
   BezierPatch m_patch;
   PatchGrid m_grid;
 
+  /**
+   * A bounding volume hierarchy over the triangles of m_grid. It is built on the first
+   * pick after the grid was tessellated, and discarded whenever the grid changes.
+   */
+  std::unique_ptr<PickingBVH> m_pickingBVH;
+
 public:
   explicit PatchNode(BezierPatch patch);
+  ~PatchNode() override;
 
   EntityNodeBase* entity();
   const EntityNodeBase* entity() const;
@@ -93,6 +103,20 @@ public:
   const BezierPatch& patch() const;
   BezierPatch setPatch(BezierPatch patch);
 
+  /**
+   * Sets the given patch and its grid, which must have been returned by makeGrid for the
+   * given patch.
+   */
+  BezierPatch setPatch(BezierPatch patch, PatchGrid grid);
+
+  /**
+   * Returns the grid of the given patch, which is meant to replace this node's patch. If
+   * the given patch is a rotated and translated copy of this node's patch, then this
+   * node's grid is transformed, otherwise the given patch is tessellated. This node is
+   * not modified, so the grids of many nodes can be made in parallel.
+   */
+  PatchGrid makeGrid(const BezierPatch& patch) const;
+
   void setTexture(Assets::Texture* texture);
 
   const PatchGrid& grid() const;
@@ -31,34 +31,21 @@
 
 #include <algorithm>
 #include <cassert>
+#include <limits>
+#include <variant>
 
 namespace TrenchBroom
 {
 namespace Model
 {
-class PickResult::CompareWrapper
-{
-private:
-  const CompareHits* m_compare;
-
-public:
-  CompareWrapper(const CompareHits* compare)
-    : m_compare(compare)
-  {
-  }
-  bool operator()(const Hit& lhs, const Hit& rhs) const
-  {
-    return m_compare->compare(lhs, rhs) < 0;
-  }
-};
-
-PickResult::PickResult(std::shared_ptr<CompareHits> compare)
+PickResult::PickResult(CompareHits compare)
   : m_compare(std::move(compare))
+  , m_maxHitCount(std::numeric_limits<size_t>::max())
 {
 }
 
 PickResult::PickResult()
-  : m_compare(std::make_shared<CompareHitsByDistance>())
+  : PickResult(CompareHitsByDistance{})
 {
 }
 
@@ -66,13 +53,24 @@ PickResult::~PickResult() = default;
 
 PickResult PickResult::byDistance()
 {
-  return PickResult(std::make_shared<CombineCompareHits>(
-    std::make_unique<CompareHitsByDistance>(), std::make_unique<CompareHitsByType>()));
+  return PickResult(CompareHitsByDistanceAndType{});
 }
 
 PickResult PickResult::bySize(const vm::axis::type axis)
 {
-  return PickResult(std::make_shared<CompareHitsBySize>(axis));
+  return PickResult(CompareHitsBySize(axis));
+}
+
+PickResult PickResult::closest(HitFilter hitFilter, const size_t maxHitCount)
+{
+  ensure(hitFilter != nullptr, "hitFilter is null");
+  ensure(maxHitCount > 0u, "maxHitCount is positive");
+
+  auto result = PickResult::byDistance();
+  result.m_hitFilter = std::move(hitFilter);
+  result.m_maxHitCount = maxHitCount;
+  result.m_hits.reserve(maxHitCount + 1u);
+  return result;
 }
 
 bool PickResult::empty() const
@@ -85,6 +83,15 @@ size_t PickResult::size() const
   return m_hits.size();
 }
 
+std::optional<FloatType> PickResult::maxDistance() const
+{
+  if (m_hits.size() < m_maxHitCount)
+  {
+    return std::nullopt;
+  }
+  return m_hits.back().distance();
+}
+
 void PickResult::addHit(const Hit& hit)
 {
   assert(!vm::is_nan(hit.distance()));
@@ -93,10 +100,30 @@ void PickResult::addHit(const Hit& hit)
   {
     return;
   }
-  ensure(m_compare.get() != nullptr, "compare is null");
-  auto pos = std::upper_bound(
-    std::begin(m_hits), std::end(m_hits), hit, CompareWrapper(m_compare.get()));
-  m_hits.insert(pos, hit);
+  if (m_hitFilter && !m_hitFilter(hit))
+  {
+    return;
+  }
+
+  std::visit(
+    [&](const auto& compare) {
+      const auto less = [&](const Hit& lhs, const Hit& rhs) {
+        return compare.compare(lhs, rhs) < 0;
+      };
+
+      if (m_hits.size() == m_maxHitCount && !less(hit, m_hits.back()))
+      {
+        return;
+      }
+
+      const auto pos = std::upper_bound(std::begin(m_hits), std::end(m_hits), hit, less);
+      m_hits.insert(pos, hit);
+      if (m_hits.size() > m_maxHitCount)
+      {
+        m_hits.pop_back();
+      }
+    },
+    m_compare);
 }
 
 const std::vector<Hit>& PickResult::all() const
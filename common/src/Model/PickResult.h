@@ -19,31 +19,37 @@
 
 #pragma once
 
+#include "FloatType.h"
 #include "Macros.h"
+#include "Model/CompareHits.h"
 #include "Model/Hit.h"
 #include "Model/HitFilter.h"
 
 #include <vecmath/util.h>
 
-#include <memory>
+#include <optional>
 #include <vector>
 
 namespace TrenchBroom
 {
 namespace Model
 {
-class CompareHits;
 class HitQuery;
 
 class PickResult
 {
 private:
   std::vector<Hit> m_hits;
-  std::shared_ptr<CompareHits> m_compare;
-  class CompareWrapper;
+  CompareHits m_compare;
+
+  /**
+   * If set, hits that don't match this filter are discarded when they are added.
+   */
+  HitFilter m_hitFilter;
+  size_t m_maxHitCount;
 
 public:
-  PickResult(std::shared_ptr<CompareHits> compare);
+  explicit PickResult(CompareHits compare);
   PickResult();
 
   defineCopyAndMove(PickResult);
@@ -53,9 +59,26 @@ public:
   static PickResult byDistance();
   static PickResult bySize(vm::axis::type axis);
 
+  /**
+   * Returns a pick result that only keeps the given number of closest hits which match
+   * the given filter, ordered like byDistance. All other hits are discarded when they are
+   * added.
+   *
+   * This is much faster than keeping every hit along the ray if only the closest matching
+   * hits are needed, because picking skips every node that the ray enters beyond
+   * maxDistance.
+   */
+  static PickResult closest(HitFilter hitFilter, size_t maxHitCount = 1u);
+
   bool empty() const;
   size_t size() const;
 
+  /**
+   * Returns the distance beyond which added hits are discarded, or an empty optional if
+   * added hits are not discarded because of their distance.
+   */
+  std::optional<FloatType> maxDistance() const;
+
   void addHit(const Hit& hit);
 
   const std::vector<Hit>& all() const;
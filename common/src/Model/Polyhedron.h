@@ -21,6 +21,7 @@
 
 #include "Polyhedron_Forward.h"
 
+#include <kdl/block_pool.h>
 #include <kdl/intrusive_circular_list.h>
 
 #include <vecmath/bbox.h>
@@ -69,7 +70,7 @@ struct Polyhedron_GetVertexLink
  * The payload of a vertex can be used to store user data.
  */
 template <typename T, typename FP, typename VP>
-class Polyhedron_Vertex
+class Polyhedron_Vertex : public kdl::pool_allocated<Polyhedron_Vertex<T, FP, VP>>
 {
 private:
   friend class Polyhedron<T, FP, VP>;
@@ -219,7 +220,7 @@ struct Polyhedron_GetEdgeLink
  * intrusive circular list.
  */
 template <typename T, typename FP, typename VP>
-class Polyhedron_Edge
+class Polyhedron_Edge : public kdl::pool_allocated<Polyhedron_Edge<T, FP, VP>>
 {
 private:
   friend class Polyhedron<T, FP, VP>;
@@ -531,7 +532,7 @@ struct Polyhedron_GetHalfEdgeLink
  * boundary the half edge belongs to.
  */
 template <typename T, typename FP, typename VP>
-class Polyhedron_HalfEdge
+class Polyhedron_HalfEdge : public kdl::pool_allocated<Polyhedron_HalfEdge<T, FP, VP>>
 {
 private:
   friend class Polyhedron<T, FP, VP>;
@@ -751,7 +752,7 @@ struct Polyhedron_GetFaceLink
  * intrusive circular list.
  */
 template <typename T, typename FP, typename VP>
-class Polyhedron_Face
+class Polyhedron_Face : public kdl::pool_allocated<Polyhedron_Face<T, FP, VP>>
 {
 private:
   friend class Polyhedron<T, FP, VP>;
@@ -785,6 +786,12 @@ private:
    */
   typename FP::Type m_payload;
 
+  /**
+   * Marks this face as visited while the faces of a polyhedron are traversed. Every
+   * traversal must unset the marks of the faces it visited unless it deletes them.
+   */
+  bool m_visited;
+
   /**
    * The kdl::intrusive_circular_link member required to put half edges in an
    * intrusive_circular_list.
@@ -1167,6 +1174,12 @@ public:
   };
 
 private:
+  /*
+   * Vertices, edges, half edges and faces are allocated from one block pool per type, so
+   * building, copying and destroying polyhedra does not allocate each element from the
+   * heap individually. See kdl::pool_allocated.
+   */
+
   /**
    * The vertices of this polyhedron, stored in a circular list that owns them.
    */
@@ -1561,6 +1574,21 @@ private:
    */
   void updateBounds();
 
+public: // Transformation
+  /**
+   * Transforms the positions of all vertices and the planes of all faces by the given
+   * transformation without changing the topology of this polyhedron.
+   *
+   * The transformation must be invertible and must preserve orientation, otherwise the
+   * faces would no longer be convex or their boundaries would no longer be ordered
+   * counter clockwise.
+   *
+   * Updates the bounds of this polyhedron afterwards.
+   *
+   * @param transformation the transformation to apply
+   */
+  void transform(const vm::mat<T, 4, 4>& transformation);
+
 public: // Vertex correction and edge healing
   /**
    * Rounds each component of position of every vertex to the nearest integer if the
@@ -1695,13 +1723,20 @@ private: // Convex hull; adding and removing points
    * polyhedron's vertices and the given points.
    *
    * Duplicates in the given vector are discarded. Furthermore, the remaining points are
-   * sorted in descending order of their distance from the center of their bounding box.
-   * Therefore, the result of calling this method is different from the result of
-   * repeatedly calling addPoint() for every point in the given vector.
+   * sorted and then added in that order. Therefore, the result of calling this method is
+   * different from the result of repeatedly calling addPoint() for every point in the
+   * given vector. The scratch storage used to add a point is reused for the entire batch.
    *
    * @param points the points to add to this polyhedron
    */
   void addPoints(std::vector<vm::vec<T, 3>> points);
+
+  /**
+   * Storage that is needed while adding a point to a convex volume. It is kept between
+   * the points of a batch so that its memory can be reused.
+   */
+  struct ConvexHullScratch;
+
   /**
    * Adds the given point to this polyhedron. The effect of adding the given point to a
    * polyhedron is that the resulting polyhedron is the convex hull of the union of the
@@ -1718,6 +1753,18 @@ private: // Convex hull; adding and removing points
    */
   Vertex* addPoint(const vm::vec<T, 3>& position, T planeEpsilon);
 
+  /**
+   * Adds the given point to this polyhedron using the given scratch storage.
+   *
+   * @param position the point to add
+   * @param planeEpsilon the plane epsilon to use for point status checks
+   * @param scratch the scratch storage to use
+   * @return the newly created vertex, or null if the given point was not added to this
+   * polyhedron
+   */
+  Vertex* addPoint(
+    const vm::vec<T, 3>& position, T planeEpsilon, ConvexHullScratch& scratch);
+
 private:
   /**
    * Helper function that adds the given point to an empty polyhedron. Afterwards, this
@@ -1799,9 +1846,11 @@ private:
    *
    * @param position the point to add
    * @param planeEpsilon the plane epsilon to use for point status checks
+   * @param scratch the scratch storage to use
    * @return the newly created vertex or null if no vertex was created
    */
-  Vertex* addFurtherPoint(const vm::vec<T, 3>& position, T planeEpsilon);
+  Vertex* addFurtherPoint(
+    const vm::vec<T, 3>& position, T planeEpsilon, ConvexHullScratch& scratch);
 
   /**
    * Helper function that adds the given point to a polygon.
@@ -1850,9 +1899,11 @@ private:
    *
    * @param position the point to add
    * @param planeEpsilon the plane epsilon to use for point status checks
+   * @param scratch the scratch storage to use
    * @return the newly created vertex or null if no vertex was created
    */
-  Vertex* addFurtherPointToPolyhedron(const vm::vec<T, 3>& position, T planeEpsilon);
+  Vertex* addFurtherPointToPolyhedron(
+    const vm::vec<T, 3>& position, T planeEpsilon, ConvexHullScratch& scratch);
 
   /**
    * A seam is a circular sequence of consecutive edges. For each edge of a seam, it must
@@ -1883,15 +1934,21 @@ private:
    *
    * @param position the vertex position
    * @param planeEpsilon the plane epsilon to use for point status checks
-   * @return a seam that separates the faces that are visible from the given position from
-   * those that do not, or an empty optional if no seam could be created
+   * @param visitedFaces storage for the visited faces, must be empty and is emptied again
+   * @param seam the seam that separates the faces that are visible from the given
+   * position from those that are not, must be empty
+   * @return true if a seam was created and false otherwise
    */
-  std::optional<Seam> createSeamForHorizon(const vm::vec<T, 3>& position, T planeEpsilon);
+  bool createSeamForHorizon(
+    const vm::vec<T, 3>& position,
+    T planeEpsilon,
+    std::vector<Face*>& visitedFaces,
+    Seam& seam);
 
   void visitFace(
     const vm::vec<T, 3>& position,
     HalfEdge* initialBoundaryEdge,
-    std::unordered_set<Face*>& visitedFaces,
+    std::vector<Face*>& visitedFaces,
     Seam& seam,
     T planeEpsilon);
 
@@ -1927,14 +1984,13 @@ private:
    * ensured by unsetting the second half edge of every seam edge before calling this
    * function.
    *
-   * @tparam FaceSet a set of faces
+   * The faces that have already been visited by this function in previous calls are
+   * marked as visited.
+   *
    * @param first the half edge at which to start deleting faces
-   * @param visitedFaces the faces that have already been visited by this function in
-   * previous calls
    * @param verticesToDelete the vertices that should be deleted later
    */
-  template <typename FaceSet>
-  void deleteFaces(HalfEdge* first, FaceSet& visitedFaces, VertexList& verticesToDelete);
+  void deleteFaces(HalfEdge* first, VertexList& verticesToDelete);
 
   /**
    * Waves a new cap onto this polyhedron. The new cap will be a single polygon, so this
@@ -2246,6 +2302,34 @@ private:
   HalfEdge* findNextIntersectingEdge(
     HalfEdge* searchFrom, const vm::plane<T, 3>& plane) const;
 
+  /* ===================== Implementation in Polyhedron_Planes.h ===================== */
+public: // Construction from planes
+  /**
+   * The maximum number of planes accepted by fromPlanes.
+   */
+  static constexpr const size_t MaxPlaneCount = 16u;
+
+  /**
+   * Creates the convex polyhedron bounded by the given planes without clipping. The
+   * vertices are computed by intersecting every triple of planes and keeping the points
+   * that are inside of all half spaces, and the faces are built from the vertices on each
+   * plane.
+   *
+   * Returns std::nullopt if the planes don't bound a closed volume within the given
+   * bounds where every plane contributes a face, or if the result would be degenerate,
+   * for example, due to edges that are shorter than MinEdgeLength. Callers should then
+   * fall back to clipping, which handles all these cases. Also returns std::nullopt if
+   * fewer than 4 or more than MaxPlaneCount planes are given.
+   *
+   * The faces of the returned polyhedron are in the same order as the given planes.
+   *
+   * @param planes the planes, their normals must point out of the polyhedron
+   * @param bounds the bounds that the vertices must be within
+   * @return the polyhedron or std::nullopt
+   */
+  static std::optional<Polyhedron> fromPlanes(
+    const std::vector<vm::plane<T, 3>>& planes, const vm::bbox<T, 3>& bounds);
+
   /* ====================== Implementation in Polyhedron_CSG.h ====================== */
 public: // Intersection
   /**
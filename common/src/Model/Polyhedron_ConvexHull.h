@@ -31,7 +31,6 @@
 #include <vecmath/segment.h>
 #include <vecmath/util.h>
 
-#include <list>
 #include <unordered_set>
 #include <vector>
 
@@ -60,9 +59,10 @@ void Polyhedron<T, FP, VP>::addPoints(std::vector<vm::vec<T, 3>> points)
     points = kdl::vec_sort_and_remove_duplicates(std::move(points));
 
     const auto planeEpsilon = computePlaneEpsilon(points);
+    auto scratch = ConvexHullScratch{};
     for (const auto& point : points)
     {
-      addPoint(point, planeEpsilon);
+      addPoint(point, planeEpsilon, scratch);
     }
   }
 }
@@ -70,13 +70,21 @@ void Polyhedron<T, FP, VP>::addPoints(std::vector<vm::vec<T, 3>> points)
 template <typename T, typename FP, typename VP>
 typename Polyhedron<T, FP, VP>::Vertex* Polyhedron<T, FP, VP>::addPoint(
   const vm::vec<T, 3>& position, const T planeEpsilon)
+{
+  auto scratch = ConvexHullScratch{};
+  return addPoint(position, planeEpsilon, scratch);
+}
+
+template <typename T, typename FP, typename VP>
+typename Polyhedron<T, FP, VP>::Vertex* Polyhedron<T, FP, VP>::addPoint(
+  const vm::vec<T, 3>& position, const T planeEpsilon, ConvexHullScratch& scratch)
 {
   assert(checkInvariant());
 
   // quick test to discard vertices which would yield short edges
   for (const Vertex* v : m_vertices)
   {
-    if (vm::distance(position, v->position()) < MinEdgeLength)
+    if (vm::squared_distance(position, v->position()) < MinEdgeLength * MinEdgeLength)
     {
       return nullptr;
     }
@@ -98,7 +106,7 @@ typename Polyhedron<T, FP, VP>::Vertex* Polyhedron<T, FP, VP>::addPoint(
     m_bounds = vm::merge(m_bounds, position);
     break;
   default:
-    result = addFurtherPoint(position, planeEpsilon);
+    result = addFurtherPoint(position, planeEpsilon, scratch);
     if (result != nullptr)
     {
       m_bounds = vm::merge(m_bounds, position);
@@ -241,7 +249,7 @@ typename Polyhedron<T, FP, VP>::Vertex* Polyhedron<T, FP, VP>::addNonColinearThi
 
 template <typename T, typename FP, typename VP>
 typename Polyhedron<T, FP, VP>::Vertex* Polyhedron<T, FP, VP>::addFurtherPoint(
-  const vm::vec<T, 3>& position, const T planeEpsilon)
+  const vm::vec<T, 3>& position, const T planeEpsilon, ConvexHullScratch& scratch)
 {
   assert(faceCount() > 0u);
   if (faceCount() == 1u)
@@ -250,7 +258,7 @@ typename Polyhedron<T, FP, VP>::Vertex* Polyhedron<T, FP, VP>::addFurtherPoint(
   }
   else
   {
-    return addFurtherPointToPolyhedron(position, planeEpsilon);
+    return addFurtherPointToPolyhedron(position, planeEpsilon, scratch);
   }
 }
 
@@ -397,38 +405,42 @@ typename Polyhedron<T, FP, VP>::Vertex* Polyhedron<T, FP, VP>::makePolyhedron(
 
 template <typename T, typename FP, typename VP>
 typename Polyhedron<T, FP, VP>::Vertex* Polyhedron<T, FP, VP>::
-  addFurtherPointToPolyhedron(const vm::vec<T, 3>& position, const T planeEpsilon)
+  addFurtherPointToPolyhedron(
+    const vm::vec<T, 3>& position, const T planeEpsilon, ConvexHullScratch& scratch)
 {
   assert(polyhedron());
 
-  auto seam = createSeamForHorizon(position, planeEpsilon);
+  auto& seam = scratch.seam;
+  seam.clear();
 
   // If no correct seam could be created, we assume that the vertex was inside the
   // polyhedron. If the seam has multiple loops, this indicates that the point to be added
   // is very close to another vertex and no correct seam can be computed due to
   // imprecision. In that case, we just assume that the vertex is inside the polyhedron
   // and skip it.
-  if (!seam || seam->empty())
+  if (
+    !createSeamForHorizon(position, planeEpsilon, scratch.visitedFaces, seam)
+    || seam.empty())
   {
     return nullptr;
   }
 
-  assert(seam->size() >= 3);
+  assert(seam.size() >= 3);
 
   // Under certain circumstances, it is not possible to weave a cap onto the seam because
   // it would create a face with colinear points. In this case, we assume the vertex was
   // inside the polyhedron and skip it.
-  if (!checkSeamForWeaving(*seam, position))
+  if (!checkSeamForWeaving(seam, position))
   {
     return nullptr;
   }
 
-  if (auto cone = weaveCone(*seam, position))
+  if (auto cone = weaveCone(seam, position))
   {
     auto* top = cone->vertices.front();
 
-    split(*seam);
-    sealWithCone(std::move(*cone), *seam);
+    split(seam);
+    sealWithCone(std::move(*cone), seam);
     if (mergeCoplanarIncidentFaces(top, planeEpsilon))
     {
       return top;
@@ -442,7 +454,8 @@ template <typename T, typename FP, typename VP>
 class Polyhedron<T, FP, VP>::Seam
 {
 private:
-  using List = std::list<Edge*>;
+  // seams are short, so a vector is cheaper than a list even when replacing edges
+  using List = std::vector<Edge*>;
   List m_edges;
 
 public:
@@ -477,8 +490,7 @@ public:
   void replace(
     typename List::iterator first, typename List::iterator end, Edge* replacement)
   {
-    m_edges.erase(first, end);
-    m_edges.insert(end, replacement);
+    m_edges.insert(m_edges.erase(first, end), replacement);
     assert(check());
   }
 
@@ -635,9 +647,22 @@ private:
 };
 
 template <typename T, typename FP, typename VP>
-std::optional<typename Polyhedron<T, FP, VP>::Seam> Polyhedron<T, FP, VP>::
-  createSeamForHorizon(const vm::vec<T, 3>& position, const T planeEpsilon)
+struct Polyhedron<T, FP, VP>::ConvexHullScratch
 {
+  std::vector<Face*> visitedFaces;
+  Seam seam;
+};
+
+template <typename T, typename FP, typename VP>
+bool Polyhedron<T, FP, VP>::createSeamForHorizon(
+  const vm::vec<T, 3>& position,
+  const T planeEpsilon,
+  std::vector<Face*>& visitedFaces,
+  Seam& seam)
+{
+  assert(visitedFaces.empty());
+  assert(seam.empty());
+
   Face* initialVisibleFace = nullptr;
   for (Face* face : m_faces)
   {
@@ -650,23 +675,29 @@ std::optional<typename Polyhedron<T, FP, VP>::Seam> Polyhedron<T, FP, VP>::
 
   if (initialVisibleFace == nullptr)
   {
-    return std::nullopt;
+    return false;
   }
 
-  Seam seam;
-
-  std::unordered_set<Face*> visitedFaces{initialVisibleFace};
+  // the visited faces are marked, and they are remembered to unset their marks afterwards
+  visitedFaces.push_back(initialVisibleFace);
+  initialVisibleFace->m_visited = true;
   visitFace(
     position, initialVisibleFace->boundary().front(), visitedFaces, seam, planeEpsilon);
 
-  return seam;
+  for (Face* face : visitedFaces)
+  {
+    face->m_visited = false;
+  }
+  visitedFaces.clear();
+
+  return true;
 }
 
 template <typename T, typename FP, typename VP>
 void Polyhedron<T, FP, VP>::visitFace(
   const vm::vec<T, 3>& position,
   HalfEdge* initialBoundaryEdge,
-  std::unordered_set<Face*>& visitedFaces,
+  std::vector<Face*>& visitedFaces,
   Seam& seam,
   const T planeEpsilon)
 {
@@ -677,8 +708,10 @@ void Polyhedron<T, FP, VP>::visitFace(
     if (
       neighbour->plane().point_status(position, planeEpsilon) != vm::plane_status::below)
     {
-      if (visitedFaces.insert(neighbour).second)
+      if (!neighbour->m_visited)
       {
+        neighbour->m_visited = true;
+        visitedFaces.push_back(neighbour);
         visitFace(
           position, currentBoundaryEdge->twin(), visitedFaces, seam, planeEpsilon);
       }
@@ -721,25 +754,24 @@ void Polyhedron<T, FP, VP>::split(const Seam& seam)
   // seam edges will also not be deleted.
   // The first half edge we remembered above is our entry point into that portion of the
   // polyhedron. We must remember which faces we have already visited to stop the
-  // recursion.
-  std::unordered_set<Face*> visitedFaces;
+  // recursion, which is done by marking them. Their marks need not be unset because they
+  // are deleted.
   VertexList
     verticesToDelete; // Will automatically delete the vertices when it falls out of scope
-  deleteFaces(first, visitedFaces, verticesToDelete);
+  deleteFaces(first, verticesToDelete);
 }
 
 template <typename T, typename FP, typename VP>
-template <typename FaceSet>
-void Polyhedron<T, FP, VP>::deleteFaces(
-  HalfEdge* first, FaceSet& visitedFaces, VertexList& verticesToDelete)
+void Polyhedron<T, FP, VP>::deleteFaces(HalfEdge* first, VertexList& verticesToDelete)
 {
   Face* face = first->face();
 
   // Have we already visited this face?
-  if (!visitedFaces.insert(face).second)
+  if (face->m_visited)
   {
     return;
   }
+  face->m_visited = true;
 
   HalfEdge* current = first;
   do
@@ -756,7 +788,7 @@ void Polyhedron<T, FP, VP>::deleteFaces(
       // of our callers. In that case, the call to deleteFaces returned immediately.
       if (edge->fullySpecified())
       {
-        deleteFaces(edge->twin(current), visitedFaces, verticesToDelete);
+        deleteFaces(edge->twin(current), verticesToDelete);
       }
 
       if (edge->fullySpecified())
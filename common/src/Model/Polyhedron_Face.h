@@ -61,6 +61,7 @@ Polyhedron_Face<T, FP, VP>::Polyhedron_Face(
   : m_boundary(std::move(boundary))
   , m_plane(plane)
   , m_payload(FP::defaultValue())
+  , m_visited(false)
   ,
 #ifdef _MSC_VER
 // MSVC throws a warning because we're passing this to the FaceLink constructor, but it's
@@ -342,20 +343,24 @@ bool Polyhedron_Face<T, FP, VP>::coplanar(const Face* other, const T epsilon) co
 {
   assert(other != nullptr);
 
+  // Computing a normal normalizes a cross product, so each normal is computed only once.
+  const auto myNormal = normal();
+  const auto otherNormal = other->normal();
+
   // Test if the normals are colinear by checking their enclosed angle.
-  if (1.0 - dot(normal(), other->normal()) >= vm::constants<T>::colinear_epsilon())
+  if (1.0 - dot(myNormal, otherNormal) >= vm::constants<T>::colinear_epsilon())
   {
     return false;
   }
 
-  const vm::plane<T, 3> myPlane(m_boundary.front()->origin()->position(), normal());
+  const vm::plane<T, 3> myPlane(m_boundary.front()->origin()->position(), myNormal);
   if (!other->verticesOnPlane(myPlane, epsilon))
   {
     return false;
   }
 
   const vm::plane<T, 3> otherPlane(
-    other->boundary().front()->origin()->position(), other->normal());
+    other->boundary().front()->origin()->position(), otherNormal);
   return verticesOnPlane(otherPlane, epsilon);
 }
 
@@ -24,6 +24,8 @@
 #include <kdl/vector_utils.h>
 
 #include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
 #include <vecmath/plane.h>
 #include <vecmath/ray.h>
 #include <vecmath/scalar.h>
@@ -31,9 +33,10 @@
 #include <vecmath/vec.h>
 #include <vecmath/vec_io.h>
 
+#include <algorithm>
 #include <sstream>
-#include <unordered_map>
-#include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace TrenchBroom
 {
@@ -219,6 +222,7 @@ Polyhedron<T, FP, VP>::Polyhedron(std::vector<vm::vec<T, 3>> positions)
 
 template <typename T, typename FP, typename VP>
 Polyhedron<T, FP, VP>::Polyhedron(const Polyhedron<T, FP, VP>& other)
+  : m_bounds(other.m_bounds)
 {
   Copy copy(other.faces(), other.edges(), other.vertices(), *this, CopyCallback());
 }
@@ -226,6 +230,7 @@ Polyhedron<T, FP, VP>::Polyhedron(const Polyhedron<T, FP, VP>& other)
 template <typename T, typename FP, typename VP>
 Polyhedron<T, FP, VP>::Polyhedron(
   const Polyhedron<T, FP, VP>& other, const CopyCallback& callback)
+  : m_bounds(other.m_bounds)
 {
   Copy copy(other.faces(), other.edges(), other.vertices(), *this, callback);
 }
@@ -259,11 +264,10 @@ template <typename T, typename FP, typename VP>
 class Polyhedron<T, FP, VP>::Copy
 {
 private:
-  using VertexMap = std::unordered_map<const Vertex*, Vertex*>;
-  using VertexMapEntry = typename VertexMap::value_type;
-
-  using HalfEdgeMap = std::unordered_map<const HalfEdge*, HalfEdge*>;
-  using HalfEdgeMapEntry = typename HalfEdgeMap::value_type;
+  // Sorted vectors of (original, copy) pairs are much cheaper to build than hash maps
+  // for the small number of elements that a polyhedron usually has.
+  using VertexMap = std::vector<std::pair<const Vertex*, Vertex*>>;
+  using HalfEdgeMap = std::vector<std::pair<const HalfEdge*, HalfEdge*>>;
 
   /**
    * Maps the vertices of the original to their copies.
@@ -304,7 +308,8 @@ public:
    * @param originalFaces the faces to copy
    * @param originalEdges the edges to copy
    * @param originalVertices the vertices to copy
-   * @param destination the destination polyhedron that will become a copy
+   * @param destination the destination polyhedron that will become a copy, its bounds
+   * are not updated
    * @param callback the callback to call for every created face or vertex             *
    */
   Copy(
@@ -315,8 +320,15 @@ public:
     const CopyCallback& callback)
     : m_destination(destination)
   {
+    m_vertexMap.reserve(originalVertices.size());
+    m_halfEdgeMap.reserve(2u * originalEdges.size());
+
     copyVertices(originalVertices, callback);
+    std::sort(std::begin(m_vertexMap), std::end(m_vertexMap));
+
     copyFaces(originalFaces, callback);
+    std::sort(std::begin(m_halfEdgeMap), std::end(m_halfEdgeMap));
+
     copyEdges(originalEdges);
     swapContents();
   }
@@ -328,8 +340,7 @@ private:
     {
       Vertex* copy = new Vertex(currentVertex->position());
       callback.vertexWasCopied(currentVertex, copy);
-      assert(m_vertexMap.count(currentVertex) == 0u);
-      m_vertexMap.insert(std::make_pair(currentVertex, copy));
+      m_vertexMap.emplace_back(currentVertex, copy);
       m_vertices.push_back(copy);
       currentVertex = currentVertex->next();
     }
@@ -363,16 +374,26 @@ private:
 
     Vertex* myOrigin = findVertex(originalOrigin);
     HalfEdge* copy = new HalfEdge(myOrigin);
-    assert(m_halfEdgeMap.count(original) == 0u);
-    m_halfEdgeMap.insert(std::make_pair(original, copy));
+    m_halfEdgeMap.emplace_back(original, copy);
     return copy;
   }
 
+  template <typename Map, typename Element>
+  static auto* findCopy(const Map& map, const Element* original)
+  {
+    const auto it = std::lower_bound(
+      std::begin(map),
+      std::end(map),
+      original,
+      [](const auto& entry, const Element* value) { return entry.first < value; });
+    return it != std::end(map) && it->first == original ? it->second : nullptr;
+  }
+
   Vertex* findVertex(const Vertex* original)
   {
-    typename VertexMap::iterator it = m_vertexMap.find(original);
-    assert(it != std::end(m_vertexMap));
-    return it->second;
+    auto* copy = findCopy(m_vertexMap, original);
+    assert(copy != nullptr);
+    return copy;
   }
 
   void copyEdges(const EdgeList& originalEdges)
@@ -397,19 +418,16 @@ private:
 
   HalfEdge* findOrCopyHalfEdge(const HalfEdge* original)
   {
-    auto it = m_halfEdgeMap.find(original);
-    if (it == std::end(m_halfEdgeMap))
+    if (auto* copy = findCopy(m_halfEdgeMap, original))
     {
-      const Vertex* originalOrigin = original->origin();
-      Vertex* myOrigin = findVertex(originalOrigin);
-      HalfEdge* copy = new HalfEdge(myOrigin);
-      m_halfEdgeMap.insert(std::make_pair(original, copy));
       return copy;
     }
-    else
-    {
-      return it->second;
-    }
+
+    // a half edge that doesn't belong to a face belongs to exactly one edge, so it is
+    // only copied once and does not need to be added to the map
+    const Vertex* originalOrigin = original->origin();
+    Vertex* myOrigin = findVertex(originalOrigin);
+    return new HalfEdge(myOrigin);
   }
 
   void swapContents()
@@ -418,7 +436,6 @@ private:
     swap(m_vertices, m_destination.m_vertices);
     swap(m_edges, m_destination.m_edges);
     swap(m_faces, m_destination.m_faces);
-    m_destination.updateBounds();
   }
 };
 
@@ -822,6 +839,20 @@ void Polyhedron<T, FP, VP>::updateBounds()
   }
 }
 
+template <typename T, typename FP, typename VP>
+void Polyhedron<T, FP, VP>::transform(const vm::mat<T, 4, 4>& transformation)
+{
+  for (auto* vertex : m_vertices)
+  {
+    vertex->setPosition(transformation * vertex->position());
+  }
+  for (auto* face : m_faces)
+  {
+    face->setPlane(face->plane().transform(transformation));
+  }
+  updateBounds();
+}
+
 template <typename T, typename FP, typename VP>
 void Polyhedron<T, FP, VP>::correctVertexPositions(const size_t decimals, const T epsilon)
 {
@@ -0,0 +1,270 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Polyhedron.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/plane.h>
+#include <vecmath/scalar.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <optional>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+template <typename T, typename FP, typename VP>
+std::optional<Polyhedron<T, FP, VP>> Polyhedron<T, FP, VP>::fromPlanes(
+  const std::vector<vm::plane<T, 3>>& planes, const vm::bbox<T, 3>& bounds)
+{
+  const auto planeCount = planes.size();
+  if (planeCount < 4u || planeCount > MaxPlaneCount)
+  {
+    return std::nullopt;
+  }
+
+  const auto epsilon = vm::constants<T>::point_status_epsilon();
+  const auto minEdgeLength2 = MinEdgeLength * MinEdgeLength;
+
+  // Store the planes as a structure of arrays so that the compiler can vectorize the
+  // half space tests.
+  auto nx = std::array<T, MaxPlaneCount>{};
+  auto ny = std::array<T, MaxPlaneCount>{};
+  auto nz = std::array<T, MaxPlaneCount>{};
+  auto d = std::array<T, MaxPlaneCount>{};
+  for (size_t i = 0u; i < planeCount; ++i)
+  {
+    nx[i] = planes[i].normal.x();
+    ny[i] = planes[i].normal.y();
+    nz[i] = planes[i].normal.z();
+    d[i] = planes[i].distance;
+  }
+
+  const auto maxDistance = [&](const vm::vec<T, 3>& point) {
+    auto distances = std::array<T, MaxPlaneCount>{};
+    for (size_t i = 0u; i < MaxPlaneCount; ++i)
+    {
+      distances[i] = nx[i] * point.x() + ny[i] * point.y() + nz[i] * point.z() - d[i];
+    }
+    return *std::max_element(std::begin(distances), std::begin(distances) + planeCount);
+  };
+
+  const auto insideBounds = [&](const vm::vec<T, 3>& point) {
+    for (size_t i = 0u; i < 3u; ++i)
+    {
+      if (point[i] <= bounds.min[i] + epsilon || point[i] >= bounds.max[i] - epsilon)
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // Find the vertices by intersecting every triple of planes.
+  auto positions = std::vector<vm::vec<T, 3>>{};
+  for (size_t i = 0u; i < planeCount; ++i)
+  {
+    for (size_t j = i + 1u; j < planeCount; ++j)
+    {
+      const auto& pi = planes[i];
+      const auto& pj = planes[j];
+      const auto nij = vm::cross(pi.normal, pj.normal);
+
+      for (size_t k = j + 1u; k < planeCount; ++k)
+      {
+        const auto& pk = planes[k];
+        const auto det = vm::dot(nij, pk.normal);
+        if (vm::abs(det) < vm::constants<T>::almost_zero())
+        {
+          continue;
+        }
+
+        const auto position = (pi.distance * vm::cross(pj.normal, pk.normal)
+                               + pj.distance * vm::cross(pk.normal, pi.normal)
+                               + pk.distance * nij)
+                              / det;
+        if (maxDistance(position) > epsilon)
+        {
+          continue;
+        }
+
+        if (!insideBounds(position))
+        {
+          // clipping must decide whether the brush is incomplete
+          return std::nullopt;
+        }
+
+        auto isNew = true;
+        for (const auto& other : positions)
+        {
+          const auto distance2 = vm::squared_distance(position, other);
+          if (distance2 <= epsilon * epsilon)
+          {
+            isNew = false;
+            break;
+          }
+          if (distance2 < minEdgeLength2)
+          {
+            // clipping and healing must decide how to handle short edges
+            return std::nullopt;
+          }
+        }
+
+        if (isNew)
+        {
+          positions.push_back(position);
+        }
+      }
+    }
+  }
+
+  const auto vertexCount = positions.size();
+  if (vertexCount < 4u)
+  {
+    return std::nullopt;
+  }
+
+  // For each plane, find the incident vertices and sort them counter clockwise around
+  // the plane normal.
+  auto faceVertices = std::vector<std::vector<size_t>>(planeCount);
+  for (size_t i = 0u; i < planeCount; ++i)
+  {
+    const auto& plane = planes[i];
+    auto& indices = faceVertices[i];
+    auto center = vm::vec<T, 3>{};
+    for (size_t v = 0u; v < vertexCount; ++v)
+    {
+      if (vm::abs(plane.point_distance(positions[v])) <= epsilon)
+      {
+        indices.push_back(v);
+        center = center + positions[v];
+      }
+    }
+
+    if (indices.size() < 3u)
+    {
+      // the plane is redundant or only touches the polyhedron
+      return std::nullopt;
+    }
+
+    center = center / static_cast<T>(indices.size());
+    const auto u = vm::normalize(positions[indices.front()] - center);
+    const auto w = vm::cross(plane.normal, u);
+    const auto angle = [&](const size_t v) {
+      const auto offset = positions[v] - center;
+      return std::atan2(vm::dot(offset, w), vm::dot(offset, u));
+    };
+    std::sort(
+      std::begin(indices), std::end(indices), [&](const auto lhs, const auto rhs) {
+        return angle(lhs) < angle(rhs);
+      });
+
+    // every vertex of a face must be a corner of a strictly convex polygon
+    for (size_t k = 0u; k < indices.size(); ++k)
+    {
+      const auto& p0 = positions[indices[k]];
+      const auto& p1 = positions[indices[(k + 1u) % indices.size()]];
+      const auto& p2 = positions[indices[(k + 2u) % indices.size()]];
+      if (vm::dot(vm::cross(p1 - p0, p2 - p1), plane.normal) <= T(0))
+      {
+        return std::nullopt;
+      }
+    }
+  }
+
+  // Build the half edge structure. The result's lists own all elements created so far,
+  // so they are destroyed if we have to bail out.
+  auto result = Polyhedron{};
+
+  auto vertices = std::vector<Vertex*>{};
+  vertices.reserve(vertexCount);
+  for (const auto& position : positions)
+  {
+    auto* vertex = new Vertex(position);
+    result.m_vertices.push_back(vertex);
+    vertices.push_back(vertex);
+  }
+
+  // maps a pair of vertex indices (origin, destination) to the half edge connecting them
+  auto halfEdges = std::vector<HalfEdge*>(vertexCount * vertexCount, nullptr);
+  for (size_t i = 0u; i < planeCount; ++i)
+  {
+    const auto& indices = faceVertices[i];
+
+    auto boundary = HalfEdgeList{};
+    for (size_t k = 0u; k < indices.size(); ++k)
+    {
+      const auto origin = indices[k];
+      const auto destination = indices[(k + 1u) % indices.size()];
+
+      auto* halfEdge = new HalfEdge(vertices[origin]);
+      boundary.push_back(halfEdge);
+
+      auto& slot = halfEdges[origin * vertexCount + destination];
+      if (slot != nullptr)
+      {
+        // two faces share a directed edge, so some planes must be duplicates
+        return std::nullopt;
+      }
+      slot = halfEdge;
+    }
+
+    result.m_faces.push_back(new Face(std::move(boundary), planes[i]));
+  }
+
+  for (size_t origin = 0u; origin < vertexCount; ++origin)
+  {
+    for (size_t destination = 0u; destination < vertexCount; ++destination)
+    {
+      if (auto* halfEdge = halfEdges[origin * vertexCount + destination])
+      {
+        auto* twin = halfEdges[destination * vertexCount + origin];
+        if (twin == nullptr)
+        {
+          // the polyhedron is not closed
+          return std::nullopt;
+        }
+        if (origin < destination)
+        {
+          result.m_edges.push_back(new Edge(halfEdge, twin));
+        }
+      }
+    }
+  }
+
+  if (
+    result.vertexCount() + result.faceCount() != result.edgeCount() + 2u
+    || !result.checkEdgeLengths())
+  {
+    return std::nullopt;
+  }
+
+  result.updateBounds();
+  assert(result.checkInvariant());
+  return result;
+}
+} // namespace Model
+} // namespace TrenchBroom
@@ -39,7 +39,9 @@
 #include <kdl/struct_io.h>
 #include <kdl/vector_utils.h>
 
+#include <mutex>
 #include <ostream>
+#include <shared_mutex>
 #include <vector>
 
 namespace TrenchBroom
@@ -147,7 +149,7 @@ std::unique_ptr<TagMatcher> TextureNameTagMatcher::clone() const
 bool TextureNameTagMatcher::matches(const Taggable& taggable) const
 {
   BrushFaceMatchVisitor visitor([this](const BrushFace& face) {
-    return matchesTextureName(face.attributes().textureName());
+    return matchesTextureName(face.attributes().internedTextureName());
   });
 
   taggable.accept(visitor);
@@ -185,6 +187,25 @@ bool TextureNameTagMatcher::matchesTextureName(std::string_view textureName) con
   return kdl::ci::str_matches_glob(textureName, m_pattern);
 }
 
+bool TextureNameTagMatcher::matchesTextureName(
+  const kdl::interned_string& textureName) const
+{
+  {
+    const auto lock = std::shared_lock<std::shared_mutex>{m_cacheMutex};
+    const auto it = m_cache.find(textureName);
+    if (it != m_cache.end())
+    {
+      return it->second;
+    }
+  }
+
+  const auto result = matchesTextureName(std::string_view{textureName.str()});
+
+  const auto lock = std::unique_lock<std::shared_mutex>{m_cacheMutex};
+  m_cache.emplace(textureName, result);
+  return result;
+}
+
 SurfaceParmTagMatcher::SurfaceParmTagMatcher(const std::string& parameter)
   : m_parameters({parameter})
 {
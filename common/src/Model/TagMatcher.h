@@ -23,13 +23,16 @@
 #include "Model/Tag.h"
 #include "Model/TagVisitor.h"
 
+#include <kdl/interned_string.h>
 #include <kdl/vector_set.h>
 
 #include <functional>
 #include <iosfwd>
 #include <memory>
+#include <shared_mutex>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom
@@ -100,6 +103,10 @@ class TextureNameTagMatcher : public TextureTagMatcher
 private:
   std::string m_pattern;
 
+  // caches the match results for face texture names, which are interned
+  mutable std::shared_mutex m_cacheMutex;
+  mutable std::unordered_map<kdl::interned_string, bool> m_cache;
+
 public:
   explicit TextureNameTagMatcher(const std::string& pattern);
   std::unique_ptr<TagMatcher> clone() const override;
@@ -109,6 +116,7 @@ public:
 private:
   bool matchesTexture(const Assets::Texture* texture) const override;
   bool matchesTextureName(std::string_view textureName) const;
+  bool matchesTextureName(const kdl::interned_string& textureName) const;
 };
 
 class SurfaceParmTagMatcher : public TextureTagMatcher
@@ -25,12 +25,19 @@
 #include "Model/EntityNode.h"
 #include "Model/EntityNodeIndex.h"
 #include "Model/GroupNode.h"
+#include "Model/Hit.h"
 #include "Model/LayerNode.h"
 #include "Model/PatchNode.h"
+#include "Model/PickResult.h"
 #include "Model/TagVisitor.h"
 #include "Model/Validator.h"
 #include "Model/ValidatorRegistry.h"
+
+#ifdef TB_USE_AABB_NODE_TREE
+#include "aabb_tree.h"
+#else
 #include "octree.h"
+#endif
 
 #include <kdl/overload.h>
 #include <kdl/result.h>
@@ -38,14 +45,40 @@
 
 #include <vecmath/bbox_io.h>
 
+#include <atomic>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom
 {
 namespace Model
 {
+namespace
+{
+template <typename NodeTree>
+std::unique_ptr<NodeTree> createNodeTree()
+{
+#ifdef TB_USE_AABB_NODE_TREE
+  return std::make_unique<NodeTree>();
+#else
+  return std::make_unique<NodeTree>(256.0);
+#endif
+}
+
+/**
+ * Returns a node tree revision that no world has used before, so that a revision also
+ * identifies a world whose address is reused after another world was destroyed.
+ */
+size_t nextNodeTreeRevision()
+{
+  static auto lastRevision = std::atomic<size_t>{0};
+  return ++lastRevision;
+}
+} // namespace
+
 WorldNode::WorldNode(
   EntityPropertyConfig entityPropertyConfig, Entity entity, const MapFormat mapFormat)
   : m_entityPropertyConfig{std::move(entityPropertyConfig)}
@@ -53,8 +86,9 @@ WorldNode::WorldNode(
   , m_defaultLayer{nullptr}
   , m_entityNodeIndex{std::make_unique<EntityNodeIndex>()}
   , m_validatorRegistry{std::make_unique<ValidatorRegistry>()}
-  , m_nodeTree{std::make_unique<NodeTree>(256.0)}
+  , m_nodeTree{createNodeTree<NodeTree>()}
   , m_updateNodeTree{true}
+  , m_nodeTreeRevision{nextNodeTreeRevision()}
 {
   entity.addOrUpdateProperty(
     m_entityPropertyConfig,
@@ -208,6 +242,27 @@ void WorldNode::unregisterAllValidators()
   invalidateAllIssues();
 }
 
+std::vector<Node*> WorldNode::findNodesIntersecting(const vm::bbox3& bounds) const
+{
+  // the node tree may return nodes whose bounds do not intersect the given bounds
+  return kdl::vec_filter(m_nodeTree->find_overlapping(bounds), [&](const Node* node) {
+    return node->physicalBounds().intersects(bounds);
+  });
+}
+
+std::vector<Node*> WorldNode::findNodesInFrustum(
+  const std::vector<vm::plane3>& frustumPlanes) const
+{
+  return m_nodeTree->find_in_frustum(
+    frustumPlanes,
+    [](const Node* node) -> const vm::bbox3& { return node->physicalBounds(); });
+}
+
+size_t WorldNode::nodeTreeRevision() const
+{
+  return m_nodeTreeRevision;
+}
+
 void WorldNode::disableNodeTreeUpdates()
 {
   m_updateNodeTree = false;
@@ -248,11 +303,10 @@ void WorldNode::rebuildNodeTree()
     [&](BrushNode* brush) { addNode(brush); },
     [&](PatchNode* patch) { addNode(patch); }));
 
-  m_nodeTree->clear();
-  for (auto* node : nodes)
-  {
-    m_nodeTree->insert(node->physicalBounds(), node);
-  }
+  m_nodeTree->build(kdl::vec_transform(std::move(nodes), [](Model::Node* node) {
+    return std::make_pair(node->physicalBounds(), node);
+  }));
+  m_nodeTreeRevision = nextNodeTreeRevision();
 }
 
 void WorldNode::invalidateAllIssues()
@@ -347,6 +401,8 @@ bool WorldNode::doShouldAddToSpacialIndex() const
 
 void WorldNode::doDescendantWasAdded(Node* node, const size_t /* depth */)
 {
+  m_nodeTreeRevision = nextNodeTreeRevision();
+
   // NOTE: `node` is just the root of a subtree that is being connected to this World.
   // In some cases, (e.g. if `node` is a Group), `node` will not be added to the spatial
   // index, but some of its descendants may be. We need to recursively search the `node`
@@ -399,6 +455,8 @@ void WorldNode::doDescendantWasAdded(Node* node, const size_t /* depth */)
 
 void WorldNode::doDescendantWillBeRemoved(Node* node, const size_t /* depth */)
 {
+  m_nodeTreeRevision = nextNodeTreeRevision();
+
   if (m_updateNodeTree)
   {
     const auto doRemove = [&](auto* nodeToRemove) {
@@ -426,6 +484,8 @@ void WorldNode::doDescendantWillBeRemoved(Node* node, const size_t /* depth */)
 
 void WorldNode::doDescendantPhysicalBoundsDidChange(Node* node)
 {
+  m_nodeTreeRevision = nextNodeTreeRevision();
+
   if (m_updateNodeTree)
   {
     node->accept(kdl::overload(
@@ -446,10 +506,15 @@ bool WorldNode::doSelectable() const
 void WorldNode::doPick(
   const EditorContext& editorContext, const vm::ray3& ray, PickResult& pickResult)
 {
-  for (auto* node : m_nodeTree->find_intersectors(ray))
-  {
-    node->pick(editorContext, ray, pickResult);
-  }
+  m_nodeTree->visit_intersectors_by_distance(
+    ray,
+    [](const Node* node) -> const vm::bbox3& { return node->physicalBounds(); },
+    [&](Node* node) {
+      node->pick(editorContext, ray, pickResult);
+
+      // skip every node the ray enters beyond the hits that the pick result keeps
+      return pickResult.maxDistance();
+    });
 }
 
 void WorldNode::doFindNodesContaining(const vm::vec3& point, std::vector<Node*>& result)
@@ -35,8 +35,13 @@
 
 namespace TrenchBroom
 {
+#ifdef TB_USE_AABB_NODE_TREE
+template <typename T, typename U>
+class aabb_tree;
+#else
 template <typename T, typename U>
 class octree;
+#endif
 
 namespace Model
 {
@@ -56,9 +61,14 @@ private:
   std::unique_ptr<EntityNodeIndex> m_entityNodeIndex;
   std::unique_ptr<ValidatorRegistry> m_validatorRegistry;
 
+#ifdef TB_USE_AABB_NODE_TREE
+  using NodeTree = aabb_tree<FloatType, Node*>;
+#else
   using NodeTree = octree<FloatType, Node*>;
+#endif
   std::unique_ptr<NodeTree> m_nodeTree;
   bool m_updateNodeTree;
+  size_t m_nodeTreeRevision;
 
   IdType m_nextPersistentId = 1;
 
@@ -137,6 +147,30 @@ public: // validator registration
   void registerValidator(std::unique_ptr<Validator> validator);
   void unregisterAllValidators();
 
+public: // spatial queries
+  /**
+   * Returns every node in the node tree whose physical bounds intersect the given bounds.
+   */
+  std::vector<Node*> findNodesIntersecting(const vm::bbox3& bounds) const;
+
+  /**
+   * Returns every node in the node tree whose physical bounds are not entirely above any
+   * of the given planes.
+   *
+   * If the planes are the planes of a view frustum with their normals pointing outward,
+   * then these are the nodes which may be visible in the frustum.
+   */
+  std::vector<Node*> findNodesInFrustum(
+    const std::vector<vm::plane3>& frustumPlanes) const;
+
+  /**
+   * Returns a number that changes whenever a node is added to or removed from the node
+   * tree or whenever the physical bounds of such a node change. Results of the above
+   * queries remain valid for as long as this number does not change. No two worlds share
+   * a revision, even if one of them is created after the other was destroyed.
+   */
+  size_t nodeTreeRevision() const;
+
 public: // node tree bulk updating
   void disableNodeTreeUpdates();
   void enableNodeTreeUpdates();
@@ -25,6 +25,7 @@
 #include "Model/Polyhedron.h"
 
 #include <algorithm>
+#include <unordered_map>
 
 namespace TrenchBroom
 {
@@ -80,6 +81,12 @@ void BrushRendererBrushCache::validateVertexCache(const Model::BrushNode& brushN
   m_cachedFacesSortedByTexture.clear();
   m_cachedFacesSortedByTexture.reserve(brush.faceCount());
 
+  // The index of each vertex, relative to the brush's first vertex being 0. This is
+  // used below when building the edge cache. It is not stored in the vertex payloads
+  // because the geometry may be shared with copies of the brush.
+  auto vertexIndices = std::unordered_map<const Model::BrushVertex*, GLuint>{};
+  vertexIndices.reserve(brush.vertexCount());
+
   for (const auto& face : brush.faces())
   {
     const auto indexOfFirstVertexRelativeToBrush = m_cachedVertices.size();
@@ -91,12 +98,10 @@ void BrushRendererBrushCache::validateVertexCache(const Model::BrushNode& brushN
       auto* currentHalfEdge = *it;
       auto* vertex = currentHalfEdge->origin();
 
-      // Set the vertex payload to the index, relative to the brush's first vertex being
-      // 0. This is used below when building the edge cache. NOTE: we'll overwrite the
-      // payload as we visit the same vertex several times while visiting different faces,
-      // this is fine.
+      // NOTE: we'll overwrite the index as we visit the same vertex several times while
+      // visiting different faces, this is fine.
       const auto currentIndex = m_cachedVertices.size();
-      vertex->setPayload(static_cast<GLuint>(currentIndex));
+      vertexIndices[vertex] = static_cast<GLuint>(currentIndex);
 
       const auto& position = vertex->position();
       m_cachedVertices.emplace_back(
@@ -134,8 +139,9 @@ void BrushRendererBrushCache::validateVertexCache(const Model::BrushNode& brushN
     const auto& face1 = brush.face(*faceIndex1);
     const auto& face2 = brush.face(*faceIndex2);
 
-    const auto vertexIndex1RelativeToBrush = currentEdge->firstVertex()->payload();
-    const auto vertexIndex2RelativeToBrush = currentEdge->secondVertex()->payload();
+    const auto vertexIndex1RelativeToBrush = vertexIndices.at(currentEdge->firstVertex());
+    const auto vertexIndex2RelativeToBrush =
+      vertexIndices.at(currentEdge->secondVertex());
 
     m_cachedEdges.emplace_back(
       &face1, &face2, vertexIndex1RelativeToBrush, vertexIndex2RelativeToBrush);
@@ -124,8 +124,8 @@ private:
       glAssert(glDrawElements(
         toGL(primType),
         static_cast<GLsizei>(count),
-        GL_UNSIGNED_INT,
-        reinterpret_cast<void*>(offset * 4u)));
+        glType<Index>(),
+        reinterpret_cast<void*>(offset * sizeof(Index))));
     }
 
   private:
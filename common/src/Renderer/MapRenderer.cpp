@@ -39,6 +39,7 @@
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
 #include "Renderer/RenderUtils.h"
+#include "Renderer/Transformation.h"
 #include "View/MapDocument.h"
 #include "View/Selection.h"
 
@@ -46,6 +47,8 @@
 #include <kdl/overload.h>
 #include <kdl/vector_set.h>
 
+#include <vecmath/mat.h>
+
 #include <set>
 #include <vector>
 
@@ -279,12 +282,53 @@ void MapRenderer::renderDefaultTransparent(
   m_defaultRenderer->renderTransparent(renderContext, renderBatch);
 }
 
+class PushModelMatrix : public Renderable
+{
+private:
+  vm::mat4x4f m_modelMatrix;
+
+public:
+  explicit PushModelMatrix(const vm::mat4x4f& modelMatrix)
+    : m_modelMatrix{modelMatrix}
+  {
+  }
+
+private:
+  void doRender(RenderContext& renderContext) override
+  {
+    renderContext.transformation().pushModelMatrix(m_modelMatrix);
+  }
+};
+
+class PopModelMatrix : public Renderable
+{
+private:
+  void doRender(RenderContext& renderContext) override
+  {
+    renderContext.transformation().popModelMatrix();
+  }
+};
+
 void MapRenderer::renderSelectionOpaque(
   RenderContext& renderContext, RenderBatch& renderBatch)
 {
   if (!renderContext.hideSelection())
   {
+    // while a tool previews a transformation, the selection is rendered with the
+    // transformation as its model matrix instead of being modified
+    auto document = kdl::mem_lock(m_document);
+    const auto& transformationPreview = document->transformationPreview();
+    if (transformationPreview)
+    {
+      renderBatch.addOneShot(new PushModelMatrix{vm::mat4x4f{*transformationPreview}});
+    }
+
     m_selectionRenderer->renderOpaque(renderContext, renderBatch);
+
+    if (transformationPreview)
+    {
+      renderBatch.addOneShot(new PopModelMatrix{});
+    }
   }
 }
 
@@ -293,7 +337,19 @@ void MapRenderer::renderSelectionTransparent(
 {
   if (!renderContext.hideSelection())
   {
+    auto document = kdl::mem_lock(m_document);
+    const auto& transformationPreview = document->transformationPreview();
+    if (transformationPreview)
+    {
+      renderBatch.addOneShot(new PushModelMatrix{vm::mat4x4f{*transformationPreview}});
+    }
+
     m_selectionRenderer->renderTransparent(renderContext, renderBatch);
+
+    if (transformationPreview)
+    {
+      renderBatch.addOneShot(new PopModelMatrix{});
+    }
   }
 }
 
@@ -21,6 +21,7 @@
 
 #include "Renderer/IndexArray.h"
 #include "Renderer/TexturedIndexArrayMap.h"
+#include "Renderer/TexturedIndexRangeRenderer.h"
 #include "Renderer/VertexArray.h"
 
 namespace TrenchBroom
@@ -35,7 +36,7 @@ namespace Renderer
 class VboManager;
 class TextureRenderFunc;
 
-class TexturedIndexArrayRenderer
+class TexturedIndexArrayRenderer : public TexturedRenderer
 {
 private:
   VertexArray m_vertexArray;
@@ -47,11 +48,11 @@ public:
   TexturedIndexArrayRenderer(
     VertexArray vertexArray, IndexArray indexArray, TexturedIndexArrayMap indexArrayMap);
 
-  bool empty() const;
+  bool empty() const override;
 
-  void prepare(VboManager& vboManager);
-  void render();
-  void render(TextureRenderFunc& func);
+  void prepare(VboManager& vboManager) override;
+  void render() override;
+  void render(TextureRenderFunc& func) override;
 };
 } // namespace Renderer
 } // namespace TrenchBroom
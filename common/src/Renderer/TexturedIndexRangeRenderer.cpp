@@ -73,15 +73,15 @@ void TexturedIndexRangeRenderer::render(TextureRenderFunc& func)
   }
 }
 
-MultiTexturedIndexRangeRenderer::MultiTexturedIndexRangeRenderer(
-  std::vector<std::unique_ptr<TexturedIndexRangeRenderer>> renderers)
+MultiTexturedRenderer::MultiTexturedRenderer(
+  std::vector<std::unique_ptr<TexturedRenderer>> renderers)
   : m_renderers(std::move(renderers))
 {
 }
 
-MultiTexturedIndexRangeRenderer::~MultiTexturedIndexRangeRenderer() = default;
+MultiTexturedRenderer::~MultiTexturedRenderer() = default;
 
-bool MultiTexturedIndexRangeRenderer::empty() const
+bool MultiTexturedRenderer::empty() const
 {
   for (const auto& renderer : m_renderers)
   {
@@ -93,7 +93,7 @@ bool MultiTexturedIndexRangeRenderer::empty() const
   return true;
 }
 
-void MultiTexturedIndexRangeRenderer::prepare(VboManager& vboManager)
+void MultiTexturedRenderer::prepare(VboManager& vboManager)
 {
   for (auto& renderer : m_renderers)
   {
@@ -101,7 +101,7 @@ void MultiTexturedIndexRangeRenderer::prepare(VboManager& vboManager)
   }
 }
 
-void MultiTexturedIndexRangeRenderer::render()
+void MultiTexturedRenderer::render()
 {
   for (auto& renderer : m_renderers)
   {
@@ -109,7 +109,7 @@ void MultiTexturedIndexRangeRenderer::render()
   }
 }
 
-void MultiTexturedIndexRangeRenderer::render(TextureRenderFunc& func)
+void MultiTexturedRenderer::render(TextureRenderFunc& func)
 {
   for (auto& renderer : m_renderers)
   {
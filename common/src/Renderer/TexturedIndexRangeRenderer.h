@@ -72,15 +72,14 @@ public:
   void render(TextureRenderFunc& func) override;
 };
 
-class MultiTexturedIndexRangeRenderer : public TexturedRenderer
+class MultiTexturedRenderer : public TexturedRenderer
 {
 private:
-  std::vector<std::unique_ptr<TexturedIndexRangeRenderer>> m_renderers;
+  std::vector<std::unique_ptr<TexturedRenderer>> m_renderers;
 
 public:
-  MultiTexturedIndexRangeRenderer(
-    std::vector<std::unique_ptr<TexturedIndexRangeRenderer>> renderers);
-  ~MultiTexturedIndexRangeRenderer() override;
+  MultiTexturedRenderer(std::vector<std::unique_ptr<TexturedRenderer>> renderers);
+  ~MultiTexturedRenderer() override;
 
   bool empty() const override;
 
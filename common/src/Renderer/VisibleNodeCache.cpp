@@ -0,0 +1,80 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "VisibleNodeCache.h"
+
+#include "Model/WorldNode.h"
+#include "Renderer/Camera.h"
+
+#include <vecmath/plane.h>
+#include <vecmath/vec.h>
+
+#include <utility>
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+std::vector<vm::plane3> visibilityPlanes(const Camera& camera)
+{
+  auto top = vm::plane3f{};
+  auto right = vm::plane3f{};
+  auto bottom = vm::plane3f{};
+  auto left = vm::plane3f{};
+  camera.frustumPlanes(top, right, bottom, left);
+
+  auto result = std::vector<vm::plane3>{
+    vm::plane3{top}, vm::plane3{right}, vm::plane3{bottom}, vm::plane3{left}};
+
+  // orthographic cameras see everything along their viewing direction
+  if (camera.perspectiveProjection())
+  {
+    const auto direction = vm::vec3{camera.direction()};
+    const auto farPoint =
+      vm::vec3{camera.position()} + direction * FloatType(camera.farPlane());
+    result.emplace_back(farPoint, direction);
+  }
+
+  return result;
+}
+
+const std::vector<Model::Node*>& VisibleNodeCache::visibleNodes(
+  const Camera& camera, const Model::WorldNode& world)
+{
+  auto frustumPlanes = visibilityPlanes(camera);
+  if (
+    m_world != &world || m_nodeTreeRevision != world.nodeTreeRevision()
+    || m_frustumPlanes != frustumPlanes)
+  {
+    m_visibleNodes = world.findNodesInFrustum(frustumPlanes);
+    m_world = &world;
+    m_nodeTreeRevision = world.nodeTreeRevision();
+    m_frustumPlanes = std::move(frustumPlanes);
+  }
+  return m_visibleNodes;
+}
+
+void VisibleNodeCache::invalidate()
+{
+  m_world = nullptr;
+  m_frustumPlanes.clear();
+  m_visibleNodes.clear();
+}
+} // namespace Renderer
+} // namespace TrenchBroom
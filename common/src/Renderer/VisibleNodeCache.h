@@ -0,0 +1,75 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "FloatType.h"
+
+#include <vecmath/forward.h>
+
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+class Node;
+class WorldNode;
+} // namespace Model
+
+namespace Renderer
+{
+class Camera;
+
+/**
+ * Returns the planes of the view frustum of the given camera with their normals pointing
+ * out of the frustum. For perspective cameras, this includes the far plane.
+ */
+std::vector<vm::plane3> visibilityPlanes(const Camera& camera);
+
+/**
+ * Caches the nodes of a world that may be visible to a camera.
+ *
+ * The cached nodes are recomputed when the camera's view frustum changes, when another
+ * world is passed, or when the world's node tree changes, so a renderer can ask for the
+ * visible nodes on every frame and only pays for the query when something has changed.
+ */
+class VisibleNodeCache
+{
+private:
+  const Model::WorldNode* m_world = nullptr;
+  size_t m_nodeTreeRevision = 0;
+  std::vector<vm::plane3> m_frustumPlanes;
+  std::vector<Model::Node*> m_visibleNodes;
+
+public:
+  /**
+   * Returns the nodes of the given world's node tree whose physical bounds may intersect
+   * the view frustum of the given camera.
+   */
+  const std::vector<Model::Node*>& visibleNodes(
+    const Camera& camera, const Model::WorldNode& world);
+
+  /**
+   * Discards the cached nodes.
+   */
+  void invalidate();
+};
+} // namespace Renderer
+} // namespace TrenchBroom
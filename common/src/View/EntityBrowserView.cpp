@@ -229,7 +229,7 @@ void EntityBrowserView::addEntityToLayout(
       EL::NullVariableStore{},
       m_defaultScaleModelExpression)};
 
-    auto* modelRenderer = static_cast<Renderer::TexturedRenderer*>(nullptr);
+    auto modelSpec = Assets::ModelSpecification{};
     auto rotatedBounds = vm::bbox3f{};
     auto modelOrientation = Assets::Orientation::Oriented;
 
@@ -254,7 +254,7 @@ void EntityBrowserView::addEntityToLayout(
                              * vm::rotation_matrix(m_rotation) * scalingMatrix
                              * vm::translation_matrix(-center);
 
-      modelRenderer = m_entityModelManager.renderer(spec);
+      modelSpec = spec;
       rotatedBounds = bounds.transform(transform);
     }
     else
@@ -271,7 +271,7 @@ void EntityBrowserView::addEntityToLayout(
     layout.addItem(
       EntityCellData{
         definition,
-        modelRenderer,
+        modelSpec,
         modelOrientation,
         actualFont,
         rotatedBounds,
@@ -329,7 +329,8 @@ void EntityBrowserView::renderBounds(Layout& layout, const float y, const float
           for (const auto& cell : row.cells())
           {
             const auto* definition = cellData(cell).entityDefinition;
-            auto* modelRenderer = cellData(cell).modelRenderer;
+            auto* modelRenderer =
+              m_entityModelManager.renderer(cellData(cell).modelSpec);
 
             if (modelRenderer == nullptr)
             {
@@ -387,7 +388,9 @@ void EntityBrowserView::renderModels(
         {
           for (const auto& cell : row.cells())
           {
-            if (auto* modelRenderer = cellData(cell).modelRenderer)
+            if (
+              auto* modelRenderer =
+                m_entityModelManager.renderer(cellData(cell).modelSpec))
             {
               shader.set(
                 "Orientation", static_cast<int>(cellData(cell).modelOrientation));
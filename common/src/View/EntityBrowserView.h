@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "Assets/ModelDefinition.h"
 #include "EL/Expression.h"
 #include "NotifierConnection.h"
 #include "Renderer/FontDescriptor.h"
@@ -60,9 +61,9 @@ using EntityGroupData = std::string;
 
 struct EntityCellData
 {
-  using EntityRenderer = Renderer::TexturedRenderer;
   const Assets::PointEntityDefinition* entityDefinition;
-  EntityRenderer* modelRenderer;
+  // the renderer is looked up when rendering because the model may have been evicted
+  Assets::ModelSpecification modelSpec;
   Assets::Orientation modelOrientation;
   Renderer::FontDescriptor fontDescriptor;
   vm::bbox3f bounds;
@@ -735,7 +735,9 @@ void FaceAttribsEditor::updateControls()
     for (size_t i = 1; i < faceHandles.size(); i++)
     {
       const Model::BrushFace& face = faceHandles[i].face();
-      textureMulti |= (textureName != face.attributes().textureName());
+      textureMulti |=
+        (firstFace.attributes().internedTextureName()
+         != face.attributes().internedTextureName());
       xOffsetMulti |= (xOffset != face.attributes().xOffset());
       yOffsetMulti |= (yOffset != face.attributes().yOffset());
       rotationMulti |= (rotation != face.attributes().rotation());
@@ -47,26 +47,58 @@ void Lasso::update(const vm::vec3& point)
   m_cur = point;
 }
 
+bool Lasso::mightSelect(const vm::bbox3& bounds) const
+{
+  // Projecting onto the lasso plane preserves convexity as long as all corners of the
+  // bounds are in front of the camera, so the projected bounds are then contained in the
+  // bounds of the projected corners.
+  const auto plane = getPlane();
+  const auto transform = getTransform();
+
+  auto projectedBounds = vm::bbox2::builder{};
+  for (const auto& corner : bounds.vertices())
+  {
+    const auto projected = project(corner, plane, transform);
+    if (vm::is_nan(projected))
+    {
+      return true;
+    }
+    projectedBounds.add(vm::vec2{projected});
+  }
+
+  return getBox(transform).intersects(projectedBounds.bounds());
+}
+
 bool Lasso::selects(
-  const vm::vec3& point, const vm::plane3& plane, const vm::bbox2& box) const
+  const vm::vec3& point,
+  const vm::plane3& plane,
+  const vm::mat4x4& transform,
+  const vm::bbox2& box) const
 {
-  const auto projected = project(point, plane);
+  const auto projected = project(point, plane, transform);
   return !vm::is_nan(projected) && box.contains(vm::vec2{projected});
 }
 
 bool Lasso::selects(
-  const vm::segment3& edge, const vm::plane3& plane, const vm::bbox2& box) const
+  const vm::segment3& edge,
+  const vm::plane3& plane,
+  const vm::mat4x4& transform,
+  const vm::bbox2& box) const
 {
-  return selects(edge.center(), plane, box);
+  return selects(edge.center(), plane, transform, box);
 }
 
 bool Lasso::selects(
-  const vm::polygon3& polygon, const vm::plane3& plane, const vm::bbox2& box) const
+  const vm::polygon3& polygon,
+  const vm::plane3& plane,
+  const vm::mat4x4& transform,
+  const vm::bbox2& box) const
 {
-  return selects(polygon.center(), plane, box);
+  return selects(polygon.center(), plane, transform, box);
 }
 
-vm::vec3 Lasso::project(const vm::vec3& point, const vm::plane3& plane) const
+vm::vec3 Lasso::project(
+  const vm::vec3& point, const vm::plane3& plane, const vm::mat4x4& transform) const
 {
   const auto ray = vm::ray3{m_camera.pickRay(vm::vec3f{point})};
   const auto hitDistance = vm::intersect_ray_plane(ray, plane);
@@ -76,7 +108,7 @@ vm::vec3 Lasso::project(const vm::vec3& point, const vm::plane3& plane) const
   }
 
   const auto hitPoint = vm::point_at_distance(ray, hitDistance);
-  return getTransform() * hitPoint;
+  return transform * hitPoint;
 }
 
 void Lasso::render(
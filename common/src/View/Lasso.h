@@ -22,6 +22,7 @@
 #include "FloatType.h"
 
 #include <vecmath/bbox.h>
+#include <vecmath/mat.h>
 #include <vecmath/plane.h>
 
 namespace TrenchBroom
@@ -52,10 +53,11 @@ public:
   void selected(I cur, I end, O out) const
   {
     const auto plane = getPlane();
-    const auto box = getBox(getTransform());
+    const auto transform = getTransform();
+    const auto box = getBox(transform);
     while (cur != end)
     {
-      if (selects(*cur, plane, box))
+      if (selects(*cur, plane, transform, box))
       {
         out = *cur;
       }
@@ -63,14 +65,30 @@ public:
     }
   }
 
+  /**
+   * Indicates whether this lasso might select a handle within the given bounds. If this
+   * returns false, then no handle within the given bounds is selected by this lasso.
+   */
+  bool mightSelect(const vm::bbox3& bounds) const;
+
 private:
   bool selects(
-    const vm::vec3& point, const vm::plane3& plane, const vm::bbox2& box) const;
+    const vm::vec3& point,
+    const vm::plane3& plane,
+    const vm::mat4x4& transform,
+    const vm::bbox2& box) const;
   bool selects(
-    const vm::segment3& edge, const vm::plane3& plane, const vm::bbox2& box) const;
+    const vm::segment3& edge,
+    const vm::plane3& plane,
+    const vm::mat4x4& transform,
+    const vm::bbox2& box) const;
   bool selects(
-    const vm::polygon3& polygon, const vm::plane3& plane, const vm::bbox2& box) const;
-  vm::vec3 project(const vm::vec3& point, const vm::plane3& plane) const;
+    const vm::polygon3& polygon,
+    const vm::plane3& plane,
+    const vm::mat4x4& transform,
+    const vm::bbox2& box) const;
+  vm::vec3 project(
+    const vm::vec3& point, const vm::plane3& plane, const vm::mat4x4& transform) const;
 
 public:
   void render(
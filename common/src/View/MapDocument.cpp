@@ -36,12 +36,14 @@
 #include "IO/IOUtils.h"
 #include "IO/SimpleParserStatus.h"
 #include "IO/SystemPaths.h"
+#include "Model/ApplyToNodeContents.h"
 #include "Model/BezierPatch.h"
 #include "Model/Brush.h"
 #include "Model/BrushBuilder.h"
 #include "Model/BrushEntityWithoutModelKeyIssueGenerator.h"
 #include "Model/BrushError.h"
 #include "Model/BrushFace.h"
+#include "Model/BrushFaceTexturing.h"
 #include "Model/BrushGeometry.h"
 #include "Model/BrushNode.h"
 #include "Model/ChangeBrushFaceAttributesRequest.h"
@@ -100,6 +102,7 @@
 #include "View/SetCurrentLayerCommand.h"
 #include "View/SetLockStateCommand.h"
 #include "View/SetVisibilityCommand.h"
+#include "View/SwapBrushFaceTexturingCommand.h"
 #include "View/SwapNodeContentsCommand.h"
 #include "View/TransactionScope.h"
 #include "View/UpdateLinkedGroupsCommand.h"
@@ -123,6 +126,7 @@
 #include <vecmath/vec_io.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdlib> // for std::abs
 #include <map>
@@ -193,61 +197,6 @@ static auto findAllLinkedGroups(Model::WorldNode& worldNode, const std::vector<T
   return findLinkedGroupsRecursively(worldNode, nodes, true);
 }
 
-/**
- * Applies the given lambda to a copy of the contents of each of the given nodes and
- * returns a vector of pairs of the original node and the modified contents.
- *
- * The lambda L needs three overloads:
- * - bool operator()(Model::Entity&);
- * - bool operator()(Model::Brush&);
- * - bool operator()(Model::BezierPatch&);
- *
- * The given node contents should be modified in place and the lambda should return true
- * if it was applied successfully and false otherwise.
- *
- * Returns a vector of pairs which map each node to its modified contents if the lambda
- * succeeded for every given node, or an empty optional otherwise.
- */
-template <typename N, typename L>
-static std::optional<std::vector<std::pair<Model::Node*, Model::NodeContents>>>
-applyToNodeContents(const std::vector<N*>& nodes, L lambda)
-{
-  using NodeContentType = std::
-    variant<Model::Layer, Model::Group, Model::Entity, Model::Brush, Model::BezierPatch>;
-
-  auto newNodes = std::vector<std::pair<Model::Node*, Model::NodeContents>>{};
-  newNodes.reserve(nodes.size());
-
-  bool success = true;
-  std::transform(
-    std::begin(nodes), std::end(nodes), std::back_inserter(newNodes), [&](auto* node) {
-      NodeContentType nodeContents = node->accept(kdl::overload(
-        [](const Model::WorldNode* worldNode) -> NodeContentType {
-          return worldNode->entity();
-        },
-        [](const Model::LayerNode* layerNode) -> NodeContentType {
-          return layerNode->layer();
-        },
-        [](const Model::GroupNode* groupNode) -> NodeContentType {
-          return groupNode->group();
-        },
-        [](const Model::EntityNode* entityNode) -> NodeContentType {
-          return entityNode->entity();
-        },
-        [](const Model::BrushNode* brushNode) -> NodeContentType {
-          return brushNode->brush();
-        },
-        [](const Model::PatchNode* patchNode) -> NodeContentType {
-          return patchNode->patch();
-        }));
-
-      success = success && std::visit(lambda, nodeContents);
-      return std::make_pair(node, Model::NodeContents(std::move(nodeContents)));
-    });
-
-  return success ? std::make_optional(newNodes) : std::nullopt;
-}
-
 /**
  * Applies the given lambda to a copy of the contents of each of the given nodes and swaps
  * the node contents if the given lambda succeeds for all node contents.
@@ -258,7 +207,8 @@ applyToNodeContents(const std::vector<N*>& nodes, L lambda)
  * - bool operator()(Model::BezierPatch&);
  *
  * The given node contents should be modified in place and the lambda should return true
- * if it was applied successfully and false otherwise.
+ * if it was applied successfully and false otherwise. If the lambda is wrapped using
+ * Model::threadSafe, it is applied in parallel.
  *
  * For each linked group in the given list of linked groups, its changes are distributed
  * to the connected members of its link set.
@@ -280,7 +230,7 @@ static bool applyAndSwap(
     return true;
   }
 
-  if (auto newNodes = applyToNodeContents(nodes, std::move(lambda)))
+  if (auto newNodes = Model::applyToNodeContents(nodes, std::move(lambda)))
   {
     return document.swapNodeContents(
       commandName, std::move(*newNodes), std::move(changedLinkedGroups));
@@ -300,7 +250,8 @@ static bool applyAndSwap(
  * - bool operator()(Model::BrushFace&);
  *
  * The given node contents should be modified in place and the lambda should return true
- * if it was applied successfully and false otherwise.
+ * if it was applied successfully and false otherwise. If the lambda is wrapped using
+ * Model::threadSafe, it is applied in parallel.
  *
  * For each linked group in the given list of linked groups, its changes are distributed
  * to the connected members of its link set.
@@ -321,39 +272,13 @@ static bool applyAndSwap(
     return true;
   }
 
-  auto brushes = std::unordered_map<Model::BrushNode*, Model::Brush>{};
-
-  bool success = true;
-  std::for_each(std::begin(faces), std::end(faces), [&](const auto& faceHandle) {
-    auto* brushNode = faceHandle.node();
-    auto it = brushes.find(brushNode);
-    if (it == std::end(brushes))
-    {
-      it = brushes.emplace(brushNode, brushNode->brush()).first;
-    }
-
-    auto& brush = it->second;
-    success = success && lambda(brush.face(faceHandle.faceIndex()));
-  });
-
-  if (success)
+  if (auto facesToSwap = Model::applyToBrushFaces(faces, std::move(lambda)))
   {
-    auto newNodes = std::vector<std::pair<Model::Node*, Model::NodeContents>>{};
-    newNodes.reserve(brushes.size());
-
-    for (auto& [brushNode, brush] : brushes)
-    {
-      newNodes.emplace_back(brushNode, Model::NodeContents(std::move(brush)));
-    }
-
-    auto changedLinkedGroups = findContainingLinkedGroups(
-      *document.world(),
-      kdl::vec_transform(newNodes, [](const auto& p) { return p.first; }));
-    document.swapNodeContents(
-      commandName, std::move(newNodes), std::move(changedLinkedGroups));
+    document.swapBrushFaceTexturing(commandName, std::move(*facesToSwap));
+    return true;
   }
 
-  return success;
+  return false;
 }
 
 const vm::bbox3 MapDocument::DefaultWorldBounds(-32768.0, 32768.0);
@@ -381,6 +306,7 @@ MapDocument::MapDocument()
   , m_viewEffectsService(nullptr)
   , m_repeatStack(std::make_unique<RepeatStack>())
 {
+  m_entityModelManager->setFramesInUse([&]() { return entityModelFramesInUse(); });
   connectObservers();
 }
 
@@ -2338,6 +2264,41 @@ void MapDocument::setHasPendingChanges(
   }
 }
 
+/**
+ * Adds each of the given changed nodes to the pending changed nodes of the closest of its
+ * ancestors among the given group nodes.
+ */
+void MapDocument::addPendingChangedNodes(
+  const std::vector<Model::GroupNode*>& groupNodes,
+  const std::vector<Model::Node*>& changedNodes)
+{
+  auto changedNodesByGroupNode =
+    std::unordered_map<const Model::Node*, std::vector<const Model::Node*>>{};
+  for (const auto* groupNode : groupNodes)
+  {
+    changedNodesByGroupNode[groupNode];
+  }
+
+  for (const auto* changedNode : changedNodes)
+  {
+    for (const auto* ancestor = changedNode->parent(); ancestor != nullptr;
+         ancestor = ancestor->parent())
+    {
+      if (const auto it = changedNodesByGroupNode.find(ancestor);
+          it != changedNodesByGroupNode.end())
+      {
+        it->second.push_back(changedNode);
+        break;
+      }
+    }
+  }
+
+  for (auto* groupNode : groupNodes)
+  {
+    groupNode->addPendingChangedNodes(changedNodesByGroupNode[groupNode]);
+  }
+}
+
 static std::vector<Model::GroupNode*> collectLinkedGroupsWithPendingChanges(
   Model::Node& node)
 {
@@ -2376,10 +2337,10 @@ bool MapDocument::updateLinkedGroups()
           collectLinkedGroupsWithPendingChanges(*m_world);
         !allChangedLinkedGroups.empty())
     {
-      setHasPendingChanges(allChangedLinkedGroups, false);
-
+      // the command reads the pending changed nodes when it is executed
       auto command = std::make_unique<UpdateLinkedGroupsCommand>(allChangedLinkedGroups);
       const auto result = executeAndStore(std::move(command));
+      setHasPendingChanges(allChangedLinkedGroups, false);
       return result->success();
     }
   }
@@ -2849,6 +2810,9 @@ bool MapDocument::swapNodeContents(
     return false;
   }
 
+  const auto changedNodes =
+    kdl::vec_transform(nodesToSwap, [](const auto& p) { return p.first; });
+
   auto transaction = Transaction{*this};
   const auto result = executeAndStore(
     std::make_unique<SwapNodeContentsCommand>(commandName, std::move(nodesToSwap)));
@@ -2859,7 +2823,7 @@ bool MapDocument::swapNodeContents(
     return false;
   }
 
-  setHasPendingChanges(changedLinkedGroups, true);
+  addPendingChangedNodes(changedLinkedGroups, changedNodes);
   return transaction.commit();
 }
 
@@ -2874,6 +2838,32 @@ bool MapDocument::swapNodeContents(
     commandName, std::move(nodesToSwap), std::move(changedLinkedGroups));
 }
 
+bool MapDocument::swapBrushFaceTexturing(
+  const std::string& commandName, std::vector<Model::BrushFaceTexturing> facesToSwap)
+{
+  const auto changedNodes = kdl::vec_transform(
+    facesToSwap, [](const auto& f) -> Model::Node* { return f.faceHandle.node(); });
+  const auto changedLinkedGroups = findContainingLinkedGroups(*m_world, changedNodes);
+
+  if (!checkLinkedGroupsToUpdate(changedLinkedGroups))
+  {
+    return false;
+  }
+
+  auto transaction = Transaction{*this};
+  const auto result = executeAndStore(std::make_unique<SwapBrushFaceTexturingCommand>(
+    commandName, std::move(facesToSwap)));
+
+  if (!result->success())
+  {
+    transaction.cancel();
+    return false;
+  }
+
+  addPendingChangedNodes(changedLinkedGroups, changedNodes);
+  return transaction.commit();
+}
+
 bool MapDocument::transformObjects(
   const std::string& commandName, const vm::mat4x4& transformation)
 {
@@ -3032,6 +3022,26 @@ bool MapDocument::flipObjects(const vm::vec3& center, const vm::axis::type axis)
   return transformObjects("Flip Objects", transformation);
 }
 
+const std::optional<vm::mat4x4>& MapDocument::transformationPreview() const
+{
+  return m_transformationPreview;
+}
+
+void MapDocument::setTransformationPreview(const vm::mat4x4& transformation)
+{
+  m_transformationPreview = transformation;
+  transformationPreviewDidChangeNotifier();
+}
+
+void MapDocument::clearTransformationPreview()
+{
+  if (m_transformationPreview)
+  {
+    m_transformationPreview = std::nullopt;
+    transformationPreviewDidChangeNotifier();
+  }
+}
+
 namespace
 {
 struct CreateAndSelectBrushError
@@ -3173,13 +3183,21 @@ bool MapDocument::csgSubtract()
   auto toRemove =
     std::vector<Model::Node*>{std::begin(subtrahendNodes), std::end(subtrahendNodes)};
 
-  for (auto* minuendNode : minuendNodes)
+  // subtract from the minuends in parallel, but collect the results in the order of the
+  // minuends
+  const auto mapFormat = m_world->mapFormat();
+  const auto& textureName = currentTextureName();
+  auto subtractionResults =
+    kdl::vec_parallel_transform(minuendNodes, [&](const auto* minuendNode) {
+      return minuendNode->brush().subtract(
+        mapFormat, m_worldBounds, textureName, subtrahends);
+    });
+
+  for (size_t i = 0; i < minuendNodes.size(); ++i)
   {
-    const auto& minuend = minuendNode->brush();
-    auto currentSubtractionResults = minuend.subtract(
-      m_world->mapFormat(), m_worldBounds, currentTextureName(), subtrahends);
+    auto* minuendNode = minuendNodes[i];
     auto currentBrushes = kdl::collect_values(
-      std::move(currentSubtractionResults),
+      std::move(subtractionResults[i]),
       [&](const Model::BrushError& e) { error() << "Could not create brush: " << e; });
 
     if (!currentBrushes.empty())
@@ -3720,10 +3738,13 @@ bool MapDocument::setFaceAttributes(
   const Model::ChangeBrushFaceAttributesRequest& request)
 {
   return applyAndSwap(
-    *this, request.name(), allSelectedBrushFaces(), [&](Model::BrushFace& brushFace) {
+    *this,
+    request.name(),
+    allSelectedBrushFaces(),
+    Model::threadSafe([&](Model::BrushFace& brushFace) {
       request.evaluate(brushFace);
       return true;
-    });
+    }));
 }
 
 bool MapDocument::copyTexCoordSystemFromFace(
@@ -3789,26 +3810,32 @@ bool MapDocument::flipTextures(
 
 bool MapDocument::snapVertices(const FloatType snapTo)
 {
-  size_t succeededBrushCount = 0;
-  size_t failedBrushCount = 0;
+  auto succeededBrushCount = std::atomic<size_t>{0};
+  auto failedBrushCount = std::atomic<size_t>{0};
+
+  // the brushes are snapped in parallel, so the errors are logged afterwards
+  auto errorMutex = std::mutex{};
+  auto errors = std::vector<Model::BrushError>{};
 
+  const auto uvLock = pref(Preferences::UVLock);
   const auto allSelectedBrushes = allSelectedBrushNodes();
   const bool applyAndSwapSuccess = applyAndSwap(
     *this,
     "Snap Brush Vertices",
     allSelectedBrushes,
     findContainingLinkedGroups(*m_world, allSelectedBrushes),
-    kdl::overload(
+    Model::threadSafe(kdl::overload(
       [](Model::Layer&) { return true; },
       [](Model::Group&) { return true; },
       [](Model::Entity&) { return true; },
       [&](Model::Brush& originalBrush) {
         if (originalBrush.canSnapVertices(m_worldBounds, snapTo))
         {
-          originalBrush.snapVertices(m_worldBounds, snapTo, pref(Preferences::UVLock))
+          originalBrush.snapVertices(m_worldBounds, snapTo, uvLock)
             .transform([&]() { succeededBrushCount += 1; })
             .or_else([&](const Model::BrushError e) {
-              error() << "Could not snap vertices: " << e;
+              const auto lock = std::lock_guard<std::mutex>{errorMutex};
+              errors.push_back(e);
               failedBrushCount += 1;
             });
         }
@@ -3818,7 +3845,12 @@ bool MapDocument::snapVertices(const FloatType snapTo)
         }
         return true;
       },
-      [](Model::BezierPatch&) { return true; }));
+      [](Model::BezierPatch&) { return true; })));
+
+  for (const auto e : errors)
+  {
+    error() << "Could not snap vertices: " << e;
+  }
 
   if (!applyAndSwapSuccess)
   {
@@ -3828,17 +3860,17 @@ bool MapDocument::snapVertices(const FloatType snapTo)
   {
     info(kdl::str_to_string(
       "Snapped vertices of ",
-      succeededBrushCount,
+      succeededBrushCount.load(),
       " ",
-      kdl::str_plural(succeededBrushCount, "brush", "brushes")));
+      kdl::str_plural(succeededBrushCount.load(), "brush", "brushes")));
   }
   if (failedBrushCount > 0)
   {
     info(kdl::str_to_string(
       "Failed to snap vertices of ",
-      failedBrushCount,
+      failedBrushCount.load(),
       " ",
-      kdl::str_plural(failedBrushCount, "brush", "brushes")));
+      kdl::str_plural(failedBrushCount.load(), "brush", "brushes")));
   }
 
   return true;
@@ -3848,7 +3880,7 @@ MapDocument::MoveVerticesResult MapDocument::moveVertices(
   std::vector<vm::vec3> vertexPositions, const vm::vec3& delta)
 {
   auto newVertexPositions = std::vector<vm::vec3>{};
-  auto newNodes = applyToNodeContents(
+  auto newNodes = Model::applyToNodeContents(
     m_selectedNodes.nodes(),
     kdl::overload(
       [](Model::Layer&) { return true; },
@@ -3889,8 +3921,9 @@ MapDocument::MoveVerticesResult MapDocument::moveVertices(
       kdl::str_plural(vertexPositions.size(), "Move Brush Vertex", "Move Brush Vertices");
     auto transaction = Transaction{*this, commandName};
 
-    const auto changedLinkedGroups = findContainingLinkedGroups(
-      *m_world, kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; }));
+    const auto changedNodes =
+      kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; });
+    const auto changedLinkedGroups = findContainingLinkedGroups(*m_world, changedNodes);
 
     const auto result = executeAndStore(std::make_unique<BrushVertexCommand>(
       commandName,
@@ -3904,7 +3937,7 @@ MapDocument::MoveVerticesResult MapDocument::moveVertices(
       return MoveVerticesResult{false, false};
     }
 
-    setHasPendingChanges(changedLinkedGroups, true);
+    addPendingChangedNodes(changedLinkedGroups, changedNodes);
 
     if (!transaction.commit())
     {
@@ -3928,7 +3961,7 @@ bool MapDocument::moveEdges(
   std::vector<vm::segment3> edgePositions, const vm::vec3& delta)
 {
   auto newEdgePositions = std::vector<vm::segment3>{};
-  auto newNodes = applyToNodeContents(
+  auto newNodes = Model::applyToNodeContents(
     m_selectedNodes.nodes(),
     kdl::overload(
       [](Model::Layer&) { return true; },
@@ -3970,8 +4003,9 @@ bool MapDocument::moveEdges(
       kdl::str_plural(edgePositions.size(), "Move Brush Edge", "Move Brush Edges");
     auto transaction = Transaction{*this, commandName};
 
-    const auto changedLinkedGroups = findContainingLinkedGroups(
-      *m_world, kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; }));
+    const auto changedNodes =
+      kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; });
+    const auto changedLinkedGroups = findContainingLinkedGroups(*m_world, changedNodes);
 
     const auto result = executeAndStore(std::make_unique<BrushEdgeCommand>(
       commandName,
@@ -3985,7 +4019,7 @@ bool MapDocument::moveEdges(
       return false;
     }
 
-    setHasPendingChanges(changedLinkedGroups, true);
+    addPendingChangedNodes(changedLinkedGroups, changedNodes);
     return transaction.commit();
   }
 
@@ -3996,7 +4030,7 @@ bool MapDocument::moveFaces(
   std::vector<vm::polygon3> facePositions, const vm::vec3& delta)
 {
   auto newFacePositions = std::vector<vm::polygon3>{};
-  auto newNodes = applyToNodeContents(
+  auto newNodes = Model::applyToNodeContents(
     m_selectedNodes.nodes(),
     kdl::overload(
       [](Model::Layer&) { return true; },
@@ -4038,8 +4072,9 @@ bool MapDocument::moveFaces(
       kdl::str_plural(facePositions.size(), "Move Brush Face", "Move Brush Faces");
     auto transaction = Transaction{*this, commandName};
 
-    auto changedLinkedGroups = findContainingLinkedGroups(
-      *m_world, kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; }));
+    const auto changedNodes =
+      kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; });
+    auto changedLinkedGroups = findContainingLinkedGroups(*m_world, changedNodes);
 
     const auto result = executeAndStore(std::make_unique<BrushFaceCommand>(
       commandName,
@@ -4053,7 +4088,7 @@ bool MapDocument::moveFaces(
       return false;
     }
 
-    setHasPendingChanges(changedLinkedGroups, true);
+    addPendingChangedNodes(changedLinkedGroups, changedNodes);
     return transaction.commit();
   }
 
@@ -4062,7 +4097,7 @@ bool MapDocument::moveFaces(
 
 bool MapDocument::addVertex(const vm::vec3& vertexPosition)
 {
-  auto newNodes = applyToNodeContents(
+  auto newNodes = Model::applyToNodeContents(
     m_selectedNodes.nodes(),
     kdl::overload(
       [](Model::Layer&) { return true; },
@@ -4087,8 +4122,9 @@ bool MapDocument::addVertex(const vm::vec3& vertexPosition)
     const auto commandName = "Add Brush Vertex";
     auto transaction = Transaction{*this, commandName};
 
-    const auto changedLinkedGroups = findContainingLinkedGroups(
-      *m_world, kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; }));
+    const auto changedNodes =
+      kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; });
+    const auto changedLinkedGroups = findContainingLinkedGroups(*m_world, changedNodes);
 
     const auto result = executeAndStore(std::make_unique<BrushVertexCommand>(
       commandName,
@@ -4102,7 +4138,7 @@ bool MapDocument::addVertex(const vm::vec3& vertexPosition)
       return false;
     }
 
-    setHasPendingChanges(changedLinkedGroups, true);
+    addPendingChangedNodes(changedLinkedGroups, changedNodes);
     return transaction.commit();
   }
 
@@ -4112,7 +4148,7 @@ bool MapDocument::addVertex(const vm::vec3& vertexPosition)
 bool MapDocument::removeVertices(
   const std::string& commandName, std::vector<vm::vec3> vertexPositions)
 {
-  auto newNodes = applyToNodeContents(
+  auto newNodes = Model::applyToNodeContents(
     m_selectedNodes.nodes(),
     kdl::overload(
       [](Model::Layer&) { return true; },
@@ -4143,8 +4179,9 @@ bool MapDocument::removeVertices(
   {
     auto transaction = Transaction{*this, commandName};
 
-    auto changedLinkedGroups = findContainingLinkedGroups(
-      *m_world, kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; }));
+    const auto changedNodes =
+      kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; });
+    auto changedLinkedGroups = findContainingLinkedGroups(*m_world, changedNodes);
 
     const auto result = executeAndStore(std::make_unique<BrushVertexCommand>(
       commandName,
@@ -4158,7 +4195,7 @@ bool MapDocument::removeVertices(
       return false;
     }
 
-    setHasPendingChanges(changedLinkedGroups, true);
+    addPendingChangedNodes(changedLinkedGroups, changedNodes);
     return transaction.commit();
   }
 
@@ -4295,7 +4332,7 @@ bool MapDocument::commitTransaction()
 
   if (!updateLinkedGroups())
   {
-    rollbackTransaction();
+    cancelTransaction();
     return false;
   }
 
@@ -4804,6 +4841,33 @@ void MapDocument::setEntityModels(const std::vector<Model::Node*>& nodes)
   Model::Node::visitAll(nodes, makeSetEntityModelsVisitor(*this, *m_entityModelManager));
 }
 
+std::vector<const Assets::EntityModelFrame*> MapDocument::entityModelFramesInUse() const
+{
+  auto result = std::vector<const Assets::EntityModelFrame*>{};
+  if (m_world)
+  {
+    m_world->accept(kdl::overload(
+      [](auto&& thisLambda, const Model::WorldNode* world) {
+        world->visitChildren(thisLambda);
+      },
+      [](auto&& thisLambda, const Model::LayerNode* layer) {
+        layer->visitChildren(thisLambda);
+      },
+      [](auto&& thisLambda, const Model::GroupNode* group) {
+        group->visitChildren(thisLambda);
+      },
+      [&](const Model::EntityNode* entityNode) {
+        if (const auto* frame = entityNode->entity().model())
+        {
+          result.push_back(frame);
+        }
+      },
+      [](const Model::BrushNode*) {},
+      [](const Model::PatchNode*) {}));
+  }
+  return result;
+}
+
 void MapDocument::unsetEntityModels()
 {
   m_world->accept(makeUnsetEntityModelsVisitor());
@@ -5298,6 +5362,7 @@ void Transaction::rollback()
 void Transaction::cancel()
 {
   assert(m_state == TransactionState::Running);
+  m_document.cancelTransaction();
   m_state = TransactionState::Cancelled;
 }
 
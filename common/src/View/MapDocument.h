@@ -32,6 +32,7 @@
 
 #include <vecmath/bbox.h>
 #include <vecmath/forward.h>
+#include <vecmath/mat.h>
 #include <vecmath/util.h>
 
 #include <map>
@@ -50,6 +51,7 @@ namespace Assets
 class EntityDefinition;
 class EntityDefinitionFileSpec;
 class EntityDefinitionManager;
+class EntityModelFrame;
 class EntityModelManager;
 class Texture;
 class TextureManager;
@@ -61,6 +63,7 @@ class Brush;
 class BrushFace;
 class BrushFaceHandle;
 class BrushFaceAttributes;
+struct BrushFaceTexturing;
 class EditorContext;
 class Entity;
 class Game;
@@ -135,6 +138,7 @@ protected:
   vm::bbox3 m_lastSelectionBounds;
   mutable vm::bbox3 m_selectionBounds;
   mutable bool m_selectionBoundsValid;
+  std::optional<vm::mat4x4> m_transformationPreview;
 
   ViewEffectsService* m_viewEffectsService;
 
@@ -170,6 +174,7 @@ public: // notification
 
   Notifier<> selectionWillChangeNotifier;
   Notifier<const Selection&> selectionDidChangeNotifier;
+  Notifier<> transformationPreviewDidChangeNotifier;
 
   Notifier<const std::vector<Model::Node*>&> nodesWereAddedNotifier;
   Notifier<const std::vector<Model::Node*>&> nodesWillBeRemovedNotifier;
@@ -492,6 +497,9 @@ public:
 protected:
   void setHasPendingChanges(
     const std::vector<Model::GroupNode*>& groupNodes, bool hasPendingChanges);
+  void addPendingChangedNodes(
+    const std::vector<Model::GroupNode*>& groupNodes,
+    const std::vector<Model::Node*>& changedNodes);
   bool updateLinkedGroups();
 
 private:
@@ -548,6 +556,8 @@ public: // modifying objects, declared in MapFacade interface
   bool swapNodeContents(
     const std::string& commandName,
     std::vector<std::pair<Model::Node*, Model::NodeContents>> nodesToSwap);
+  bool swapBrushFaceTexturing(
+    const std::string& commandName, std::vector<Model::BrushFaceTexturing> facesToSwap);
   bool transformObjects(const std::string& commandName, const vm::mat4x4& transformation);
 
   bool translateObjects(const vm::vec3& delta) override;
@@ -559,6 +569,25 @@ public: // modifying objects, declared in MapFacade interface
     const vm::bbox3& box, const vm::vec3& sideToShear, const vm::vec3& delta) override;
   bool flipObjects(const vm::vec3& center, vm::axis::type axis) override;
 
+public: // previewing transformations
+  /**
+   * Returns the transformation that is currently previewed on the selected objects, if
+   * any.
+   */
+  const std::optional<vm::mat4x4>& transformationPreview() const;
+
+  /**
+   * Renders the selected objects as if the given transformation had been applied to them
+   * without modifying them. Tools use this to give feedback while the user drags, and
+   * apply the final transformation once when the drag ends.
+   */
+  void setTransformationPreview(const vm::mat4x4& transformation);
+
+  /**
+   * Renders the selected objects without any transformation.
+   */
+  void clearTransformationPreview();
+
 public: // CSG operations, declared in MapFacade interface
   bool createBrush(const std::vector<vm::vec3>& points);
   bool csgConvexMerge();
@@ -736,6 +765,7 @@ protected:
 
   void setEntityModels();
   void setEntityModels(const std::vector<Model::Node*>& nodes);
+  std::vector<const Assets::EntityModelFrame*> entityModelFramesInUse() const;
   void unsetEntityModels();
   void unsetEntityModels(const std::vector<Model::Node*>& nodes);
 
@@ -25,6 +25,7 @@
 #include "Model/Brush.h"
 #include "Model/BrushError.h"
 #include "Model/BrushFace.h"
+#include "Model/BrushFaceTexturing.h"
 #include "Model/BrushNode.h"
 #include "Model/ChangeBrushFaceAttributesRequest.h"
 #include "Model/EditorContext.h"
@@ -45,6 +46,7 @@
 
 #include <kdl/map_utils.h>
 #include <kdl/overload.h>
+#include <kdl/parallel.h>
 #include <kdl/result.h>
 #include <kdl/string_format.h>
 #include <kdl/string_utils.h>
@@ -56,6 +58,7 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -398,6 +401,38 @@ static auto notifySpecialWorldProperties(
   return std::make_tuple(false, false, false);
 }
 
+/**
+ * Makes the grids of the patches that will be swapped into patch nodes. Tessellating a
+ * patch is expensive, so the grids are made in parallel. The returned vector contains an
+ * empty optional for every node that is not a patch node.
+ */
+static std::vector<std::optional<Model::PatchGrid>> makePatchGrids(
+  const std::vector<std::pair<Model::Node*, Model::NodeContents>>& nodesToSwap)
+{
+  auto result = std::vector<std::optional<Model::PatchGrid>>(nodesToSwap.size());
+
+  auto patchIndices = std::vector<size_t>{};
+  for (size_t i = 0; i < nodesToSwap.size(); ++i)
+  {
+    if (dynamic_cast<const Model::PatchNode*>(nodesToSwap[i].first))
+    {
+      patchIndices.push_back(i);
+    }
+  }
+
+  if (!patchIndices.empty())
+  {
+    kdl::parallel_for(patchIndices.size(), [&](const size_t j) {
+      const auto i = patchIndices[j];
+      const auto& [node, contents] = nodesToSwap[i];
+      const auto* patchNode = static_cast<const Model::PatchNode*>(node);
+      result[i] = patchNode->makeGrid(std::get<Model::BezierPatch>(contents.get()));
+    });
+  }
+
+  return result;
+}
+
 void MapDocumentCommandFacade::performSwapNodeContents(
   std::vector<std::pair<Model::Node*, Model::NodeContents>>& nodesToSwap)
 {
@@ -427,8 +462,11 @@ void MapDocumentCommandFacade::performSwapNodeContents(
   NotifyBeforeAndAfter notifyMods(
     notifyModsChange, modsWillChangeNotifier, modsDidChangeNotifier);
 
-  for (auto& pair : nodesToSwap)
+  auto patchGrids = makePatchGrids(nodesToSwap);
+
+  for (size_t i = 0; i < nodesToSwap.size(); ++i)
   {
+    auto& pair = nodesToSwap[i];
     auto* node = pair.first;
     auto& contents = pair.second.get();
 
@@ -454,8 +492,8 @@ void MapDocumentCommandFacade::performSwapNodeContents(
           brushNode->setBrush(std::get<Model::Brush>(std::move(contents))));
       },
       [&](Model::PatchNode* patchNode) -> Model::NodeContents {
-        return Model::NodeContents(
-          patchNode->setPatch(std::get<Model::BezierPatch>(std::move(contents))));
+        return Model::NodeContents(patchNode->setPatch(
+          std::get<Model::BezierPatch>(std::move(contents)), std::move(*patchGrids[i])));
       }));
   }
 
@@ -472,6 +510,23 @@ void MapDocumentCommandFacade::performSwapNodeContents(
   invalidateSelectionBounds();
 }
 
+void MapDocumentCommandFacade::performSwapBrushFaceTexturing(
+  std::vector<Model::BrushFaceTexturing>& facesToSwap)
+{
+  for (auto& faceToSwap : facesToSwap)
+  {
+    faceToSwap.faceHandle.node()->swapFaceTexturing(
+      faceToSwap.faceHandle.faceIndex(),
+      faceToSwap.attributes,
+      faceToSwap.texCoordSystem);
+  }
+
+  const auto faceHandles =
+    kdl::vec_transform(facesToSwap, [](const auto& face) { return face.faceHandle; });
+  setTextures(faceHandles);
+  brushFacesDidChangeNotifier(faceHandles);
+}
+
 std::map<Model::Node*, Model::VisibilityState> MapDocumentCommandFacade::
   setVisibilityState(
     const std::vector<Model::Node*>& nodes, const Model::VisibilityState visibilityState)
@@ -35,6 +35,7 @@ namespace TrenchBroom
 {
 namespace Model
 {
+struct BrushFaceTexturing;
 enum class LockState;
 enum class VisibilityState;
 } // namespace Model
@@ -89,6 +90,8 @@ public: // adding and removing nodes
 public: // swapping node contents
   void performSwapNodeContents(
     std::vector<std::pair<Model::Node*, Model::NodeContents>>& nodesToSwap);
+  void performSwapBrushFaceTexturing(
+    std::vector<Model::BrushFaceTexturing>& facesToSwap);
 
 public: // Node Visibility
   std::map<Model::Node*, Model::VisibilityState> setVisibilityState(
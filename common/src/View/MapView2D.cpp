@@ -399,7 +399,10 @@ void MapView2D::doRenderMap(
   auto document = kdl::mem_lock(m_document);
   if (renderContext.showSelectionGuide() && document->hasSelectedNodes())
   {
-    const vm::bbox3& bounds = document->selectionBounds();
+    const auto& transformationPreview = document->transformationPreview();
+    const auto bounds = transformationPreview
+                          ? document->selectionBounds().transform(*transformationPreview)
+                          : document->selectionBounds();
     Renderer::SelectionBoundsRenderer boundsRenderer(bounds);
     boundsRenderer.render(renderContext, renderBatch);
   }
@@ -244,12 +244,13 @@ vm::vec3 MapView3D::doGetPasteObjectsDelta(
   {
     const auto pickRay = vm::ray3(m_camera->pickRay(
       static_cast<float>(clientCoords.x()), static_cast<float>(clientCoords.y())));
-    auto pickResult = Model::PickResult::byDistance();
 
+    using namespace Model::HitFilters;
+    const auto hitFilter = type(Model::BrushNode::BrushHitType);
+    auto pickResult = Model::PickResult::closest(hitFilter);
     document->pick(pickRay, pickResult);
 
-    using namespace Model::HitFilters;
-    const auto& hit = pickResult.first(type(Model::BrushNode::BrushHitType));
+    const auto& hit = pickResult.first(hitFilter);
     if (const auto faceHandle = Model::hitToFaceHandle(hit))
     {
       const auto& face = faceHandle->face();
@@ -563,7 +564,10 @@ void MapView3D::doRenderMap(
   auto document = kdl::mem_lock(m_document);
   if (renderContext.showSelectionGuide() && document->hasSelectedNodes())
   {
-    const vm::bbox3& bounds = document->selectionBounds();
+    const auto& transformationPreview = document->transformationPreview();
+    const auto bounds = transformationPreview
+                          ? document->selectionBounds().transform(*transformationPreview)
+                          : document->selectionBounds();
     Renderer::SelectionBoundsRenderer boundsRenderer(bounds);
     boundsRenderer.render(renderContext, renderBatch);
 
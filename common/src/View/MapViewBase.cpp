@@ -164,6 +164,8 @@ void MapViewBase::connectObservers()
     document->commandUndoneNotifier.connect(this, &MapViewBase::commandUndone);
   m_notifierConnection +=
     document->selectionDidChangeNotifier.connect(this, &MapViewBase::selectionDidChange);
+  m_notifierConnection += document->transformationPreviewDidChangeNotifier.connect(
+    this, &MapViewBase::transformationPreviewDidChange);
   m_notifierConnection += document->textureCollectionsDidChangeNotifier.connect(
     this, &MapViewBase::textureCollectionsDidChange);
   m_notifierConnection += document->entityDefinitionsDidChangeNotifier.connect(
@@ -243,6 +245,11 @@ void MapViewBase::selectionDidChange(const Selection&)
   updateActionStatesDelayed();
 }
 
+void MapViewBase::transformationPreviewDidChange()
+{
+  update();
+}
+
 void MapViewBase::textureCollectionsDidChange()
 {
   update();
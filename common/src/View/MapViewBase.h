@@ -157,6 +157,7 @@ private:
   void commandDone(Command& command);
   void commandUndone(UndoableCommand& command);
   void selectionDidChange(const Selection& selection);
+  void transformationPreviewDidChange();
   void textureCollectionsDidChange();
   void entityDefinitionsDidChange();
   void modsDidChange();
@@ -30,6 +30,9 @@
 #include <kdl/memory_utils.h>
 
 #include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
 
 #include <cassert>
 
@@ -41,6 +44,7 @@ MoveObjectsTool::MoveObjectsTool(std::weak_ptr<MapDocument> document)
   : Tool(true)
   , m_document(document)
   , m_duplicateObjects(false)
+  , m_delta(vm::vec3::zero())
 {
 }
 
@@ -62,6 +66,7 @@ bool MoveObjectsTool::startMove(const InputState& inputState)
     duplicateObjects(inputState) ? "Duplicate Objects" : "Move Objects",
     TransactionScope::LongRunning);
   m_duplicateObjects = duplicateObjects(inputState);
+  m_delta = vm::vec3::zero();
   return true;
 }
 
@@ -71,7 +76,7 @@ MoveObjectsTool::MoveResult MoveObjectsTool::move(
   auto document = kdl::mem_lock(m_document);
   const auto& worldBounds = document->worldBounds();
   const auto bounds = document->selectionBounds();
-  if (!worldBounds.contains(bounds.translate(delta)))
+  if (!worldBounds.contains(bounds.translate(m_delta + delta)))
   {
     return MR_Deny;
   }
@@ -82,25 +87,32 @@ MoveObjectsTool::MoveResult MoveObjectsTool::move(
     document->duplicateObjects();
   }
 
-  if (!document->translateObjects(delta))
-  {
-    return MR_Deny;
-  }
-  else
-  {
-    return MR_Continue;
-  }
+  // the objects are only moved when the drag ends, until then they are rendered at their
+  // new position
+  m_delta = m_delta + delta;
+  document->setTransformationPreview(vm::translation_matrix(m_delta));
+  return MR_Continue;
 }
 
 void MoveObjectsTool::endMove(const InputState&)
 {
   auto document = kdl::mem_lock(m_document);
-  document->commitTransaction();
+  document->clearTransformationPreview();
+
+  if (vm::is_zero(m_delta, vm::C::almost_zero()) || document->translateObjects(m_delta))
+  {
+    document->commitTransaction();
+  }
+  else
+  {
+    document->cancelTransaction();
+  }
 }
 
 void MoveObjectsTool::cancelMove()
 {
   auto document = kdl::mem_lock(m_document);
+  document->clearTransformationPreview();
   document->cancelTransaction();
 }
 
@@ -22,6 +22,8 @@
 #include "FloatType.h"
 #include "View/Tool.h"
 
+#include <vecmath/vec.h>
+
 #include <memory>
 
 namespace TrenchBroom
@@ -45,6 +47,7 @@ public:
 private:
   std::weak_ptr<MapDocument> m_document;
   bool m_duplicateObjects;
+  vm::vec3 m_delta;
 
 public:
   explicit MoveObjectsTool(std::weak_ptr<MapDocument> document);
@@ -29,7 +29,10 @@
 #include <kdl/memory_utils.h>
 #include <kdl/vector_utils.h>
 
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
 #include <vecmath/scalar.h>
+#include <vecmath/vec.h>
 
 namespace TrenchBroom
 {
@@ -115,19 +118,34 @@ void RotateObjectsTool::beginRotation()
 {
   auto document = kdl::mem_lock(m_document);
   document->startTransaction("Rotate Objects", TransactionScope::LongRunning);
+  m_rotation = std::nullopt;
 }
 
 void RotateObjectsTool::commitRotation()
 {
   auto document = kdl::mem_lock(m_document);
-  document->commitTransaction();
-  updateRecentlyUsedCenters(rotationCenter());
+  document->clearTransformationPreview();
+
+  if (
+    !m_rotation
+    || document->rotateObjects(m_rotation->center, m_rotation->axis, m_rotation->angle))
+  {
+    document->commitTransaction();
+    updateRecentlyUsedCenters(rotationCenter());
+  }
+  else
+  {
+    document->cancelTransaction();
+  }
+  m_rotation = std::nullopt;
 }
 
 void RotateObjectsTool::cancelRotation()
 {
   auto document = kdl::mem_lock(m_document);
+  document->clearTransformationPreview();
   document->cancelTransaction();
+  m_rotation = std::nullopt;
 }
 
 FloatType RotateObjectsTool::snapRotationAngle(const FloatType angle) const
@@ -139,9 +157,13 @@ FloatType RotateObjectsTool::snapRotationAngle(const FloatType angle) const
 void RotateObjectsTool::applyRotation(
   const vm::vec3& center, const vm::vec3& axis, const FloatType angle)
 {
+  // the objects are only rotated when the drag ends, until then they are rendered
+  // rotated
   auto document = kdl::mem_lock(m_document);
-  document->rollbackTransaction();
-  document->rotateObjects(center, axis, angle);
+  m_rotation = Rotation{center, axis, angle};
+  document->setTransformationPreview(
+    vm::translation_matrix(center) * vm::rotation_matrix(axis, angle)
+    * vm::translation_matrix(-center));
 }
 
 Model::Hit RotateObjectsTool::pick2D(
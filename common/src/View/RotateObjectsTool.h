@@ -24,8 +24,10 @@
 #include "View/Tool.h"
 
 #include <vecmath/forward.h>
+#include <vecmath/vec.h>
 
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace TrenchBroom
@@ -46,11 +48,19 @@ class RotateObjectsToolPage;
 class RotateObjectsTool : public Tool
 {
 private:
+  struct Rotation
+  {
+    vm::vec3 center;
+    vm::vec3 axis;
+    FloatType angle;
+  };
+
   std::weak_ptr<MapDocument> m_document;
   RotateObjectsToolPage* m_toolPage;
   RotateObjectsHandle m_handle;
   double m_angle;
   std::vector<vm::vec3> m_recentlyUsedCenters;
+  std::optional<Rotation> m_rotation;
 
 public:
   explicit RotateObjectsTool(std::weak_ptr<MapDocument> document);
@@ -39,6 +39,8 @@
 #include <vecmath/distance.h>
 #include <vecmath/intersection.h>
 #include <vecmath/line.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
 #include <vecmath/vec.h>
 #include <vecmath/vec_io.h>
 
@@ -571,6 +573,7 @@ ScaleObjectsTool::ScaleObjectsTool(std::weak_ptr<MapDocument> document)
   , m_resizing(false)
   , m_anchorPos(AnchorPos::Opposite)
   , m_bboxAtDragStart()
+  , m_bboxAtDragEnd()
   , m_dragStartHit(Model::Hit::NoHit)
   , m_dragCumulativeDelta(vm::vec3::zero())
   , m_proportionalAxes(ProportionalAxes::None())
@@ -794,6 +797,12 @@ void ScaleObjectsTool::pick3D(
 
 vm::bbox3 ScaleObjectsTool::bounds() const
 {
+  if (m_resizing)
+  {
+    // the objects are only scaled when the drag ends
+    return m_bboxAtDragEnd;
+  }
+
   auto document = kdl::mem_lock(m_document);
   return document->selectionBounds();
 }
@@ -1107,6 +1116,7 @@ void ScaleObjectsTool::startScaleWithHit(const Model::Hit& hit)
   ensure(!m_resizing, "must not be resizing already");
 
   m_bboxAtDragStart = bounds();
+  m_bboxAtDragEnd = m_bboxAtDragStart;
   m_dragStartHit = hit;
   m_dragCumulativeDelta = vm::vec3::zero();
 
@@ -1132,20 +1142,26 @@ void ScaleObjectsTool::scaleByDelta(const vm::vec3& delta)
 
   if (!newBox.is_empty())
   {
-    document->scaleObjects(bounds(), newBox);
+    m_bboxAtDragEnd = newBox;
+    document->setTransformationPreview(
+      vm::scale_bbox_matrix(m_bboxAtDragStart, m_bboxAtDragEnd));
   }
 }
 
 void ScaleObjectsTool::commitScale()
 {
   auto document = kdl::mem_lock(m_document);
-  if (vm::is_zero(m_dragCumulativeDelta, vm::C::almost_zero()))
+  document->clearTransformationPreview();
+
+  if (
+    !vm::is_zero(m_dragCumulativeDelta, vm::C::almost_zero())
+    && document->scaleObjects(m_bboxAtDragStart, m_bboxAtDragEnd))
   {
-    document->cancelTransaction();
+    document->commitTransaction();
   }
   else
   {
-    document->commitTransaction();
+    document->cancelTransaction();
   }
   m_resizing = false;
 }
@@ -1153,6 +1169,7 @@ void ScaleObjectsTool::commitScale()
 void ScaleObjectsTool::cancelScale()
 {
   auto document = kdl::mem_lock(m_document);
+  document->clearTransformationPreview();
   document->cancelTransaction();
   m_resizing = false;
 }
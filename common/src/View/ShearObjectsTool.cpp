@@ -40,6 +40,8 @@
 #include <vecmath/bbox.h>
 #include <vecmath/forward.h>
 #include <vecmath/intersection.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
 #include <vecmath/polygon.h>
 #include <vecmath/vec.h>
 
@@ -157,6 +159,12 @@ void ShearObjectsTool::pick3D(
 
 vm::bbox3 ShearObjectsTool::bounds() const
 {
+  if (m_resizing)
+  {
+    // the objects are only sheared when the drag ends
+    return m_bboxAtDragStart.transform(bboxShearMatrix());
+  }
+
   auto document = kdl::mem_lock(m_document);
   return document->selectionBounds();
 }
@@ -212,13 +220,20 @@ void ShearObjectsTool::commitShear()
   ensure(m_resizing, "must be resizing already");
 
   auto document = kdl::mem_lock(m_document);
-  if (vm::is_zero(m_dragCumulativeDelta, vm::C::almost_zero()))
+  document->clearTransformationPreview();
+
+  if (
+    !vm::is_zero(m_dragCumulativeDelta, vm::C::almost_zero())
+    && document->shearObjects(
+      m_bboxAtDragStart,
+      m_dragStartHit.target<BBoxSide>().normal,
+      m_dragCumulativeDelta))
   {
-    document->cancelTransaction();
+    document->commitTransaction();
   }
   else
   {
-    document->commitTransaction();
+    document->cancelTransaction();
   }
   m_resizing = false;
 }
@@ -228,6 +243,7 @@ void ShearObjectsTool::cancelShear()
   ensure(m_resizing, "must be resizing already");
 
   auto document = kdl::mem_lock(m_document);
+  document->clearTransformationPreview();
   document->cancelTransaction();
 
   m_resizing = false;
@@ -243,8 +259,7 @@ void ShearObjectsTool::shearByDelta(const vm::vec3& delta)
 
   if (!vm::is_zero(delta, vm::C::almost_zero()))
   {
-    const BBoxSide side = m_dragStartHit.target<BBoxSide>();
-    document->shearObjects(bounds(), side.normal, delta);
+    document->setTransformationPreview(bboxShearMatrix());
   }
 }
 
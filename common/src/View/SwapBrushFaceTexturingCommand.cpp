@@ -0,0 +1,72 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SwapBrushFaceTexturingCommand.h"
+
+#include "Model/BrushFaceHandle.h"
+#include "View/MapDocumentCommandFacade.h"
+
+#include <kdl/vector_utils.h>
+
+namespace TrenchBroom
+{
+namespace View
+{
+SwapBrushFaceTexturingCommand::SwapBrushFaceTexturingCommand(
+  const std::string& name, std::vector<Model::BrushFaceTexturing> faces)
+  : UpdateLinkedGroupsCommandBase(name, true)
+  , m_faces(std::move(faces))
+{
+}
+
+SwapBrushFaceTexturingCommand::~SwapBrushFaceTexturingCommand() = default;
+
+std::unique_ptr<CommandResult> SwapBrushFaceTexturingCommand::doPerformDo(
+  MapDocumentCommandFacade* document)
+{
+  document->performSwapBrushFaceTexturing(m_faces);
+  return std::make_unique<CommandResult>(true);
+}
+
+std::unique_ptr<CommandResult> SwapBrushFaceTexturingCommand::doPerformUndo(
+  MapDocumentCommandFacade* document)
+{
+  document->performSwapBrushFaceTexturing(m_faces);
+  return std::make_unique<CommandResult>(true);
+}
+
+bool SwapBrushFaceTexturingCommand::doCollateWith(UndoableCommand& command)
+{
+  if (auto* other = dynamic_cast<SwapBrushFaceTexturingCommand*>(&command))
+  {
+    auto myFaces =
+      kdl::vec_transform(m_faces, [](const auto& face) { return face.faceHandle; });
+    auto theirFaces = kdl::vec_transform(
+      other->m_faces, [](const auto& face) { return face.faceHandle; });
+
+    kdl::vec_sort(myFaces);
+    kdl::vec_sort(theirFaces);
+
+    return myFaces == theirFaces;
+  }
+
+  return false;
+}
+} // namespace View
+} // namespace TrenchBroom
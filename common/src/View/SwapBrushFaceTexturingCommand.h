@@ -0,0 +1,58 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Macros.h"
+#include "Model/BrushFaceTexturing.h"
+#include "View/UpdateLinkedGroupsCommandBase.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace View
+{
+/**
+ * Swaps the attributes and texture coordinate systems of brush faces without touching the
+ * brush geometry. Since the command only stores the texturing of the affected faces,
+ * retexturing many faces is much cheaper than swapping the contents of their brushes.
+ */
+class SwapBrushFaceTexturingCommand : public UpdateLinkedGroupsCommandBase
+{
+private:
+  std::vector<Model::BrushFaceTexturing> m_faces;
+
+public:
+  SwapBrushFaceTexturingCommand(
+    const std::string& name, std::vector<Model::BrushFaceTexturing> faces);
+  ~SwapBrushFaceTexturingCommand();
+
+  std::unique_ptr<CommandResult> doPerformDo(MapDocumentCommandFacade* document) override;
+  std::unique_ptr<CommandResult> doPerformUndo(
+    MapDocumentCommandFacade* document) override;
+
+  bool doCollateWith(UndoableCommand& command) override;
+
+  deleteCopyAndMove(SwapBrushFaceTexturingCommand);
+};
+} // namespace View
+} // namespace TrenchBroom
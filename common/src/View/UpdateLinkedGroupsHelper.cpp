@@ -23,6 +23,7 @@
 #include "Model/GroupNode.h"
 #include "Model/ModelUtils.h"
 #include "Model/Node.h"
+#include "Model/NodeContents.h"
 #include "Model/UpdateLinkedGroupsError.h"
 #include "View/MapDocumentCommandFacade.h"
 
@@ -51,6 +52,16 @@ bool checkLinkedGroupsToUpdate(const std::vector<Model::GroupNode*>& changedLink
          == std::end(linkedGroupIds);
 }
 
+static void swapContents(
+  MapDocumentCommandFacade& document,
+  std::vector<std::pair<Model::Node*, Model::NodeContents>>& contentsToSwap)
+{
+  if (!contentsToSwap.empty())
+  {
+    document.performSwapNodeContents(contentsToSwap);
+  }
+}
+
 // Order groups so that descendants will be updated before their ancestors
 const auto compareByAncestry = [](const auto* lhs, const auto* rhs) {
   return rhs->isAncestorOf(lhs);
@@ -68,18 +79,18 @@ kdl::result<void, Model::UpdateLinkedGroupsError> UpdateLinkedGroupsHelper::
   applyLinkedGroupUpdates(MapDocumentCommandFacade& document)
 {
   return computeLinkedGroupUpdates(document).transform(
-    [&]() { doApplyOrUndoLinkedGroupUpdates(document); });
+    [&]() { doApplyLinkedGroupUpdates(document); });
 }
 
 void UpdateLinkedGroupsHelper::undoLinkedGroupUpdates(MapDocumentCommandFacade& document)
 {
-  doApplyOrUndoLinkedGroupUpdates(document);
+  doUndoLinkedGroupUpdates(document);
 }
 
 void UpdateLinkedGroupsHelper::collateWith(UpdateLinkedGroupsHelper& other)
 {
   // Both helpers have already applied their changes at this point, so in both helpers,
-  // m_linkedGroups contains pairs p where
+  // m_state.childrenToReplace contains pairs p where
   // - p.first is the group node to update
   // - p.second is a vector containing the group node's original children
   //
@@ -90,24 +101,50 @@ void UpdateLinkedGroupsHelper::collateWith(UpdateLinkedGroupsHelper& other)
   // is not an update for a linked group node that was updated by this helper, then we
   // will add p_o to our updates and remove it from the other helper's updates to prevent
   // the replaced node to be deleted with the other helper.
+  //
+  // The same applies to m_state.contentsToSwap, where each pair contains a node and its
+  // original contents. In addition, we discard the other helper's original contents for
+  // a node that was added by one of our replacements because undoing that replacement
+  // removes the node anyway.
 
   auto& myLinkedGroupUpdates = std::get<LinkedGroupUpdates>(m_state);
   auto& theirLinkedGroupUpdates = std::get<LinkedGroupUpdates>(other.m_state);
 
-  for (auto& [theirGroupNodeToUpdate, theirOldChildren] : theirLinkedGroupUpdates)
+  auto& myChildrenToReplace = myLinkedGroupUpdates.childrenToReplace;
+  for (auto& [theirGroupNodeToUpdate, theirOldChildren] :
+       theirLinkedGroupUpdates.childrenToReplace)
   {
     const auto myIt = std::find_if(
-      std::begin(myLinkedGroupUpdates),
-      std::end(myLinkedGroupUpdates),
+      std::begin(myChildrenToReplace),
+      std::end(myChildrenToReplace),
       [theirGroupNodeToUpdate = theirGroupNodeToUpdate](const auto& p) {
         return p.first == theirGroupNodeToUpdate;
       });
-    if (myIt == std::end(myLinkedGroupUpdates))
+    if (myIt == std::end(myChildrenToReplace))
     {
-      myLinkedGroupUpdates.emplace_back(
+      myChildrenToReplace.emplace_back(
         theirGroupNodeToUpdate, std::move(theirOldChildren));
     }
   }
+
+  auto& myContentsToSwap = myLinkedGroupUpdates.contentsToSwap;
+  const auto myNodesToSwap = kdl::vec_transform(
+    myContentsToSwap, [](const auto& p) -> const Model::Node* { return p.first; });
+  const auto myNodesToSwapSet =
+    std::unordered_set<const Model::Node*>{myNodesToSwap.begin(), myNodesToSwap.end()};
+  for (auto& [theirNodeToSwap, theirOldContents] : theirLinkedGroupUpdates.contentsToSwap)
+  {
+    const auto isReplacedByMe = std::any_of(
+      std::begin(myChildrenToReplace),
+      std::end(myChildrenToReplace),
+      [theirNodeToSwap = theirNodeToSwap](const auto& p) {
+        return p.first->isAncestorOf(theirNodeToSwap);
+      });
+    if (myNodesToSwapSet.count(theirNodeToSwap) == 0 && !isReplacedByMe)
+    {
+      myContentsToSwap.emplace_back(theirNodeToSwap, std::move(theirOldContents));
+    }
+  }
 }
 
 kdl::result<void, Model::UpdateLinkedGroupsError> UpdateLinkedGroupsHelper::
@@ -145,26 +182,61 @@ UpdateLinkedGroupsHelper::computeLinkedGroupUpdates(
                  *document.world(), *groupNode->group().linkedGroupId()),
                groupNode);
 
-             return Model::updateLinkedGroups(
-               *groupNode, groupNodesToUpdate, worldBounds);
+             if (const auto& changedNodes = groupNode->pendingChangedNodes();
+                 groupNode->hasPendingChanges() && changedNodes)
+             {
+               return Model::updateLinkedGroupsIncrementally(
+                 *groupNode, *changedNodes, groupNodesToUpdate, worldBounds);
+             }
+
+             return Model::updateLinkedGroups(*groupNode, groupNodesToUpdate, worldBounds)
+               .transform([](Model::UpdateLinkedGroupsResult&& childrenToReplace) {
+                 return LinkedGroupUpdates{std::move(childrenToReplace), {}};
+               });
            })
     .and_then(
       [&](auto&& nestedUpdateLists)
         -> kdl::result<LinkedGroupUpdates, Model::UpdateLinkedGroupsError> {
-        return kdl::vec_flatten(std::move(nestedUpdateLists));
+        auto result = LinkedGroupUpdates{};
+        for (auto& updates : nestedUpdateLists)
+        {
+          result.childrenToReplace = kdl::vec_concat(
+            std::move(result.childrenToReplace), std::move(updates.childrenToReplace));
+          result.contentsToSwap = kdl::vec_concat(
+            std::move(result.contentsToSwap), std::move(updates.contentsToSwap));
+        }
+        return result;
       });
 }
 
-void UpdateLinkedGroupsHelper::doApplyOrUndoLinkedGroupUpdates(
+void UpdateLinkedGroupsHelper::doApplyLinkedGroupUpdates(
   MapDocumentCommandFacade& document)
 {
+  // Swap first because a node whose contents are swapped may be removed by replacing the
+  // children of one of its ancestors when nested linked groups are updated.
   std::visit(
     kdl::overload(
       [](const ChangedLinkedGroups&) {},
-      [&](LinkedGroupUpdates&& linkedGroupUpdates) {
-        m_state = document.performReplaceChildren(std::move(linkedGroupUpdates));
+      [&](LinkedGroupUpdates& linkedGroupUpdates) {
+        swapContents(document, linkedGroupUpdates.contentsToSwap);
+        linkedGroupUpdates.childrenToReplace = document.performReplaceChildren(
+          std::move(linkedGroupUpdates.childrenToReplace));
       }),
-    std::move(m_state));
+    m_state);
+}
+
+void UpdateLinkedGroupsHelper::doUndoLinkedGroupUpdates(
+  MapDocumentCommandFacade& document)
+{
+  std::visit(
+    kdl::overload(
+      [](const ChangedLinkedGroups&) {},
+      [&](LinkedGroupUpdates& linkedGroupUpdates) {
+        linkedGroupUpdates.childrenToReplace = document.performReplaceChildren(
+          std::move(linkedGroupUpdates.childrenToReplace));
+        swapContents(document, linkedGroupUpdates.contentsToSwap);
+      }),
+    m_state);
 }
 } // namespace View
 } // namespace TrenchBroom
@@ -20,11 +20,10 @@
 #pragma once
 
 #include "FloatType.h"
+#include "Model/GroupNode.h"
 
 #include <kdl/result_forward.h>
 
-#include <memory>
-#include <utility>
 #include <variant>
 #include <vector>
 
@@ -32,8 +31,6 @@ namespace TrenchBroom
 {
 namespace Model
 {
-class GroupNode;
-class Node;
 enum class UpdateLinkedGroupsError;
 } // namespace Model
 
@@ -54,17 +51,19 @@ bool checkLinkedGroupsToUpdate(const std::vector<Model::GroupNode*>& changedLink
  *
  * The class is initialized with a vector of group nodes whose changes should be
  * propagated to the members of their respective link sets. When applyLinkedGroupUpdates
- * is first called, a replacement node is created for each linked group that needs to be
- * updated, and these linked groups are replaced with their replacements. Calling
- * applyLinkedGroupUpdates replaces the replacement nodes with their original
- * corresponding groups again, effectively undoing the change.
+ * is first called, the pending changed nodes of each linked group (see
+ * GroupNode::pendingChangedNodes) are transformed into the linked groups that need to be
+ * updated, and their contents are swapped into the corresponding nodes of these linked
+ * groups. If that is not possible, or if the changed nodes of a linked group are not
+ * known, the children of these linked groups are replaced with transformed clones
+ * instead. Calling undoLinkedGroupUpdates swaps back the original contents and restores
+ * the original children, effectively undoing the change.
  */
 class UpdateLinkedGroupsHelper
 {
 private:
   using ChangedLinkedGroups = std::vector<Model::GroupNode*>;
-  using LinkedGroupUpdates =
-    std::vector<std::pair<Model::Node*, std::vector<std::unique_ptr<Model::Node>>>>;
+  using LinkedGroupUpdates = Model::IncrementalUpdateLinkedGroupsResult;
   std::variant<ChangedLinkedGroups, LinkedGroupUpdates> m_state;
 
 public:
@@ -83,7 +82,8 @@ private:
   computeLinkedGroupUpdates(
     const ChangedLinkedGroups& changedLinkedGroups, MapDocumentCommandFacade& document);
 
-  void doApplyOrUndoLinkedGroupUpdates(MapDocumentCommandFacade& document);
+  void doApplyLinkedGroupUpdates(MapDocumentCommandFacade& document);
+  void doUndoLinkedGroupUpdates(MapDocumentCommandFacade& document);
 };
 } // namespace View
 } // namespace TrenchBroom
@@ -0,0 +1,199 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "FloatType.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/polygon.h>
+#include <vecmath/segment.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace View
+{
+/**
+ * Returns the bounds of the given vertex handle.
+ */
+inline vm::bbox3 handleBounds(const vm::vec3& handle)
+{
+  return vm::bbox3{handle, handle};
+}
+
+/**
+ * Returns the bounds of the given edge handle.
+ */
+inline vm::bbox3 handleBounds(const vm::segment3& handle)
+{
+  return vm::bbox3{
+    vm::min(handle.start(), handle.end()), vm::max(handle.start(), handle.end())};
+}
+
+/**
+ * Returns the bounds of the given face handle.
+ */
+inline vm::bbox3 handleBounds(const vm::polygon3& handle)
+{
+  return vm::bbox3::merge_all(std::begin(handle), std::end(handle));
+}
+
+/**
+ * A spatial hash over handles. Space is divided into cubic cells of a fixed size, and
+ * every handle is stored in the cell that contains the center of its bounds. Each cell
+ * keeps the bounds of the handles stored in it, so a handle that extends beyond its cell
+ * is still found by queries that test the cell bounds.
+ *
+ * Queries pass a test for the cell bounds and only visit the handles of cells that pass
+ * it.
+ *
+ * @tparam H the handle type
+ */
+template <typename H>
+class VertexHandleGrid
+{
+public:
+  static constexpr FloatType DefaultCellSize = 256.0;
+
+private:
+  struct Cell
+  {
+    vm::bbox3 bounds;
+    std::vector<H> handles;
+  };
+
+  FloatType m_cellSize;
+  std::unordered_map<std::uint64_t, Cell> m_cells;
+
+public:
+  explicit VertexHandleGrid(const FloatType cellSize = DefaultCellSize)
+    : m_cellSize{cellSize}
+  {
+  }
+
+  /**
+   * Returns the number of non-empty cells.
+   */
+  size_t cellCount() const { return m_cells.size(); }
+
+  /**
+   * Adds the given handle. The handle must not already be contained in this grid.
+   */
+  void add(const H& handle)
+  {
+    const auto bounds = handleBounds(handle);
+    auto [it, inserted] = m_cells.try_emplace(cellKey(bounds));
+    auto& cell = it->second;
+    cell.bounds = inserted ? bounds : vm::merge(cell.bounds, bounds);
+    cell.handles.push_back(handle);
+  }
+
+  /**
+   * Removes the given handle.
+   *
+   * @return true if the given handle was contained in this grid and false otherwise
+   */
+  bool remove(const H& handle)
+  {
+    const auto cellIt = m_cells.find(cellKey(handleBounds(handle)));
+    if (cellIt == std::end(m_cells))
+    {
+      return false;
+    }
+
+    auto& cell = cellIt->second;
+    const auto handleIt =
+      std::find(std::begin(cell.handles), std::end(cell.handles), handle);
+    if (handleIt == std::end(cell.handles))
+    {
+      return false;
+    }
+
+    *handleIt = std::move(cell.handles.back());
+    cell.handles.pop_back();
+
+    if (cell.handles.empty())
+    {
+      m_cells.erase(cellIt);
+    }
+    else
+    {
+      auto builder = vm::bbox3::builder{};
+      for (const auto& remainingHandle : cell.handles)
+      {
+        builder.add(handleBounds(remainingHandle));
+      }
+      cell.bounds = builder.bounds();
+    }
+    return true;
+  }
+
+  /**
+   * Removes all handles.
+   */
+  void clear() { m_cells.clear(); }
+
+  /**
+   * Calls the given function for every handle stored in a cell whose bounds pass the
+   * given test.
+   *
+   * @tparam T the type of the cell test, a unary predicate on vm::bbox3
+   * @tparam F the type of the function to call, which accepts a handle
+   * @param testCell the cell test
+   * @param fun the function to call
+   */
+  template <typename T, typename F>
+  void forEachHandle(const T& testCell, const F& fun) const
+  {
+    for (const auto& [key, cell] : m_cells)
+    {
+      if (testCell(cell.bounds))
+      {
+        for (const auto& handle : cell.handles)
+        {
+          fun(handle);
+        }
+      }
+    }
+  }
+
+private:
+  std::uint64_t cellKey(const vm::bbox3& bounds) const
+  {
+    // Cell coordinates are truncated to 21 bits each. Distant cells that share a key are
+    // merged, which is harmless because the cell bounds cover all of their handles.
+    const auto center = bounds.center();
+    auto result = std::uint64_t(0);
+    for (size_t i = 0; i < 3; ++i)
+    {
+      const auto coord = static_cast<std::int64_t>(std::floor(center[i] / m_cellSize));
+      result = (result << 21) | (static_cast<std::uint64_t>(coord) & 0x1FFFFF);
+    }
+    return result;
+  }
+};
+} // namespace View
+} // namespace TrenchBroom
@@ -45,17 +45,16 @@ void VertexHandleManager::pick(
   const Renderer::Camera& camera,
   Model::PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
-  {
-    const auto distance = camera.pickPointHandle(
-      pickRay, position, static_cast<FloatType>(pref(Preferences::HandleRadius)));
+  const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+  forEachHandleNearRay(pickRay, camera, handleRadius, [&](const vm::vec3& position) {
+    const auto distance = camera.pickPointHandle(pickRay, position, handleRadius);
     if (!vm::is_nan(distance))
     {
       const auto hitPoint = vm::point_at_distance(pickRay, distance);
       const auto error = vm::squared_distance(pickRay, position).distance;
       pickResult.addHit(Model::Hit(HandleHitType, distance, hitPoint, position, error));
     }
-  }
+  });
 }
 
 void VertexHandleManager::addHandles(const Model::BrushNode* brushNode)
@@ -96,16 +95,16 @@ void EdgeHandleManager::pickGridHandle(
   const Grid& grid,
   Model::PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
-  {
-    const FloatType edgeDist = camera.pickLineSegmentHandle(
-      pickRay, position, static_cast<FloatType>(pref(Preferences::HandleRadius)));
+  const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+  forEachHandleNearRay(pickRay, camera, handleRadius, [&](const vm::segment3& position) {
+    const FloatType edgeDist =
+      camera.pickLineSegmentHandle(pickRay, position, handleRadius);
     if (!vm::is_nan(edgeDist))
     {
       const vm::vec3 pointHandle =
         grid.snap(vm::point_at_distance(pickRay, edgeDist), position);
-      const FloatType pointDist = camera.pickPointHandle(
-        pickRay, pointHandle, static_cast<FloatType>(pref(Preferences::HandleRadius)));
+      const FloatType pointDist =
+        camera.pickPointHandle(pickRay, pointHandle, handleRadius);
       if (!vm::is_nan(pointDist))
       {
         const vm::vec3 hitPoint = vm::point_at_distance(pickRay, pointDist);
@@ -113,7 +112,7 @@ void EdgeHandleManager::pickGridHandle(
           Model::Hit(HandleHitType, pointDist, hitPoint, HitType(position, pointHandle)));
       }
     }
-  }
+  });
 }
 
 void EdgeHandleManager::pickCenterHandle(
@@ -121,18 +120,18 @@ void EdgeHandleManager::pickCenterHandle(
   const Renderer::Camera& camera,
   Model::PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
-  {
+  const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+  forEachHandleNearRay(pickRay, camera, handleRadius, [&](const vm::segment3& position) {
     const vm::vec3 pointHandle = position.center();
 
-    const FloatType pointDist = camera.pickPointHandle(
-      pickRay, pointHandle, static_cast<FloatType>(pref(Preferences::HandleRadius)));
+    const FloatType pointDist =
+      camera.pickPointHandle(pickRay, pointHandle, handleRadius);
     if (!vm::is_nan(pointDist))
     {
       const vm::vec3 hitPoint = vm::point_at_distance(pickRay, pointDist);
       pickResult.addHit(Model::Hit(HandleHitType, pointDist, hitPoint, position));
     }
-  }
+  });
 }
 
 void EdgeHandleManager::addHandles(const Model::BrushNode* brushNode)
@@ -174,12 +173,12 @@ void FaceHandleManager::pickGridHandle(
   const Grid& grid,
   Model::PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
-  {
+  const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+  forEachHandleNearRay(pickRay, camera, handleRadius, [&](const vm::polygon3& position) {
     const auto [valid, plane] = vm::from_points(std::begin(position), std::end(position));
     if (!valid)
     {
-      continue;
+      return;
     }
 
     const auto distance =
@@ -188,8 +187,7 @@ void FaceHandleManager::pickGridHandle(
     {
       const auto pointHandle = grid.snap(vm::point_at_distance(pickRay, distance), plane);
 
-      const auto pointDist = camera.pickPointHandle(
-        pickRay, pointHandle, static_cast<FloatType>(pref(Preferences::HandleRadius)));
+      const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius);
       if (!vm::is_nan(pointDist))
       {
         const auto hitPoint = vm::point_at_distance(pickRay, pointDist);
@@ -197,7 +195,7 @@ void FaceHandleManager::pickGridHandle(
           Model::Hit(HandleHitType, pointDist, hitPoint, HitType(position, pointHandle)));
       }
     }
-  }
+  });
 }
 
 void FaceHandleManager::pickCenterHandle(
@@ -205,18 +203,17 @@ void FaceHandleManager::pickCenterHandle(
   const Renderer::Camera& camera,
   Model::PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
-  {
+  const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+  forEachHandleNearRay(pickRay, camera, handleRadius, [&](const vm::polygon3& position) {
     const auto pointHandle = position.center();
 
-    const auto pointDist = camera.pickPointHandle(
-      pickRay, pointHandle, static_cast<FloatType>(pref(Preferences::HandleRadius)));
+    const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius);
     if (!vm::is_nan(pointDist))
     {
       const auto hitPoint = vm::point_at_distance(pickRay, pointDist);
       pickResult.addHit(Model::Hit(HandleHitType, pointDist, hitPoint, position));
     }
-  }
+  });
 }
 
 void FaceHandleManager::addHandles(const Model::BrushNode* brushNode)
@@ -25,13 +25,17 @@
 #include "Model/HitType.h"
 #include "Model/PickResult.h"
 #include "Renderer/Camera.h"
+#include "View/VertexHandleGrid.h"
 
 #include <kdl/vector_set.h>
 
+#include <vecmath/intersection.h>
+#include <vecmath/ray.h>
 #include <vecmath/segment.h>
 
 #include <iterator>
 #include <map>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom
@@ -178,6 +182,12 @@ protected:
    */
   HandleMap m_handles;
 
+  /**
+   * Spatial index over the handles in m_handles, used to restrict picking and lasso
+   * selection to the handles near the pick ray or the lasso.
+   */
+  VertexHandleGrid<H> m_grid;
+
   /**
    * The total number of selected handles, not counting duplicates.
    */
@@ -324,8 +334,13 @@ public:
    */
   void add(const Handle& handle)
   {
-    m_handles[handle].inc(); // unknown value gets value constructed, which for HandleInfo
-                             // means its default constructor is called
+    auto& info = m_handles[handle]; // unknown value gets value constructed, which for
+                                    // HandleInfo means its default constructor is called
+    if (info.count == 0)
+    {
+      m_grid.add(handle);
+    }
+    info.inc();
   }
 
   /**
@@ -346,6 +361,7 @@ public:
       if (info.count == 0)
       {
         deselect(info);
+        m_grid.remove(handle);
         m_handles.erase(it);
       }
       return true;
@@ -360,6 +376,7 @@ public:
   void clear()
   {
     m_handles.clear();
+    m_grid.clear();
     m_selectedHandleCount = 0;
   }
 
@@ -466,13 +483,17 @@ private:
   void forEachCloseHandle(const H& otherHandle, F fun)
   {
     static const auto epsilon = 0.001 * 0.001;
-    for (auto& [handle, info] : m_handles)
-    {
-      if (compare(otherHandle, handle, epsilon) == 0)
-      {
-        fun(info);
-      }
-    }
+    const auto otherBounds = handleBounds(otherHandle);
+    forEachHandle(
+      [&](const vm::bbox3& bounds) {
+        return bounds.expand(epsilon).intersects(otherBounds);
+      },
+      [&](const H& handle) {
+        if (compare(otherHandle, handle, epsilon) == 0)
+        {
+          fun(m_handles.find(handle)->second);
+        }
+      });
   }
 
   void select(HandleInfo& info)
@@ -507,6 +528,77 @@ private:
     }
   }
 
+public:
+  /**
+   * Calls the given function for every handle in a region of space whose bounds pass the
+   * given test. The handles are visited in no particular order.
+   *
+   * @tparam T the type of the bounds test, a unary predicate on vm::bbox3 that must
+   * return true for any bounds that contain a handle which the caller is looking for
+   * @tparam F the type of the function to call, which accepts a handle
+   * @param testBounds the bounds test
+   * @param fun the function to call
+   */
+  template <typename T, typename F>
+  void forEachHandle(const T& testBounds, const F& fun) const
+  {
+    m_grid.forEachHandle(testBounds, fun);
+  }
+
+  /**
+   * Calls the given function for every handle which might be hit by the given pick ray
+   * when it is picked with the given handle radius in the given camera. This skips every
+   * handle that is so far away from the ray that no point of it can be hit by the ray.
+   *
+   * @tparam F the type of the function to call, which accepts a handle
+   * @param pickRay the pick ray
+   * @param camera the camera
+   * @param handleRadius the handle radius in screen pixels
+   * @param fun the function to call
+   */
+  template <typename F>
+  void forEachHandleNearRay(
+    const vm::ray3& pickRay,
+    const Renderer::Camera& camera,
+    const FloatType handleRadius,
+    const F& fun) const
+  {
+    // see Camera::pickPointHandle; the scaling factor is either constant or proportional
+    // to the distance along the view direction, so it is evaluated only twice here, and
+    // its largest absolute value within some bounds is found at their nearest or
+    // farthest corner along the view direction
+    const auto position = vm::vec3{camera.position()};
+    const auto direction = vm::vec3{camera.direction()};
+    const auto scalingAtPosition =
+      static_cast<FloatType>(camera.perspectiveScalingFactor(camera.position()));
+    const auto scalingPerDistance =
+      static_cast<FloatType>(
+        camera.perspectiveScalingFactor(camera.position() + camera.direction()))
+      - scalingAtPosition;
+    const auto scalingAt = [&](const vm::vec3& point) {
+      return vm::abs(
+        scalingAtPosition + scalingPerDistance * vm::dot(point - position, direction));
+    };
+
+    forEachHandle(
+      [&](const vm::bbox3& bounds) {
+        auto nearest = bounds.min;
+        auto farthest = bounds.max;
+        for (size_t i = 0; i < 3; ++i)
+        {
+          if (direction[i] < FloatType(0))
+          {
+            std::swap(nearest[i], farthest[i]);
+          }
+        }
+        // slightly enlarged to account for rounding errors
+        const auto scaling = vm::max(scalingAt(nearest), scalingAt(farthest));
+        const auto radius = FloatType(2.01) * handleRadius * scaling;
+        return !vm::is_nan(vm::intersect_ray_bbox(pickRay, bounds.expand(radius)));
+      },
+      fun);
+  }
+
 public:
   /**
    * Applies the given picking test to all handles in this manager and adds all hits to
@@ -215,11 +215,16 @@ public: // Handle selection
   {
     using HandleList = std::vector<H>;
 
-    const HandleList allHandles = handleManager().allHandles();
-    HandleList selectedHandles;
+    HandleList candidateHandles;
+    handleManager().forEachHandle(
+      [&](const vm::bbox3& bounds) { return lasso.mightSelect(bounds); },
+      [&](const H& handle) { candidateHandles.push_back(handle); });
 
+    HandleList selectedHandles;
     lasso.selected(
-      std::begin(allHandles), std::end(allHandles), std::back_inserter(selectedHandles));
+      std::begin(candidateHandles),
+      std::end(candidateHandles),
+      std::back_inserter(selectedHandles));
     if (!modifySelection)
     {
       handleManager().deselectAll();
@@ -0,0 +1,897 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Exceptions.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/intersection.h>
+#include <vecmath/plane.h>
+#include <vecmath/ray.h>
+#include <vecmath/scalar.h>
+#include <vecmath/util.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom
+{
+/**
+ * A dynamic bounding volume hierarchy that allows for quick ray intersection queries.
+ *
+ * The tree is a balanced binary tree whose nodes are stored in flat arrays, one array per
+ * node property, and reference each other by index. Queries only touch the arrays they
+ * need and never chase pointers. Nodes are inserted at the position where they enlarge
+ * the surface area of the tree the least, and the tree is rebalanced by rotations on
+ * the way back up to the root. Nodes whose bounds change only a little are refitted in
+ * place.
+ *
+ * This tree offers the same interface as octree and can be used in its place.
+ *
+ * @tparam T the floating point type
+ * @tparam U the node data to store in the leafs, must be default constructible
+ */
+template <typename T, typename U>
+class aabb_tree
+{
+private:
+  static constexpr auto null_index = std::numeric_limits<size_t>::max();
+
+  // the node arrays, indexed by node index
+  std::vector<vm::bbox<T, 3>> m_bounds;
+  std::vector<std::array<size_t, 2>> m_children;
+  std::vector<size_t> m_parent;
+  std::vector<int> m_height;
+  std::vector<U> m_data;
+
+  std::vector<size_t> m_free_nodes;
+  size_t m_root = null_index;
+  std::unordered_map<U, size_t> m_leaf_for_data;
+
+public:
+  /**
+   * Indicates whether a node with the given data exists in this tree.
+   *
+   * @param data the data to find
+   * @return true if a node with the given data exists and false otherwise
+   */
+  bool contains(const U& data) const { return m_leaf_for_data.count(data) > 0; }
+
+  /**
+   * Inserts a node with the given bounds and data into this tree.
+   *
+   * @param bounds the bounds of the node
+   * @param data the node data
+   *
+   * @throws NodeTreeException if the given bounds are invalid or if a node with the given
+   * data already exists in this tree
+   */
+  void insert(const vm::bbox<T, 3>& bounds, U data)
+  {
+    check(bounds);
+
+    if (contains(data))
+    {
+      throw NodeTreeException("Data already in tree");
+    }
+
+    const auto leaf = allocate_node();
+    m_bounds[leaf] = bounds;
+    m_height[leaf] = 0;
+    m_data[leaf] = data;
+    m_leaf_for_data.emplace(std::move(data), leaf);
+
+    insert_leaf(leaf);
+  }
+
+  /**
+   * Replaces the contents of this tree with the given items.
+   *
+   * The tree is built top down by recursively splitting the items at the median of their
+   * centers along the axis where the centers are spread the most. This is much faster
+   * than inserting the items one by one, and large subtrees are built in parallel.
+   *
+   * @param items pairs of the bounds and data of the items to add
+   *
+   * @throws NodeTreeException if any bounds are invalid or if any data is given more than
+   * once, in which case this tree is left empty
+   */
+  void build(std::vector<std::pair<vm::bbox<T, 3>, U>> items)
+  {
+    clear();
+
+    if (items.empty())
+    {
+      return;
+    }
+
+    for (const auto& [bounds, data] : items)
+    {
+      check(bounds);
+    }
+
+    // a tree with n leafs has n - 1 inner nodes
+    const auto num_nodes = 2 * items.size() - 1;
+    m_bounds.resize(num_nodes);
+    m_children.resize(num_nodes, {null_index, null_index});
+    m_parent.resize(num_nodes, null_index);
+    m_height.resize(num_nodes);
+    m_data.resize(num_nodes);
+
+    build_subtree(0, null_index, items.begin(), items.end(), 0);
+    m_root = 0;
+
+    m_leaf_for_data.reserve(items.size());
+    for (size_t index = 0; index < num_nodes; ++index)
+    {
+      if (is_leaf(index) && !m_leaf_for_data.emplace(m_data[index], index).second)
+      {
+        clear();
+        throw NodeTreeException("Data already in tree");
+      }
+    }
+  }
+
+  /**
+   * Removes the node with the given data from this tree.
+   *
+   * @param data the data to remove
+   * @return true if a node with the given data was removed, and false otherwise
+   */
+  bool remove(const U& data)
+  {
+    const auto i_leaf = m_leaf_for_data.find(data);
+    if (i_leaf == m_leaf_for_data.end())
+    {
+      return false;
+    }
+
+    const auto leaf = i_leaf->second;
+    m_leaf_for_data.erase(i_leaf);
+
+    remove_leaf(leaf);
+    free_node(leaf);
+
+    return true;
+  }
+
+  /**
+   * Updates the node with the given data with the given new bounds.
+   *
+   * If the new bounds intersect the previous bounds, the node is refitted in place,
+   * otherwise it is reinserted.
+   *
+   * @param newBounds the new bounds of the node
+   * @param data the node data of the node to update
+   *
+   * @throws NodeTreeException if no node with the given data can be found in this tree
+   */
+  void update(const vm::bbox<T, 3>& newBounds, const U& data)
+  {
+    check(newBounds);
+
+    const auto i_leaf = m_leaf_for_data.find(data);
+    if (i_leaf == m_leaf_for_data.end())
+    {
+      throw NodeTreeException("node not found");
+    }
+
+    const auto leaf = i_leaf->second;
+    if (m_bounds[leaf] == newBounds)
+    {
+      return;
+    }
+
+    if (m_bounds[leaf].intersects(newBounds))
+    {
+      m_bounds[leaf] = newBounds;
+      refit(m_parent[leaf]);
+    }
+    else
+    {
+      remove_leaf(leaf);
+      m_bounds[leaf] = newBounds;
+      insert_leaf(leaf);
+    }
+  }
+
+  /**
+   * Clears this node tree.
+   */
+  void clear()
+  {
+    m_bounds.clear();
+    m_children.clear();
+    m_parent.clear();
+    m_height.clear();
+    m_data.clear();
+    m_free_nodes.clear();
+    m_root = null_index;
+    m_leaf_for_data.clear();
+  }
+
+  /**
+   * Indicates whether this tree is empty.
+   *
+   * @return true if this tree is empty and false otherwise
+   */
+  bool empty() const { return m_root == null_index; }
+
+  /**
+   * Returns the height of this tree, that is, the length of the longest path from the
+   * root to a leaf. An empty tree and a tree with a single node both have height 0.
+   */
+  size_t height() const { return empty() ? 0 : size_t(m_height[m_root]); }
+
+  /**
+   * Finds every data item in this tree whose bounding box intersects with the given ray
+   * and retuns a list of those items.
+   *
+   * @param ray the ray to test
+   * @return a list containing all found data items
+   */
+  std::vector<U> find_intersectors(const vm::ray<T, 3>& ray) const
+  {
+    auto result = std::vector<U>{};
+    find_intersectors(ray, std::back_inserter(result));
+    return result;
+  }
+
+  /**
+   * Finds every data item in this tree whose bounding box intersects with the given ray
+   * and appends it to the given output iterator.
+   *
+   * @tparam O the output iterator type
+   * @param ray the ray to test
+   * @param out the output iterator to append to
+   */
+  template <typename O>
+  void find_intersectors(const vm::ray<T, 3>& ray, O out) const
+  {
+    const auto query = ray_query{ray};
+    visit_leafs_if(
+      [&](const size_t leaf) { *out++ = m_data[leaf]; },
+      [&](const vm::bbox<T, 3>& bounds) {
+        return !vm::is_nan(entry_distance(query, bounds));
+      });
+  }
+
+  /**
+   * Visits every data item in this tree whose bounding box intersects with the given ray
+   * in the order of the distances at which the ray enters the bounding boxes of the
+   * items.
+   *
+   * The visitor is called with each such data item and returns the distance at which the
+   * item was hit, or an empty optional if the item was not hit. Once the visitor has
+   * reported a hit, items and nodes which the ray enters beyond the closest reported hit
+   * are skipped.
+   *
+   * This tree stores the bounding boxes of its data items, so the given function is not
+   * called. It is accepted so that this tree can be used in place of an octree.
+   *
+   * @tparam B the type of the function that returns the bounding box of a data item
+   * @tparam V the visitor type
+   * @param ray the ray to test
+   * @param visitor the visitor to call for each data item whose bounding box is hit
+   */
+  template <typename B, typename V>
+  void visit_intersectors_by_distance(
+    const vm::ray<T, 3>& ray, const B& /* get_bounds */, const V& visitor) const
+  {
+    if (empty())
+    {
+      return;
+    }
+
+    using queue_entry = std::pair<T, size_t>;
+    using queue_compare = std::greater<queue_entry>;
+    auto queue =
+      std::priority_queue<queue_entry, std::vector<queue_entry>, queue_compare>{};
+
+    const auto query = ray_query{ray};
+    const auto push_node = [&](const size_t index) {
+      const auto distance = entry_distance(query, m_bounds[index]);
+      if (!vm::is_nan(distance))
+      {
+        queue.emplace(distance, index);
+      }
+    };
+
+    push_node(m_root);
+
+    auto closest_hit = std::numeric_limits<T>::max();
+    while (!queue.empty() && queue.top().first <= closest_hit)
+    {
+      const auto index = queue.top().second;
+      queue.pop();
+
+      if (is_leaf(index))
+      {
+        if (const auto hit_distance = visitor(m_data[index]))
+        {
+          closest_hit = std::min(closest_hit, *hit_distance);
+        }
+      }
+      else
+      {
+        push_node(m_children[index][0]);
+        push_node(m_children[index][1]);
+      }
+    }
+  }
+
+  /**
+   * Finds every data item in this tree whose bounding box contains the given point and
+   * returns a list of those items.
+   *
+   * @param point the point to test
+   * @return a list containing all found data items
+   */
+  std::vector<U> find_containers(const vm::vec<T, 3>& point) const
+  {
+    auto result = std::vector<U>{};
+    find_containers(point, std::back_inserter(result));
+    return result;
+  }
+
+  /**
+   * Finds every data item in this tree whose bounding box contains the given point and
+   * appends it to the given output iterator.
+   *
+   * @tparam O the output iterator type
+   * @param point the point to test
+   * @param out the output iterator to append to
+   */
+  template <typename O>
+  void find_containers(const vm::vec<T, 3>& point, O out) const
+  {
+    visit_leafs_if(
+      [&](const size_t leaf) { *out++ = m_data[leaf]; },
+      [&](const vm::bbox<T, 3>& bounds) { return bounds.contains(point); });
+  }
+
+  /**
+   * Finds every data item in this tree whose bounding box intersects with the given
+   * bounding box and returns a list of those items.
+   *
+   * @param bounds the bounding box to test
+   * @return a list containing all found data items
+   */
+  std::vector<U> find_overlapping(const vm::bbox<T, 3>& bounds) const
+  {
+    auto result = std::vector<U>{};
+    find_overlapping(bounds, std::back_inserter(result));
+    return result;
+  }
+
+  /**
+   * Finds every data item in this tree whose bounding box intersects with the given
+   * bounding box and appends it to the given output iterator.
+   *
+   * @tparam O the output iterator type
+   * @param bounds the bounding box to test
+   * @param out the output iterator to append to
+   */
+  template <typename O>
+  void find_overlapping(const vm::bbox<T, 3>& bounds, O out) const
+  {
+    visit_leafs_if(
+      [&](const size_t leaf) { *out++ = m_data[leaf]; },
+      [&](const vm::bbox<T, 3>& node_bounds) { return node_bounds.intersects(bounds); });
+  }
+
+  /**
+   * Finds every data item in this tree whose bounding box is not entirely above any of
+   * the given planes and returns a list of those items.
+   *
+   * If the planes bound a convex volume such as a view frustum and their normals point
+   * out of the volume, then these are the items whose bounding boxes may intersect the
+   * volume.
+   *
+   * This tree stores the bounding boxes of its data items, so the given function is not
+   * called. It is accepted so that this tree can be used in place of an octree.
+   *
+   * @tparam B the type of the function that returns the bounding box of a data item
+   * @param frustum_planes the planes to test
+   * @return a list containing all found data items
+   */
+  template <typename B>
+  std::vector<U> find_in_frustum(
+    const std::vector<vm::plane<T, 3>>& frustum_planes, const B& get_bounds) const
+  {
+    auto result = std::vector<U>{};
+    find_in_frustum(frustum_planes, get_bounds, std::back_inserter(result));
+    return result;
+  }
+
+  /**
+   * Finds every data item in this tree whose bounding box is not entirely above any of
+   * the given planes and appends it to the given output iterator.
+   *
+   * @tparam B the type of the function that returns the bounding box of a data item
+   * @tparam O the output iterator type
+   * @param frustum_planes the planes to test
+   * @param out the output iterator to append to
+   */
+  template <typename B, typename O>
+  void find_in_frustum(
+    const std::vector<vm::plane<T, 3>>& frustum_planes,
+    const B& /* get_bounds */,
+    O out) const
+  {
+    if (empty())
+    {
+      return;
+    }
+
+    // pairs of node indices and whether the node is known to be below all planes, in
+    // which case its descendants need not be tested
+    auto stack = std::vector<std::pair<size_t, bool>>{{m_root, false}};
+    while (!stack.empty())
+    {
+      auto [index, below_all] = stack.back();
+      stack.pop_back();
+
+      if (!below_all)
+      {
+        const auto status = frustum_status(frustum_planes, m_bounds[index]);
+        if (status == vm::plane_status::above)
+        {
+          continue;
+        }
+        below_all = status == vm::plane_status::below;
+      }
+
+      if (is_leaf(index))
+      {
+        *out++ = m_data[index];
+      }
+      else
+      {
+        stack.emplace_back(m_children[index][1], below_all);
+        stack.emplace_back(m_children[index][0], below_all);
+      }
+    }
+  }
+
+private:
+  /**
+   * Returns plane_status::above if the given bounding box is entirely above any of the
+   * given planes, plane_status::below if it is entirely below all of them, and
+   * plane_status::inside otherwise.
+   */
+  static vm::plane_status frustum_status(
+    const std::vector<vm::plane<T, 3>>& frustum_planes, const vm::bbox<T, 3>& bounds)
+  {
+    auto result = vm::plane_status::below;
+    for (const auto& plane : frustum_planes)
+    {
+      const auto status = vm::plane_bbox_status(plane, bounds);
+      if (status == vm::plane_status::above)
+      {
+        return status;
+      }
+      if (status == vm::plane_status::inside)
+      {
+        result = status;
+      }
+    }
+    return result;
+  }
+
+  /**
+   * A ray with its precomputed inverse direction for repeated bounding box tests.
+   */
+  struct ray_query
+  {
+    vm::vec<T, 3> origin;
+    vm::vec<T, 3> inverse_direction;
+
+    explicit ray_query(const vm::ray<T, 3>& ray)
+      : origin{ray.origin}
+      , inverse_direction{T(1) / ray.direction}
+    {
+    }
+  };
+
+  /**
+   * Returns the distance at which the given ray enters the given bounding box, 0 if the
+   * box contains the ray origin, or NaN if the ray misses the box.
+   */
+  static T entry_distance(const ray_query& ray, const vm::bbox<T, 3>& bounds)
+  {
+    auto t_min = T(0);
+    auto t_max = std::numeric_limits<T>::max();
+    for (size_t i = 0; i < 3; ++i)
+    {
+      if (std::isinf(ray.inverse_direction[i]))
+      {
+        // the ray is parallel to the slab
+        if (ray.origin[i] < bounds.min[i] || ray.origin[i] > bounds.max[i])
+        {
+          return vm::nan<T>();
+        }
+      }
+      else
+      {
+        const auto t1 = (bounds.min[i] - ray.origin[i]) * ray.inverse_direction[i];
+        const auto t2 = (bounds.max[i] - ray.origin[i]) * ray.inverse_direction[i];
+        t_min = std::max(t_min, std::min(t1, t2));
+        t_max = std::min(t_max, std::max(t1, t2));
+      }
+    }
+
+    return t_min <= t_max ? t_min : vm::nan<T>();
+  }
+
+  static T surface_area(const vm::bbox<T, 3>& bounds)
+  {
+    const auto size = bounds.size();
+    return T(2) * (size.x() * size.y() + size.y() * size.z() + size.z() * size.x());
+  }
+
+  bool is_leaf(const size_t index) const { return m_children[index][0] == null_index; }
+
+  template <typename Visitor, typename Predicate>
+  void visit_leafs_if(const Visitor& visitor, const Predicate& predicate) const
+  {
+    if (empty())
+    {
+      return;
+    }
+
+    auto stack = std::vector<size_t>{m_root};
+    while (!stack.empty())
+    {
+      const auto index = stack.back();
+      stack.pop_back();
+
+      if (predicate(m_bounds[index]))
+      {
+        if (is_leaf(index))
+        {
+          visitor(index);
+        }
+        else
+        {
+          stack.push_back(m_children[index][1]);
+          stack.push_back(m_children[index][0]);
+        }
+      }
+    }
+  }
+
+  using build_iterator = typename std::vector<std::pair<vm::bbox<T, 3>, U>>::iterator;
+
+  /**
+   * Builds the subtree for the given items, rooted at the given node index. The subtree
+   * occupies the next 2 * n - 1 nodes, where n is the number of items, so that subtrees
+   * can be built independently of each other.
+   */
+  void build_subtree(
+    const size_t index,
+    const size_t parent,
+    const build_iterator begin,
+    const build_iterator end,
+    const size_t depth)
+  {
+    m_parent[index] = parent;
+
+    const auto count = size_t(std::distance(begin, end));
+    if (count == 1)
+    {
+      m_bounds[index] = begin->first;
+      m_height[index] = 0;
+      m_data[index] = std::move(begin->second);
+      return;
+    }
+
+    // the sum of min and max is twice the center
+    const auto center2 = [](const auto& item) { return item.first.min + item.first.max; };
+
+    auto center_bounds = vm::bbox<T, 3>{center2(*begin), center2(*begin)};
+    for (auto it = std::next(begin); it != end; ++it)
+    {
+      center_bounds = vm::merge(center_bounds, center2(*it));
+    }
+
+    const auto axis = vm::find_max_component(center_bounds.size());
+    const auto mid = std::next(begin, std::ptrdiff_t(count / 2));
+    std::nth_element(begin, mid, end, [&](const auto& lhs, const auto& rhs) {
+      return lhs.first.min[axis] + lhs.first.max[axis]
+             < rhs.first.min[axis] + rhs.first.max[axis];
+    });
+
+    const auto left = index + 1;
+    const auto right = index + 2 * (count / 2);
+
+    // large subtrees near the root are split among threads
+    static constexpr auto max_parallel_depth = size_t(3);
+    static constexpr auto min_parallel_count = size_t(4096);
+    if (depth < max_parallel_depth && count >= min_parallel_count)
+    {
+      auto left_future = std::async(std::launch::async, [&]() {
+        build_subtree(left, index, begin, mid, depth + 1);
+      });
+      build_subtree(right, index, mid, end, depth + 1);
+      left_future.get();
+    }
+    else
+    {
+      build_subtree(left, index, begin, mid, depth + 1);
+      build_subtree(right, index, mid, end, depth + 1);
+    }
+
+    m_children[index] = {left, right};
+    m_bounds[index] = vm::merge(m_bounds[left], m_bounds[right]);
+    m_height[index] = 1 + std::max(m_height[left], m_height[right]);
+  }
+
+  size_t allocate_node()
+  {
+    if (!m_free_nodes.empty())
+    {
+      const auto index = m_free_nodes.back();
+      m_free_nodes.pop_back();
+
+      m_children[index] = {null_index, null_index};
+      m_parent[index] = null_index;
+      return index;
+    }
+
+    m_bounds.emplace_back();
+    m_children.push_back({null_index, null_index});
+    m_parent.push_back(null_index);
+    m_height.push_back(0);
+    m_data.emplace_back();
+    return m_bounds.size() - 1;
+  }
+
+  void free_node(const size_t index)
+  {
+    m_height[index] = -1;
+    m_data[index] = U{};
+    m_free_nodes.push_back(index);
+  }
+
+  void replace_child(const size_t parent, const size_t old_child, const size_t new_child)
+  {
+    if (parent == null_index)
+    {
+      m_root = new_child;
+    }
+    else if (m_children[parent][0] == old_child)
+    {
+      m_children[parent][0] = new_child;
+    }
+    else
+    {
+      assert(m_children[parent][1] == old_child);
+      m_children[parent][1] = new_child;
+    }
+  }
+
+  /**
+   * Finds the node that, when made the sibling of a new leaf with the given bounds,
+   * increases the total surface area of the tree the least.
+   *
+   * The cost of choosing a node is the surface area of the new parent plus the increase
+   * of the surface areas of all ancestors. Since that increase only grows while
+   * descending, the search can skip any subtree whose lower bound exceeds the best cost
+   * found so far.
+   */
+  size_t find_best_sibling(const vm::bbox<T, 3>& bounds) const
+  {
+    const auto leaf_area = surface_area(bounds);
+
+    auto best_sibling = m_root;
+    auto best_cost = surface_area(vm::merge(m_bounds[m_root], bounds));
+
+    // pairs of the increase of the surface areas of a node's ancestors and the node
+    // index, visiting the nodes with the smallest increase first
+    using candidate = std::pair<T, size_t>;
+    auto queue =
+      std::priority_queue<candidate, std::vector<candidate>, std::greater<candidate>>{};
+    queue.emplace(T(0), m_root);
+
+    while (!queue.empty())
+    {
+      const auto [inherited_cost, index] = queue.top();
+      queue.pop();
+
+      if (leaf_area + inherited_cost >= best_cost)
+      {
+        break;
+      }
+
+      const auto merged_area = surface_area(vm::merge(m_bounds[index], bounds));
+      const auto cost = merged_area + inherited_cost;
+      if (cost < best_cost)
+      {
+        best_sibling = index;
+        best_cost = cost;
+      }
+
+      if (!is_leaf(index))
+      {
+        const auto child_inherited_cost =
+          inherited_cost + merged_area - surface_area(m_bounds[index]);
+        if (leaf_area + child_inherited_cost < best_cost)
+        {
+          queue.emplace(child_inherited_cost, m_children[index][0]);
+          queue.emplace(child_inherited_cost, m_children[index][1]);
+        }
+      }
+    }
+
+    return best_sibling;
+  }
+
+  void insert_leaf(const size_t leaf)
+  {
+    if (m_root == null_index)
+    {
+      m_root = leaf;
+      m_parent[leaf] = null_index;
+      return;
+    }
+
+    const auto sibling = find_best_sibling(m_bounds[leaf]);
+    const auto old_parent = m_parent[sibling];
+
+    const auto new_parent = allocate_node();
+    m_bounds[new_parent] = vm::merge(m_bounds[sibling], m_bounds[leaf]);
+    m_children[new_parent] = {sibling, leaf};
+    m_parent[new_parent] = old_parent;
+    m_height[new_parent] = m_height[sibling] + 1;
+
+    replace_child(old_parent, sibling, new_parent);
+    m_parent[sibling] = new_parent;
+    m_parent[leaf] = new_parent;
+
+    refit(old_parent);
+  }
+
+  void remove_leaf(const size_t leaf)
+  {
+    if (leaf == m_root)
+    {
+      m_root = null_index;
+      return;
+    }
+
+    const auto parent = m_parent[leaf];
+    const auto grand_parent = m_parent[parent];
+    const auto sibling =
+      m_children[parent][0] == leaf ? m_children[parent][1] : m_children[parent][0];
+
+    replace_child(grand_parent, parent, sibling);
+    m_parent[sibling] = grand_parent;
+    free_node(parent);
+
+    refit(grand_parent);
+  }
+
+  /**
+   * Recomputes the bounds and heights of the given node and its ancestors and rebalances
+   * them on the way up.
+   */
+  void refit(size_t index)
+  {
+    while (index != null_index)
+    {
+      index = balance(index);
+
+      const auto [child1, child2] = m_children[index];
+      m_bounds[index] = vm::merge(m_bounds[child1], m_bounds[child2]);
+      m_height[index] = 1 + std::max(m_height[child1], m_height[child2]);
+
+      index = m_parent[index];
+    }
+  }
+
+  /**
+   * If the subtrees of the given node differ in height by more than one, rotates the
+   * higher subtree up and returns the index of the node that replaced the given node.
+   */
+  size_t balance(const size_t a)
+  {
+    if (is_leaf(a) || m_height[a] < 2)
+    {
+      return a;
+    }
+
+    const auto [b, c] = m_children[a];
+    const auto difference = m_height[c] - m_height[b];
+
+    if (difference > 1)
+    {
+      rotate_up(a, c, 1);
+      return c;
+    }
+    if (difference < -1)
+    {
+      rotate_up(a, b, 0);
+      return b;
+    }
+    return a;
+  }
+
+  /**
+   * Rotates the given child of the given node up so that it becomes the node's parent.
+   * The given node takes over the lower subtree of the child.
+   *
+   * @param a the node to rotate down
+   * @param child the child to rotate up
+   * @param child_slot the index of the child in the children of a
+   */
+  void rotate_up(const size_t a, const size_t child, const size_t child_slot)
+  {
+    const auto other = m_children[a][1 - child_slot];
+    const auto [f, g] = m_children[child];
+
+    m_children[child][0] = a;
+    m_parent[child] = m_parent[a];
+    m_parent[a] = child;
+    replace_child(m_parent[child], a, child);
+
+    // keep the higher grandchild below the rotated child and give the other one to a; if
+    // both are equally high, give a the one that results in the smaller bounds
+    const auto give_f = m_height[f] != m_height[g]
+                          ? m_height[f] < m_height[g]
+                          : surface_area(vm::merge(m_bounds[other], m_bounds[f]))
+                              < surface_area(vm::merge(m_bounds[other], m_bounds[g]));
+    const auto keep = give_f ? g : f;
+    const auto give = give_f ? f : g;
+
+    m_children[child][1] = keep;
+    m_children[a][child_slot] = give;
+    m_parent[give] = a;
+
+    m_bounds[a] = vm::merge(m_bounds[other], m_bounds[give]);
+    m_height[a] = 1 + std::max(m_height[other], m_height[give]);
+
+    m_bounds[child] = vm::merge(m_bounds[a], m_bounds[keep]);
+    m_height[child] = 1 + std::max(m_height[a], m_height[keep]);
+  }
+
+  void check(const vm::bbox<T, 3>& bounds) const
+  {
+    if (vm::is_nan(bounds.min) || vm::is_nan(bounds.max))
+    {
+      throw NodeTreeException("Cannot add node to tree with invalid bounds");
+    }
+  }
+};
+
+} // namespace TrenchBroom
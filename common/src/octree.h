@@ -25,10 +25,13 @@
 #include <vecmath/bbox.h>
 #include <vecmath/bbox_io.h>
 #include <vecmath/intersection.h>
+#include <vecmath/plane.h>
 #include <vecmath/ray.h>
 #include <vecmath/scalar.h>
+#include <vecmath/util.h>
 
 #include <kdl/overload.h>
+#include <kdl/parallel.h>
 #include <kdl/reflection_decl.h>
 #include <kdl/reflection_impl.h>
 #include <kdl/vector_utils.h>
@@ -37,9 +40,13 @@
 #include <cassert>
 #include <cmath>
 #include <cstdint>
+#include <limits>
 #include <optional>
 #include <ostream>
+#include <queue>
+#include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -360,6 +367,129 @@ private:
       node);
   }
 
+  struct build_item
+  {
+    detail::node_address address;
+    U data;
+
+    // 0 if the item is stored in the node being built, otherwise its quadrant plus 1
+    size_t key = 0;
+  };
+
+  using build_iterator = typename std::vector<build_item>::iterator;
+
+  /**
+   * Builds a node for the given items. The items must fit into the given address, and the
+   * address must be the smallest one that contains all of the items.
+   */
+  static node build_node(
+    const detail::node_address& address,
+    const build_iterator begin,
+    const build_iterator end)
+  {
+    // the items that don't fit into any quadrant come first, then the items of each
+    // quadrant in order
+    for (auto it = begin; it != end; ++it)
+    {
+      const auto quadrant = get_quadrant(address, it->address);
+      it->key = quadrant ? *quadrant + 1 : 0;
+    }
+    const auto data_end =
+      std::partition(begin, end, [](const auto& item) { return item.key == 0; });
+    sort_by_key(data_end, end, 1, 9);
+
+    auto data = std::vector<U>{};
+    data.reserve(size_t(std::distance(begin, data_end)));
+    std::transform(begin, data_end, std::back_inserter(data), [](auto& item) {
+      return std::move(item.data);
+    });
+
+    if (data_end == end)
+    {
+      return leaf_node{address, std::move(data)};
+    }
+
+    return inner_node{address, std::move(data), build_children(address, data_end, end)};
+  }
+
+  /**
+   * Sorts the given items, whose keys must be in the given half open interval, by key in
+   * linear time.
+   */
+  static void sort_by_key(
+    const build_iterator begin,
+    const build_iterator end,
+    const size_t min_key,
+    const size_t max_key)
+  {
+    if (max_key - min_key > 1 && begin != end)
+    {
+      const auto mid_key = (min_key + max_key) / 2;
+      const auto mid =
+        std::partition(begin, end, [&](const auto& item) { return item.key < mid_key; });
+      sort_by_key(begin, mid, min_key, mid_key);
+      sort_by_key(mid, end, mid_key, max_key);
+    }
+  }
+
+  /**
+   * Builds the children of the node with the given address. The given items must be
+   * sorted by quadrant. If requested, the children are built in parallel.
+   */
+  static std::vector<node> build_children(
+    const detail::node_address& address,
+    build_iterator begin,
+    const build_iterator end,
+    const bool parallel = false)
+  {
+    auto child_items = std::vector<std::tuple<size_t, build_iterator, build_iterator>>{};
+    child_items.reserve(8);
+    for (size_t quadrant = 0; quadrant < 8; ++quadrant)
+    {
+      const auto quadrant_end = std::find_if(
+        begin, end, [&](const auto& item) { return item.key > quadrant + 1; });
+      child_items.emplace_back(quadrant, begin, quadrant_end);
+      begin = quadrant_end;
+    }
+
+    const auto build_child = [&](const auto& child) -> node {
+      const auto& [quadrant, child_begin, child_end] = child;
+      if (child_begin == child_end)
+      {
+        return leaf_node{get_child(address, quadrant), {}};
+      }
+
+      // like insert_into_node, use the smallest address that contains all items
+      return build_node(
+        get_items_container(child_begin, child_end), child_begin, child_end);
+    };
+
+    return parallel ? kdl::vec_parallel_transform(std::move(child_items), build_child)
+                    : kdl::vec_transform(child_items, build_child);
+  }
+
+  /**
+   * Returns the smallest address that contains all of the given items. The items must not
+   * be stored in the root.
+   */
+  static detail::node_address get_items_container(
+    const build_iterator begin, const build_iterator end)
+  {
+    auto min = begin->address.min();
+    auto max = begin->address.max();
+    for (auto it = std::next(begin); it != end; ++it)
+    {
+      min = vm::min(min, it->address.min());
+      max = vm::max(max, it->address.max());
+    }
+
+    // the smallest address that contains the cells at both corners contains all items
+    return detail::get_container(
+      detail::node_address{int16_t(min.x()), int16_t(min.y()), int16_t(min.z()), 0},
+      detail::node_address{
+        int16_t(max.x() - 1), int16_t(max.y() - 1), int16_t(max.z() - 1), 0});
+  }
+
 private:
   std::optional<node> m_root;
   T m_min_size;
@@ -447,6 +577,98 @@ public:
     }
   }
 
+  /**
+   * Replaces the contents of this tree with the given items.
+   *
+   * This is faster than inserting the items one by one because every item is moved into
+   * its final node directly, and the tree never needs to grow its root.
+   *
+   * @param items pairs of the bounds and data of the items to add
+   *
+   * @throws NodeTreeException if any bounds are invalid or if any data is given more than
+   * once, in which case this tree is left empty
+   */
+  void build(std::vector<std::pair<vm::bbox<T, 3>, U>> items)
+  {
+    clear();
+
+    auto root_address = std::optional<detail::node_address>{};
+    const auto include_in_root = [&](const detail::node_address& address) {
+      if (!root_address || root_address->size < address.size)
+      {
+        root_address = address;
+      }
+    };
+
+    auto root_data = std::vector<U>{};
+    auto non_root_items = std::vector<build_item>{};
+    non_root_items.reserve(items.size());
+    m_node_address_for_data.reserve(items.size());
+
+    for (const auto& [bounds, data] : items)
+    {
+      check(bounds);
+    }
+
+    const auto addresses = kdl::vec_parallel_transform(
+      kdl::vec_transform(items, [](const auto& item) { return item.first; }),
+      [&](const vm::bbox<T, 3>& bounds) {
+        return detail::get_container(bounds, m_min_size);
+      });
+
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+      const auto& address = addresses[i];
+      auto& data = items[i].second;
+      if (!m_node_address_for_data.emplace(data, address).second)
+      {
+        clear();
+        throw NodeTreeException("Data already in tree");
+      }
+
+      if (is_root(address))
+      {
+        include_in_root(address);
+        root_data.push_back(std::move(data));
+      }
+      else
+      {
+        include_in_root(get_root(address));
+        non_root_items.push_back({address, std::move(data)});
+      }
+    }
+
+    if (!root_address)
+    {
+      return;
+    }
+
+    // like update_root_address, register the data stored in the root with its address
+    for (const auto& data : root_data)
+    {
+      m_node_address_for_data.insert_or_assign(data, *root_address);
+    }
+
+    if (non_root_items.empty())
+    {
+      m_root = leaf_node{*root_address, std::move(root_data)};
+      return;
+    }
+
+    for (auto& item : non_root_items)
+    {
+      const auto quadrant = get_quadrant(*root_address, item.address);
+      assert(quadrant.has_value());
+      item.key = *quadrant + 1;
+    }
+    sort_by_key(non_root_items.begin(), non_root_items.end(), 1, 9);
+
+    m_root = inner_node{
+      *root_address,
+      std::move(root_data),
+      build_children(
+        *root_address, non_root_items.begin(), non_root_items.end(), true)};
+  }
 
   /**
    * Removes the node with the given data from this tree.
@@ -549,6 +771,129 @@ public:
     }
   }
 
+  /**
+   * Visits every data item in this tree whose bounding box intersects with the given ray
+   * in the order of the distances at which the ray enters the bounding boxes of the
+   * items.
+   *
+   * The visitor is called with each such data item and returns the distance at which the
+   * item was hit, or an empty optional if the item was not hit. Once the visitor has
+   * reported a hit, items and nodes which the ray enters beyond the closest reported hit
+   * are skipped.
+   *
+   * Since this tree does not store the bounding boxes of its data items, they must be
+   * provided by the given function. The bounding box of a data item must be contained in
+   * the bounds of the node that stores it.
+   *
+   * @tparam B the type of the function that returns the bounding box of a data item
+   * @tparam V the visitor type
+   * @param ray the ray to test
+   * @param get_bounds returns the bounding box of a data item
+   * @param visitor the visitor to call for each data item whose bounding box is hit
+   */
+  template <typename B, typename V>
+  void visit_intersectors_by_distance(
+    const vm::ray<T, 3>& ray, const B& get_bounds, const V& visitor) const
+  {
+    if (!m_root)
+    {
+      return;
+    }
+
+    // the queue contains both nodes and data items, ordered by ray entry distance
+    struct queue_entry
+    {
+      T distance;
+      const node* node_;
+      const U* data;
+    };
+
+    const auto compare = [](const queue_entry& lhs, const queue_entry& rhs) {
+      return lhs.distance > rhs.distance;
+    };
+    auto queue =
+      std::priority_queue<queue_entry, std::vector<queue_entry>, decltype(compare)>{
+        compare};
+
+    // the bounds of the children and data items of a node are intersected with the ray
+    // in one batch
+    auto batch = vm::bbox_batch<T, 3>{};
+    auto distances = std::vector<T>{};
+    const auto get_entry_distances = [&]() {
+      distances.resize(batch.size());
+      vm::intersect_ray_bboxes(ray, batch, distances.data());
+      for (size_t i = 0; i < batch.size(); ++i)
+      {
+        if (batch[i].contains(ray.origin))
+        {
+          distances[i] = T(0);
+        }
+      }
+    };
+
+    batch.push_back(get_address(*m_root).to_bounds(m_min_size));
+    get_entry_distances();
+    if (!vm::is_nan(distances.front()))
+    {
+      queue.push({distances.front(), &*m_root, nullptr});
+    }
+
+    auto closest_hit = std::numeric_limits<T>::max();
+    while (!queue.empty() && queue.top().distance <= closest_hit)
+    {
+      const auto entry = queue.top();
+      queue.pop();
+
+      if (entry.data)
+      {
+        if (const auto hit_distance = visitor(*entry.data))
+        {
+          closest_hit = std::min(closest_hit, *hit_distance);
+        }
+        continue;
+      }
+
+      const auto& data = get_data(*entry.node_);
+      batch.clear();
+      for (const auto& u : data)
+      {
+        batch.push_back(get_bounds(u));
+      }
+
+      const auto* inner = std::get_if<inner_node>(entry.node_);
+      if (inner)
+      {
+        for (const auto& child : inner->children)
+        {
+          batch.push_back(get_address(child).to_bounds(m_min_size));
+        }
+      }
+
+      get_entry_distances();
+      for (size_t i = 0; i < data.size(); ++i)
+      {
+        if (!vm::is_nan(distances[i]) && distances[i] <= closest_hit)
+        {
+          queue.push({distances[i], nullptr, &data[i]});
+        }
+      }
+
+      if (inner)
+      {
+        for (size_t i = 0; i < inner->children.size(); ++i)
+        {
+          const auto& child = inner->children[i];
+          const auto distance = distances[data.size() + i];
+          if (
+            !vm::is_nan(distance) && (is_inner_node(child) || !get_data(child).empty()))
+          {
+            queue.push({distance, &child, nullptr});
+          }
+        }
+      }
+    }
+  }
+
   /**
    * Finds every data item in this tree whose bounding box contains the given point and
    * returns a list of those items.
@@ -588,9 +933,166 @@ public:
     }
   }
 
+  /**
+   * Finds every data item in this tree whose bounding box intersects with the given
+   * bounding box and returns a list of those items.
+   *
+   * @param bounds the bounding box to test
+   * @return a list containing all found data items
+   */
+  std::vector<U> find_overlapping(const vm::bbox<T, 3>& bounds) const
+  {
+    auto result = std::vector<U>{};
+    find_overlapping(bounds, std::back_inserter(result));
+    return result;
+  }
+
+  /**
+   * Finds every data item in this tree whose bounding box intersects with the given
+   * bounding box and appends it to the given output iterator.
+   *
+   * @tparam O the output iterator type
+   * @param bounds the bounding box to test
+   * @param out the output iterator to append to
+   */
+  template <typename O>
+  void find_overlapping(const vm::bbox<T, 3>& bounds, O out) const
+  {
+    if (m_root)
+    {
+      visit_node_if(
+        *m_root,
+        [&](const auto& node) {
+          const auto& data = get_data(node);
+          std::copy(data.begin(), data.end(), out);
+        },
+        [&](const auto& node) {
+          return get_address(node).to_bounds(m_min_size).intersects(bounds);
+        });
+    }
+  }
+
+  /**
+   * Finds every data item in this tree whose bounding box is not entirely above any of
+   * the given planes and returns a list of those items.
+   *
+   * If the planes bound a convex volume such as a view frustum and their normals point
+   * out of the volume, then these are the items whose bounding boxes may intersect the
+   * volume.
+   *
+   * Since this tree does not store the bounding boxes of its data items, they must be
+   * provided by the given function. It is only called for items of nodes which straddle
+   * one of the planes. The bounding box of a data item must be contained in the bounds of
+   * the node that stores it.
+   *
+   * @tparam B the type of the function that returns the bounding box of a data item
+   * @param frustum_planes the planes to test
+   * @param get_bounds returns the bounding box of a data item
+   * @return a list containing all found data items
+   */
+  template <typename B>
+  std::vector<U> find_in_frustum(
+    const std::vector<vm::plane<T, 3>>& frustum_planes, const B& get_bounds) const
+  {
+    auto result = std::vector<U>{};
+    find_in_frustum(frustum_planes, get_bounds, std::back_inserter(result));
+    return result;
+  }
+
+  /**
+   * Finds every data item in this tree whose bounding box is not entirely above any of
+   * the given planes and appends it to the given output iterator.
+   *
+   * @tparam B the type of the function that returns the bounding box of a data item
+   * @tparam O the output iterator type
+   * @param frustum_planes the planes to test
+   * @param get_bounds returns the bounding box of a data item
+   * @param out the output iterator to append to
+   */
+  template <typename B, typename O>
+  void find_in_frustum(
+    const std::vector<vm::plane<T, 3>>& frustum_planes,
+    const B& get_bounds,
+    O out) const
+  {
+    if (m_root)
+    {
+      find_in_frustum(*m_root, frustum_planes, get_bounds, false, out);
+    }
+  }
+
   kdl_reflect_inline(octree, m_root, m_min_size, m_node_address_for_data);
 
 private:
+  /**
+   * Appends the data items of the given node and its descendants that are not entirely
+   * above any of the given planes. If the node is known to be below all planes, so are
+   * its descendants and their data items, and they are not tested.
+   */
+  template <typename B, typename O>
+  void find_in_frustum(
+    const node& node,
+    const std::vector<vm::plane<T, 3>>& frustum_planes,
+    const B& get_bounds,
+    bool below_all,
+    O& out) const
+  {
+    if (!below_all)
+    {
+      const auto status =
+        frustum_status(frustum_planes, get_address(node).to_bounds(m_min_size));
+      if (status == vm::plane_status::above)
+      {
+        return;
+      }
+      below_all = status == vm::plane_status::below;
+    }
+
+    const auto& data = get_data(node);
+    if (below_all)
+    {
+      std::copy(data.begin(), data.end(), out);
+    }
+    else
+    {
+      std::copy_if(data.begin(), data.end(), out, [&](const U& u) {
+        return frustum_status(frustum_planes, get_bounds(u)) != vm::plane_status::above;
+      });
+    }
+
+    if (const auto* inner = std::get_if<inner_node>(&node))
+    {
+      for (const auto& child : inner->children)
+      {
+        find_in_frustum(child, frustum_planes, get_bounds, below_all, out);
+      }
+    }
+  }
+
+  /**
+   * Returns plane_status::above if the given bounding box is entirely above any of the
+   * given planes, plane_status::below if it is entirely below all of them, and
+   * plane_status::inside otherwise.
+   */
+  static vm::plane_status frustum_status(
+    const std::vector<vm::plane<T, 3>>& frustum_planes, const vm::bbox<T, 3>& bounds)
+  {
+    auto result = vm::plane_status::below;
+    for (const auto& plane : frustum_planes)
+    {
+      const auto status = vm::plane_bbox_status(plane, bounds);
+      if (status == vm::plane_status::above)
+      {
+        return status;
+      }
+      if (status == vm::plane_status::inside)
+      {
+        result = status;
+      }
+    }
+    return result;
+  }
+
   void check(const vm::bbox<T, 3>& bounds) const
   {
     if (vm::is_nan(bounds.min) || vm::is_nan(bounds.max))
@@ -0,0 +1,178 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/EntityModel.h"
+#include "Assets/EntityModelManager.h"
+#include "Assets/ModelDefinition.h"
+#include "IO/EntityModelLoader.h"
+#include "IO/Path.h"
+#include "Logger.h"
+#include "Renderer/IndexRangeMap.h"
+#include "Renderer/PrimType.h"
+#include "Renderer/VboManager.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <memory>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace Assets
+{
+namespace
+{
+/**
+ * Loads a model with a single frame containing a fan of triangles for any path.
+ */
+class TestModelLoader : public IO::EntityModelLoader
+{
+private:
+  std::unique_ptr<EntityModel> doInitializeModel(
+    const IO::Path& path, Logger& /* logger */) const override
+  {
+    auto model = std::make_unique<EntityModel>(
+      path.asString(), PitchType::Normal, Orientation::Oriented);
+    model->addFrame();
+    model->addSurface("surface");
+    return model;
+  }
+
+  void doLoadFrame(
+    const IO::Path& /* path */,
+    const size_t frameIndex,
+    EntityModel& model,
+    Logger& /* logger */) const override
+  {
+    auto vertices = std::vector<EntityModelVertex>{};
+    vertices.emplace_back(vm::vec3f{0, 0, 0}, vm::vec2f{0, 0});
+    for (size_t i = 0; i < 64; ++i)
+    {
+      vertices.emplace_back(vm::vec3f{float(i), 8, 0}, vm::vec2f{0, 0});
+    }
+
+    auto& frame = model.loadFrame(frameIndex, "frame", vm::bbox3f{64.0f});
+    auto indices = EntityModelIndices{
+      Renderer::PrimType::TriangleFan, 0, vertices.size()};
+    model.surface(0).addIndexedMesh(frame, std::move(vertices), std::move(indices));
+  }
+};
+
+ModelSpecification spec(const std::string& path)
+{
+  return ModelSpecification{IO::Path{path}, 0, 0};
+}
+} // namespace
+
+TEST_CASE("EntityModelManagerTest.memoryUsage")
+{
+  auto logger = NullLogger{};
+  auto loader = TestModelLoader{};
+
+  auto manager = EntityModelManager{0, 0, logger};
+  manager.setLoader(&loader);
+  CHECK(manager.memoryUsage() == 0u);
+
+  REQUIRE(manager.frame(spec("a")) != nullptr);
+  CHECK(manager.modelCount() == 1u);
+  CHECK(manager.memoryUsage(IO::Path{"a"}) > 0u);
+  CHECK(manager.memoryUsage() == manager.memoryUsage(IO::Path{"a"}));
+
+  REQUIRE(manager.frame(spec("b")) != nullptr);
+  CHECK(manager.modelCount() == 2u);
+  CHECK(
+    manager.memoryUsage()
+    == manager.memoryUsage(IO::Path{"a"}) + manager.memoryUsage(IO::Path{"b"}));
+  CHECK(manager.memoryUsage(IO::Path{"c"}) == 0u);
+
+  manager.clear();
+  CHECK(manager.modelCount() == 0u);
+  CHECK(manager.memoryUsage() == 0u);
+}
+
+TEST_CASE("EntityModelManagerTest.evictLeastRecentlyUsed")
+{
+  auto logger = NullLogger{};
+  auto loader = TestModelLoader{};
+  auto vboManager = Renderer::VboManager{nullptr};
+
+  auto manager = EntityModelManager{0, 0, logger};
+  manager.setLoader(&loader);
+
+  REQUIRE(manager.frame(spec("a")) != nullptr);
+  const auto modelMemory = manager.memoryUsage();
+  manager.setMemoryBudget(2 * modelMemory);
+
+  manager.prepare(vboManager);
+  REQUIRE(manager.frame(spec("b")) != nullptr);
+  manager.prepare(vboManager);
+  REQUIRE(manager.frame(spec("c")) != nullptr);
+  manager.prepare(vboManager);
+
+  // a was used least recently
+  CHECK(manager.modelCount() == 2u);
+  CHECK(manager.evictionCount() == 1u);
+  CHECK(manager.memoryUsage() == 2 * modelMemory);
+  CHECK(manager.memoryUsage(IO::Path{"a"}) == 0u);
+
+  // touch b so that c becomes the least recently used model
+  REQUIRE(manager.frame(spec("b")) != nullptr);
+  manager.prepare(vboManager);
+
+  // a is reloaded transparently
+  CHECK(manager.frame(spec("a")) != nullptr);
+  CHECK(manager.memoryUsage(IO::Path{"a"}) == modelMemory);
+  manager.prepare(vboManager);
+
+  CHECK(manager.modelCount() == 2u);
+  CHECK(manager.evictionCount() == 2u);
+  CHECK(manager.memoryUsage(IO::Path{"b"}) == modelMemory);
+  CHECK(manager.memoryUsage(IO::Path{"c"}) == 0u);
+}
+
+TEST_CASE("EntityModelManagerTest.doNotEvictModelsInUse")
+{
+  auto logger = NullLogger{};
+  auto loader = TestModelLoader{};
+  auto vboManager = Renderer::VboManager{nullptr};
+
+  auto manager = EntityModelManager{0, 0, logger};
+  manager.setLoader(&loader);
+
+  const auto* frameA = manager.frame(spec("a"));
+  REQUIRE(frameA != nullptr);
+  manager.setFramesInUse([&]() { return std::vector<const EntityModelFrame*>{frameA}; });
+  manager.setMemoryBudget(0);
+
+  // b is used in the same generation, so nothing can be evicted yet
+  REQUIRE(manager.frame(spec("b")) != nullptr);
+  manager.prepare(vboManager);
+  CHECK(manager.modelCount() == 2u);
+
+  manager.prepare(vboManager);
+  CHECK(manager.modelCount() == 1u);
+  CHECK(manager.memoryUsage(IO::Path{"a"}) > 0u);
+  CHECK(manager.memoryUsage(IO::Path{"b"}) == 0u);
+  CHECK(manager.memoryUsage() == manager.memoryUsage(IO::Path{"a"}));
+}
+} // namespace Assets
+} // namespace TrenchBroom
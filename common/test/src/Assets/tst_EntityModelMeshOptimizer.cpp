@@ -0,0 +1,212 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/EntityModel.h"
+#include "Assets/EntityModelMeshOptimizer.h"
+#include "Renderer/IndexRangeMap.h"
+#include "Renderer/IndexRangeMapBuilder.h"
+#include "Renderer/PrimType.h"
+
+#include <vecmath/vec.h>
+#include <vecmath/vec_io.h>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace Assets
+{
+namespace
+{
+EntityModelVertex vertex(const float x, const float y)
+{
+  return EntityModelVertex{vm::vec3f{x, y, 0}, vm::vec2f{x, y}};
+}
+
+/**
+ * Returns the triangles of the given mesh as sorted positions so that triangles can be
+ * compared regardless of vertex order and triangle order.
+ */
+std::vector<std::array<vm::vec3f, 3>> triangles(const EntityModelTriangleMesh& mesh)
+{
+  auto result = std::vector<std::array<vm::vec3f, 3>>{};
+  for (size_t i = 0; i < mesh.indices.size(); i += 3)
+  {
+    auto triangle = std::array<vm::vec3f, 3>{
+      Renderer::getVertexComponent<0>(mesh.vertices[mesh.indices[i + 0]]),
+      Renderer::getVertexComponent<0>(mesh.vertices[mesh.indices[i + 1]]),
+      Renderer::getVertexComponent<0>(mesh.vertices[mesh.indices[i + 2]])};
+
+    // rotate the smallest vertex to the front to keep the winding order
+    std::rotate(
+      std::begin(triangle),
+      std::min_element(std::begin(triangle), std::end(triangle)),
+      std::end(triangle));
+    result.push_back(triangle);
+  }
+  std::sort(std::begin(result), std::end(result));
+  return result;
+}
+
+/**
+ * Creates a grid of quads where every quad has its own four vertices.
+ */
+EntityModelTriangleMesh makeQuadGrid(const size_t width, const size_t height)
+{
+  auto size = Renderer::IndexRangeMap::Size{};
+  size.inc(Renderer::PrimType::Polygon, width * height);
+
+  auto builder =
+    Renderer::IndexRangeMapBuilder<EntityModelVertex::Type>{width * height * 4, size};
+  for (size_t y = 0; y < height; ++y)
+  {
+    for (size_t x = 0; x < width; ++x)
+    {
+      const auto fx = float(x);
+      const auto fy = float(y);
+      builder.addPolygon({
+        vertex(fx, fy),
+        vertex(fx + 1, fy),
+        vertex(fx + 1, fy + 1),
+        vertex(fx, fy + 1),
+      });
+    }
+  }
+
+  return triangulateMesh(std::move(builder.vertices()), builder.indices());
+}
+} // namespace
+
+TEST_CASE("EntityModelMeshOptimizerTest.triangulateMesh")
+{
+  auto size = Renderer::IndexRangeMap::Size{};
+  size.inc(Renderer::PrimType::Polygon, 1);
+  size.inc(Renderer::PrimType::TriangleStrip, 1);
+
+  auto builder = Renderer::IndexRangeMapBuilder<EntityModelVertex::Type>{9, size};
+  builder.addPolygon({vertex(0, 0), vertex(1, 0), vertex(1, 1), vertex(0, 1)});
+  builder.addTriangleStrip(
+    {vertex(2, 0), vertex(2, 1), vertex(3, 0), vertex(3, 1), vertex(4, 0)});
+
+  const auto mesh = triangulateMesh(builder.vertices(), builder.indices());
+  CHECK(mesh.vertices.size() == 9u);
+  CHECK(mesh.indices.size() == 15u);
+  REQUIRE(mesh.groups.size() == 1u);
+  CHECK(mesh.groups[0].texture == nullptr);
+  CHECK(mesh.groups[0].offset == 0u);
+  CHECK(mesh.groups[0].count == 15u);
+}
+
+TEST_CASE("EntityModelMeshOptimizerTest.triangulateQuads")
+{
+  auto size = Renderer::IndexRangeMap::Size{};
+  size.inc(Renderer::PrimType::Quads, 1);
+
+  auto builder = Renderer::IndexRangeMapBuilder<EntityModelVertex::Type>{8, size};
+  builder.addQuads({
+    vertex(0, 0),
+    vertex(1, 0),
+    vertex(1, 1),
+    vertex(0, 1),
+    vertex(2, 0),
+    vertex(3, 0),
+    vertex(3, 1),
+    vertex(2, 1),
+  });
+
+  const auto mesh = triangulateMesh(builder.vertices(), builder.indices());
+  CHECK(mesh.indices.size() == 12u);
+  CHECK(
+    triangles(mesh)
+    == std::vector<std::array<vm::vec3f, 3>>{
+      {vm::vec3f{0, 0, 0}, vm::vec3f{1, 0, 0}, vm::vec3f{1, 1, 0}},
+      {vm::vec3f{0, 0, 0}, vm::vec3f{1, 1, 0}, vm::vec3f{0, 1, 0}},
+      {vm::vec3f{2, 0, 0}, vm::vec3f{3, 0, 0}, vm::vec3f{3, 1, 0}},
+      {vm::vec3f{2, 0, 0}, vm::vec3f{3, 1, 0}, vm::vec3f{2, 1, 0}},
+    });
+}
+
+TEST_CASE("EntityModelMeshOptimizerTest.optimizeMesh")
+{
+  const auto original = makeQuadGrid(16, 16);
+  const auto optimized = optimizeMesh(original);
+
+  SECTION("Identical vertices are welded")
+  {
+    CHECK(original.vertices.size() == 16u * 16u * 4u);
+    CHECK(optimized.vertices.size() == 17u * 17u);
+  }
+
+  SECTION("Triangles are preserved")
+  {
+    CHECK(optimized.indices.size() == original.indices.size());
+    CHECK(triangles(optimized) == triangles(original));
+  }
+
+  SECTION("Groups are preserved")
+  {
+    REQUIRE(optimized.groups.size() == 1u);
+    CHECK(optimized.groups[0].offset == 0u);
+    CHECK(optimized.groups[0].count == optimized.indices.size());
+  }
+
+  SECTION("Vertices are ordered by first use")
+  {
+    auto maxIndex = std::uint32_t(0);
+    for (const auto index : optimized.indices)
+    {
+      CHECK(index <= maxIndex + 1u);
+      maxIndex = std::max(maxIndex, index);
+    }
+  }
+
+  SECTION("Vertex cache efficiency improves")
+  {
+    CHECK(computeACMR(original.indices) == 2.0f);
+    CHECK(computeACMR(optimized.indices) < 1.0f);
+  }
+}
+
+TEST_CASE("EntityModelMeshOptimizerTest.optimizeMeshRemovesDegenerateTriangles")
+{
+  auto mesh = EntityModelTriangleMesh{
+    {vertex(0, 0), vertex(1, 0), vertex(1, 0), vertex(0, 0), vertex(1, 0), vertex(0, 1)},
+    {0, 1, 2, 3, 4, 5},
+    {{nullptr, 0, 6}}};
+
+  const auto optimized = optimizeMesh(std::move(mesh));
+  CHECK(optimized.vertices.size() == 3u);
+  CHECK(optimized.indices == std::vector<std::uint32_t>{0, 1, 2});
+  REQUIRE(optimized.groups.size() == 1u);
+  CHECK(optimized.groups[0].count == 3u);
+}
+
+TEST_CASE("EntityModelMeshOptimizerTest.computeACMR")
+{
+  CHECK(computeACMR({}) == 0.0f);
+  CHECK(computeACMR({0, 1, 2}) == 3.0f);
+  CHECK(computeACMR({0, 1, 2, 2, 1, 3}) == 2.0f);
+  CHECK(computeACMR({0, 1, 2, 3, 4, 5, 0, 1, 2}, 3) == 3.0f);
+}
+} // namespace Assets
+} // namespace TrenchBroom
@@ -25,6 +25,10 @@
 #include "IO/Reader.h"
 #include "Logger.h"
 
+#include <vecmath/ray.h>
+#include <vecmath/scalar.h>
+#include <vecmath/vec.h>
+
 #include "Catch2.h"
 
 namespace TrenchBroom
@@ -56,5 +60,68 @@ TEST_CASE("ObjParserTest.loadValidObj")
   CHECK(surface.skinCount() == 1u);
   CHECK(surface.frameCount() == 1u);
 }
+
+namespace
+{
+std::unique_ptr<Assets::EntityModel> loadObjModel(const Path& path)
+{
+  NullLogger logger;
+
+  const auto basePath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Obj");
+  DiskFileSystem fs(basePath);
+
+  const auto file = fs.openFile(path);
+  REQUIRE(file != nullptr);
+
+  auto reader = file->reader().buffer();
+  auto parser = NvObjParser(path, reader.stringView(), fs);
+  auto model = parser.initializeModel(logger);
+  parser.loadFrame(0, *model, logger);
+  return model;
+}
+
+float intersectFromAbove(const Assets::EntityModelFrame& frame, const float x, const float y)
+{
+  return frame.intersect(vm::ray3f{vm::vec3f{x, y, 128.0f}, vm::vec3f::neg_z()});
+}
+} // namespace
+
+TEST_CASE("ObjParserTest.pickQuad")
+{
+  const auto model = loadObjModel(Path("quad.obj"));
+  REQUIRE(model != nullptr);
+
+  const auto* frame = model->frame(0);
+  REQUIRE(frame != nullptr);
+
+  // the quad covers [-64, 64] on the X and Y axes at Z = 0
+  for (float x = -56.0f; x <= 56.0f; x += 16.0f)
+  {
+    for (float y = -56.0f; y <= 56.0f; y += 16.0f)
+    {
+      CHECK(intersectFromAbove(*frame, x, y) == Approx(128.0f));
+    }
+  }
+
+  CHECK(vm::is_nan(intersectFromAbove(*frame, 72.0f, 0.0f)));
+  CHECK(vm::is_nan(intersectFromAbove(*frame, 0.0f, -72.0f)));
+}
+
+TEST_CASE("ObjParserTest.pickNgon")
+{
+  const auto model = loadObjModel(Path("ngon.obj"));
+  REQUIRE(model != nullptr);
+
+  const auto* frame = model->frame(0);
+  REQUIRE(frame != nullptr);
+
+  // a hexagon with radius 64 at Z = 0, and a small triangle at Z = 64 above its center
+  CHECK(intersectFromAbove(*frame, 0.0f, 0.0f) == Approx(64.0f));
+  CHECK(intersectFromAbove(*frame, 0.0f, -40.0f) == Approx(128.0f));
+  CHECK(intersectFromAbove(*frame, 40.0f, 20.0f) == Approx(128.0f));
+  CHECK(intersectFromAbove(*frame, -40.0f, 20.0f) == Approx(128.0f));
+  CHECK(intersectFromAbove(*frame, -56.0f, 0.0f) == Approx(128.0f));
+  CHECK(vm::is_nan(intersectFromAbove(*frame, 60.0f, 30.0f)));
+}
 } // namespace IO
 } // namespace TrenchBroom
@@ -0,0 +1,170 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Model/ApplyToNodeContents.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceHandle.h"
+#include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/MapFormat.h"
+#include "Model/Node.h"
+
+#include <kdl/overload.h>
+#include <kdl/result.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace Model
+{
+TEST_CASE("ApplyToNodeContentsTest.applyToNodeContents")
+{
+  const auto worldBounds = vm::bbox3{4096.0};
+  const auto builder = BrushBuilder{MapFormat::Quake3, worldBounds};
+
+  auto brushNode1 = BrushNode{builder.createCube(64.0, "texture").value()};
+  auto brushNode2 = BrushNode{builder.createCube(32.0, "texture").value()};
+  auto entityNode = EntityNode{Entity{}};
+  const auto nodes = std::vector<Node*>{&brushNode1, &entityNode, &brushNode2};
+
+  const auto delta = vm::vec3{16, 0, 0};
+  auto visitedBrushCount = std::atomic<size_t>{0};
+  const auto translate = kdl::overload(
+    [](Layer&) { return true; },
+    [](Group&) { return true; },
+    [](Entity&) { return true; },
+    [&](Brush& brush) {
+      visitedBrushCount += 1;
+      return brush.transform(worldBounds, vm::translation_matrix(delta), false)
+        .is_success();
+    },
+    [](BezierPatch&) { return true; });
+
+  const auto failOnEntity = kdl::overload(
+    [](Layer&) { return true; },
+    [](Group&) { return true; },
+    [](Entity&) { return false; },
+    [](Brush&) { return true; },
+    [](BezierPatch&) { return true; });
+
+  SECTION("Serial")
+  {
+    const auto newNodes = applyToNodeContents(nodes, translate);
+    REQUIRE(newNodes);
+    REQUIRE(newNodes->size() == 3u);
+    CHECK(visitedBrushCount == 2u);
+
+    CHECK((*newNodes)[0].first == &brushNode1);
+    CHECK((*newNodes)[1].first == &entityNode);
+    CHECK((*newNodes)[2].first == &brushNode2);
+    CHECK(
+      std::get<Brush>((*newNodes)[0].second.get()).bounds()
+      == brushNode1.brush().bounds().translate(delta));
+
+    CHECK_FALSE(applyToNodeContents(nodes, failOnEntity));
+  }
+
+  SECTION("Parallel")
+  {
+    const auto newNodes = applyToNodeContents(nodes, threadSafe(translate));
+    REQUIRE(newNodes);
+    REQUIRE(newNodes->size() == 3u);
+    CHECK(visitedBrushCount == 2u);
+
+    CHECK((*newNodes)[0].first == &brushNode1);
+    CHECK((*newNodes)[1].first == &entityNode);
+    CHECK((*newNodes)[2].first == &brushNode2);
+    CHECK(
+      std::get<Brush>((*newNodes)[2].second.get()).bounds()
+      == brushNode2.brush().bounds().translate(delta));
+
+    CHECK_FALSE(applyToNodeContents(nodes, threadSafe(failOnEntity)));
+  }
+
+  // the original nodes remain unchanged
+  CHECK(brushNode1.brush().bounds() == vm::bbox3{32.0});
+  CHECK(brushNode2.brush().bounds() == vm::bbox3{16.0});
+}
+
+TEST_CASE("ApplyToNodeContentsTest.applyToBrushFaces")
+{
+  const auto worldBounds = vm::bbox3{4096.0};
+  const auto builder = BrushBuilder{MapFormat::Quake3, worldBounds};
+
+  auto brushNode1 = BrushNode{builder.createCube(64.0, "texture").value()};
+  auto brushNode2 = BrushNode{builder.createCube(32.0, "texture").value()};
+
+  const auto faces = std::vector<BrushFaceHandle>{
+    {&brushNode2, 0u},
+    {&brushNode1, 1u},
+    {&brushNode2, 3u},
+  };
+
+  const auto setTexture = [](BrushFace& face) {
+    auto attributes = face.attributes();
+    attributes.setTextureName("other");
+    face.setAttributes(attributes);
+    return true;
+  };
+
+  const auto checkTexturing = [&](const auto& texturing) {
+    REQUIRE(texturing);
+    REQUIRE(texturing->size() == 3u);
+
+    // the texturing is returned in the order of the given faces
+    for (size_t i = 0; i < faces.size(); ++i)
+    {
+      CHECK((*texturing)[i].faceHandle == faces[i]);
+      CHECK((*texturing)[i].attributes.textureName() == "other");
+      CHECK((*texturing)[i].texCoordSystem != nullptr);
+    }
+  };
+
+  SECTION("Serial")
+  {
+    checkTexturing(applyToBrushFaces(faces, setTexture));
+    CHECK_FALSE(applyToBrushFaces(faces, [](BrushFace&) { return false; }));
+  }
+
+  SECTION("Parallel")
+  {
+    checkTexturing(applyToBrushFaces(faces, threadSafe(setTexture)));
+    CHECK_FALSE(
+      applyToBrushFaces(faces, threadSafe([](BrushFace&) { return false; })));
+  }
+
+  CHECK(brushNode1.brush().face(1u).attributes().textureName() == "texture");
+  CHECK(brushNode2.brush().face(0u).attributes().textureName() == "texture");
+}
+} // namespace Model
+} // namespace TrenchBroom
@@ -17,14 +17,22 @@
  along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "FloatType.h"
 #include "Model/BezierPatch.h"
 
+#include <kdl/vector_utils.h>
+
+#include <vecmath/approx.h>
+#include <vecmath/bezier_surface.h>
 #include <vecmath/mat.h>
 #include <vecmath/mat_ext.h>
 #include <vecmath/mat_io.h>
+#include <vecmath/scalar.h>
 #include <vecmath/vec.h>
 #include <vecmath/vec_io.h>
 
+#include <array>
+#include <optional>
 #include <tuple>
 #include <vector>
 
@@ -60,6 +68,61 @@ TEST_CASE("BezierPatch.evaluate")
   CHECK(patch.evaluate(subdiv) == expectedGrid);
 }
 
+TEST_CASE("BezierPatch.evaluateSurfaces")
+{
+  // a patch with 2*3 surfaces and irregular control points
+  const auto w = size_t(7);
+  const auto h = size_t(5);
+  auto controlPoints = std::vector<BezierPatch::Point>{};
+  for (size_t row = 0; row < h; ++row)
+  {
+    for (size_t col = 0; col < w; ++col)
+    {
+      const auto x = FloatType(col);
+      const auto y = FloatType(row);
+      controlPoints.push_back(
+        BezierPatch::Point{x * 1.3, y * 0.7 + x * 0.1, (x * y) / 3.0, x / 6.0, y / 4.0});
+    }
+  }
+  const auto patch = BezierPatch{h, w, controlPoints, ""};
+
+  const auto subdiv = GENERATE(size_t(0), size_t(1), size_t(3), size_t(5));
+  CAPTURE(subdiv);
+
+  const auto quadsPerSurfaceSide = size_t(1) << subdiv;
+  const auto gridColumnCount = patch.surfaceColumnCount() * quadsPerSurfaceSide + 1u;
+
+  // every grid point must be exactly the point computed by evaluating its surface
+  auto expectedGrid = std::vector<BezierPatch::Point>{};
+  for (size_t gridRow = 0; gridRow < patch.surfaceRowCount() * quadsPerSurfaceSide + 1u;
+       ++gridRow)
+  {
+    const auto surfaceRow = (gridRow > 0u ? gridRow - 1u : 0u) / quadsPerSurfaceSide;
+    const auto v = FloatType(gridRow - surfaceRow * quadsPerSurfaceSide)
+                   / FloatType(quadsPerSurfaceSide);
+    for (size_t gridCol = 0; gridCol < gridColumnCount; ++gridCol)
+    {
+      const auto surfaceCol = (gridCol > 0u ? gridCol - 1u : 0u) / quadsPerSurfaceSide;
+      const auto u = FloatType(gridCol - surfaceCol * quadsPerSurfaceSide)
+                     / FloatType(quadsPerSurfaceSide);
+
+      auto surfaceControlPoints = std::array<std::array<BezierPatch::Point, 3>, 3>{};
+      for (size_t row = 0; row < 3; ++row)
+      {
+        for (size_t col = 0; col < 3; ++col)
+        {
+          surfaceControlPoints[row][col] =
+            patch.controlPoint(2u * surfaceRow + row, 2u * surfaceCol + col);
+        }
+      }
+      expectedGrid.push_back(
+        vm::evaluate_quadratic_bezier_surface(surfaceControlPoints, u, v));
+    }
+  }
+
+  CHECK(patch.evaluate(subdiv) == expectedGrid);
+}
+
 TEST_CASE("BezierPatch.transform")
 {
   // clang-format off
@@ -76,5 +139,74 @@ TEST_CASE("BezierPatch.transform")
                                                                   {2, 2, 0}, {3, 2, 1}, {4, 2, 0} });
   // clang-format on
 }
+
+TEST_CASE("BezierPatch.gridTransformation")
+{
+  // clang-format off
+  auto patch = BezierPatch{3, 5, { {0, 0, 0, 0.0, 0.0}, {1, 0, 1, 0.25, 0.0}, {2, 0, 0, 0.5, 0.0}, {3, 0, 2, 0.75, 0.0}, {4, 0, 0, 1.0, 0.0},
+                                   {0, 1, 1, 0.0, 0.5}, {1, 1, 2, 0.25, 0.5}, {2, 1, 1, 0.5, 0.5}, {3, 1, 0, 0.75, 0.5}, {4, 1, 1, 1.0, 0.5},
+                                   {0, 2, 0, 0.0, 1.0}, {1, 2, 1, 0.25, 1.0}, {2, 2, 0, 0.5, 1.0}, {3, 2, 2, 0.75, 1.0}, {4, 2, 0, 1.0, 1.0} }, ""};
+  // clang-format on
+
+  const auto subdiv = size_t(2);
+  const auto originalGrid = patch.evaluate(subdiv);
+
+  const auto transformation =
+    vm::translation_matrix(vm::vec3{16.0, -8.0, 32.0})
+    * vm::rotation_matrix(vm::vec3::pos_z(), vm::to_radians(30.0));
+
+  auto transformedPatch = patch;
+  CHECK(transformedPatch.gridTransformation(patch) == std::nullopt);
+
+  transformedPatch.transform(transformation);
+  CHECK(transformedPatch.gridTransformation(patch) == transformation);
+  CHECK(
+    patch.gridTransformation(transformedPatch)
+    == vm::approx{std::get<1>(vm::invert(transformation))});
+
+  SECTION("The grid of the transformed patch is the transformed grid")
+  {
+    CHECK(
+      transformedPatch.evaluate(subdiv)
+      == kdl::vec_transform(originalGrid, [&](const auto& p) {
+           return vm::approx{BezierPatch::Point{transformation * p.xyz(), p[3], p[4]}};
+         }));
+    CHECK(patch.evaluate(subdiv) == originalGrid);
+  }
+
+  SECTION("Copies of the transformed patch refer to the same original patch")
+  {
+    const auto copy = transformedPatch;
+    CHECK(copy.gridTransformation(patch) == transformation);
+  }
+
+  SECTION("Transforming the patch again refers to the intermediate patch")
+  {
+    auto twiceTransformedPatch = transformedPatch;
+    twiceTransformedPatch.transform(vm::scaling_matrix(vm::vec3{2.0, 1.0, 0.5}));
+    CHECK(twiceTransformedPatch.gridTransformation(patch) == std::nullopt);
+    CHECK(
+      twiceTransformedPatch.gridTransformation(transformedPatch)
+      == vm::scaling_matrix(vm::vec3{2.0, 1.0, 0.5}));
+  }
+
+  SECTION("Changing a control point of the transformed patch invalidates the reference")
+  {
+    transformedPatch.setControlPoint(1, 2, {2, 1, 5, 0.5, 0.5});
+    CHECK(transformedPatch.gridTransformation(patch) == std::nullopt);
+    CHECK(
+      transformedPatch.evaluate(subdiv)
+      == BezierPatch{3, 5, transformedPatch.controlPoints(), ""}.evaluate(subdiv));
+  }
+
+  SECTION("Changing a control point of the original patch invalidates the reference")
+  {
+    patch.setControlPoint(1, 2, {2, 1, 5, 0.5, 0.5});
+    CHECK(transformedPatch.gridTransformation(patch) == std::nullopt);
+    CHECK(
+      patch.evaluate(subdiv)
+      == BezierPatch{3, 5, patch.controlPoints(), ""}.evaluate(subdiv));
+  }
+}
 } // namespace Model
 } // namespace TrenchBroom
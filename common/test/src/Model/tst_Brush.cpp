@@ -39,12 +39,15 @@
 #include <kdl/vector_utils.h>
 
 #include <vecmath/approx.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
 #include <vecmath/polygon.h>
 #include <vecmath/ray.h>
 #include <vecmath/segment.h>
 #include <vecmath/vec.h>
 #include <vecmath/vec_ext.h>
 
+#include <algorithm>
 #include <fstream>
 #include <string>
 #include <vector>
@@ -2248,6 +2251,134 @@ TEST_CASE("moveFaceWithUVLock")
   }
 }
 
+TEST_CASE("BrushTest.transformPreservingTopology")
+{
+  const auto worldBounds = vm::bbox3(4096.0);
+  const auto format = GENERATE(MapFormat::Valve, MapFormat::Standard);
+  const auto lockTextures = GENERATE(true, false);
+
+  // translations and rotations by multiples of 90 degrees transform the geometry in
+  // place, mirroring rebuilds it
+  const auto transformation = GENERATE(values<vm::mat4x4>({
+    vm::translation_matrix(vm::vec3(16.0, -32.0, 8.0)),
+    vm::translation_matrix(vm::vec3(0.5, 0.25, -3.75)),
+    vm::rotation_matrix(vm::vec3::pos_z(), vm::to_radians(90.0)),
+    vm::rotation_matrix(vm::vec3::pos_y(), vm::to_radians(-90.0)),
+    vm::translation_matrix(vm::vec3(64.0, 0.0, 0.0))
+      * vm::rotation_matrix(vm::vec3::pos_x(), vm::to_radians(180.0)),
+    vm::mirror_matrix<FloatType>(vm::axis::x),
+  }));
+
+  Assets::Texture texture("texture", 64, 64);
+
+  // an irregular brush so that the rotations are not symmetries of the brush
+  const auto builder = BrushBuilder(format, worldBounds);
+  auto brush = builder
+                 .createBrush(
+                   std::vector<vm::vec3>{
+                     vm::vec3(0, 0, 0),
+                     vm::vec3(64, 0, 0),
+                     vm::vec3(0, 32, 0),
+                     vm::vec3(48, 32, 0),
+                     vm::vec3(0, 0, 16),
+                     vm::vec3(64, 0, 16),
+                     vm::vec3(0, 32, 24),
+                     vm::vec3(16, 32, 24),
+                   },
+                   "texture")
+                 .value();
+  for (auto& face : brush.faces())
+  {
+    face.setTexture(&texture);
+  }
+
+  auto transformed = brush;
+  REQUIRE(transformed.transform(worldBounds, transformation, lockTextures).is_success());
+
+  // transform the faces and rebuild the geometry from them
+  auto faces = brush.faces();
+  for (auto& face : faces)
+  {
+    REQUIRE(face.transform(transformation, lockTextures).is_success());
+  }
+  const auto rebuilt = Brush::create(worldBounds, std::move(faces)).value();
+
+  CHECK(transformed.vertexCount() == rebuilt.vertexCount());
+  CHECK(transformed.edgeCount() == rebuilt.edgeCount());
+  CHECK(transformed.faceCount() == rebuilt.faceCount());
+  CHECK(transformed.bounds().min == vm::approx(rebuilt.bounds().min));
+  CHECK(transformed.bounds().max == vm::approx(rebuilt.bounds().max));
+
+  for (const auto& position : rebuilt.vertexPositions())
+  {
+    CHECK(transformed.hasVertex(position, vm::C::almost_zero()));
+  }
+
+  for (const auto& rebuiltFace : rebuilt.faces())
+  {
+    const auto faceIndex = transformed.findFace(rebuiltFace.boundary());
+    REQUIRE(faceIndex);
+
+    const auto& transformedFace = transformed.face(*faceIndex);
+    CHECK(transformedFace.points() == rebuiltFace.points());
+    CHECK(transformedFace.geometry()->plane() == rebuiltFace.boundary());
+    CHECK(transformedFace.vertexCount() == rebuiltFace.vertexCount());
+
+    for (const auto& position : rebuiltFace.vertexPositions())
+    {
+      CHECK(texCoordsEqual(
+        transformedFace.textureCoords(position), rebuiltFace.textureCoords(position)));
+    }
+  }
+}
+
+TEST_CASE("BrushTest.copySharesGeometry")
+{
+  const auto worldBounds = vm::bbox3(4096.0);
+  const auto builder = BrushBuilder(MapFormat::Standard, worldBounds);
+  const auto cuboid = vm::bbox3(vm::vec3(0, 0, 0), vm::vec3(32, 32, 32));
+  const auto original = builder.createCuboid(cuboid, "texture").value();
+
+  auto copy = original;
+  CHECK(copy.sharesGeometryWith(original));
+  for (size_t i = 0u; i < copy.faceCount(); ++i)
+  {
+    CHECK(copy.face(i).geometry() == original.face(i).geometry());
+  }
+
+  SECTION("Changing face attributes keeps the geometry shared")
+  {
+    auto attributes = copy.face(0).attributes();
+    attributes.setTextureName("other");
+    copy.face(0).setAttributes(attributes);
+    CHECK(copy.sharesGeometryWith(original));
+  }
+
+  SECTION("Transforming the copy in place does not modify the original")
+  {
+    const auto translation = vm::translation_matrix(vm::vec3(16, 0, 0));
+    REQUIRE(copy.transform(worldBounds, translation, false).is_success());
+
+    CHECK_FALSE(copy.sharesGeometryWith(original));
+    CHECK(copy.bounds() == cuboid.translate(vm::vec3(16, 0, 0)));
+    CHECK(original.bounds() == cuboid);
+    for (size_t i = 0u; i < copy.faceCount(); ++i)
+    {
+      CHECK(copy.face(i).geometry()->payload() == i);
+      CHECK(original.face(i).geometry()->payload() == i);
+    }
+  }
+
+  SECTION("Rebuilding the geometry of the copy does not modify the original")
+  {
+    REQUIRE(copy.moveBoundary(worldBounds, 0, copy.face(0).boundary().normal * 8.0, false)
+              .is_success());
+
+    CHECK_FALSE(copy.sharesGeometryWith(original));
+    CHECK(original.bounds() == cuboid);
+  }
+}
+
 TEST_CASE("BrushTest.subtractCuboidFromCuboid")
 {
   const vm::bbox3 worldBounds(4096.0);
@@ -2427,5 +2558,97 @@ TEST_CASE("BrushTest.subtractEnclosed")
     [](const auto&) {});
   CHECK(result.size() == 0u);
 }
+
+TEST_CASE("BrushTest.subtractMultiple")
+{
+  const vm::bbox3 worldBounds(4096.0);
+
+  BrushBuilder builder(MapFormat::Standard, worldBounds);
+  const auto minuendBounds = vm::bbox3(vm::vec3::fill(-32.0), vm::vec3::fill(+32.0));
+  const Brush minuend = builder.createCuboid(minuendBounds, "minuend").value();
+
+  // the subtrahends are given in order of increasing overlap with the minuend, so
+  // Brush::subtract processes them in a different order than they are given
+  const auto subtrahendBounds = std::vector<vm::bbox3>{
+    // touches the minuend's +x face
+    vm::bbox3(vm::vec3(32.0, -16.0, -16.0), vm::vec3(48.0, 16.0, 16.0)),
+    // disjoint
+    vm::bbox3(vm::vec3(128.0, 128.0, 128.0), vm::vec3(160.0, 160.0, 160.0)),
+    // overlaps the minuend and the next subtrahend
+    vm::bbox3(vm::vec3(-16.0, -16.0, -48.0), vm::vec3(16.0, 16.0, 16.0)),
+    // overlaps the minuend and the previous subtrahend
+    vm::bbox3(vm::vec3(0.0, -48.0, 0.0), vm::vec3(48.0, 48.0, 48.0)),
+  };
+  const auto subtrahends = kdl::vec_transform(subtrahendBounds, [&](const auto& bounds) {
+    return builder.createCuboid(bounds, "subtrahend").value();
+  });
+  const auto subtrahendPtrs =
+    kdl::vec_transform(subtrahends, [](const auto& brush) { return &brush; });
+
+  const auto subtract = [&]() {
+    return kdl::collect_values(
+      minuend.subtract(MapFormat::Standard, worldBounds, "default", subtrahendPtrs),
+      [](const auto&) { FAIL(); });
+  };
+
+  // subtract one subtrahend at a time, in the given order
+  auto expected = std::vector<Brush>{minuend};
+  for (const auto& subtrahend : subtrahends)
+  {
+    auto fragments = std::vector<Brush>{};
+    for (const auto& fragment : expected)
+    {
+      fragments = kdl::vec_concat(
+        std::move(fragments),
+        kdl::collect_values(
+          fragment.subtract(MapFormat::Standard, worldBounds, "default", subtrahend),
+          [](const auto&) { FAIL(); }));
+    }
+    expected = std::move(fragments);
+  }
+
+  const auto result = subtract();
+  REQUIRE_FALSE(result.empty());
+
+  const auto countContaining = [](const auto& fragments, const auto& point) {
+    return std::count_if(fragments.begin(), fragments.end(), [&](const auto& fragment) {
+      return fragment.containsPoint(point);
+    });
+  };
+
+  // sample the minuend away from any of the brush boundaries, which all lie on multiples
+  // of 16
+  for (double x = -30.0; x < 32.0; x += 4.0)
+  {
+    for (double y = -30.0; y < 32.0; y += 4.0)
+    {
+      for (double z = -30.0; z < 32.0; z += 4.0)
+      {
+        const auto point = vm::vec3(x, y, z);
+        const auto isSubtracted = std::any_of(
+          subtrahendBounds.begin(), subtrahendBounds.end(), [&](const auto& bounds) {
+            return bounds.contains(point);
+          });
+        const auto expectedCount = isSubtracted ? 0 : 1;
+
+        CAPTURE(point);
+        CHECK(countContaining(expected, point) == expectedCount);
+        CHECK(countContaining(result, point) == expectedCount);
+      }
+    }
+  }
+
+  const auto getVertexPositions = [](const std::vector<Brush>& fragments) {
+    return kdl::vec_transform(
+      fragments, [](const auto& fragment) { return fragment.vertexPositions(); });
+  };
+
+  // the fragments and their order do not change between runs
+  const auto resultVertexPositions = getVertexPositions(result);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    CHECK(getVertexPositions(subtract()) == resultVertexPositions);
+  }
+}
 } // namespace Model
 } // namespace TrenchBroom
@@ -86,6 +86,50 @@ TEST_CASE("BrushFaceTest.constructWithColinearPoints")
       .is_success());
 }
 
+TEST_CASE("BrushFaceTest.attributesTextureName")
+{
+  auto attribs = BrushFaceAttributes{"some_texture"};
+  CHECK(attribs.textureName() == "some_texture");
+  CHECK(
+    attribs.internedTextureName()
+    == BrushFaceAttributes{"some_texture"}.internedTextureName());
+
+  CHECK_FALSE(attribs.setTextureName("some_texture"));
+  CHECK(attribs.setTextureName("other_texture"));
+  CHECK(attribs.textureName() == "other_texture");
+  CHECK(attribs != BrushFaceAttributes{"some_texture"});
+}
+
+TEST_CASE("BrushFaceTest.attributesCopyOnWrite")
+{
+  const auto color = Color{1.0f, 0.0f, 0.0f, 1.0f};
+  const auto bpMatrix = vm::scaling_matrix(vm::vec3f{2.0f, 2.0f, 1.0f});
+
+  auto original = BrushFaceAttributes{"some_texture"};
+  CHECK_FALSE(original.hasColor());
+  CHECK_FALSE(original.hasBrushPrimitMode());
+  CHECK(original.bpMatrix() == vm::mat4x4f::identity());
+
+  CHECK(original.setColor(color));
+  CHECK_FALSE(original.setColor(color));
+
+  auto copy = original;
+  CHECK(copy == original);
+  CHECK(copy.setBrushPrimitMatrix(bpMatrix));
+  CHECK_FALSE(copy.setBrushPrimitMatrix(bpMatrix));
+
+  // modifying the copy must not affect the original
+  CHECK(copy.hasBrushPrimitMode());
+  CHECK(copy.bpMatrix() == bpMatrix);
+  CHECK(copy.color() == color);
+  CHECK_FALSE(original.hasBrushPrimitMode());
+  CHECK(original.bpMatrix() == vm::mat4x4f::identity());
+
+  CHECK(copy.setColor(std::nullopt));
+  CHECK_FALSE(copy.hasColor());
+  CHECK(original.color() == color);
+}
+
 TEST_CASE("BrushFaceTest.textureUsageCount")
 {
   const vm::vec3 p0(0.0, 0.0, 4.0);
@@ -34,6 +34,7 @@
 #include "Model/MapFormat.h"
 #include "Model/PatchNode.h"
 #include "Model/PickResult.h"
+#include "Model/TexCoordSystem.h"
 
 #include <kdl/collection_utils.h>
 #include <kdl/result.h>
@@ -167,6 +168,38 @@ TEST_CASE("BrushNodeTest.hasSelectedFaces")
   }
 }
 
+TEST_CASE("BrushNodeTest.swapFaceTexturing")
+{
+  const auto worldBounds = vm::bbox3{4096.0};
+
+  auto brushNode = BrushNode{
+    BrushBuilder{MapFormat::Quake3, worldBounds}.createCube(64.0, "testure").value()};
+  const auto* faceGeometry = brushNode.brush().face(1u).geometry();
+
+  auto attributes = brushNode.brush().face(1u).attributes();
+  attributes.setTextureName("other");
+  attributes.setXOffset(16.0f);
+  auto texCoordSystem = brushNode.brush().face(1u).texCoordSystem().clone();
+
+  brushNode.swapFaceTexturing(1u, attributes, texCoordSystem);
+
+  const auto& face = brushNode.brush().face(1u);
+  CHECK(face.attributes().textureName() == "other");
+  CHECK(face.attributes().xOffset() == 16.0f);
+  CHECK(face.geometry() == faceGeometry);
+  CHECK(brushNode.brush().face(0u).attributes().textureName() == "testure");
+
+  // the previous texturing is swapped out
+  CHECK(attributes.textureName() == "testure");
+  CHECK(attributes.xOffset() == 0.0f);
+  CHECK(texCoordSystem != nullptr);
+
+  // swapping again restores the previous texturing
+  brushNode.swapFaceTexturing(1u, attributes, texCoordSystem);
+  CHECK(brushNode.brush().face(1u).attributes().textureName() == "testure");
+  CHECK(attributes.textureName() == "other");
+}
+
 TEST_CASE("BrushNodeTest.containsPatchNode")
 {
   const auto worldBounds = vm::bbox3d{8192.0};
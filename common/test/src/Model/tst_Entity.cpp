@@ -73,6 +73,39 @@ TEST_CASE("EntityTest.setProperties")
     entity.setProperties(config, {{"modelscale", "1 2 3"}});
 
     CHECK(entity.modelTransformation() == vm::scaling_matrix(vm::vec3{1, 2, 3}));
+    REQUIRE(entity.inverseModelTransformation().has_value());
+    CHECK(
+      *entity.inverseModelTransformation()
+      == vm::approx{vm::scaling_matrix(vm::vec3{1.0, 1.0 / 2.0, 1.0 / 3.0})});
+  }
+
+  SECTION("Updates cached inverse model transformation")
+  {
+    auto config = EntityPropertyConfig{{{EL::LiteralExpression{EL::Value{2.0}}, 0, 0}}};
+    auto definition = Assets::PointEntityDefinition{
+      "some_name",
+      Color{},
+      vm::bbox3{32.0},
+      "",
+      {},
+      Assets::ModelDefinition{
+        {EL::MapExpression{{{"scale", {EL::VariableExpression{"modelscale"}, 0, 0}}}},
+         0,
+         0}}};
+
+    auto entity = Entity{};
+    REQUIRE(entity.inverseModelTransformation() == vm::mat4x4::identity());
+
+    entity.setDefinition(config, &definition);
+    entity.setProperties(config, {{"origin", "8 16 32"}, {"angle", "90"}});
+
+    const auto [invertible, inverse] = vm::invert(entity.modelTransformation());
+    REQUIRE(invertible);
+    REQUIRE(entity.inverseModelTransformation().has_value());
+    CHECK(*entity.inverseModelTransformation() == vm::approx{inverse});
+
+    entity.setProperties(config, {{"modelscale", "0 0 0"}});
+    CHECK(entity.inverseModelTransformation() == std::nullopt);
   }
 }
 
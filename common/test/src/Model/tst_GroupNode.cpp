@@ -427,6 +427,146 @@ TEST_CASE("GroupNodeTest.updateLinkedGroupsExceedsWorldBounds")
       }));
 }
 
+TEST_CASE("GroupNodeTest.updateLinkedGroupsIncrementally")
+{
+  constexpr auto mapFormat = MapFormat::Quake3;
+  const auto worldBounds = vm::bbox3(8192.0);
+  const auto builder = BrushBuilder{mapFormat, worldBounds};
+
+  auto groupNode = GroupNode{Group{"name"}};
+  auto* brushNode1 = new BrushNode{builder.createCube(64.0, "texture").value()};
+  auto* brushNode2 = new BrushNode{builder.createCube(32.0, "texture").value()};
+  auto* entityNode = new EntityNode{Entity{}};
+  groupNode.addChildren({brushNode1, brushNode2, entityNode});
+
+  auto groupNodeClone1 = std::unique_ptr<GroupNode>{
+    static_cast<GroupNode*>(groupNode.cloneRecursively(worldBounds))};
+  auto groupNodeClone2 = std::unique_ptr<GroupNode>{
+    static_cast<GroupNode*>(groupNode.cloneRecursively(worldBounds))};
+
+  transformNode(
+    *groupNodeClone1, vm::translation_matrix(vm::vec3(0.0, 128.0, 0.0)), worldBounds);
+  transformNode(
+    *groupNodeClone2, vm::translation_matrix(vm::vec3(0.0, 256.0, 0.0)), worldBounds);
+
+  const auto targetGroupNodes =
+    std::vector<GroupNode*>{groupNodeClone1.get(), groupNodeClone2.get()};
+
+  SECTION("Nothing has changed")
+  {
+    updateLinkedGroupsIncrementally(groupNode, {}, targetGroupNodes, worldBounds)
+      .transform([&](const IncrementalUpdateLinkedGroupsResult& r) {
+        CHECK(r.childrenToReplace.empty());
+        CHECK(r.contentsToSwap.empty());
+      })
+      .or_else([](const auto&) { FAIL(); });
+  }
+
+  SECTION("A brush has changed")
+  {
+    transformNode(
+      *brushNode2, vm::translation_matrix(vm::vec3(0.0, 0.0, 16.0)), worldBounds);
+
+    updateLinkedGroupsIncrementally(
+      groupNode, {brushNode2}, targetGroupNodes, worldBounds)
+      .transform([&](const IncrementalUpdateLinkedGroupsResult& r) {
+        CHECK(r.childrenToReplace.empty());
+        REQUIRE(r.contentsToSwap.size() == 2u);
+
+        const auto& [nodeToSwap1, contents1] = r.contentsToSwap[0];
+        CHECK(nodeToSwap1 == groupNodeClone1->children()[1]);
+        CHECK(
+          std::get<Brush>(contents1.get()).bounds()
+          == vm::bbox3(vm::vec3(-16.0, 112.0, 0.0), vm::vec3(16.0, 144.0, 32.0)));
+
+        const auto& [nodeToSwap2, contents2] = r.contentsToSwap[1];
+        CHECK(nodeToSwap2 == groupNodeClone2->children()[1]);
+        CHECK(
+          std::get<Brush>(contents2.get()).bounds()
+          == vm::bbox3(vm::vec3(-16.0, 240.0, 0.0), vm::vec3(16.0, 272.0, 32.0)));
+      })
+      .or_else([](const auto&) { FAIL(); });
+  }
+
+  SECTION("A changed brush is updated in a target group that has diverged")
+  {
+    transformNode(
+      *groupNodeClone2->children()[0],
+      vm::translation_matrix(vm::vec3(0.0, 0.0, 16.0)),
+      worldBounds);
+    transformNode(
+      *groupNodeClone2->children()[1],
+      vm::translation_matrix(vm::vec3(0.0, 0.0, 16.0)),
+      worldBounds);
+    transformNode(
+      *brushNode2, vm::translation_matrix(vm::vec3(0.0, 0.0, 32.0)), worldBounds);
+
+    updateLinkedGroupsIncrementally(
+      groupNode, {brushNode2}, targetGroupNodes, worldBounds)
+      .transform([&](const IncrementalUpdateLinkedGroupsResult& r) {
+        CHECK(r.childrenToReplace.empty());
+        REQUIRE(r.contentsToSwap.size() == 2u);
+        CHECK(r.contentsToSwap[0].first == groupNodeClone1->children()[1]);
+
+        const auto& [nodeToSwap, contents] = r.contentsToSwap[1];
+        CHECK(nodeToSwap == groupNodeClone2->children()[1]);
+        CHECK(
+          std::get<Brush>(contents.get()).bounds()
+          == vm::bbox3(vm::vec3(-16.0, 240.0, 16.0), vm::vec3(16.0, 272.0, 48.0)));
+      })
+      .or_else([](const auto&) { FAIL(); });
+  }
+
+  SECTION("Changed nodes that are not in the source group are ignored")
+  {
+    auto otherBrushNode = BrushNode{builder.createCube(32.0, "texture").value()};
+
+    updateLinkedGroupsIncrementally(
+      groupNode, {&otherBrushNode}, targetGroupNodes, worldBounds)
+      .transform([&](const IncrementalUpdateLinkedGroupsResult& r) {
+        CHECK(r.childrenToReplace.empty());
+        CHECK(r.contentsToSwap.empty());
+      })
+      .or_else([](const auto&) { FAIL(); });
+  }
+
+  SECTION("An entity has changed")
+  {
+    transformNode(
+      *entityNode, vm::translation_matrix(vm::vec3(0.0, 0.0, 16.0)), worldBounds);
+
+    updateLinkedGroupsIncrementally(
+      groupNode, {entityNode}, targetGroupNodes, worldBounds)
+      .transform([&](const IncrementalUpdateLinkedGroupsResult& r) {
+        CHECK(r.contentsToSwap.empty());
+        REQUIRE(r.childrenToReplace.size() == 2u);
+        CHECK(r.childrenToReplace[0].first == groupNodeClone1.get());
+        CHECK(r.childrenToReplace[1].first == groupNodeClone2.get());
+      })
+      .or_else([](const auto&) { FAIL(); });
+  }
+
+  SECTION("The structure of a target group differs")
+  {
+    auto entityNodeClone2 = std::unique_ptr<Node>{groupNodeClone2->children().back()};
+    groupNodeClone2->removeChild(entityNodeClone2.get());
+    transformNode(
+      *brushNode2, vm::translation_matrix(vm::vec3(0.0, 0.0, 16.0)), worldBounds);
+
+    updateLinkedGroupsIncrementally(
+      groupNode, {brushNode2}, targetGroupNodes, worldBounds)
+      .transform([&](const IncrementalUpdateLinkedGroupsResult& r) {
+        REQUIRE(r.contentsToSwap.size() == 1u);
+        CHECK(r.contentsToSwap[0].first == groupNodeClone1->children()[1]);
+
+        REQUIRE(r.childrenToReplace.size() == 1u);
+        CHECK(r.childrenToReplace[0].first == groupNodeClone2.get());
+        CHECK(r.childrenToReplace[0].second.size() == 3u);
+      })
+      .or_else([](const auto&) { FAIL(); });
+  }
+}
+
 static void setGroupName(GroupNode& groupNode, const std::string& name)
 {
   auto group = groupNode.group();
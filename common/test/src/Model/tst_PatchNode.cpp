@@ -26,11 +26,19 @@
 #include <kdl/vector_utils.h>
 
 #include <vecmath/approx.h>
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/mat_io.h>
 #include <vecmath/ray.h>
 #include <vecmath/ray_io.h>
+#include <vecmath/scalar.h>
 #include <vecmath/vec.h>
 #include <vecmath/vec_io.h>
 
+#include <cmath>
+#include <tuple>
+
 #include "Catch2.h"
 
 namespace vm
@@ -212,5 +220,131 @@ TEST_CASE("PatchNode.pickFlatPatch")
     CHECK(pickResult.size() == 0u);
   }
 }
+
+TEST_CASE("PatchNode.pickNearestHit")
+{
+  using P = BezierPatch::Point;
+
+  // A patch that is bent so that a ray along the x axis passes through it twice, at
+  // x = 100 -/+ 100 / sqrt(3), where the hit with the larger x lies in the grid's last
+  // rows.
+  // clang-format off
+  auto patchNode = PatchNode{BezierPatch{3, 3, {
+    P{  0.0, -64.0,  32.0}, P{  0.0, 0.0,  32.0}, P{  0.0, 64.0,  32.0},
+    P{100.0, -64.0, -64.0}, P{100.0, 0.0, -64.0}, P{100.0, 64.0, -64.0},
+    P{200.0, -64.0,  32.0}, P{200.0, 0.0,  32.0}, P{200.0, 64.0,  32.0},
+  }, "texture"}};
+  // clang-format on
+
+  const auto nearHitX = 100.0 - 100.0 / std::sqrt(3.0);
+  const auto farHitX = 100.0 + 100.0 / std::sqrt(3.0);
+
+  using T = std::tuple<vm::ray3, FloatType>;
+
+  // clang-format off
+  const auto
+  [pickRay,                                             expectedHitX] = GENERATE_COPY(values<T>({
+  {vm::ray3{vm::vec3{-100.0, 8.0, 0.0}, vm::vec3::pos_x()}, nearHitX  },
+  {vm::ray3{vm::vec3{ 300.0, 8.0, 0.0}, vm::vec3::neg_x()}, farHitX   },
+  {vm::ray3{vm::vec3{ 100.0, 8.0, 0.0}, vm::vec3::pos_x()}, farHitX   },
+  {vm::ray3{vm::vec3{ 100.0, 8.0, 0.0}, vm::vec3::neg_x()}, nearHitX  },
+  }));
+  // clang-format on
+
+  CAPTURE(pickRay);
+
+  const auto editorContext = EditorContext{};
+  auto pickResult = PickResult{};
+  patchNode.pick(editorContext, pickRay, pickResult);
+
+  REQUIRE(pickResult.size() == 1u);
+
+  const auto hit = pickResult.all().front();
+  CHECK(hit.hitPoint().x() == Approx(expectedHitX).margin(2.0));
+  CHECK(hit.distance() == Approx(vm::abs(expectedHitX - pickRay.origin.x())).margin(2.0));
+}
+
+TEST_CASE("PatchNode.pickAfterSetPatch")
+{
+  using P = BezierPatch::Point;
+
+  // clang-format off
+  auto patchNode = PatchNode{BezierPatch{3, 3, {
+    P{0.0, 2.0, 0.0}, P{1.0, 2.0, 0.0}, P{2.0, 2.0, 0.0},
+    P{0.0, 1.0, 0.0}, P{1.0, 1.0, 0.0}, P{2.0, 1.0, 0.0},
+    P{0.0, 0.0, 0.0}, P{1.0, 0.0, 0.0}, P{2.0, 0.0, 0.0},
+  }, "texture"}};
+  // clang-format on
+
+  const auto editorContext = EditorContext{};
+  const auto pickRay = vm::ray3{vm::vec3{1, 1, 8}, vm::vec3::neg_z()};
+
+  auto pickResult = PickResult{};
+  patchNode.pick(editorContext, pickRay, pickResult);
+  REQUIRE(pickResult.size() == 1u);
+  CHECK(pickResult.all().front().hitPoint() == vm::vec3{1, 1, 0});
+
+  // clang-format off
+  patchNode.setPatch(BezierPatch{3, 3, {
+    P{0.0, 2.0, 4.0}, P{1.0, 2.0, 4.0}, P{2.0, 2.0, 4.0},
+    P{0.0, 1.0, 4.0}, P{1.0, 1.0, 4.0}, P{2.0, 1.0, 4.0},
+    P{0.0, 0.0, 4.0}, P{1.0, 0.0, 4.0}, P{2.0, 0.0, 4.0},
+  }, "texture"});
+  // clang-format on
+
+  pickResult.clear();
+  patchNode.pick(editorContext, pickRay, pickResult);
+  REQUIRE(pickResult.size() == 1u);
+  CHECK(pickResult.all().front().hitPoint() == vm::vec3{1, 1, 4});
+}
+
+TEST_CASE("PatchNode.setTransformedPatch")
+{
+  using P = BezierPatch::Point;
+
+  // clang-format off
+  auto patchNode = PatchNode{BezierPatch{3, 5, {
+    P{0.0, 0.0, 0.0, 0.0, 0.0}, P{1.0, 0.0, 1.0, 0.25, 0.0}, P{2.0, 0.0, 0.0, 0.5, 0.0}, P{3.0, 0.0, 2.0, 0.75, 0.0}, P{4.0, 0.0, 0.0, 1.0, 0.0},
+    P{0.0, 1.0, 1.0, 0.0, 0.5}, P{1.0, 1.0, 2.0, 0.25, 0.5}, P{2.0, 1.0, 1.0, 0.5, 0.5}, P{3.0, 1.0, 0.0, 0.75, 0.5}, P{4.0, 1.0, 1.0, 1.0, 0.5},
+    P{0.0, 2.0, 0.0, 0.0, 1.0}, P{1.0, 2.0, 1.0, 0.25, 1.0}, P{2.0, 2.0, 0.0, 0.5, 1.0}, P{3.0, 2.0, 2.0, 0.75, 1.0}, P{4.0, 2.0, 0.0, 1.0, 1.0},
+  }, "texture"}};
+  // clang-format on
+
+  // rigid transformations transform the grid, the others tessellate the patch again
+  const auto transformation = GENERATE(
+    vm::translation_matrix(vm::vec3{16.0, -8.0, 4.0}),
+    vm::translation_matrix(vm::vec3{16.0, -8.0, 4.0})
+      * vm::rotation_matrix(vm::normalize(vm::vec3{1.0, 2.0, 3.0}), vm::to_radians(40.0)),
+    vm::scaling_matrix(vm::vec3{-1.0, 1.0, 1.0}),
+    vm::scaling_matrix(vm::vec3{2.0, 1.0, 1.0}));
+  CAPTURE(transformation);
+
+  const auto changeControlPoint = GENERATE(false, true);
+  CAPTURE(changeControlPoint);
+
+  auto patch = patchNode.patch();
+  patch.transform(transformation);
+  if (changeControlPoint)
+  {
+    // the grid of the previous patch must not be reused
+    patch.setControlPoint(1, 2, P{2.0, 1.0, 5.0, 0.5, 0.5});
+  }
+  patchNode.setPatch(std::move(patch));
+
+  const auto& transformedPatch = patchNode.patch();
+  const auto expectedGrid = makePatchGrid(
+    BezierPatch{
+      transformedPatch.pointRowCount(),
+      transformedPatch.pointColumnCount(),
+      transformedPatch.controlPoints(),
+      transformedPatch.textureName()},
+    3u);
+
+  CHECK(
+    patchNode.grid().points
+    == kdl::vec_transform(
+      expectedGrid.points, [](const auto& p) { return vm::approx{p}; }));
+  CHECK(vm::is_equal(patchNode.grid().bounds, expectedGrid.bounds, vm::C::almost_zero()));
+}
 } // namespace Model
 } // namespace TrenchBroom
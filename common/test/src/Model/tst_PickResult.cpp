@@ -0,0 +1,101 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FloatType.h"
+#include "Model/Hit.h"
+#include "Model/HitFilter.h"
+#include "Model/HitType.h"
+#include "Model/PickResult.h"
+
+#include <kdl/vector_utils.h>
+
+#include <vecmath/vec.h>
+
+#include <optional>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace Model
+{
+static const auto TestHitType = HitType::freeType();
+static const auto OtherHitType = HitType::freeType();
+
+static Hit makeHit(const HitType::Type type, const FloatType distance)
+{
+  return Hit{type, distance, vm::vec3{distance, 0, 0}, distance};
+}
+
+static std::vector<FloatType> distances(const PickResult& pickResult)
+{
+  return kdl::vec_transform(
+    pickResult.all(), [](const auto& hit) { return hit.distance(); });
+}
+
+TEST_CASE("PickResultTest.addHit")
+{
+  auto pickResult = PickResult{};
+  for (const auto distance : {5.0, 3.0, 7.0, 1.0, 4.0})
+  {
+    pickResult.addHit(makeHit(TestHitType, distance));
+  }
+  pickResult.addHit(makeHit(OtherHitType, 2.0));
+
+  CHECK(distances(pickResult) == std::vector<FloatType>{1, 2, 3, 4, 5, 7});
+  CHECK(pickResult.maxDistance() == std::nullopt);
+}
+
+TEST_CASE("PickResultTest.closest")
+{
+  auto pickResult = PickResult::closest(HitFilters::type(TestHitType), 3u);
+
+  pickResult.addHit(makeHit(TestHitType, 5.0));
+  pickResult.addHit(makeHit(TestHitType, 3.0));
+  CHECK(pickResult.maxDistance() == std::nullopt);
+
+  pickResult.addHit(makeHit(TestHitType, 7.0));
+  CHECK(distances(pickResult) == std::vector<FloatType>{3, 5, 7});
+  CHECK(pickResult.maxDistance() == 7.0);
+
+  // hits that don't match the filter are discarded
+  pickResult.addHit(makeHit(OtherHitType, 2.0));
+  CHECK(distances(pickResult) == std::vector<FloatType>{3, 5, 7});
+
+  // hits beyond the farthest hit are discarded
+  pickResult.addHit(makeHit(TestHitType, 8.0));
+  CHECK(distances(pickResult) == std::vector<FloatType>{3, 5, 7});
+
+  // closer hits replace the farthest hit
+  pickResult.addHit(makeHit(TestHitType, 1.0));
+  CHECK(distances(pickResult) == std::vector<FloatType>{1, 3, 5});
+  CHECK(pickResult.maxDistance() == 5.0);
+
+  pickResult.addHit(makeHit(TestHitType, 4.0));
+  CHECK(distances(pickResult) == std::vector<FloatType>{1, 3, 4});
+  CHECK(pickResult.maxDistance() == 4.0);
+
+  CHECK(pickResult.first(HitFilters::any()).target<FloatType>() == 1.0);
+
+  pickResult.clear();
+  CHECK(pickResult.maxDistance() == std::nullopt);
+}
+} // namespace Model
+} // namespace TrenchBroom
@@ -28,7 +28,9 @@
 #include <vecmath/vec.h>
 #include <vecmath/vec_io.h>
 
+#include <cmath>
 #include <iterator>
+#include <optional>
 #include <set>
 #include <tuple>
 
@@ -820,6 +822,150 @@ TEST_CASE("PolyhedronTest.clipCubeWithVerticalSlantedPlane")
   CHECK(p.hasFace({p2, p6, p4}));
 }
 
+TEST_CASE("PolyhedronTest.fromPlanes")
+{
+  const auto worldBounds = vm::bbox3d(8192.0);
+
+  SECTION("Cube")
+  {
+    const auto planes = std::vector<vm::plane3d>{
+      vm::plane3d(vm::vec3d(+64, 0, 0), vm::vec3d::pos_x()),
+      vm::plane3d(vm::vec3d(-64, 0, 0), vm::vec3d::neg_x()),
+      vm::plane3d(vm::vec3d(0, +64, 0), vm::vec3d::pos_y()),
+      vm::plane3d(vm::vec3d(0, -64, 0), vm::vec3d::neg_y()),
+      vm::plane3d(vm::vec3d(0, 0, +64), vm::vec3d::pos_z()),
+      vm::plane3d(vm::vec3d(0, 0, -64), vm::vec3d::neg_z()),
+    };
+
+    const auto p = Polyhedron3d::fromPlanes(planes, worldBounds);
+    REQUIRE(p.has_value());
+    CHECK(p->polyhedron());
+    CHECK(p->closed());
+    CHECK(*p == Polyhedron3d(vm::bbox3d(64.0)));
+    CHECK(p->bounds() == vm::bbox3d(64.0));
+
+    // the faces are in the same order as the planes
+    auto i = size_t(0);
+    for (const auto* face : p->faces())
+    {
+      CHECK(face->plane() == planes[i++]);
+    }
+  }
+
+  SECTION("Pyramid with four planes meeting at the apex")
+  {
+    const auto apex = vm::vec3d(0, 0, 64);
+    const auto planes = std::vector<vm::plane3d>{
+      vm::plane3d(vm::vec3d::zero(), vm::vec3d::neg_z()),
+      vm::plane3d(apex, vm::normalize(vm::vec3d(+1, 0, 1))),
+      vm::plane3d(apex, vm::normalize(vm::vec3d(-1, 0, 1))),
+      vm::plane3d(apex, vm::normalize(vm::vec3d(0, +1, 1))),
+      vm::plane3d(apex, vm::normalize(vm::vec3d(0, -1, 1))),
+    };
+
+    const auto p = Polyhedron3d::fromPlanes(planes, worldBounds);
+    REQUIRE(p.has_value());
+    CHECK(p->vertexCount() == 5u);
+    CHECK(p->edgeCount() == 8u);
+    CHECK(p->faceCount() == 5u);
+    CHECK(p->hasVertex(apex, vm::Cd::almost_zero()));
+    CHECK(p->hasFace(
+      {vm::vec3d(-64, -64, 0),
+       vm::vec3d(-64, +64, 0),
+       vm::vec3d(+64, +64, 0),
+       vm::vec3d(+64, -64, 0)},
+      vm::Cd::almost_zero()));
+  }
+
+  SECTION("Redundant plane")
+  {
+    const auto planes = std::vector<vm::plane3d>{
+      vm::plane3d(vm::vec3d(+64, 0, 0), vm::vec3d::pos_x()),
+      vm::plane3d(vm::vec3d(-64, 0, 0), vm::vec3d::neg_x()),
+      vm::plane3d(vm::vec3d(0, +64, 0), vm::vec3d::pos_y()),
+      vm::plane3d(vm::vec3d(0, -64, 0), vm::vec3d::neg_y()),
+      vm::plane3d(vm::vec3d(0, 0, +64), vm::vec3d::pos_z()),
+      vm::plane3d(vm::vec3d(0, 0, -64), vm::vec3d::neg_z()),
+      vm::plane3d(vm::vec3d(0, 0, +128), vm::vec3d::pos_z()),
+    };
+
+    CHECK(Polyhedron3d::fromPlanes(planes, worldBounds) == std::nullopt);
+  }
+
+  SECTION("Duplicate plane")
+  {
+    const auto planes = std::vector<vm::plane3d>{
+      vm::plane3d(vm::vec3d(+64, 0, 0), vm::vec3d::pos_x()),
+      vm::plane3d(vm::vec3d(-64, 0, 0), vm::vec3d::neg_x()),
+      vm::plane3d(vm::vec3d(0, +64, 0), vm::vec3d::pos_y()),
+      vm::plane3d(vm::vec3d(0, -64, 0), vm::vec3d::neg_y()),
+      vm::plane3d(vm::vec3d(0, 0, +64), vm::vec3d::pos_z()),
+      vm::plane3d(vm::vec3d(0, 0, -64), vm::vec3d::neg_z()),
+      vm::plane3d(vm::vec3d(0, 0, +64), vm::vec3d::pos_z()),
+    };
+
+    CHECK(Polyhedron3d::fromPlanes(planes, worldBounds) == std::nullopt);
+  }
+
+  SECTION("Unbounded")
+  {
+    const auto planes = std::vector<vm::plane3d>{
+      vm::plane3d(vm::vec3d(+64, 0, 0), vm::vec3d::pos_x()),
+      vm::plane3d(vm::vec3d(-64, 0, 0), vm::vec3d::neg_x()),
+      vm::plane3d(vm::vec3d(0, +64, 0), vm::vec3d::pos_y()),
+      vm::plane3d(vm::vec3d(0, -64, 0), vm::vec3d::neg_y()),
+      vm::plane3d(vm::vec3d(0, 0, +64), vm::vec3d::pos_z()),
+    };
+
+    CHECK(Polyhedron3d::fromPlanes(planes, worldBounds) == std::nullopt);
+  }
+
+  SECTION("Exceeds bounds")
+  {
+    const auto planes = std::vector<vm::plane3d>{
+      vm::plane3d(vm::vec3d(+64, 0, 0), vm::vec3d::pos_x()),
+      vm::plane3d(vm::vec3d(-64, 0, 0), vm::vec3d::neg_x()),
+      vm::plane3d(vm::vec3d(0, +64, 0), vm::vec3d::pos_y()),
+      vm::plane3d(vm::vec3d(0, -64, 0), vm::vec3d::neg_y()),
+      vm::plane3d(vm::vec3d(0, 0, +64), vm::vec3d::pos_z()),
+      vm::plane3d(vm::vec3d(0, 0, -64), vm::vec3d::neg_z()),
+    };
+
+    CHECK(Polyhedron3d::fromPlanes(planes, vm::bbox3d(32.0)) == std::nullopt);
+  }
+
+  SECTION("Too few planes")
+  {
+    const auto planes = std::vector<vm::plane3d>{
+      vm::plane3d(vm::vec3d(+64, 0, 0), vm::vec3d::pos_x()),
+      vm::plane3d(vm::vec3d(0, +64, 0), vm::vec3d::pos_y()),
+      vm::plane3d(vm::vec3d(0, 0, +64), vm::vec3d::pos_z()),
+    };
+
+    CHECK(Polyhedron3d::fromPlanes(planes, worldBounds) == std::nullopt);
+  }
+
+  SECTION("Too many planes")
+  {
+    // a prism with more sides than fromPlanes accepts
+    const auto sides = Polyhedron3d::MaxPlaneCount - 1u;
+    auto planes = std::vector<vm::plane3d>{
+      vm::plane3d(vm::vec3d(0, 0, +64), vm::vec3d::pos_z()),
+      vm::plane3d(vm::vec3d(0, 0, -64), vm::vec3d::neg_z()),
+    };
+    for (size_t i = 0; i < sides; ++i)
+    {
+      const auto angle = vm::Cd::two_pi() * double(i) / double(sides);
+      const auto normal = vm::vec3d(std::cos(angle), std::sin(angle), 0.0);
+      planes.emplace_back(64.0 * normal, normal);
+    }
+
+    CHECK(Polyhedron3d::fromPlanes(planes, worldBounds) == std::nullopt);
+    planes.pop_back();
+    CHECK(Polyhedron3d::fromPlanes(planes, worldBounds) != std::nullopt);
+  }
+}
+
 bool findAndRemove(
   std::vector<Polyhedron3d>& result, const std::vector<vm::vec3d>& vertices);
 bool findAndRemove(
@@ -20,24 +20,38 @@
 #include "Model/BezierPatch.h"
 #include "Model/BrushBuilder.h"
 #include "Model/BrushNode.h"
+#include "Model/EditorContext.h"
 #include "Model/Entity.h"
 #include "Model/EntityNode.h"
 #include "Model/Group.h"
 #include "Model/GroupNode.h"
+#include "Model/Hit.h"
+#include "Model/HitAdapter.h"
+#include "Model/HitFilter.h"
 #include "Model/Layer.h"
 #include "Model/LayerNode.h"
 #include "Model/MapFormat.h"
 #include "Model/PatchNode.h"
+#include "Model/PickResult.h"
 #include "Model/WorldNode.h"
+
+#ifdef TB_USE_AABB_NODE_TREE
+#include "aabb_tree.h"
+#else
 #include "octree.h"
+#endif
 
 #include <kdl/result.h>
 #include <kdl/result_io.h>
 #include <kdl/string_utils.h>
+#include <kdl/vector_utils.h>
 
 #include <vecmath/mat.h>
 #include <vecmath/mat_ext.h>
 #include <vecmath/mat_io.h>
+#include <vecmath/ray.h>
+
+#include <vector>
 
 #include "Catch2.h"
 #include "TestUtils.h"
@@ -323,6 +337,151 @@ TEST_CASE("WorldNodeTest.disableNodeTreeUpdates")
   CHECK(nodeTree.contains(patchNode));
 }
 
+TEST_CASE("WorldNodeTest.pickClosest")
+{
+  constexpr auto worldBounds = vm::bbox3d{8192.0};
+  constexpr auto mapFormat = MapFormat::Quake3;
+
+  const auto builder = BrushBuilder{mapFormat, worldBounds};
+  const auto createBrushNode = [&](const FloatType x) {
+    return new BrushNode{
+      builder.createCuboid(vm::bbox3{{x, -16, -16}, {x + 32, 16, 16}}, "texture")
+        .value()};
+  };
+
+  auto worldNode = WorldNode{{}, {}, mapFormat};
+  auto* brushNode1 = createBrushNode(64.0);
+  auto* entityNode = new EntityNode{Entity{{}, {{"origin", "160 0 0"}}}};
+  auto* brushNode2 = createBrushNode(192.0);
+  auto* brushNode3 = createBrushNode(320.0);
+
+  worldNode.defaultLayer()->addChildren({brushNode3, entityNode, brushNode1, brushNode2});
+
+  const auto editorContext = EditorContext{};
+  const auto ray = vm::ray3{{0, 0, 0}, {1, 0, 0}};
+
+  auto allHits = PickResult::byDistance();
+  worldNode.pick(editorContext, ray, allHits);
+  REQUIRE(allHits.size() == 4u);
+
+  using namespace HitFilters;
+
+  SECTION("Picks only the closest brush")
+  {
+    const auto hitFilter = type(BrushNode::BrushHitType);
+
+    auto pickResult = PickResult::closest(hitFilter);
+    worldNode.pick(editorContext, ray, pickResult);
+    CHECK(pickResult.size() == 1u);
+
+    const auto& hit = pickResult.first(hitFilter);
+    CHECK(hitToNode(hit) == brushNode1);
+    CHECK(hit.distance() == allHits.first(hitFilter).distance());
+  }
+
+  SECTION("Picks the closest entity")
+  {
+    const auto hitFilter = type(EntityNode::EntityHitType);
+
+    auto pickResult = PickResult::closest(hitFilter);
+    worldNode.pick(editorContext, ray, pickResult);
+    CHECK(pickResult.size() == 1u);
+    CHECK(hitToNode(pickResult.first(hitFilter)) == entityNode);
+  }
+
+  SECTION("Picks nodes beyond hits that do not match the filter")
+  {
+    const auto hitFilter = type(BrushNode::BrushHitType) && minDistance(100.0);
+
+    auto pickResult = PickResult::closest(hitFilter);
+    worldNode.pick(editorContext, ray, pickResult);
+    CHECK(pickResult.size() == 1u);
+    CHECK(hitToNode(pickResult.first(hitFilter)) == brushNode2);
+  }
+
+  SECTION("Picks the given number of closest hits")
+  {
+    const auto hitFilter = type(BrushNode::BrushHitType);
+
+    auto pickResult = PickResult::closest(hitFilter, 2u);
+    worldNode.pick(editorContext, ray, pickResult);
+    CHECK(
+      kdl::vec_transform(pickResult.all(), [](const auto& hit) { return hitToNode(hit); })
+      == std::vector<Node*>{brushNode1, brushNode2});
+  }
+
+  SECTION("Picks nothing if no hit matches the filter")
+  {
+    auto pickResult = PickResult::closest(none());
+    worldNode.pick(editorContext, ray, pickResult);
+    CHECK(pickResult.empty());
+  }
+}
+
+TEST_CASE("WorldNodeTest.findNodesInFrustum")
+{
+  constexpr auto worldBounds = vm::bbox3d{8192.0};
+  constexpr auto mapFormat = MapFormat::Quake3;
+
+  const auto builder = BrushBuilder{mapFormat, worldBounds};
+  const auto createBrushNode = [&](const FloatType x) {
+    return new BrushNode{
+      builder.createCuboid(vm::bbox3{{x, -16, -16}, {x + 32, 16, 16}}, "texture")
+        .value()};
+  };
+
+  auto worldNode = WorldNode{{}, {}, mapFormat};
+  auto* brushNode1 = createBrushNode(0.0);
+  auto* brushNode2 = createBrushNode(64.0);
+  auto* brushNode3 = createBrushNode(128.0);
+
+  worldNode.defaultLayer()->addChildren({brushNode1, brushNode2, brushNode3});
+
+  // the volume 16 <= x <= 80, -16 <= y <= 16, -16 <= z <= 16
+  const auto frustumPlanes = std::vector<vm::plane3>{
+    {{16, 0, 0}, {-1, 0, 0}},
+    {{80, 0, 0}, {1, 0, 0}},
+    {{0, -16, 0}, {0, -1, 0}},
+    {{0, 16, 0}, {0, 1, 0}},
+    {{0, 0, -16}, {0, 0, -1}},
+    {{0, 0, 16}, {0, 0, 1}},
+  };
+
+  CHECK_THAT(
+    worldNode.findNodesInFrustum(frustumPlanes),
+    Catch::UnorderedEquals(std::vector<Node*>{brushNode1, brushNode2}));
+  CHECK_THAT(
+    worldNode.findNodesIntersecting(vm::bbox3{{40, -8, -8}, {48, 8, 8}}),
+    Catch::UnorderedEquals(std::vector<Node*>{}));
+  CHECK_THAT(
+    worldNode.findNodesIntersecting(vm::bbox3{{48, -8, -8}, {144, 8, 8}}),
+    Catch::UnorderedEquals(std::vector<Node*>{brushNode2, brushNode3}));
+
+  SECTION("Revision changes when the node tree changes")
+  {
+    auto revision = worldNode.nodeTreeRevision();
+
+    brushNode3->setBrush(
+      builder.createCuboid(vm::bbox3{{72, -16, -16}, {104, 16, 16}}, "texture").value());
+    CHECK(worldNode.nodeTreeRevision() != revision);
+    CHECK_THAT(
+      worldNode.findNodesInFrustum(frustumPlanes),
+      Catch::UnorderedEquals(std::vector<Node*>{brushNode1, brushNode2, brushNode3}));
+
+    revision = worldNode.nodeTreeRevision();
+    worldNode.defaultLayer()->removeChild(brushNode1);
+    CHECK(worldNode.nodeTreeRevision() != revision);
+    CHECK_THAT(
+      worldNode.findNodesInFrustum(frustumPlanes),
+      Catch::UnorderedEquals(std::vector<Node*>{brushNode2, brushNode3}));
+    delete brushNode1;
+
+    revision = worldNode.nodeTreeRevision();
+    worldNode.rebuildNodeTree();
+    CHECK(worldNode.nodeTreeRevision() != revision);
+  }
+}
+
 TEST_CASE("WorldNodeTest.persistentIdOfDefaultLayer")
 {
   auto worldNode = WorldNode{{}, {}, MapFormat::Standard};
@@ -0,0 +1,89 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushGeometry.h"
+#include "Model/BrushNode.h"
+#include "Model/MapFormat.h"
+#include "Model/Polyhedron.h"
+#include "Renderer/BrushRendererBrushCache.h"
+
+#include <kdl/result.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+namespace
+{
+void checkCachedEdges(const Model::BrushNode& brushNode)
+{
+  const auto& cache = brushNode.brushRendererBrushCache();
+  const auto& vertices = cache.cachedVertices();
+  const auto& edges = cache.cachedEdges();
+
+  const auto& brush = brushNode.brush();
+  REQUIRE(edges.size() == brush.edgeCount());
+
+  auto i = size_t(0);
+  for (const auto* edge : brush.edges())
+  {
+    const auto& position1 =
+      getVertexComponent<0>(vertices[edges[i].vertexIndex1RelativeToBrush]);
+    const auto& position2 =
+      getVertexComponent<0>(vertices[edges[i].vertexIndex2RelativeToBrush]);
+    CHECK(position1 == vm::vec3f{edge->firstVertex()->position()});
+    CHECK(position2 == vm::vec3f{edge->secondVertex()->position()});
+    ++i;
+  }
+}
+} // namespace
+
+TEST_CASE("BrushRendererBrushCacheTest.sharedGeometry")
+{
+  constexpr auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = Model::BrushBuilder{Model::MapFormat::Standard, worldBounds};
+  const auto brush =
+    builder.createCuboid(vm::bbox3{vm::vec3::fill(0.0), vm::vec3::fill(32.0)}, "texture")
+      .value();
+
+  auto brushNode1 = Model::BrushNode{brush};
+  auto brushNode2 = Model::BrushNode{brush};
+  REQUIRE(brushNode1.brush().sharesGeometryWith(brushNode2.brush()));
+
+  brushNode1.brushRendererBrushCache().validateVertexCache(brushNode1);
+  brushNode2.brushRendererBrushCache().validateVertexCache(brushNode2);
+
+  checkCachedEdges(brushNode1);
+  checkCachedEdges(brushNode2);
+
+  // the cache must not write to the geometry, which is shared between both brushes
+  for (const auto* vertex : brush.vertices())
+  {
+    CHECK(vertex->payload() == Model::BrushVertexPayload::defaultValue());
+  }
+}
+} // namespace Renderer
+} // namespace TrenchBroom
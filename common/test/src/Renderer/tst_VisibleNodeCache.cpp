@@ -0,0 +1,170 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/EntityProperties.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+#include "Renderer/OrthographicCamera.h"
+#include "Renderer/PerspectiveCamera.h"
+#include "Renderer/VisibleNodeCache.h"
+
+#include <kdl/result.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
+#include <optional>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+TEST_CASE("VisibleNodeCacheTest.visibleNodes")
+{
+  constexpr auto worldBounds = vm::bbox3{8192.0};
+  constexpr auto mapFormat = Model::MapFormat::Quake3;
+
+  const auto builder = Model::BrushBuilder{mapFormat, worldBounds};
+  const auto createBrushNode = [&](const vm::vec3& center) {
+    const auto bounds =
+      vm::bbox3{center - vm::vec3::fill(16.0), center + vm::vec3::fill(16.0)};
+    return new Model::BrushNode{builder.createCuboid(bounds, "texture").value()};
+  };
+
+  auto world = Model::WorldNode{{}, {}, mapFormat};
+  auto* inFront = createBrushNode({256, 0, 0});
+  auto* behind = createBrushNode({-256, 0, 0});
+  auto* beside = createBrushNode({256, 1024, 0});
+  auto* beyondFarPlane = createBrushNode({4096, 0, 0});
+  world.defaultLayer()->addChildren({inFront, behind, beside, beyondFarPlane});
+
+  auto cache = VisibleNodeCache{};
+
+  SECTION("Perspective camera")
+  {
+    auto camera = PerspectiveCamera{
+      90.0f,
+      1.0f,
+      2048.0f,
+      Camera::Viewport{0, 0, 1024, 768},
+      vm::vec3f{0, 0, 0},
+      vm::vec3f{1, 0, 0},
+      vm::vec3f{0, 0, 1}};
+
+    const auto& visibleNodes = cache.visibleNodes(camera, world);
+    CHECK_THAT(visibleNodes, Catch::UnorderedEquals(std::vector<Model::Node*>{inFront}));
+
+    camera.setDirection(vm::vec3f{-1, 0, 0}, vm::vec3f{0, 0, 1});
+    CHECK_THAT(
+      cache.visibleNodes(camera, world),
+      Catch::UnorderedEquals(std::vector<Model::Node*>{behind}));
+
+    camera.setDirection(vm::vec3f{1, 0, 0}, vm::vec3f{0, 0, 1});
+    camera.moveTo(vm::vec3f{0, 1024, 0});
+    CHECK_THAT(
+      cache.visibleNodes(camera, world),
+      Catch::UnorderedEquals(std::vector<Model::Node*>{beside}));
+
+    auto* added = createBrushNode({512, 1024, 0});
+    world.defaultLayer()->addChild(added);
+    CHECK_THAT(
+      cache.visibleNodes(camera, world),
+      Catch::UnorderedEquals(std::vector<Model::Node*>{beside, added}));
+
+    auto brush = beyondFarPlane->brush();
+    REQUIRE(brush
+              .transform(
+                worldBounds, vm::translation_matrix(vm::vec3{-3584, 1024, 0}), false)
+              .is_success());
+    beyondFarPlane->setBrush(std::move(brush));
+    CHECK_THAT(
+      cache.visibleNodes(camera, world),
+      Catch::UnorderedEquals(std::vector<Model::Node*>{beside, added, beyondFarPlane}));
+  }
+
+  SECTION("Orthographic camera")
+  {
+    auto camera = OrthographicCamera{
+      1.0f,
+      1024.0f,
+      Camera::Viewport{0, 0, 256, 256},
+      vm::vec3f{0, 0, 0},
+      vm::vec3f{0, 0, -1},
+      vm::vec3f{0, 1, 0}};
+
+    CHECK_THAT(
+      cache.visibleNodes(camera, world),
+      Catch::UnorderedEquals(std::vector<Model::Node*>{}));
+
+    camera.moveTo(vm::vec3f{256, 0, 0});
+    CHECK_THAT(
+      cache.visibleNodes(camera, world),
+      Catch::UnorderedEquals(std::vector<Model::Node*>{inFront}));
+  }
+}
+
+TEST_CASE("VisibleNodeCacheTest.replacedWorld")
+{
+  constexpr auto worldBounds = vm::bbox3{8192.0};
+  constexpr auto mapFormat = Model::MapFormat::Quake3;
+
+  const auto builder = Model::BrushBuilder{mapFormat, worldBounds};
+  const auto bounds = vm::bbox3{vm::vec3{240, -16, -16}, vm::vec3{272, 16, 16}};
+
+  const auto camera = PerspectiveCamera{
+    90.0f,
+    1.0f,
+    2048.0f,
+    Camera::Viewport{0, 0, 1024, 768},
+    vm::vec3f{0, 0, 0},
+    vm::vec3f{1, 0, 0},
+    vm::vec3f{0, 0, 1}};
+
+  auto cache = VisibleNodeCache{};
+
+  // the second world is created at the address of the first one
+  auto world = std::optional<Model::WorldNode>{};
+  world.emplace(Model::EntityPropertyConfig{}, Model::Entity{}, mapFormat);
+  auto* brushNode1 =
+    new Model::BrushNode{builder.createCuboid(bounds, "texture").value()};
+  world->defaultLayer()->addChild(brushNode1);
+  CHECK_THAT(
+    cache.visibleNodes(camera, *world),
+    Catch::UnorderedEquals(std::vector<Model::Node*>{brushNode1}));
+
+  world.emplace(Model::EntityPropertyConfig{}, Model::Entity{}, mapFormat);
+  auto* brushNode2 = new Model::BrushNode{
+    builder.createCuboid(bounds.translate(vm::vec3{-512, 0, 0}), "texture").value()};
+  world->defaultLayer()->addChild(brushNode2);
+  CHECK_THAT(
+    cache.visibleNodes(camera, *world),
+    Catch::UnorderedEquals(std::vector<Model::Node*>{}));
+}
+} // namespace Renderer
+} // namespace TrenchBroom
@@ -0,0 +1,122 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "View/MoveObjectsTool.h"
+
+#include "Model/BrushNode.h"
+#include "Model/Group.h"
+#include "Model/GroupNode.h"
+#include "View/InputState.h"
+#include "View/MapDocument.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/bbox_io.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/mat_io.h>
+#include <vecmath/vec.h>
+
+#include <optional>
+#include <string>
+
+#include "MapDocumentTest.h"
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace View
+{
+TEST_CASE_METHOD(MapDocumentTest, "MoveObjectsToolTest.moveObjects")
+{
+  auto* brushNode = createBrushNode();
+  document->addNodes({{document->parentForNodes(), {brushNode}}});
+  document->selectNodes({brushNode});
+
+  const auto originalBounds = brushNode->logicalBounds();
+  const auto undoCommandName = document->undoCommandName();
+
+  auto tool = MoveObjectsTool{document};
+  REQUIRE(tool.startMove(InputState{}));
+
+  REQUIRE(tool.move(InputState{}, vm::vec3{16, 0, 0}) == MoveObjectsTool::MR_Continue);
+  REQUIRE(tool.move(InputState{}, vm::vec3{0, 16, 0}) == MoveObjectsTool::MR_Continue);
+
+  // the objects are only previewed at their new position while dragging
+  CHECK(brushNode->logicalBounds() == originalBounds);
+  CHECK(
+    document->transformationPreview()
+    == std::optional{vm::translation_matrix(vm::vec3{16, 16, 0})});
+
+  SECTION("End the move")
+  {
+    tool.endMove(InputState{});
+
+    CHECK(brushNode->logicalBounds() == originalBounds.translate(vm::vec3{16, 16, 0}));
+    CHECK(document->transformationPreview() == std::nullopt);
+    CHECK(document->undoCommandName() == "Move Objects");
+
+    document->undoCommand();
+    CHECK(brushNode->logicalBounds() == originalBounds);
+    CHECK(document->undoCommandName() == undoCommandName);
+  }
+
+  SECTION("Cancel the move")
+  {
+    tool.cancelMove();
+
+    CHECK(brushNode->logicalBounds() == originalBounds);
+    CHECK(document->transformationPreview() == std::nullopt);
+    CHECK(document->undoCommandName() == undoCommandName);
+  }
+}
+
+TEST_CASE_METHOD(MapDocumentTest, "MoveObjectsToolTest.moveObjectsFails")
+{
+  auto* groupNode = new Model::GroupNode{Model::Group{"group"}};
+  auto* brushNode = createBrushNode();
+  groupNode->addChild(brushNode);
+  document->addNodes({{document->parentForNodes(), {groupNode}}});
+
+  document->selectNodes({groupNode});
+  auto* linkedGroupNode = document->createLinkedDuplicate();
+  document->deselectAll();
+
+  // moving the brush will fail because the linked brush will go out of world bounds
+  document->selectNodes({linkedGroupNode});
+  REQUIRE(document->translateObjects(
+    document->worldBounds().max - linkedGroupNode->physicalBounds().size()));
+  document->deselectAll();
+
+  document->selectNodes({brushNode});
+
+  const auto originalBounds = brushNode->logicalBounds();
+  const auto undoCommandName = document->undoCommandName();
+
+  auto tool = MoveObjectsTool{document};
+  REQUIRE(tool.startMove(InputState{}));
+  REQUIRE(tool.move(InputState{}, vm::vec3{0, 32, 0}) == MoveObjectsTool::MR_Continue);
+  tool.endMove(InputState{});
+
+  CHECK(brushNode->logicalBounds() == originalBounds);
+  CHECK(document->transformationPreview() == std::nullopt);
+  CHECK(document->undoCommandName() == undoCommandName);
+}
+} // namespace View
+} // namespace TrenchBroom
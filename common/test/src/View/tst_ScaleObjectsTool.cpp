@@ -20,6 +20,24 @@
 
 #include "View/ScaleObjectsTool.h"
 
+#include "Model/BrushNode.h"
+#include "Model/Group.h"
+#include "Model/GroupNode.h"
+#include "Model/Hit.h"
+#include "View/MapDocument.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/bbox_io.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/mat_io.h>
+#include <vecmath/vec.h>
+
+#include <optional>
+#include <string>
+
+#include "MapDocumentTest.h"
+
 #include "Catch2.h"
 
 namespace TrenchBroom
@@ -347,5 +365,91 @@ TEST_CASE("ScaleObjectsToolTest.moveBBoxEdge")
       AnchorPos::Opposite)
     == exp1);
 }
+
+TEST_CASE_METHOD(MapDocumentTest, "ScaleObjectsToolTest.scaleObjects")
+{
+  auto* brushNode = createBrushNode();
+  document->addNodes({{document->parentForNodes(), {brushNode}}});
+  document->selectNodes({brushNode});
+
+  const auto originalBounds = brushNode->logicalBounds();
+  const auto scaledBounds = vm::bbox3{vm::vec3{-16, -16, -16}, vm::vec3{32, 16, 16}};
+  const auto undoCommandName = document->undoCommandName();
+
+  auto tool = ScaleObjectsTool{document};
+  tool.startScaleWithHit(Model::Hit{
+    ScaleObjectsTool::ScaleToolSideHitType,
+    0.0,
+    vm::vec3{16, 0, 0},
+    BBoxSide{vm::vec3::pos_x()}});
+
+  tool.scaleByDelta(vm::vec3{8, 0, 0});
+  tool.scaleByDelta(vm::vec3{8, 0, 0});
+
+  // the objects are only previewed scaled while dragging
+  CHECK(brushNode->logicalBounds() == originalBounds);
+  CHECK(tool.bounds() == scaledBounds);
+  CHECK(
+    document->transformationPreview()
+    == std::optional{vm::scale_bbox_matrix(originalBounds, scaledBounds)});
+
+  SECTION("Commit the scale")
+  {
+    tool.commitScale();
+
+    CHECK(brushNode->logicalBounds() == scaledBounds);
+    CHECK(document->transformationPreview() == std::nullopt);
+    CHECK(document->undoCommandName() == "Scale Objects");
+
+    document->undoCommand();
+    CHECK(brushNode->logicalBounds() == originalBounds);
+    CHECK(document->undoCommandName() == undoCommandName);
+  }
+
+  SECTION("Cancel the scale")
+  {
+    tool.cancelScale();
+
+    CHECK(brushNode->logicalBounds() == originalBounds);
+    CHECK(document->transformationPreview() == std::nullopt);
+    CHECK(document->undoCommandName() == undoCommandName);
+  }
+}
+
+TEST_CASE_METHOD(MapDocumentTest, "ScaleObjectsToolTest.scaleObjectsFails")
+{
+  auto* groupNode = new Model::GroupNode{Model::Group{"group"}};
+  auto* brushNode = createBrushNode();
+  groupNode->addChild(brushNode);
+  document->addNodes({{document->parentForNodes(), {groupNode}}});
+
+  document->selectNodes({groupNode});
+  auto* linkedGroupNode = document->createLinkedDuplicate();
+  document->deselectAll();
+
+  // scaling the brush will fail because the linked brush will go out of world bounds
+  document->selectNodes({linkedGroupNode});
+  REQUIRE(document->translateObjects(
+    document->worldBounds().max - linkedGroupNode->physicalBounds().size()));
+  document->deselectAll();
+
+  document->selectNodes({brushNode});
+
+  const auto originalBounds = brushNode->logicalBounds();
+  const auto undoCommandName = document->undoCommandName();
+
+  auto tool = ScaleObjectsTool{document};
+  tool.startScaleWithHit(Model::Hit{
+    ScaleObjectsTool::ScaleToolSideHitType,
+    0.0,
+    vm::vec3{16, 0, 0},
+    BBoxSide{vm::vec3::pos_x()}});
+  tool.scaleByDelta(vm::vec3{32, 0, 0});
+  tool.commitScale();
+
+  CHECK(brushNode->logicalBounds() == originalBounds);
+  CHECK(document->transformationPreview() == std::nullopt);
+  CHECK(document->undoCommandName() == undoCommandName);
+}
 } // namespace View
 } // namespace TrenchBroom
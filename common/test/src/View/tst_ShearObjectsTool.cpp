@@ -0,0 +1,131 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "View/ShearObjectsTool.h"
+
+#include "Model/BrushNode.h"
+#include "Model/Group.h"
+#include "Model/GroupNode.h"
+#include "Model/Hit.h"
+#include "View/MapDocument.h"
+#include "View/ScaleObjectsTool.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/bbox_io.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/mat_io.h>
+#include <vecmath/vec.h>
+
+#include <optional>
+#include <string>
+
+#include "MapDocumentTest.h"
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace View
+{
+TEST_CASE_METHOD(MapDocumentTest, "ShearObjectsToolTest.shearObjects")
+{
+  auto* brushNode = createBrushNode();
+  document->addNodes({{document->parentForNodes(), {brushNode}}});
+  document->selectNodes({brushNode});
+
+  const auto originalBounds = brushNode->logicalBounds();
+  const auto shearedBounds = vm::bbox3{vm::vec3{-16, -16, -16}, vm::vec3{16, 32, 16}};
+  const auto undoCommandName = document->undoCommandName();
+
+  auto tool = ShearObjectsTool{document};
+  tool.startShearWithHit(Model::Hit{
+    ShearObjectsTool::ShearToolSideHitType,
+    0.0,
+    vm::vec3{16, 0, 0},
+    BBoxSide{vm::vec3::pos_x()}});
+
+  tool.shearByDelta(vm::vec3{0, 8, 0});
+  tool.shearByDelta(vm::vec3{0, 8, 0});
+
+  // the objects are only previewed sheared while dragging
+  CHECK(brushNode->logicalBounds() == originalBounds);
+  CHECK(tool.bounds() == shearedBounds);
+  CHECK(document->transformationPreview() == std::optional{tool.bboxShearMatrix()});
+
+  SECTION("Commit the shear")
+  {
+    tool.commitShear();
+
+    CHECK(brushNode->logicalBounds() == shearedBounds);
+    CHECK(document->transformationPreview() == std::nullopt);
+    CHECK(document->undoCommandName() == "Shear Objects");
+
+    document->undoCommand();
+    CHECK(brushNode->logicalBounds() == originalBounds);
+    CHECK(document->undoCommandName() == undoCommandName);
+  }
+
+  SECTION("Cancel the shear")
+  {
+    tool.cancelShear();
+
+    CHECK(brushNode->logicalBounds() == originalBounds);
+    CHECK(document->transformationPreview() == std::nullopt);
+    CHECK(document->undoCommandName() == undoCommandName);
+  }
+}
+
+TEST_CASE_METHOD(MapDocumentTest, "ShearObjectsToolTest.shearObjectsFails")
+{
+  auto* groupNode = new Model::GroupNode{Model::Group{"group"}};
+  auto* brushNode = createBrushNode();
+  groupNode->addChild(brushNode);
+  document->addNodes({{document->parentForNodes(), {groupNode}}});
+
+  document->selectNodes({groupNode});
+  auto* linkedGroupNode = document->createLinkedDuplicate();
+  document->deselectAll();
+
+  // shearing the brush will fail because the linked brush will go out of world bounds
+  document->selectNodes({linkedGroupNode});
+  REQUIRE(document->translateObjects(
+    document->worldBounds().max - linkedGroupNode->physicalBounds().size()));
+  document->deselectAll();
+
+  document->selectNodes({brushNode});
+
+  const auto originalBounds = brushNode->logicalBounds();
+  const auto undoCommandName = document->undoCommandName();
+
+  auto tool = ShearObjectsTool{document};
+  tool.startShearWithHit(Model::Hit{
+    ShearObjectsTool::ShearToolSideHitType,
+    0.0,
+    vm::vec3{16, 0, 0},
+    BBoxSide{vm::vec3::pos_x()}});
+  tool.shearByDelta(vm::vec3{0, 32, 0});
+  tool.commitShear();
+
+  CHECK(brushNode->logicalBounds() == originalBounds);
+  CHECK(document->transformationPreview() == std::nullopt);
+  CHECK(document->undoCommandName() == undoCommandName);
+}
+} // namespace View
+} // namespace TrenchBroom
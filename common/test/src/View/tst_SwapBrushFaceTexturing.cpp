@@ -0,0 +1,188 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/Texture.h"
+#include "Assets/TextureManager.h"
+#include "IO/Path.h"
+#include "Model/ApplyToNodeContents.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceHandle.h"
+#include "Model/BrushFaceTexturing.h"
+#include "Model/BrushNode.h"
+#include "Model/ChangeBrushFaceAttributesRequest.h"
+#include "Model/Group.h"
+#include "Model/GroupNode.h"
+#include "View/MapDocument.h"
+#include "View/MapDocumentTest.h"
+
+#include <vecmath/vec.h>
+#include <vecmath/vec_io.h>
+
+#include <vector>
+
+#include "TestUtils.h"
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace View
+{
+TEST_CASE_METHOD(ValveMapDocumentTest, "SwapBrushFaceTexturingTest.undoRedo")
+{
+  auto* brushNode = createBrushNode();
+  document->addNodes({{document->parentForNodes(), {brushNode}}});
+
+  const auto faceIndex = brushNode->brush().findFace(vm::vec3::pos_z());
+  REQUIRE(faceIndex.has_value());
+
+  const auto& face = brushNode->brush().face(*faceIndex);
+  const auto originalXOffset = face.attributes().xOffset();
+  const auto originalRotation = face.attributes().rotation();
+  const auto originalXAxis = face.textureXAxis();
+
+  auto facesToSwap = Model::applyToBrushFaces(
+    std::vector<Model::BrushFaceHandle>{{brushNode, *faceIndex}},
+    [](Model::BrushFace& faceCopy) {
+      auto attributes = faceCopy.attributes();
+      attributes.setXOffset(12.0f);
+      faceCopy.setAttributes(attributes);
+      faceCopy.rotateTexture(30.0f);
+      return true;
+    });
+  REQUIRE(facesToSwap.has_value());
+  REQUIRE(facesToSwap->size() == 1u);
+
+  const auto newRotation = facesToSwap->front().attributes.rotation();
+  const auto newXAxis = facesToSwap->front().texCoordSystem->xAxis();
+  REQUIRE(newRotation != originalRotation);
+  REQUIRE(newXAxis != originalXAxis);
+
+  const auto originalBrush = brushNode->brush();
+
+  REQUIRE(document->swapBrushFaceTexturing("Swap Texturing", std::move(*facesToSwap)));
+  CHECK(brushNode->brush().face(*faceIndex).attributes().xOffset() == 12.0f);
+  CHECK(brushNode->brush().face(*faceIndex).attributes().rotation() == newRotation);
+  CHECK(brushNode->brush().face(*faceIndex).textureXAxis() == newXAxis);
+  CHECK(brushNode->brush().sharesGeometryWith(originalBrush));
+
+  document->undoCommand();
+  CHECK(brushNode->brush().face(*faceIndex).attributes().xOffset() == originalXOffset);
+  CHECK(brushNode->brush().face(*faceIndex).attributes().rotation() == originalRotation);
+  CHECK(brushNode->brush().face(*faceIndex).textureXAxis() == originalXAxis);
+
+  document->redoCommand();
+  CHECK(brushNode->brush().face(*faceIndex).attributes().xOffset() == 12.0f);
+  CHECK(brushNode->brush().face(*faceIndex).attributes().rotation() == newRotation);
+  CHECK(brushNode->brush().face(*faceIndex).textureXAxis() == newXAxis);
+}
+
+TEST_CASE_METHOD(MapDocumentTest, "SwapBrushFaceTexturingTest.textureUsageCount")
+{
+  document->setEnabledTextureCollections({IO::Path("fixture/test/IO/Wad/cr8_czg.wad")});
+
+  const auto* coffin = document->textureManager().texture("coffin1");
+  const auto* bongs = document->textureManager().texture("bongs2");
+  REQUIRE(coffin != nullptr);
+  REQUIRE(bongs != nullptr);
+
+  auto* brushNode = createBrushNode("coffin1");
+  document->addNodes({{document->parentForNodes(), {brushNode}}});
+
+  REQUIRE(coffin->usageCount() == 6u);
+  REQUIRE(bongs->usageCount() == 0u);
+
+  document->selectNodes({brushNode});
+
+  auto request = Model::ChangeBrushFaceAttributesRequest{};
+  request.setTextureName("bongs2");
+  REQUIRE(document->setFaceAttributes(request));
+
+  CHECK(coffin->usageCount() == 0u);
+  CHECK(bongs->usageCount() == 6u);
+  for (const auto& face : brushNode->brush().faces())
+  {
+    CHECK(face.texture() == bongs);
+  }
+
+  document->undoCommand();
+  CHECK(coffin->usageCount() == 6u);
+  CHECK(bongs->usageCount() == 0u);
+  for (const auto& face : brushNode->brush().faces())
+  {
+    CHECK(face.texture() == coffin);
+  }
+
+  document->redoCommand();
+  CHECK(coffin->usageCount() == 0u);
+  CHECK(bongs->usageCount() == 6u);
+}
+
+TEST_CASE_METHOD(MapDocumentTest, "SwapBrushFaceTexturingTest.updateLinkedGroups")
+{
+  auto* groupNode = new Model::GroupNode{Model::Group{"group"}};
+  auto* brushNode = createBrushNode("original");
+  groupNode->addChild(brushNode);
+  document->addNodes({{document->parentForNodes(), {groupNode}}});
+
+  document->selectNodes({groupNode});
+  auto* linkedGroupNode = document->createLinkedDuplicate();
+  document->deselectAll();
+
+  document->selectNodes({linkedGroupNode});
+  document->translateObjects(vm::vec3(32.0, 0.0, 0.0));
+  document->deselectAll();
+
+  const auto faceIndex = brushNode->brush().findFace(vm::vec3::pos_z());
+  REQUIRE(faceIndex.has_value());
+
+  document->selectBrushFaces({{brushNode, *faceIndex}});
+
+  auto request = Model::ChangeBrushFaceAttributesRequest{};
+  request.setTextureName("changed");
+  REQUIRE(document->setFaceAttributes(request));
+  REQUIRE(brushNode->brush().face(*faceIndex).attributes().textureName() == "changed");
+
+  REQUIRE(linkedGroupNode->childCount() == 1u);
+  auto* linkedBrushNode =
+    dynamic_cast<Model::BrushNode*>(linkedGroupNode->children().front());
+  REQUIRE(linkedBrushNode != nullptr);
+
+  auto linkedFaceIndex = linkedBrushNode->brush().findFace(vm::vec3::pos_z());
+  REQUIRE(linkedFaceIndex.has_value());
+  CHECK(
+    linkedBrushNode->brush().face(*linkedFaceIndex).attributes().textureName()
+    == "changed");
+
+  document->undoCommand();
+  REQUIRE(brushNode->brush().face(*faceIndex).attributes().textureName() == "original");
+
+  REQUIRE(linkedGroupNode->childCount() == 1u);
+  linkedBrushNode = dynamic_cast<Model::BrushNode*>(linkedGroupNode->children().front());
+  REQUIRE(linkedBrushNode != nullptr);
+
+  linkedFaceIndex = linkedBrushNode->brush().findFace(vm::vec3::pos_z());
+  REQUIRE(linkedFaceIndex.has_value());
+  CHECK(
+    linkedBrushNode->brush().face(*linkedFaceIndex).attributes().textureName()
+    == "original");
+}
+} // namespace View
+} // namespace TrenchBroom
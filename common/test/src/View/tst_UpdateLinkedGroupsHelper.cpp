@@ -186,6 +186,7 @@ TEST_CASE_METHOD(
   */
 
   // propagate changes
+  groupNode->addPendingChangedNodes({brushNode});
   auto helper = UpdateLinkedGroupsHelper{{groupNode}};
   REQUIRE(
     helper
@@ -198,15 +199,16 @@ TEST_CASE_METHOD(
     +-groupNode
       +-brushNode (translated 0 16 0)
     +-linkedGroupNode (translated 32 0 0)
-      +-newLinkedBrushNode (translated 32 16 0)
+      +-linkedBrushNode (translated 32 16 0)
   */
 
-  // changes were propagated
+  // changes were propagated by updating the linked brush node in place
   REQUIRE(linkedGroupNode->childCount() == 1u);
-  CHECK(linkedBrushNode->parent() == nullptr);
-  auto* newLinkedBrushNode = linkedGroupNode->children().front();
+  CHECK_THAT(
+    linkedGroupNode->children(),
+    Catch::Equals(std::vector<Model::Node*>{linkedBrushNode}));
   CHECK(
-    newLinkedBrushNode->physicalBounds()
+    linkedBrushNode->physicalBounds()
     == originalBrushBounds.translate(vm::vec3(32.0, 16.0, 0.0)));
 
   // undo change propagation
@@ -0,0 +1,295 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FloatType.h"
+#include "Model/Hit.h"
+#include "Model/PickResult.h"
+#include "PreferenceManager.h"
+#include "Preferences.h"
+#include "Renderer/OrthographicCamera.h"
+#include "Renderer/PerspectiveCamera.h"
+#include "View/Lasso.h"
+#include "View/VertexHandleManager.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/scalar.h>
+#include <vecmath/segment.h>
+#include <vecmath/vec.h>
+#include <vecmath/vec_io.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace View
+{
+namespace
+{
+std::vector<vm::vec3> makeHandles(const size_t count)
+{
+  auto rng = std::mt19937{0};
+  auto coord = std::uniform_int_distribution<int>{-64, 64};
+
+  auto result = std::vector<vm::vec3>{};
+  result.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    result.push_back(16.0 * vm::vec3{coord(rng), coord(rng), coord(rng)});
+  }
+  return result;
+}
+
+std::vector<std::unique_ptr<Renderer::Camera>> makeCameras()
+{
+  auto result = std::vector<std::unique_ptr<Renderer::Camera>>{};
+  result.push_back(std::make_unique<Renderer::PerspectiveCamera>(
+    90.0f,
+    1.0f,
+    8192.0f,
+    Renderer::Camera::Viewport{0, 0, 1024, 768},
+    vm::vec3f{-1536, 256, 128},
+    vm::normalize(vm::vec3f{1, -0.25f, -0.125f}),
+    vm::vec3f{0, 0, 1}));
+
+  auto orthographicCamera = std::make_unique<Renderer::OrthographicCamera>(
+    1.0f,
+    8192.0f,
+    Renderer::Camera::Viewport{0, 0, 1024, 768},
+    vm::vec3f{0, 0, 2048},
+    vm::vec3f{0, 0, -1},
+    vm::vec3f{0, 1, 0});
+  orthographicCamera->setZoom(0.5f);
+  result.push_back(std::move(orthographicCamera));
+
+  return result;
+}
+
+template <typename H>
+std::vector<H> collectHandles(const VertexHandleManagerBaseT<H>& manager)
+{
+  auto result = std::vector<H>{};
+  manager.forEachHandle(
+    [](const vm::bbox3&) { return true; },
+    [&](const H& handle) { result.push_back(handle); });
+  std::sort(std::begin(result), std::end(result));
+  return result;
+}
+
+template <typename H>
+std::vector<H> hitHandles(const Model::PickResult& pickResult)
+{
+  auto result = std::vector<H>{};
+  for (const auto& hit : pickResult.all())
+  {
+    result.push_back(hit.target<H>());
+  }
+  std::sort(std::begin(result), std::end(result));
+  return result;
+}
+} // namespace
+
+TEST_CASE("VertexHandleManagerTest.addAndRemoveHandles")
+{
+  auto manager = VertexHandleManager{};
+
+  const auto h1 = vm::vec3{0, 0, 0};
+  const auto h2 = vm::vec3{1024, 0, 0};
+  const auto h3 = vm::vec3{1024, 0, 8};
+
+  manager.add(h1);
+  manager.add(h2);
+  manager.add(h2);
+  manager.add(h3);
+
+  CHECK(manager.totalHandleCount() == 3u);
+  CHECK(collectHandles(manager) == std::vector<vm::vec3>{h1, h2, h3});
+
+  CHECK(manager.remove(h2));
+  CHECK(collectHandles(manager) == std::vector<vm::vec3>{h1, h2, h3});
+
+  CHECK(manager.remove(h2));
+  CHECK(collectHandles(manager) == std::vector<vm::vec3>{h1, h3});
+
+  CHECK_FALSE(manager.remove(h2));
+
+  manager.clear();
+  CHECK(collectHandles(manager) == std::vector<vm::vec3>{});
+}
+
+TEST_CASE("VertexHandleManagerTest.forEachHandleVisitsNearbyCells")
+{
+  auto manager = VertexHandleManager{};
+
+  const auto near = vm::vec3{8, 8, 8};
+  const auto far = vm::vec3{2048, 2048, 2048};
+  manager.add(near);
+  manager.add(far);
+
+  auto visited = std::vector<vm::vec3>{};
+  manager.forEachHandle(
+    [](const vm::bbox3& bounds) { return bounds.intersects(vm::bbox3{0.0, 16.0}); },
+    [&](const vm::vec3& handle) { visited.push_back(handle); });
+
+  CHECK(visited == std::vector<vm::vec3>{near});
+}
+
+TEST_CASE("VertexHandleManagerTest.selectHandles")
+{
+  auto manager = VertexHandleManager{};
+
+  const auto handles = makeHandles(1000);
+  for (const auto& handle : handles)
+  {
+    manager.add(handle);
+  }
+
+  manager.select(handles[0]);
+  manager.select(handles[1] + vm::vec3{0.0000001, 0, 0});
+  manager.select(vm::vec3{2048, 2048, 2048});
+
+  CHECK(manager.selected(handles[0]));
+  CHECK(manager.selected(handles[1]));
+  CHECK(manager.selectedHandleCount() == 2u);
+
+  manager.deselect(handles[0]);
+  CHECK_FALSE(manager.selected(handles[0]));
+  CHECK(manager.selectedHandleCount() == 1u);
+}
+
+TEST_CASE("VertexHandleManagerTest.pickVertexHandles")
+{
+  auto manager = VertexHandleManager{};
+  const auto handles = makeHandles(2000);
+  for (const auto& handle : handles)
+  {
+    manager.add(handle);
+  }
+
+  const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+  for (const auto& camera : makeCameras())
+  {
+    for (const auto& handle : handles)
+    {
+      // pick each handle through its own screen position and slightly beside it
+      const auto screenPos = camera->project(vm::vec3f{handle});
+      for (const auto offset : {0.0f, 6.0f})
+      {
+        const auto pickRay = vm::ray3{camera->pickRay(
+          screenPos.x() + offset, float(camera->viewport().height) - screenPos.y())};
+
+        auto pickResult = Model::PickResult{};
+        manager.pick(pickRay, *camera, pickResult);
+
+        auto expected = std::vector<vm::vec3>{};
+        for (const auto& other : manager.allHandles())
+        {
+          if (!vm::is_nan(camera->pickPointHandle(pickRay, other, handleRadius)))
+          {
+            expected.push_back(other);
+          }
+        }
+        std::sort(std::begin(expected), std::end(expected));
+
+        CHECK(hitHandles<vm::vec3>(pickResult) == expected);
+      }
+    }
+  }
+}
+
+TEST_CASE("VertexHandleManagerTest.pickEdgeCenterHandles")
+{
+  auto manager = EdgeHandleManager{};
+  const auto points = makeHandles(400);
+  for (size_t i = 0; i + 1 < points.size(); i += 2)
+  {
+    manager.add(vm::segment3{points[i], points[i + 1]});
+  }
+
+  const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+  for (const auto& camera : makeCameras())
+  {
+    for (const auto& handle : manager.allHandles())
+    {
+      const auto screenPos = camera->project(vm::vec3f{handle.center()});
+      const auto pickRay = vm::ray3{
+        camera->pickRay(screenPos.x(), float(camera->viewport().height) - screenPos.y())};
+
+      auto pickResult = Model::PickResult{};
+      manager.pickCenterHandle(pickRay, *camera, pickResult);
+
+      auto expected = std::vector<vm::segment3>{};
+      for (const auto& other : manager.allHandles())
+      {
+        if (!vm::is_nan(camera->pickPointHandle(pickRay, other.center(), handleRadius)))
+        {
+          expected.push_back(other);
+        }
+      }
+      std::sort(std::begin(expected), std::end(expected));
+
+      CHECK(hitHandles<vm::segment3>(pickResult) == expected);
+    }
+  }
+}
+
+TEST_CASE("VertexHandleManagerTest.lassoCandidates")
+{
+  auto manager = VertexHandleManager{};
+  const auto handles = makeHandles(2000);
+  for (const auto& handle : handles)
+  {
+    manager.add(handle);
+  }
+
+  for (const auto& camera : makeCameras())
+  {
+    const auto start = vm::vec3{camera->defaultPoint(64.0f)};
+    auto lasso = Lasso{*camera, 64.0, start};
+    lasso.update(start + 128.0 * vm::vec3{camera->right() + camera->up()});
+
+    auto candidates = std::vector<vm::vec3>{};
+    manager.forEachHandle(
+      [&](const vm::bbox3& bounds) { return lasso.mightSelect(bounds); },
+      [&](const vm::vec3& handle) { candidates.push_back(handle); });
+
+    auto expected = std::vector<vm::vec3>{};
+    const auto allHandles = manager.allHandles();
+    lasso.selected(
+      std::begin(allHandles), std::end(allHandles), std::back_inserter(expected));
+
+    auto selected = std::vector<vm::vec3>{};
+    lasso.selected(
+      std::begin(candidates), std::end(candidates), std::back_inserter(selected));
+
+    std::sort(std::begin(expected), std::end(expected));
+    std::sort(std::begin(selected), std::end(selected));
+
+    CHECK(!expected.empty());
+    CHECK(candidates.size() < allHandles.size());
+    CHECK(selected == expected);
+  }
+}
+} // namespace View
+} // namespace TrenchBroom
@@ -0,0 +1,427 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Exceptions.h"
+#include "aabb_tree.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/intersection.h>
+#include <vecmath/plane.h>
+#include <vecmath/ray.h>
+#include <vecmath/scalar.h>
+#include <vecmath/util.h>
+#include <vecmath/vec.h>
+
+#include <kdl/vector_utils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+TEST_CASE("aabb_tree.insert")
+{
+  auto tree = aabb_tree<double, int>{};
+  CHECK(tree.empty());
+
+  tree.insert({{0, 0, 0}, {16, 16, 16}}, 1);
+  CHECK_FALSE(tree.empty());
+  CHECK(tree.contains(1));
+  CHECK(tree.height() == 0u);
+
+  tree.insert({{32, 0, 0}, {48, 16, 16}}, 2);
+  CHECK(tree.contains(2));
+  CHECK(tree.height() == 1u);
+
+  CHECK_THROWS_AS(tree.insert({{0, 0, 0}, {8, 8, 8}}, 1), NodeTreeException);
+
+  const auto nan = std::numeric_limits<double>::quiet_NaN();
+  CHECK_THROWS_AS(tree.insert({{nan, 0, 0}, {8, 8, 8}}, 3), NodeTreeException);
+  CHECK_FALSE(tree.contains(3));
+}
+
+TEST_CASE("aabb_tree.remove")
+{
+  auto tree = aabb_tree<double, int>{};
+  tree.insert({{0, 0, 0}, {16, 16, 16}}, 1);
+  tree.insert({{32, 0, 0}, {48, 16, 16}}, 2);
+  tree.insert({{64, 0, 0}, {80, 16, 16}}, 3);
+
+  CHECK_FALSE(tree.remove(4));
+
+  CHECK(tree.remove(2));
+  CHECK_FALSE(tree.contains(2));
+  CHECK(tree.find_containers({40, 8, 8}).empty());
+  CHECK(tree.find_containers({72, 8, 8}) == std::vector<int>{3});
+
+  CHECK(tree.remove(1));
+  CHECK(tree.remove(3));
+  CHECK(tree.empty());
+
+  // removed nodes are reused
+  tree.insert({{0, 0, 0}, {16, 16, 16}}, 2);
+  CHECK(tree.find_containers({8, 8, 8}) == std::vector<int>{2});
+}
+
+TEST_CASE("aabb_tree.update")
+{
+  auto tree = aabb_tree<double, int>{};
+  tree.insert({{0, 0, 0}, {16, 16, 16}}, 1);
+  tree.insert({{32, 0, 0}, {48, 16, 16}}, 2);
+
+  CHECK_THROWS_AS(tree.update({{0, 0, 0}, {8, 8, 8}}, 3), NodeTreeException);
+
+  SECTION("refitting")
+  {
+    tree.update({{8, 0, 0}, {24, 16, 16}}, 1);
+    CHECK(tree.find_containers({4, 8, 8}).empty());
+    CHECK(tree.find_containers({20, 8, 8}) == std::vector<int>{1});
+  }
+
+  SECTION("reinserting")
+  {
+    tree.update({{128, 0, 0}, {144, 16, 16}}, 1);
+    CHECK(tree.find_containers({8, 8, 8}).empty());
+    CHECK(tree.find_containers({136, 8, 8}) == std::vector<int>{1});
+  }
+}
+
+TEST_CASE("aabb_tree.clear")
+{
+  auto tree = aabb_tree<double, int>{};
+  tree.insert({{0, 0, 0}, {16, 16, 16}}, 1);
+  tree.clear();
+
+  CHECK(tree.empty());
+  CHECK_FALSE(tree.contains(1));
+  CHECK(tree.find_containers({8, 8, 8}).empty());
+}
+
+TEST_CASE("aabb_tree.build")
+{
+  auto tree = aabb_tree<double, int>{};
+
+  SECTION("empty")
+  {
+    tree.insert({{0, 0, 0}, {16, 16, 16}}, 1);
+    tree.build({});
+    CHECK(tree.empty());
+    CHECK_FALSE(tree.contains(1));
+  }
+
+  SECTION("invalid bounds")
+  {
+    const auto nan = std::numeric_limits<double>::quiet_NaN();
+    CHECK_THROWS_AS(
+      tree.build({
+        {{{0, 0, 0}, {16, 16, 16}}, 1},
+        {{{nan, 0, 0}, {8, 8, 8}}, 2},
+      }),
+      NodeTreeException);
+    CHECK(tree.empty());
+  }
+
+  SECTION("duplicate data")
+  {
+    CHECK_THROWS_AS(
+      tree.build({
+        {{{0, 0, 0}, {16, 16, 16}}, 1},
+        {{{32, 0, 0}, {48, 16, 16}}, 1},
+      }),
+      NodeTreeException);
+    CHECK(tree.empty());
+    CHECK_FALSE(tree.contains(1));
+  }
+
+  SECTION("random nodes")
+  {
+    auto rng = std::mt19937{12345};
+    auto coord = std::uniform_real_distribution<double>{-1024.0, 1024.0};
+    auto extent = std::uniform_real_distribution<double>{1.0, 64.0};
+
+    const auto random_bounds = [&]() {
+      const auto min = vm::vec3d{coord(rng), coord(rng), coord(rng)};
+      return vm::bbox3d{min, min + vm::vec3d{extent(rng), extent(rng), extent(rng)}};
+    };
+
+    constexpr auto num_nodes = 5000;
+    auto items = std::vector<std::pair<vm::bbox3d, int>>{};
+    auto incremental_tree = aabb_tree<double, int>{};
+    for (int i = 0; i < num_nodes; ++i)
+    {
+      items.emplace_back(random_bounds(), i);
+      incremental_tree.insert(items.back().first, i);
+    }
+
+    tree.build(items);
+    CHECK(tree.height() == size_t(std::ceil(std::log2(double(num_nodes)))));
+
+    const auto check_queries = [&]() {
+      for (size_t i = 0; i < 100; ++i)
+      {
+        const auto origin = vm::vec3d{coord(rng), coord(rng), coord(rng)};
+        const auto ray =
+          vm::ray3d{origin, vm::normalize(vm::vec3d{coord(rng), coord(rng), coord(rng)})};
+
+        CHECK(
+          kdl::vec_sort(tree.find_intersectors(ray))
+          == kdl::vec_sort(incremental_tree.find_intersectors(ray)));
+        CHECK(
+          kdl::vec_sort(tree.find_containers(origin))
+          == kdl::vec_sort(incremental_tree.find_containers(origin)));
+      }
+    };
+
+    check_queries();
+
+    // the built tree can be modified like an incrementally built tree
+    for (int i = 0; i < num_nodes; i += 3)
+    {
+      REQUIRE(tree.remove(i));
+      REQUIRE(incremental_tree.remove(i));
+    }
+    for (int i = 1; i < num_nodes; i += 3)
+    {
+      const auto bounds = random_bounds();
+      tree.update(bounds, i);
+      incremental_tree.update(bounds, i);
+    }
+    for (int i = num_nodes; i < num_nodes + 100; ++i)
+    {
+      const auto bounds = random_bounds();
+      tree.insert(bounds, i);
+      incremental_tree.insert(bounds, i);
+    }
+
+    check_queries();
+  }
+}
+
+TEST_CASE("aabb_tree.find_intersectors")
+{
+  auto tree = aabb_tree<double, int>{};
+
+  SECTION("empty tree") { CHECK(tree.find_intersectors({{0, 0, 0}, {1, 0, 0}}).empty()); }
+
+  SECTION("single node")
+  {
+    tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+
+    // the ray misses the node
+    CHECK(tree.find_intersectors({{48, 48, 0}, {0, 0, -1}}).empty());
+
+    // the node contains the ray origin
+    CHECK(tree.find_intersectors({{48, 48, 48}, {0, 0, -1}}) == std::vector<int>{1});
+
+    // the node is hit by the ray
+    CHECK(tree.find_intersectors({{48, 48, 0}, {0, 0, 1}}) == std::vector<int>{1});
+  }
+}
+
+TEST_CASE("aabb_tree.find_overlapping")
+{
+  auto tree = aabb_tree<double, int>{};
+  CHECK(tree.find_overlapping(vm::bbox3d{{0, 0, 0}, {16, 16, 16}}).empty());
+
+  tree.insert({{0, 0, 0}, {16, 16, 16}}, 1);
+  tree.insert({{32, 0, 0}, {48, 16, 16}}, 2);
+  tree.insert({{64, 0, 0}, {80, 16, 16}}, 3);
+
+  CHECK(tree.find_overlapping(vm::bbox3d{{20, 0, 0}, {28, 8, 8}}).empty());
+  CHECK(
+    tree.find_overlapping(vm::bbox3d{{8, 8, 8}, {12, 12, 12}}) == std::vector<int>{1});
+
+  // touching boxes intersect
+  CHECK(
+    kdl::vec_sort(tree.find_overlapping(vm::bbox3d{{16, 0, 0}, {64, 8, 8}}))
+    == std::vector<int>{1, 2, 3});
+}
+
+TEST_CASE("aabb_tree.find_in_frustum")
+{
+  auto tree = aabb_tree<double, int>{};
+
+  // the volume 0 <= x <= 40, 0 <= y <= 16, 0 <= z <= 16
+  const auto planes = std::vector<vm::plane3d>{
+    {{0, 0, 0}, {-1, 0, 0}},
+    {{0, 0, 0}, {0, -1, 0}},
+    {{0, 0, 0}, {0, 0, -1}},
+    {{40, 16, 16}, {1, 0, 0}},
+    {{40, 16, 16}, {0, 1, 0}},
+    {{40, 16, 16}, {0, 0, 1}},
+  };
+
+  const auto get_bounds = [](int) { return vm::bbox3d{}; };
+
+  CHECK(tree.find_in_frustum(planes, get_bounds).empty());
+
+  tree.insert({{0, 0, 0}, {16, 16, 16}}, 1);
+  tree.insert({{32, 0, 0}, {48, 16, 16}}, 2);
+  tree.insert({{64, 0, 0}, {80, 16, 16}}, 3);
+  tree.insert({{0, 0, 32}, {16, 16, 48}}, 4);
+
+  CHECK(
+    kdl::vec_sort(tree.find_in_frustum(planes, get_bounds)) == std::vector<int>{1, 2});
+
+  // without planes, every item is found
+  CHECK(
+    kdl::vec_sort(tree.find_in_frustum({}, get_bounds))
+    == std::vector<int>{1, 2, 3, 4});
+}
+
+TEST_CASE("aabb_tree.visit_intersectors_by_distance")
+{
+  auto tree = aabb_tree<double, int>{};
+  tree.insert({{96, -8, -8}, {112, 8, 8}}, 1);
+  tree.insert({{-64, -64, -64}, {64, 64, 64}}, 2);
+  tree.insert({{16, -8, -8}, {32, 8, 8}}, 3);
+  tree.insert({{200, -8, -8}, {216, 8, 8}}, 4);
+  tree.insert({{48, 16, 16}, {64, 32, 32}}, 5);
+
+  const auto ray = vm::ray3d{{-128, 0, 0}, {1, 0, 0}};
+  const auto get_bounds = [](int) { return vm::bbox3d{}; };
+
+  SECTION("visits items in order without hits")
+  {
+    auto visited = std::vector<int>{};
+    tree.visit_intersectors_by_distance(ray, get_bounds, [&](const int data) {
+      visited.push_back(data);
+      return std::optional<double>{};
+    });
+
+    CHECK(visited == std::vector<int>{2, 3, 1, 4});
+  }
+
+  SECTION("skips items beyond the closest hit")
+  {
+    auto visited = std::vector<int>{};
+    tree.visit_intersectors_by_distance(ray, get_bounds, [&](const int data) {
+      visited.push_back(data);
+      return data == 2 ? std::optional<double>{192.0} : std::optional<double>{};
+    });
+
+    CHECK(visited == std::vector<int>{2, 3});
+  }
+}
+
+TEST_CASE("aabb_tree.random")
+{
+  auto rng = std::mt19937{12345};
+  auto coord = std::uniform_real_distribution<double>{-1024.0, 1024.0};
+  auto extent = std::uniform_real_distribution<double>{1.0, 64.0};
+
+  const auto random_bounds = [&]() {
+    const auto min = vm::vec3d{coord(rng), coord(rng), coord(rng)};
+    return vm::bbox3d{min, min + vm::vec3d{extent(rng), extent(rng), extent(rng)}};
+  };
+
+  auto tree = aabb_tree<double, int>{};
+  auto bounds = std::unordered_map<int, vm::bbox3d>{};
+
+  constexpr auto num_nodes = 2000;
+  for (int i = 0; i < num_nodes; ++i)
+  {
+    bounds[i] = random_bounds();
+    tree.insert(bounds[i], i);
+  }
+
+  // remove every third node and move every fifth node
+  for (int i = 0; i < num_nodes; i += 3)
+  {
+    REQUIRE(tree.remove(i));
+    bounds.erase(i);
+  }
+  for (int i = 1; i < num_nodes; i += 5)
+  {
+    if (const auto i_bounds = bounds.find(i); i_bounds != bounds.end())
+    {
+      i_bounds->second = i_bounds->second.translate(vm::vec3d{extent(rng), 0, 0});
+      tree.update(i_bounds->second, i);
+    }
+  }
+
+  // the tree remains balanced
+  CHECK(tree.height() <= size_t(2.0 * std::log2(double(bounds.size()))));
+
+  for (size_t i = 0; i < 100; ++i)
+  {
+    const auto origin = vm::vec3d{coord(rng), coord(rng), coord(rng)};
+    const auto ray =
+      vm::ray3d{origin, vm::normalize(vm::vec3d{coord(rng), coord(rng), coord(rng)})};
+
+    const auto query_bounds = random_bounds().expand(128.0);
+    const auto frustum_planes = std::vector<vm::plane3d>{
+      {origin, vm::normalize(vm::vec3d{coord(rng), coord(rng), coord(rng)})},
+      {origin, vm::normalize(vm::vec3d{coord(rng), coord(rng), coord(rng)})},
+      {origin, vm::normalize(vm::vec3d{coord(rng), coord(rng), coord(rng)})},
+    };
+
+    auto expected_intersectors = std::vector<int>{};
+    auto expected_containers = std::vector<int>{};
+    auto expected_box_intersectors = std::vector<int>{};
+    auto expected_frustum_items = std::vector<int>{};
+    for (const auto& [data, data_bounds] : bounds)
+    {
+      if (data_bounds.intersects(query_bounds))
+      {
+        expected_box_intersectors.push_back(data);
+      }
+      if (std::none_of(
+            frustum_planes.begin(), frustum_planes.end(), [&](const auto& plane) {
+              return vm::plane_bbox_status(plane, data_bounds) == vm::plane_status::above;
+            }))
+      {
+        expected_frustum_items.push_back(data);
+      }
+      if (
+        data_bounds.contains(ray.origin)
+        || !vm::is_nan(vm::intersect_ray_bbox(ray, data_bounds)))
+      {
+        expected_intersectors.push_back(data);
+      }
+      if (data_bounds.contains(origin))
+      {
+        expected_containers.push_back(data);
+      }
+    }
+
+    CHECK(
+      kdl::vec_sort(tree.find_intersectors(ray))
+      == kdl::vec_sort(std::move(expected_intersectors)));
+    CHECK(
+      kdl::vec_sort(tree.find_containers(origin))
+      == kdl::vec_sort(std::move(expected_containers)));
+    CHECK(
+      kdl::vec_sort(tree.find_overlapping(query_bounds))
+      == kdl::vec_sort(std::move(expected_box_intersectors)));
+    CHECK(
+      kdl::vec_sort(
+        tree.find_in_frustum(frustum_planes, [](int) { return vm::bbox3d{}; }))
+      == kdl::vec_sort(std::move(expected_frustum_items)));
+  }
+}
+} // namespace TrenchBroom
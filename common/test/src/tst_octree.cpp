@@ -21,10 +21,18 @@
 
 #include <vecmath/bbox.h>
 #include <vecmath/forward.h>
+#include <vecmath/plane.h>
 #include <vecmath/ray.h>
 #include <vecmath/vec.h>
 
 #include <kdl/string_utils.h>
+#include <kdl/vector_utils.h>
+
+#include <optional>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "Catch2.h"
 
@@ -559,6 +567,109 @@ TEST_CASE("octree.insert_duplicate")
   CHECK_FALSE(tree.empty());
 }
 
+TEST_CASE("octree.build")
+{
+  auto tree = octree<double, int>{32.0};
+
+  SECTION("empty")
+  {
+    tree.insert(vm::bbox3d{{0, 0, 0}, {16, 16, 16}}, 1);
+    tree.build({});
+    CHECK(tree == octree<double, int>{32.0});
+  }
+
+  SECTION("single node")
+  {
+    auto expected = octree<double, int>{32.0};
+    expected.insert(vm::bbox3d{{32, 32, 32}, {64, 64, 64}}, 1);
+
+    tree.build({{vm::bbox3d{{32, 32, 32}, {64, 64, 64}}, 1}});
+    CHECK(tree == expected);
+  }
+
+  SECTION("single root node")
+  {
+    auto expected = octree<double, int>{32.0};
+    expected.insert(vm::bbox3d{{-32, -32, -32}, {32, 32, 32}}, 1);
+
+    tree.build({{vm::bbox3d{{-32, -32, -32}, {32, 32, 32}}, 1}});
+    CHECK(tree == expected);
+  }
+
+  SECTION("duplicate data")
+  {
+    CHECK_THROWS_AS(
+      tree.build({
+        {vm::bbox3d{{0, 0, 0}, {16, 16, 16}}, 1},
+        {vm::bbox3d{{32, 0, 0}, {48, 16, 16}}, 1},
+      }),
+      NodeTreeException);
+    CHECK(tree.empty());
+    CHECK_FALSE(tree.contains(1));
+  }
+
+  SECTION("random nodes")
+  {
+    auto rng = std::mt19937{12345};
+    auto coord = std::uniform_real_distribution<double>{-1024.0, 1024.0};
+    auto extent = std::uniform_real_distribution<double>{1.0, 128.0};
+
+    const auto random_bounds = [&]() {
+      const auto min = vm::vec3d{coord(rng), coord(rng), coord(rng)};
+      return vm::bbox3d{min, min + vm::vec3d{extent(rng), extent(rng), extent(rng)}};
+    };
+
+    auto items = std::vector<std::pair<vm::bbox3d, int>>{};
+    auto incremental_tree = octree<double, int>{32.0};
+    for (int i = 0; i < 1000; ++i)
+    {
+      items.emplace_back(random_bounds(), i);
+      incremental_tree.insert(items.back().first, i);
+    }
+
+    tree.build(items);
+
+    const auto check_queries = [&]() {
+      for (size_t i = 0; i < 100; ++i)
+      {
+        const auto origin = vm::vec3d{coord(rng), coord(rng), coord(rng)};
+        const auto ray = vm::ray3d{
+          origin, vm::normalize(vm::vec3d{coord(rng), coord(rng), coord(rng)})};
+
+        CHECK(
+          kdl::vec_sort(tree.find_intersectors(ray))
+          == kdl::vec_sort(incremental_tree.find_intersectors(ray)));
+        CHECK(
+          kdl::vec_sort(tree.find_containers(origin))
+          == kdl::vec_sort(incremental_tree.find_containers(origin)));
+      }
+    };
+
+    check_queries();
+
+    // the built tree can be modified like an incrementally built tree
+    for (int i = 0; i < 1000; i += 3)
+    {
+      REQUIRE(tree.remove(i));
+      REQUIRE(incremental_tree.remove(i));
+    }
+    for (int i = 1; i < 1000; i += 3)
+    {
+      const auto bounds = random_bounds();
+      tree.update(bounds, i);
+      incremental_tree.update(bounds, i);
+    }
+    for (int i = 1000; i < 1100; ++i)
+    {
+      const auto bounds = random_bounds();
+      tree.insert(bounds, i);
+      incremental_tree.insert(bounds, i);
+    }
+
+    check_queries();
+  }
+}
+
 TEST_CASE("octree.contains")
 {
   auto tree = octree<double, int>{32.0};
@@ -615,6 +726,131 @@ TEST_CASE("octree.find_intersectors")
   }
 }
 
+TEST_CASE("octree.find_overlapping")
+{
+  auto tree = octree<double, int>{32.0};
+  CHECK(tree.find_overlapping(vm::bbox3d{{0, 0, 0}, {16, 16, 16}}).empty());
+
+  tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+  tree.insert({{-64, -64, -64}, {64, 64, 64}}, 2);
+
+  // the root contains node 2
+  CHECK(
+    tree.find_overlapping(vm::bbox3d{{0, 0, 0}, {16, 16, 16}}) == std::vector<int>{2});
+
+  CHECK(
+    kdl::vec_sort(tree.find_overlapping(vm::bbox3d{{40, 40, 40}, {48, 48, 48}}))
+    == std::vector<int>{1, 2});
+}
+
+TEST_CASE("octree.find_in_frustum")
+{
+  auto tree = octree<double, int>{32.0};
+
+  const auto bounds = std::unordered_map<int, vm::bbox3d>{
+    {1, {{0, 0, 0}, {16, 16, 16}}},
+    {2, {{48, 0, 0}, {56, 16, 16}}},
+    {3, {{256, 256, 256}, {272, 272, 272}}},
+    {4, {{64, 0, 0}, {80, 16, 16}}},
+    {5, {{76, 0, 0}, {88, 8, 8}}},
+  };
+  const auto get_bounds = [&](const int data) { return bounds.at(data); };
+
+  // the volume -8 <= x, y, z <= 72
+  const auto planes = std::vector<vm::plane3d>{
+    {{-8, -8, -8}, {-1, 0, 0}},
+    {{-8, -8, -8}, {0, -1, 0}},
+    {{-8, -8, -8}, {0, 0, -1}},
+    {{72, 72, 72}, {1, 0, 0}},
+    {{72, 72, 72}, {0, 1, 0}},
+    {{72, 72, 72}, {0, 0, 1}},
+  };
+
+  CHECK(tree.find_in_frustum(planes, get_bounds).empty());
+
+  for (const auto& [data, data_bounds] : bounds)
+  {
+    tree.insert(data_bounds, data);
+  }
+
+  // item 5 is outside of the volume, but the node containing it intersects the volume
+  CHECK(
+    kdl::vec_sort(tree.find_in_frustum(planes, get_bounds))
+    == std::vector<int>{1, 2, 4});
+
+  // without planes, every item is found
+  CHECK(
+    kdl::vec_sort(tree.find_in_frustum({}, get_bounds))
+    == std::vector<int>{1, 2, 3, 4, 5});
+}
+
+TEST_CASE("octree.visit_intersectors_by_distance")
+{
+  auto tree = octree<double, int>{32.0};
+
+  const auto bounds = std::unordered_map<int, vm::bbox3d>{
+    {1, {{96, -8, -8}, {112, 8, 8}}},
+    {2, {{-64, -64, -64}, {64, 64, 64}}},
+    {3, {{16, -8, -8}, {32, 8, 8}}},
+    {4, {{200, -8, -8}, {216, 8, 8}}},
+    {5, {{48, 16, 16}, {64, 32, 32}}},
+  };
+  const auto get_bounds = [&](const int data) { return bounds.at(data); };
+
+  const auto ray = vm::ray3d{{-128, 0, 0}, {1, 0, 0}};
+
+  SECTION("empty tree")
+  {
+    auto visited = std::vector<int>{};
+    tree.visit_intersectors_by_distance(ray, get_bounds, [&](const int data) {
+      visited.push_back(data);
+      return std::optional<double>{};
+    });
+    CHECK(visited.empty());
+  }
+
+  for (const auto& [data, data_bounds] : bounds)
+  {
+    tree.insert(data_bounds, data);
+  }
+
+  SECTION("visits items in order without hits")
+  {
+    auto visited = std::vector<int>{};
+    tree.visit_intersectors_by_distance(ray, get_bounds, [&](const int data) {
+      visited.push_back(data);
+      return std::optional<double>{};
+    });
+
+    // item 5 is not hit by the ray
+    CHECK(visited == std::vector<int>{2, 3, 1, 4});
+  }
+
+  SECTION("skips items beyond the closest hit")
+  {
+    auto visited = std::vector<int>{};
+    tree.visit_intersectors_by_distance(ray, get_bounds, [&](const int data) {
+      visited.push_back(data);
+      // item 2 is hit at its far side, only item 3 is entered before that
+      return data == 2 ? std::optional<double>{192.0} : std::optional<double>{};
+    });
+
+    CHECK(visited == std::vector<int>{2, 3});
+  }
+
+  SECTION("ray origin inside of an item")
+  {
+    auto visited = std::vector<int>{};
+    tree.visit_intersectors_by_distance(
+      vm::ray3d{{104, 0, 0}, {1, 0, 0}}, get_bounds, [&](const int data) {
+        visited.push_back(data);
+        return std::optional<double>{0.0};
+      });
+
+    CHECK(visited == std::vector<int>{1});
+  }
+}
+
 TEST_CASE("octree.find_containers")
 {
   auto tree = octree<double, int>{32.0};
@@ -0,0 +1,272 @@
+/*
+ Copyright 2010-2019 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace kdl
+{
+/**
+ * A pool of memory blocks of a fixed size. The blocks are carved out of large chunks so
+ * that blocks allocated one after another are likely to be adjacent in memory.
+ *
+ * Every thread keeps its own list of free blocks, so allocating and deallocating a block
+ * does not require any synchronization in the common case. A thread refills its free list
+ * from a shared free list or a new chunk if it runs out of free blocks, and it returns
+ * blocks to the shared free list if it accumulates too many of them or when it exits.
+ * Blocks can therefore be deallocated by a different thread than the one that allocated
+ * them.
+ *
+ * The chunks are never returned to the operating system, but their blocks are reused.
+ *
+ * @tparam BlockSize the size of the blocks in bytes
+ * @tparam BlockAlign the alignment of the blocks
+ * @tparam BlocksPerChunk the number of blocks per chunk
+ */
+template <std::size_t BlockSize, std::size_t BlockAlign, std::size_t BlocksPerChunk = 256>
+class block_pool
+{
+  static_assert(BlocksPerChunk > 0u, "chunks must contain at least one block");
+
+private:
+  struct free_block
+  {
+    free_block* next;
+  };
+
+public:
+  static constexpr std::size_t block_align = std::max(BlockAlign, alignof(free_block));
+  static constexpr std::size_t block_size =
+    (std::max(BlockSize, sizeof(free_block)) + block_align - 1u) / block_align
+    * block_align;
+  static constexpr std::size_t blocks_per_chunk = BlocksPerChunk;
+
+  static_assert(
+    block_align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+    "over-aligned blocks are not supported");
+
+private:
+  struct shared_state
+  {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<unsigned char[]>> chunks;
+    free_block* free_list = nullptr;
+    std::size_t free_count = 0u;
+  };
+
+  struct local_state
+  {
+    free_block* free_list = nullptr;
+    std::size_t free_count = 0u;
+
+    ~local_state() { return_blocks(*this, free_count); }
+  };
+
+public:
+  /**
+   * Returns a block of at least BlockSize bytes.
+   *
+   * @throws std::bad_alloc if a new chunk is needed and cannot be allocated
+   */
+  static void* allocate()
+  {
+    auto& local = local_pool();
+    if (local.free_list == nullptr)
+    {
+      refill(local);
+    }
+
+    assert(local.free_list != nullptr);
+    auto* block = local.free_list;
+    local.free_list = block->next;
+    --local.free_count;
+    return block;
+  }
+
+  /**
+   * Returns the given block to the pool. The block must have been allocated by this pool.
+   *
+   * @param ptr the block to deallocate, may be null
+   */
+  static void deallocate(void* ptr) noexcept
+  {
+    if (ptr == nullptr)
+    {
+      return;
+    }
+
+    auto& local = local_pool();
+    auto* block = static_cast<free_block*>(ptr);
+    block->next = local.free_list;
+    local.free_list = block;
+    ++local.free_count;
+
+    if (local.free_count > 2u * blocks_per_chunk)
+    {
+      return_blocks(local, blocks_per_chunk);
+    }
+  }
+
+  /**
+   * Returns the number of chunks allocated by this pool.
+   */
+  static std::size_t chunk_count()
+  {
+    auto& shared = shared_pool();
+    const auto lock = std::lock_guard<std::mutex>{shared.mutex};
+    return shared.chunks.size();
+  }
+
+private:
+  static shared_state& shared_pool()
+  {
+    // intentionally leaked so that blocks can still be deallocated during static
+    // destruction
+    static auto* state = new shared_state{};
+    return *state;
+  }
+
+  static local_state& local_pool()
+  {
+    // make sure that the shared state outlives the thread local state
+    shared_pool();
+
+    thread_local auto state = local_state{};
+    return state;
+  }
+
+  static void refill(local_state& local)
+  {
+    assert(local.free_list == nullptr);
+
+    auto& shared = shared_pool();
+    {
+      const auto lock = std::lock_guard<std::mutex>{shared.mutex};
+      if (shared.free_list != nullptr)
+      {
+        // take at most one chunk's worth of blocks from the shared free list
+        auto* first = shared.free_list;
+        auto* last = first;
+        auto count = std::size_t(1);
+        while (last->next != nullptr && count < blocks_per_chunk)
+        {
+          last = last->next;
+          ++count;
+        }
+
+        shared.free_list = last->next;
+        shared.free_count -= count;
+
+        last->next = nullptr;
+        local.free_list = first;
+        local.free_count = count;
+        return;
+      }
+    }
+
+    auto chunk = std::make_unique<unsigned char[]>(block_size * blocks_per_chunk);
+
+    // link the blocks in ascending order so that they are handed out in that order
+    auto* next = static_cast<free_block*>(nullptr);
+    for (std::size_t i = blocks_per_chunk; i > 0u; --i)
+    {
+      auto* block = new (chunk.get() + (i - 1u) * block_size) free_block{next};
+      next = block;
+    }
+
+    {
+      const auto lock = std::lock_guard<std::mutex>{shared.mutex};
+      shared.chunks.push_back(std::move(chunk));
+    }
+
+    local.free_list = next;
+    local.free_count = blocks_per_chunk;
+  }
+
+  static void return_blocks(local_state& local, const std::size_t count) noexcept
+  {
+    if (count == 0u)
+    {
+      return;
+    }
+
+    assert(count <= local.free_count);
+    auto* first = local.free_list;
+    auto* last = first;
+    for (std::size_t i = 1u; i < count; ++i)
+    {
+      last = last->next;
+    }
+
+    local.free_list = last->next;
+    local.free_count -= count;
+
+    auto& shared = shared_pool();
+    const auto lock = std::lock_guard<std::mutex>{shared.mutex};
+    last->next = shared.free_list;
+    shared.free_list = first;
+    shared.free_count += count;
+  }
+};
+
+/**
+ * Base class for types whose instances should be allocated from a block_pool. Deriving
+ * from this class replaces the class specific operator new and operator delete; new and
+ * delete expressions do not need to be changed.
+ *
+ * Instances of classes derived from T are allocated with the global operator new unless
+ * they have the same size as T.
+ *
+ * @tparam T the derived type
+ * @tparam BlocksPerChunk the number of instances per chunk
+ */
+template <typename T, std::size_t BlocksPerChunk = 256>
+class pool_allocated
+{
+public:
+  static void* operator new(const std::size_t size)
+  {
+    if (size != sizeof(T))
+    {
+      return ::operator new(size);
+    }
+    return block_pool<sizeof(T), alignof(T), BlocksPerChunk>::allocate();
+  }
+
+  static void operator delete(void* ptr, const std::size_t size) noexcept
+  {
+    if (size != sizeof(T))
+    {
+      ::operator delete(ptr);
+    }
+    else
+    {
+      block_pool<sizeof(T), alignof(T), BlocksPerChunk>::deallocate(ptr);
+    }
+  }
+};
+} // namespace kdl
@@ -0,0 +1,186 @@
+/*
+ Copyright 2010-2019 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace kdl
+{
+/**
+ * A handle to an immutable string that is stored in a global string table. Every distinct
+ * string is stored only once, so an interned string is only as large as a pointer, and
+ * two interned strings are equal if and only if they point to the same table entry.
+ *
+ * Strings are never removed from the table, so interning should be restricted to strings
+ * that are drawn from a small set of values, such as names.
+ *
+ * Interning a string and looking it up are thread safe.
+ */
+class interned_string
+{
+private:
+  class string_table
+  {
+  private:
+    std::shared_mutex m_mutex;
+    // the keys view the values, which do not move when the map is rehashed
+    std::unordered_map<std::string_view, std::unique_ptr<const std::string>> m_strings;
+
+  public:
+    const std::string* find(const std::string_view str)
+    {
+      const auto lock = std::shared_lock<std::shared_mutex>{m_mutex};
+      const auto it = m_strings.find(str);
+      return it != m_strings.end() ? it->second.get() : nullptr;
+    }
+
+    const std::string* intern(const std::string_view str)
+    {
+      if (const auto* result = find(str))
+      {
+        return result;
+      }
+
+      const auto lock = std::unique_lock<std::shared_mutex>{m_mutex};
+      auto it = m_strings.find(str);
+      if (it == m_strings.end())
+      {
+        auto owned = std::make_unique<const std::string>(str);
+        const auto key = std::string_view{*owned};
+        it = m_strings.emplace(key, std::move(owned)).first;
+      }
+      return it->second.get();
+    }
+
+    std::size_t size()
+    {
+      const auto lock = std::shared_lock<std::shared_mutex>{m_mutex};
+      return m_strings.size();
+    }
+  };
+
+  static string_table& table()
+  {
+    // intentionally leaked so that interned strings remain valid during static
+    // destruction
+    static auto* instance = new string_table{};
+    return *instance;
+  }
+
+  const std::string* m_string;
+
+  explicit interned_string(const std::string* string)
+    : m_string{string}
+  {
+  }
+
+public:
+  /**
+   * Creates an interned empty string.
+   */
+  interned_string()
+    : m_string{empty_string()}
+  {
+  }
+
+  /**
+   * Interns the given string, adding it to the string table if necessary.
+   */
+  explicit interned_string(const std::string_view str)
+    : m_string{table().intern(str)}
+  {
+  }
+
+  /**
+   * Returns the interned string equal to the given string without adding it to the string
+   * table. If no such string was interned, returns an empty optional.
+   */
+  static std::optional<interned_string> find(const std::string_view str)
+  {
+    if (const auto* string = table().find(str))
+    {
+      return interned_string{string};
+    }
+    return std::nullopt;
+  }
+
+  /**
+   * Returns the number of distinct strings in the string table.
+   */
+  static std::size_t table_size() { return table().size(); }
+
+  const std::string& str() const { return *m_string; }
+
+  bool empty() const { return m_string->empty(); }
+
+  friend bool operator==(const interned_string& lhs, const interned_string& rhs)
+  {
+    return lhs.m_string == rhs.m_string;
+  }
+
+  friend bool operator!=(const interned_string& lhs, const interned_string& rhs)
+  {
+    return lhs.m_string != rhs.m_string;
+  }
+
+  /**
+   * Compares the string values, so that the order does not depend on the order in which
+   * the strings were interned.
+   */
+  friend bool operator<(const interned_string& lhs, const interned_string& rhs)
+  {
+    return lhs.m_string != rhs.m_string && *lhs.m_string < *rhs.m_string;
+  }
+
+  friend std::ostream& operator<<(std::ostream& lhs, const interned_string& rhs)
+  {
+    return lhs << *rhs.m_string;
+  }
+
+private:
+  static const std::string* empty_string()
+  {
+    static const auto* empty = table().intern("");
+    return empty;
+  }
+};
+} // namespace kdl
+
+namespace std
+{
+template <>
+struct hash<kdl::interned_string>
+{
+  std::size_t operator()(const kdl::interned_string& str) const noexcept
+  {
+    return std::hash<const std::string*>{}(&str.str());
+  }
+};
+} // namespace std
@@ -0,0 +1,218 @@
+/*
+ Copyright 2010-2019 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#include "kdl/block_pool.h"
+
+#include <cstdint>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace kdl
+{
+// each test uses its own pool type so that the tests do not share state
+
+TEST_CASE("block_pool_test.block_size")
+{
+  CHECK(block_pool<1, 1>::block_size == sizeof(void*));
+  CHECK(block_pool<1, 1>::block_align == alignof(void*));
+  CHECK(block_pool<24, 8>::block_size == 24u);
+  CHECK(block_pool<20, 8>::block_size == 24u);
+  CHECK(block_pool<20, 16>::block_size == 32u);
+}
+
+TEST_CASE("block_pool_test.allocate")
+{
+  using pool = block_pool<24, 8, 4>;
+  CHECK(pool::chunk_count() == 0u);
+
+  auto blocks = std::vector<void*>{};
+  for (size_t i = 0; i < 4; ++i)
+  {
+    blocks.push_back(pool::allocate());
+  }
+  CHECK(pool::chunk_count() == 1u);
+
+  // the blocks of a chunk are handed out in ascending order
+  for (size_t i = 1; i < blocks.size(); ++i)
+  {
+    CHECK(
+      reinterpret_cast<std::uintptr_t>(blocks[i])
+      == reinterpret_cast<std::uintptr_t>(blocks[i - 1]) + pool::block_size);
+  }
+
+  blocks.push_back(pool::allocate());
+  CHECK(pool::chunk_count() == 2u);
+  CHECK(std::set<void*>(std::begin(blocks), std::end(blocks)).size() == blocks.size());
+
+  for (auto* block : blocks)
+  {
+    CHECK(reinterpret_cast<std::uintptr_t>(block) % pool::block_align == 0u);
+    pool::deallocate(block);
+  }
+}
+
+TEST_CASE("block_pool_test.deallocate")
+{
+  using pool = block_pool<32, 8, 4>;
+
+  auto* block = pool::allocate();
+  pool::deallocate(block);
+  CHECK(pool::allocate() == block);
+  pool::deallocate(block);
+
+  // deallocating null is a noop
+  pool::deallocate(nullptr);
+  CHECK(pool::allocate() == block);
+  pool::deallocate(block);
+
+  auto blocks = std::vector<void*>{};
+  for (size_t i = 0; i < 16; ++i)
+  {
+    blocks.push_back(pool::allocate());
+  }
+  CHECK(pool::chunk_count() == 4u);
+
+  for (auto* b : blocks)
+  {
+    pool::deallocate(b);
+  }
+
+  // the freed blocks are reused
+  for (size_t i = 0; i < 16; ++i)
+  {
+    blocks[i] = pool::allocate();
+  }
+  CHECK(pool::chunk_count() == 4u);
+
+  for (auto* b : blocks)
+  {
+    pool::deallocate(b);
+  }
+}
+
+TEST_CASE("block_pool_test.deallocate_on_other_thread")
+{
+  using pool = block_pool<40, 8, 4>;
+
+  auto blocks = std::vector<void*>{};
+  auto allocator = std::thread{[&]() {
+    for (size_t i = 0; i < 8; ++i)
+    {
+      blocks.push_back(pool::allocate());
+    }
+  }};
+  allocator.join();
+  CHECK(pool::chunk_count() == 2u);
+
+  for (auto* block : blocks)
+  {
+    pool::deallocate(block);
+  }
+
+  // the blocks freed by the other thread are reused
+  for (size_t i = 0; i < 8; ++i)
+  {
+    blocks[i] = pool::allocate();
+  }
+  CHECK(pool::chunk_count() == 2u);
+
+  // blocks are returned to the shared free list when a thread exits
+  auto deallocator = std::thread{[&]() {
+    for (auto* block : blocks)
+    {
+      pool::deallocate(block);
+    }
+  }};
+  deallocator.join();
+
+  for (size_t i = 0; i < 8; ++i)
+  {
+    blocks[i] = pool::allocate();
+  }
+  CHECK(pool::chunk_count() == 2u);
+
+  for (auto* block : blocks)
+  {
+    pool::deallocate(block);
+  }
+}
+
+namespace
+{
+struct pooled : public pool_allocated<pooled, 8>
+{
+  std::uint64_t a;
+  std::uint64_t b;
+  std::uint64_t c;
+  std::uint64_t d;
+  std::uint64_t e;
+
+  explicit pooled(const std::uint64_t i_a)
+    : a{i_a}
+    , b{0}
+    , c{0}
+    , d{0}
+    , e{0}
+  {
+  }
+};
+
+struct derived_pooled : public pooled
+{
+  std::uint64_t f;
+
+  derived_pooled()
+    : pooled{1}
+    , f{2}
+  {
+  }
+};
+} // namespace
+
+TEST_CASE("pool_allocated_test.new_delete")
+{
+  using pool = block_pool<sizeof(pooled), alignof(pooled), 8>;
+
+  auto* p1 = new pooled{1};
+  auto* p2 = new pooled{2};
+  CHECK(pool::chunk_count() == 1u);
+  CHECK(p1->a == 1u);
+  CHECK(p2->a == 2u);
+  CHECK(
+    reinterpret_cast<std::uintptr_t>(p2)
+    == reinterpret_cast<std::uintptr_t>(p1) + pool::block_size);
+
+  delete p2;
+  auto* p3 = new pooled{3};
+  CHECK(p3 == p2);
+
+  // derived types of a different size use the global operator new
+  pooled* d = new derived_pooled{};
+  CHECK(static_cast<derived_pooled*>(d)->f == 2u);
+  delete static_cast<derived_pooled*>(d);
+
+  delete p1;
+  delete p3;
+  CHECK(pool::chunk_count() == 1u);
+}
+} // namespace kdl
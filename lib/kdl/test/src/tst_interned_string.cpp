@@ -0,0 +1,121 @@
+/*
+ Copyright 2010-2019 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#include "kdl/interned_string.h"
+
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace kdl
+{
+TEST_CASE("interned_string_test.constructor")
+{
+  CHECK(interned_string{}.str() == "");
+  CHECK(interned_string{}.empty());
+  CHECK(interned_string{"abc"}.str() == "abc");
+  CHECK_FALSE(interned_string{"abc"}.empty());
+
+  // the string is copied into the table
+  auto str = std::string{"interned_string_test.constructor"};
+  const auto interned = interned_string{str};
+  str[0] = 'x';
+  CHECK(interned.str() == "interned_string_test.constructor");
+}
+
+TEST_CASE("interned_string_test.identity")
+{
+  const auto a = interned_string{"interned_string_test.identity"};
+  const auto b = interned_string{std::string{"interned_string_test.identity"}};
+  const auto c = interned_string{"interned_string_test.identity2"};
+
+  CHECK(&a.str() == &b.str());
+  CHECK(&a.str() != &c.str());
+  CHECK(interned_string{""} == interned_string{});
+}
+
+TEST_CASE("interned_string_test.find")
+{
+  CHECK(interned_string::find("interned_string_test.find") == std::nullopt);
+
+  const auto size = interned_string::table_size();
+  CHECK(interned_string::find("interned_string_test.find") == std::nullopt);
+  CHECK(interned_string::table_size() == size);
+
+  const auto interned = interned_string{"interned_string_test.find"};
+  CHECK(interned_string::find("interned_string_test.find") == interned);
+  CHECK(interned_string::table_size() == size + 1u);
+}
+
+TEST_CASE("interned_string_test.operators")
+{
+  const auto a = interned_string{"interned_string_test.operators.a"};
+  const auto b = interned_string{"interned_string_test.operators.b"};
+
+  CHECK(a == a);
+  CHECK_FALSE(a == b);
+  CHECK(a != b);
+  CHECK_FALSE(a != a);
+
+  // the order is the order of the string values regardless of the order of interning
+  const auto d = interned_string{"interned_string_test.operators.d"};
+  const auto c = interned_string{"interned_string_test.operators.c"};
+  CHECK(a < b);
+  CHECK(c < d);
+  CHECK_FALSE(d < c);
+  CHECK_FALSE(a < a);
+
+  auto str = std::stringstream{};
+  str << a;
+  CHECK(str.str() == "interned_string_test.operators.a");
+
+  const auto set = std::unordered_set<interned_string>{a, b, interned_string{a.str()}};
+  CHECK(set.size() == 2u);
+}
+
+TEST_CASE("interned_string_test.concurrent_interning")
+{
+  auto results = std::vector<std::vector<interned_string>>(4);
+  auto threads = std::vector<std::thread>{};
+  for (auto& result : results)
+  {
+    threads.emplace_back([&]() {
+      for (size_t i = 0; i < 100; ++i)
+      {
+        result.emplace_back("interned_string_test.concurrent" + std::to_string(i));
+      }
+    });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  for (const auto& result : results)
+  {
+    CHECK(result == results.front());
+  }
+}
+} // namespace kdl
@@ -29,6 +29,19 @@
 #include "util.h"
 #include "vec.h"
 
+#include <type_traits>
+#include <vector>
+
+#if !defined(VECMATH_NO_SIMD)
+#if defined(__AVX__)
+#define VECMATH_SIMD_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VECMATH_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+#endif
+
 namespace vm
 {
 
@@ -480,6 +493,568 @@ constexpr T intersect_ray_bbox(const ray<T, S>& r, const bbox<T, S>& b)
   return distances[bestPlane];
 }
 
+/**
+ * Determines the position of the given bounding box relative to the given plane.
+ *
+ * @tparam T the component type
+ * @tparam S the number of components
+ * @param p the plane
+ * @param b the bounding box
+ * @return plane_status::above if the bounding box is entirely above the plane,
+ * plane_status::below if it is entirely below the plane, and plane_status::inside if the
+ * plane intersects the bounding box
+ */
+template <typename T, size_t S>
+constexpr plane_status plane_bbox_status(const plane<T, S>& p, const bbox<T, S>& b)
+{
+  // the distances of the box corners that are closest to and farthest from the plane in
+  // the direction of its normal
+  auto min_distance = -p.distance;
+  auto max_distance = -p.distance;
+  for (size_t i = 0; i < S; ++i)
+  {
+    if (p.normal[i] >= static_cast<T>(0.0))
+    {
+      min_distance += p.normal[i] * b.min[i];
+      max_distance += p.normal[i] * b.max[i];
+    }
+    else
+    {
+      min_distance += p.normal[i] * b.max[i];
+      max_distance += p.normal[i] * b.min[i];
+    }
+  }
+
+  if (min_distance > static_cast<T>(0.0))
+  {
+    return plane_status::above;
+  }
+  if (max_distance < static_cast<T>(0.0))
+  {
+    return plane_status::below;
+  }
+  return plane_status::inside;
+}
+
+/**
+ * A list of bounding boxes whose coordinates are stored in separate arrays, one per
+ * component of the min and max corners. This layout allows testing several bounding
+ * boxes against a ray at once, see intersect_ray_bboxes.
+ *
+ * @tparam T the component type
+ * @tparam S the number of components
+ */
+template <typename T, size_t S>
+struct bbox_batch
+{
+  std::vector<T> min[S];
+  std::vector<T> max[S];
+
+  size_t size() const { return min[0].size(); }
+
+  bool empty() const { return min[0].empty(); }
+
+  bbox<T, S> operator[](const size_t index) const
+  {
+    auto result = bbox<T, S>{};
+    for (size_t i = 0; i < S; ++i)
+    {
+      result.min[i] = min[i][index];
+      result.max[i] = max[i][index];
+    }
+    return result;
+  }
+
+  void reserve(const size_t capacity)
+  {
+    for (size_t i = 0; i < S; ++i)
+    {
+      min[i].reserve(capacity);
+      max[i].reserve(capacity);
+    }
+  }
+
+  void clear()
+  {
+    for (size_t i = 0; i < S; ++i)
+    {
+      min[i].clear();
+      max[i].clear();
+    }
+  }
+
+  void push_back(const bbox<T, S>& b)
+  {
+    for (size_t i = 0; i < S; ++i)
+    {
+      min[i].push_back(b.min[i]);
+      max[i].push_back(b.max[i]);
+    }
+  }
+};
+
+/**
+ * A list of planes whose normal components and distances are stored in separate arrays,
+ * see bbox_batch and intersect_ray_planes.
+ *
+ * @tparam T the component type
+ * @tparam S the number of components
+ */
+template <typename T, size_t S>
+struct plane_batch
+{
+  std::vector<T> normal[S];
+  std::vector<T> distance;
+
+  size_t size() const { return distance.size(); }
+
+  bool empty() const { return distance.empty(); }
+
+  plane<T, S> operator[](const size_t index) const
+  {
+    auto result = plane<T, S>{distance[index], vec<T, S>{}};
+    for (size_t i = 0; i < S; ++i)
+    {
+      result.normal[i] = normal[i][index];
+    }
+    return result;
+  }
+
+  void reserve(const size_t capacity)
+  {
+    for (size_t i = 0; i < S; ++i)
+    {
+      normal[i].reserve(capacity);
+    }
+    distance.reserve(capacity);
+  }
+
+  void clear()
+  {
+    for (size_t i = 0; i < S; ++i)
+    {
+      normal[i].clear();
+    }
+    distance.clear();
+  }
+
+  void push_back(const plane<T, S>& p)
+  {
+    for (size_t i = 0; i < S; ++i)
+    {
+      normal[i].push_back(p.normal[i]);
+    }
+    distance.push_back(p.distance);
+  }
+};
+
+/**
+ * A list of rays whose origin and direction components are stored in separate arrays,
+ * see bbox_batch and intersect_rays_bbox.
+ *
+ * @tparam T the component type
+ * @tparam S the number of components
+ */
+template <typename T, size_t S>
+struct ray_batch
+{
+  std::vector<T> origin[S];
+  std::vector<T> direction[S];
+
+  size_t size() const { return origin[0].size(); }
+
+  bool empty() const { return origin[0].empty(); }
+
+  ray<T, S> operator[](const size_t index) const
+  {
+    auto result = ray<T, S>{};
+    for (size_t i = 0; i < S; ++i)
+    {
+      result.origin[i] = origin[i][index];
+      result.direction[i] = direction[i][index];
+    }
+    return result;
+  }
+
+  void reserve(const size_t capacity)
+  {
+    for (size_t i = 0; i < S; ++i)
+    {
+      origin[i].reserve(capacity);
+      direction[i].reserve(capacity);
+    }
+  }
+
+  void clear()
+  {
+    for (size_t i = 0; i < S; ++i)
+    {
+      origin[i].clear();
+      direction[i].clear();
+    }
+  }
+
+  void push_back(const ray<T, S>& r)
+  {
+    for (size_t i = 0; i < S; ++i)
+    {
+      origin[i].push_back(r.origin[i]);
+      direction[i].push_back(r.direction[i]);
+    }
+  }
+};
+
+namespace detail
+{
+#if defined(VECMATH_SIMD_AVX)
+/**
+ * Four double lanes using AVX instructions.
+ */
+struct double_lanes
+{
+  using value = __m256d;
+  static constexpr size_t width = 4;
+
+  static value load(const double* p) { return _mm256_loadu_pd(p); }
+  static void store(double* p, const value v) { _mm256_storeu_pd(p, v); }
+  static value broadcast(const double d) { return _mm256_set1_pd(d); }
+  static value all() { return _mm256_castsi256_pd(_mm256_set1_epi64x(-1)); }
+
+  static value add(const value a, const value b) { return _mm256_add_pd(a, b); }
+  static value sub(const value a, const value b) { return _mm256_sub_pd(a, b); }
+  static value mul(const value a, const value b) { return _mm256_mul_pd(a, b); }
+  static value div(const value a, const value b) { return _mm256_div_pd(a, b); }
+  static value abs(const value a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+
+  static value eq(const value a, const value b)
+  {
+    return _mm256_cmp_pd(a, b, _CMP_EQ_OQ);
+  }
+  static value ne(const value a, const value b)
+  {
+    return _mm256_cmp_pd(a, b, _CMP_NEQ_UQ);
+  }
+  static value lt(const value a, const value b)
+  {
+    return _mm256_cmp_pd(a, b, _CMP_LT_OQ);
+  }
+  static value le(const value a, const value b)
+  {
+    return _mm256_cmp_pd(a, b, _CMP_LE_OQ);
+  }
+  static value gt(const value a, const value b)
+  {
+    return _mm256_cmp_pd(a, b, _CMP_GT_OQ);
+  }
+
+  static value both(const value a, const value b) { return _mm256_and_pd(a, b); }
+  static value either(const value a, const value b) { return _mm256_or_pd(a, b); }
+  static value but_not(const value a, const value b) { return _mm256_andnot_pd(b, a); }
+  static value select(const value m, const value a, const value b)
+  {
+    return _mm256_blendv_pd(b, a, m);
+  }
+};
+#elif defined(VECMATH_SIMD_SSE2)
+/**
+ * Two double lanes using SSE2 instructions.
+ */
+struct double_lanes
+{
+  using value = __m128d;
+  static constexpr size_t width = 2;
+
+  static value load(const double* p) { return _mm_loadu_pd(p); }
+  static void store(double* p, const value v) { _mm_storeu_pd(p, v); }
+  static value broadcast(const double d) { return _mm_set1_pd(d); }
+  static value all() { return _mm_castsi128_pd(_mm_set1_epi32(-1)); }
+
+  static value add(const value a, const value b) { return _mm_add_pd(a, b); }
+  static value sub(const value a, const value b) { return _mm_sub_pd(a, b); }
+  static value mul(const value a, const value b) { return _mm_mul_pd(a, b); }
+  static value div(const value a, const value b) { return _mm_div_pd(a, b); }
+  static value abs(const value a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+
+  static value eq(const value a, const value b) { return _mm_cmpeq_pd(a, b); }
+  static value ne(const value a, const value b) { return _mm_cmpneq_pd(a, b); }
+  static value lt(const value a, const value b) { return _mm_cmplt_pd(a, b); }
+  static value le(const value a, const value b) { return _mm_cmple_pd(a, b); }
+  static value gt(const value a, const value b) { return _mm_cmpgt_pd(a, b); }
+
+  static value both(const value a, const value b) { return _mm_and_pd(a, b); }
+  static value either(const value a, const value b) { return _mm_or_pd(a, b); }
+  static value but_not(const value a, const value b) { return _mm_andnot_pd(b, a); }
+  static value select(const value m, const value a, const value b)
+  {
+    return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b));
+  }
+};
+#endif
+
+#if defined(VECMATH_SIMD_AVX) || defined(VECMATH_SIMD_SSE2)
+/**
+ * Computes intersect_ray_bbox for several rays and bounding boxes at once, performing the
+ * same operations as the scalar function in each lane so that the results are identical.
+ *
+ * @tparam L the lane type
+ * @tparam S the number of components
+ */
+template <typename L, size_t S>
+typename L::value intersect_ray_bbox_lanes(
+  const typename L::value (&origin)[S],
+  const typename L::value (&direction)[S],
+  const typename L::value (&min)[S],
+  const typename L::value (&max)[S])
+{
+  using value = typename L::value;
+
+  const auto zero = L::broadcast(0.0);
+
+  // compute candidate planes and intersect them with the rays
+  value distances[S];
+  value inside[S];
+  auto all_inside = L::all();
+  for (size_t i = 0; i < S; ++i)
+  {
+    const auto below = L::lt(origin[i], min[i]);
+    const auto above = L::gt(origin[i], max[i]);
+    const auto candidate = L::select(
+      below,
+      min[i],
+      L::select(above, max[i], L::select(L::lt(direction[i], zero), min[i], max[i])));
+
+    inside[i] = L::but_not(L::but_not(L::all(), below), above);
+    all_inside = L::both(all_inside, inside[i]);
+    distances[i] = L::select(
+      L::ne(direction[i], zero),
+      L::div(L::sub(candidate, origin[i]), direction[i]),
+      L::broadcast(-1.0));
+  }
+
+  // if all origins are inside, find the closest plane that was hit
+  auto closest = distances[0];
+  value is_closest[S];
+  is_closest[0] = L::all();
+  for (size_t i = 1; i < S; ++i)
+  {
+    const auto take = L::lt(distances[i], closest);
+    closest = L::select(take, distances[i], closest);
+    for (size_t j = 0; j < i; ++j)
+    {
+      is_closest[j] = L::but_not(is_closest[j], take);
+    }
+    is_closest[i] = take;
+  }
+
+  // otherwise, find the farthest plane that was hit among those outside
+  auto farthest = zero;
+  auto none_found = L::all();
+  value is_farthest[S];
+  for (size_t i = 0; i < S; ++i)
+  {
+    const auto take = L::but_not(
+      L::either(none_found, L::gt(distances[i], farthest)), inside[i]);
+    farthest = L::select(take, distances[i], farthest);
+    for (size_t j = 0; j < i; ++j)
+    {
+      is_farthest[j] = L::but_not(is_farthest[j], take);
+    }
+    is_farthest[i] = take;
+    none_found = L::but_not(none_found, take);
+  }
+
+  // check if the final candidate actually hits the box
+  const auto best = L::select(all_inside, closest, farthest);
+  auto miss = L::lt(best, zero);
+  for (size_t i = 0; i < S; ++i)
+  {
+    const auto is_best = L::select(all_inside, is_closest[i], is_farthest[i]);
+    const auto coord = L::add(origin[i], L::mul(best, direction[i]));
+    const auto outside = L::either(L::lt(coord, min[i]), L::gt(coord, max[i]));
+    miss = L::either(miss, L::but_not(outside, is_best));
+  }
+
+  return L::select(miss, L::broadcast(nan<double>()), best);
+}
+
+/**
+ * Computes intersect_ray_plane for one ray and several planes at once, performing the
+ * same operations as the scalar function in each lane so that the results are identical.
+ *
+ * @tparam L the lane type
+ * @tparam S the number of components
+ */
+template <typename L, size_t S>
+typename L::value intersect_ray_plane_lanes(
+  const typename L::value (&origin)[S],
+  const typename L::value (&direction)[S],
+  const typename L::value (&normal)[S],
+  const typename L::value distance)
+{
+  const auto zero = L::broadcast(0.0);
+  const auto epsilon = L::broadcast(constants<double>::almost_zero());
+
+  auto cos = zero;
+  auto s = zero;
+  for (size_t i = 0; i < S; ++i)
+  {
+    cos = L::add(cos, L::mul(direction[i], normal[i]));
+    s = L::add(s, L::mul(L::sub(L::mul(normal[i], distance), origin[i]), normal[i]));
+  }
+  s = L::div(s, cos);
+
+  const auto parallel = L::either(L::eq(cos, zero), L::le(L::abs(cos), epsilon));
+  const auto behind = L::lt(s, L::broadcast(-constants<double>::almost_zero()));
+  return L::select(L::either(parallel, behind), L::broadcast(nan<double>()), s);
+}
+#endif
+} // namespace detail
+
+/**
+ * Computes the distances at which the given ray intersects each of the given bounding
+ * boxes and stores them in the given array.
+ *
+ * For each bounding box, the stored distance is identical to the result of
+ * intersect_ray_bbox. If T is double, several bounding boxes are tested at once using
+ * AVX or SSE2 instructions if available.
+ *
+ * @tparam T the component type
+ * @tparam S the number of components
+ * @param r the ray
+ * @param boxes the bounding boxes
+ * @param distances the array to store the distances in, must have room for
+ * boxes.size() elements
+ */
+template <typename T, size_t S>
+void intersect_ray_bboxes(const ray<T, S>& r, const bbox_batch<T, S>& boxes, T* distances)
+{
+  size_t first = 0;
+#if defined(VECMATH_SIMD_AVX) || defined(VECMATH_SIMD_SSE2)
+  if constexpr (std::is_same_v<T, double>)
+  {
+    using L = detail::double_lanes;
+    typename L::value origin[S], direction[S], min[S], max[S];
+    for (size_t i = 0; i < S; ++i)
+    {
+      origin[i] = L::broadcast(r.origin[i]);
+      direction[i] = L::broadcast(r.direction[i]);
+    }
+    for (; first + L::width <= boxes.size(); first += L::width)
+    {
+      for (size_t i = 0; i < S; ++i)
+      {
+        min[i] = L::load(boxes.min[i].data() + first);
+        max[i] = L::load(boxes.max[i].data() + first);
+      }
+      L::store(
+        distances + first,
+        detail::intersect_ray_bbox_lanes<L, S>(origin, direction, min, max));
+    }
+  }
+#endif
+  for (size_t j = first; j < boxes.size(); ++j)
+  {
+    distances[j] = intersect_ray_bbox(r, boxes[j]);
+  }
+}
+
+/**
+ * Computes the distances at which each of the given rays intersects the given bounding
+ * box and stores them in the given array.
+ *
+ * For each ray, the stored distance is identical to the result of intersect_ray_bbox. If
+ * T is double, several rays are tested at once using AVX or SSE2 instructions if
+ * available.
+ *
+ * @tparam T the component type
+ * @tparam S the number of components
+ * @param rays the rays
+ * @param b the bounding box
+ * @param distances the array to store the distances in, must have room for rays.size()
+ * elements
+ */
+template <typename T, size_t S>
+void intersect_rays_bbox(const ray_batch<T, S>& rays, const bbox<T, S>& b, T* distances)
+{
+  size_t first = 0;
+#if defined(VECMATH_SIMD_AVX) || defined(VECMATH_SIMD_SSE2)
+  if constexpr (std::is_same_v<T, double>)
+  {
+    using L = detail::double_lanes;
+    typename L::value origin[S], direction[S], min[S], max[S];
+    for (size_t i = 0; i < S; ++i)
+    {
+      min[i] = L::broadcast(b.min[i]);
+      max[i] = L::broadcast(b.max[i]);
+    }
+    for (; first + L::width <= rays.size(); first += L::width)
+    {
+      for (size_t i = 0; i < S; ++i)
+      {
+        origin[i] = L::load(rays.origin[i].data() + first);
+        direction[i] = L::load(rays.direction[i].data() + first);
+      }
+      L::store(
+        distances + first,
+        detail::intersect_ray_bbox_lanes<L, S>(origin, direction, min, max));
+    }
+  }
+#endif
+  for (size_t j = first; j < rays.size(); ++j)
+  {
+    distances[j] = intersect_ray_bbox(rays[j], b);
+  }
+}
+
+/**
+ * Computes the distances at which the given ray intersects each of the given planes and
+ * stores them in the given array.
+ *
+ * For each plane, the stored distance is identical to the result of intersect_ray_plane.
+ * If T is double, several planes are tested at once using AVX or SSE2 instructions if
+ * available.
+ *
+ * @tparam T the component type
+ * @tparam S the number of components
+ * @param r the ray
+ * @param planes the planes
+ * @param distances the array to store the distances in, must have room for
+ * planes.size() elements
+ */
+template <typename T, size_t S>
+void intersect_ray_planes(
+  const ray<T, S>& r, const plane_batch<T, S>& planes, T* distances)
+{
+  size_t first = 0;
+#if defined(VECMATH_SIMD_AVX) || defined(VECMATH_SIMD_SSE2)
+  if constexpr (std::is_same_v<T, double>)
+  {
+    using L = detail::double_lanes;
+    typename L::value origin[S], direction[S], normal[S];
+    for (size_t i = 0; i < S; ++i)
+    {
+      origin[i] = L::broadcast(r.origin[i]);
+      direction[i] = L::broadcast(r.direction[i]);
+    }
+    for (; first + L::width <= planes.size(); first += L::width)
+    {
+      for (size_t i = 0; i < S; ++i)
+      {
+        normal[i] = L::load(planes.normal[i].data() + first);
+      }
+      L::store(
+        distances + first,
+        detail::intersect_ray_plane_lanes<L, S>(
+          origin, direction, normal, L::load(planes.distance.data() + first)));
+    }
+  }
+#endif
+  for (size_t j = first; j < planes.size(); ++j)
+  {
+    distances[j] = intersect_ray_plane(r, planes[j]);
+  }
+}
+
 /**
  * Computes the point of intersection between the given ray and a sphere centered at the
  * given position and with the given radius.
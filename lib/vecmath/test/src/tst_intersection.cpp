@@ -31,6 +31,8 @@
 #include <vecmath/vec_io.h>
 
 #include <array>
+#include <random>
+#include <vector>
 
 #include <catch2/catch.hpp>
 
@@ -298,6 +300,191 @@ TEST_CASE("intersection.intersect_ray_bbox")
   CHECK(intersect_ray_bbox(ray3f(origin, dir), bounds) == approx(length(diff)));
 }
 
+TEST_CASE("intersection.plane_bbox_status")
+{
+  constexpr auto bounds = bbox3f(vec3f(-12.0f, -3.0f, 4.0f), vec3f(8.0f, 9.0f, 8.0f));
+
+  CER_CHECK(
+    plane_bbox_status(plane3f(vec3f(0, 0, 2), vec3f::pos_z()), bounds)
+    == plane_status::above);
+  CER_CHECK(
+    plane_bbox_status(plane3f(vec3f(0, 0, 10), vec3f::pos_z()), bounds)
+    == plane_status::below);
+  CER_CHECK(
+    plane_bbox_status(plane3f(vec3f(0, 0, 6), vec3f::pos_z()), bounds)
+    == plane_status::inside);
+  CER_CHECK(
+    plane_bbox_status(plane3f(vec3f(0, 0, 2), vec3f::neg_z()), bounds)
+    == plane_status::below);
+
+  // the plane touches the box
+  CER_CHECK(
+    plane_bbox_status(plane3f(vec3f(0, 0, 4), vec3f::pos_z()), bounds)
+    == plane_status::inside);
+
+  // the plane is tilted and passes by the corner closest to the origin
+  constexpr auto normal = normalize_c(vec3f(1, 1, 1));
+  CHECK(
+    plane_bbox_status(plane3f(vec3f(-12.0f, -3.0f, 3.0f), normal), bounds)
+    == plane_status::above);
+  CHECK(
+    plane_bbox_status(plane3f(vec3f(-12.0f, -3.0f, 5.0f), normal), bounds)
+    == plane_status::inside);
+  CHECK(
+    plane_bbox_status(plane3f(vec3f(8.0f, 9.0f, 9.0f), normal), bounds)
+    == plane_status::below);
+}
+
+namespace
+{
+template <typename T>
+bool is_same_result(const T lhs, const T rhs)
+{
+  return (is_nan(lhs) && is_nan(rhs)) || lhs == rhs;
+}
+
+/**
+ * Returns a random number generator for coordinates which often produces identical
+ * values, so that rays often start on the boundaries of boxes or are parallel to them.
+ */
+template <typename T>
+auto make_coord_generator(const unsigned int seed)
+{
+  return [rng = std::mt19937{seed}]() mutable {
+    auto integer = std::uniform_int_distribution<int>{-4, 4};
+    auto real = std::uniform_real_distribution<T>{static_cast<T>(-4), static_cast<T>(4)};
+    return integer(rng) % 2 == 0 ? static_cast<T>(integer(rng)) : real(rng);
+  };
+}
+
+template <typename T>
+std::vector<ray<T, 3>> make_rays(const size_t count, const unsigned int seed)
+{
+  auto coord = make_coord_generator<T>(seed);
+  auto result = std::vector<ray<T, 3>>{};
+  for (size_t i = 0; i < count; ++i)
+  {
+    const auto origin = vec<T, 3>{coord(), coord(), coord()};
+    const auto direction = vec<T, 3>{coord(), coord(), coord()};
+    result.emplace_back(
+      origin, is_zero(direction, static_cast<T>(0)) ? direction : normalize(direction));
+  }
+  return result;
+}
+
+template <typename T>
+std::vector<bbox<T, 3>> make_bboxes(const size_t count, const unsigned int seed)
+{
+  auto coord = make_coord_generator<T>(seed);
+  auto result = std::vector<bbox<T, 3>>{};
+  for (size_t i = 0; i < count; ++i)
+  {
+    const auto p1 = vec<T, 3>{coord(), coord(), coord()};
+    const auto p2 = vec<T, 3>{coord(), coord(), coord()};
+    result.emplace_back(min(p1, p2), max(p1, p2));
+  }
+  return result;
+}
+
+template <typename T>
+void test_intersect_ray_bboxes()
+{
+  const auto rays = make_rays<T>(64, 1);
+  const auto boxes = make_bboxes<T>(103, 2);
+
+  auto batch = bbox_batch<T, 3>{};
+  for (const auto& box : boxes)
+  {
+    batch.push_back(box);
+  }
+  REQUIRE(batch.size() == boxes.size());
+
+  auto distances = std::vector<T>(boxes.size());
+  for (const auto& ray : rays)
+  {
+    intersect_ray_bboxes(ray, batch, distances.data());
+    for (size_t i = 0; i < boxes.size(); ++i)
+    {
+      CHECK(is_same_result(distances[i], intersect_ray_bbox(ray, boxes[i])));
+    }
+  }
+}
+
+template <typename T>
+void test_intersect_rays_bbox()
+{
+  const auto rays = make_rays<T>(103, 3);
+  const auto boxes = make_bboxes<T>(64, 4);
+
+  auto batch = ray_batch<T, 3>{};
+  for (const auto& ray : rays)
+  {
+    batch.push_back(ray);
+  }
+  REQUIRE(batch.size() == rays.size());
+
+  auto distances = std::vector<T>(rays.size());
+  for (const auto& box : boxes)
+  {
+    intersect_rays_bbox(batch, box, distances.data());
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+      CHECK(is_same_result(distances[i], intersect_ray_bbox(rays[i], box)));
+    }
+  }
+}
+
+template <typename T>
+void test_intersect_ray_planes()
+{
+  const auto rays = make_rays<T>(64, 5);
+
+  auto coord = make_coord_generator<T>(6);
+  auto planes = std::vector<plane<T, 3>>{};
+  for (size_t i = 0; i < 103; ++i)
+  {
+    const auto normal = vec<T, 3>{coord(), coord(), coord()};
+    planes.emplace_back(
+      coord(), is_zero(normal, static_cast<T>(0)) ? normal : normalize(normal));
+  }
+
+  auto batch = plane_batch<T, 3>{};
+  for (const auto& plane : planes)
+  {
+    batch.push_back(plane);
+  }
+  REQUIRE(batch.size() == planes.size());
+
+  auto distances = std::vector<T>(planes.size());
+  for (const auto& ray : rays)
+  {
+    intersect_ray_planes(ray, batch, distances.data());
+    for (size_t i = 0; i < planes.size(); ++i)
+    {
+      CHECK(is_same_result(distances[i], intersect_ray_plane(ray, planes[i])));
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("intersection.intersect_ray_bboxes")
+{
+  test_intersect_ray_bboxes<double>();
+  test_intersect_ray_bboxes<float>();
+}
+
+TEST_CASE("intersection.intersect_rays_bbox")
+{
+  test_intersect_rays_bbox<double>();
+  test_intersect_rays_bbox<float>();
+}
+
+TEST_CASE("intersection.intersect_ray_planes")
+{
+  test_intersect_ray_planes<double>();
+  test_intersect_ray_planes<float>();
+}
+
 TEST_CASE("intersection.intersect_ray_sphere")
 {
   const ray3f ray(vec3f::zero(), vec3f::pos_z());